@@ -0,0 +1,139 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "utils/logger.h"
+#include "widget/batch_renderer.h"
+#include "widget/label.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// A screen full of labels drawn one by one (two draw calls each) against
+// the same labels drawn through a Batch_renderer. Draws into a hidden
+// window and waits for display() so the numbers include the driver, run
+// from the build's bin/ folder.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr int LABEL_COUNTS[] = { 100, 500, 2'000 };
+constexpr int WARMUP_COUNT   = 20;
+constexpr int FRAME_COUNT    = 300;
+
+using Labels = std::vector<std::unique_ptr<widget::Label>>;
+
+// -------------------------------------------------------------------
+Labels make_labels(sf::RenderWindow& window, int const count) {
+
+    Labels labels;
+    labels.reserve(static_cast<std::size_t>(count));
+
+    for (int i = 0; i < count; ++i) {
+
+        auto label = std::make_unique<widget::Label>(&window, "HP " + std::to_string(i));
+        label->set_pos({ static_cast<float>(i % 25) * 48.0f, static_cast<float>(i / 25 % 50) * 14.0f + 2.0f });
+        label->set_character_size(11u);
+        label->set_margins(1.0f, 1.0f, 2.0f, 2.0f);
+        label->set_background_color(sf::Color(40, 40, 40));
+        label->set_border_thickness(1.0f);
+        label->set_border_color(sf::Color(200, 200, 200));
+
+        labels.push_back(std::move(label));
+    }
+
+    return labels;
+}
+
+// -------------------------------------------------------------------
+template<typename Draw_function>
+void run(char const* const name, int const count, std::size_t const draw_calls, sf::RenderWindow& window, Draw_function&& draw_function) {
+
+    std::vector<double> samples;
+    samples.reserve(FRAME_COUNT);
+
+    for (int frame = 0; frame < WARMUP_COUNT + FRAME_COUNT; ++frame) {
+
+        auto const begin = Bench_clock::now();
+
+        window.clear();
+        draw_function();
+        window.display();
+
+        if (frame >= WARMUP_COUNT) {
+
+            samples.push_back(elapsed_ns(begin, Bench_clock::now()) / 1000.0);
+        }
+    }
+
+    double const p50 = percentile(samples, 50.0);
+    double const p99 = percentile(samples, 99.0);
+
+    std::printf("%-10s %6d labels   %6zu draw calls   p50 %9.1f us/frame   p99 %9.1f us/frame\n",
+                name, count, draw_calls, p50, p99);
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    sf::RenderWindow window(sf::VideoMode({ 1280u, 720u }), "bench_batch_draw");
+    window.setVisible(false);
+    window.setVerticalSyncEnabled(false);
+
+    widget::Batch_renderer batch;
+
+    for (int const count : LABEL_COUNTS) {
+
+        Labels labels = make_labels(window, count);
+
+        run("immediate", count, labels.size() * 2u, window, [&] {
+
+            for (auto& label : labels) {
+
+                label->draw();
+            }
+        });
+
+        // Fill once up front for the draw call count
+        batch.clear();
+
+        for (auto& label : labels) {
+
+            label->draw(batch);
+        }
+
+        run("batched", count, batch.get_draw_call_count(), window, [&] {
+
+            batch.clear();
+
+            for (auto& label : labels) {
+
+                label->draw(batch);
+            }
+
+            batch.draw(window);
+        });
+    }
+
+    return 0;
+}
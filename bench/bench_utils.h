@@ -0,0 +1,123 @@
+#ifndef BENCH_BENCH_UTILS_H
+#define BENCH_BENCH_UTILS_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef NOGDI
+        #define NOGDI
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <unistd.h>
+#endif
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::bench {
+
+// ===================================================================
+// Timing helpers
+// -------------------------------------------------------------------
+
+using Bench_clock = std::chrono::steady_clock;
+
+// Nanoseconds between two time points as a double.
+inline double elapsed_ns(Bench_clock::time_point const begin, Bench_clock::time_point const end) {
+
+    return std::chrono::duration<double, std::nano>(end - begin).count();
+}
+
+// Returns the p-th percentile (0..100) of the samples, reorders them.
+inline double percentile(std::vector<double>& samples, double const p) {
+
+    if (samples.empty()) {
+
+        return 0.0;
+    }
+
+    std::size_t const last  = samples.size() - 1u;
+    std::size_t const index = static_cast<std::size_t>(p / 100.0 * static_cast<double>(last) + 0.5);
+
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+
+    return samples[index];
+}
+
+// CPU time (user + system) this process used so far, in seconds.
+inline double process_cpu_seconds() {
+
+#if defined(_WIN32)
+
+    FILETIME creation_time{};
+    FILETIME exit_time{};
+    FILETIME kernel_time{};
+    FILETIME user_time{};
+    GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time);
+
+    auto const to_seconds = [](FILETIME const& time) {
+
+        // 100 ns ticks
+        return static_cast<double>((static_cast<unsigned long long>(time.dwHighDateTime) << 32u) | time.dwLowDateTime) / 10'000'000.0;
+    };
+
+    return to_seconds(kernel_time) + to_seconds(user_time);
+
+#else
+
+    // Process CPU time on POSIX (on Windows clock() is wall time, hence the above)
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+// ===================================================================
+// Memory helpers
+// -------------------------------------------------------------------
+
+// Resident set size of this process in bytes, 0 where it can't be read.
+inline std::size_t resident_bytes() {
+
+#if defined(_WIN32)
+
+    PROCESS_MEMORY_COUNTERS counters{};
+    K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+
+    return static_cast<std::size_t>(counters.WorkingSetSize);
+
+#elif defined(__linux__)
+
+    // Second field of statm is the resident page count, pages aren't 4 KiB everywhere (16 KiB on some ARM kernels).
+    std::ifstream statm("/proc/self/statm");
+    std::size_t   total_pages    = 0u;
+    std::size_t   resident_pages = 0u;
+    statm >> total_pages >> resident_pages;
+
+    return resident_pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+#else
+
+    return 0u;
+#endif
+}
+
+} // tiny_tanks::bench
+
+#endif // BENCH_BENCH_UTILS_H
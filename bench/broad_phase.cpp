@@ -0,0 +1,329 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "game/broad_phase.h"
+#include "utils/logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// ENTITY_COUNTS moving boxes, a tenth of them 24 px tanks and the rest
+// 4 px bullets (bullets don't hit bullets), over a map scaled to keep the
+// crowd the same and scattered with 16 px walls. Every 60 Hz tick moves
+// them and finds the pairs that overlap, with every box against every
+// other one (up to NAIVE_MAX_COUNT) and with the Broad_phase grid on 1 to
+// 8 threads. The pair counts have to match between all of them: every
+// grid run is checked against the naive one (when it ran) and against
+// the grid on one thread, and the bench returns 1 on a mismatch.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr std::size_t ENTITY_COUNTS[]  = { 1'000u, 10'000u, 50'000u, 200'000u };
+constexpr std::size_t WORKER_COUNTS[]  = { 1u, 2u, 4u, 8u };
+constexpr std::size_t NAIVE_MAX_COUNT  = 10'000u;
+constexpr int         WARMUP_COUNT     = 10;
+constexpr int         TICK_COUNT       = 200;
+constexpr float       DT               = 1.0f / 60.0f;
+constexpr float       AREA_PER_ENTITY  = 48.0f * 48.0f;
+constexpr float       TANK_SIZE        = 24.0f;
+constexpr float       BULLET_SIZE      = 4.0f;
+constexpr float       WALL_SIZE        = 16.0f;
+
+constexpr std::uint8_t TANK   = 0u;
+constexpr std::uint8_t BULLET = 1u;
+constexpr std::uint8_t WALL   = 2u;
+
+struct Scene {
+
+    float                      map_size;
+    std::vector<sf::FloatRect> bounds;
+    std::vector<sf::Vector2f>  velocities;
+    std::vector<std::uint8_t>  layers;
+    std::vector<sf::FloatRect> walls;
+    std::vector<std::uint8_t>  wall_layers;
+};
+
+// -------------------------------------------------------------------
+Scene make_scene(std::size_t const entity_count) {
+
+    Scene scene;
+    scene.map_size = std::sqrt(static_cast<float>(entity_count) * AREA_PER_ENTITY);
+
+    std::mt19937                          random(7u);
+    std::uniform_real_distribution<float> position(0.0f, scene.map_size - TANK_SIZE);
+    std::uniform_real_distribution<float> speed(-200.0f, 200.0f);
+
+    for (std::size_t i = 0u; i < entity_count; ++i) {
+
+        bool const  is_tank = (i % 10u == 0u);
+        float const size    = is_tank ? TANK_SIZE : BULLET_SIZE;
+
+        scene.bounds    .push_back({ { position(random), position(random) }, { size, size } });
+        scene.velocities.push_back({ speed(random), is_tank ? speed(random) * 0.2f : speed(random) });
+        scene.layers    .push_back(is_tank ? TANK : BULLET);
+    }
+
+    // About one wall per 20 entities
+    for (std::size_t i = 0u; i < entity_count / 20u + 1u; ++i) {
+
+        scene.walls      .push_back({ { position(random), position(random) }, { WALL_SIZE, WALL_SIZE } });
+        scene.wall_layers.push_back(WALL);
+    }
+
+    return scene;
+}
+
+// -------------------------------------------------------------------
+// Bouncing off the map's edges.
+void move(Scene& scene) {
+
+    for (std::size_t i = 0u; i < scene.bounds.size(); ++i) {
+
+        sf::FloatRect& box      = scene.bounds[i];
+        sf::Vector2f&  velocity = scene.velocities[i];
+
+        box.position += velocity * DT;
+
+        if (box.position.x < 0.0f || box.position.x + box.size.x > scene.map_size) { velocity.x = -velocity.x; }
+        if (box.position.y < 0.0f || box.position.y + box.size.y > scene.map_size) { velocity.y = -velocity.y; }
+    }
+}
+
+// -------------------------------------------------------------------
+bool collides(std::uint8_t const a, std::uint8_t const b) {
+
+    return !(a == BULLET && b == BULLET);
+}
+
+// -------------------------------------------------------------------
+bool is_overlapping(sf::FloatRect const& a, sf::FloatRect const& b) {
+
+    return a.position.x < b.position.x + b.size.x && b.position.x < a.position.x + a.size.x
+        && a.position.y < b.position.y + b.size.y && b.position.y < a.position.y + a.size.y;
+}
+
+// Pair counts are the last tick's.
+struct Result {
+
+    std::vector<double> samples;
+    std::size_t         pairs        = 0u;
+    std::size_t         static_pairs = 0u;
+    std::size_t         narrow_pairs = 0u;  // Grid only, the pairs the stand in narrow phase confirmed
+};
+
+// -------------------------------------------------------------------
+void print(char const* const name, std::size_t const entity_count, Result& result) {
+
+    std::printf("%-10s %7zu entities   p50 %9.3f ms/tick   p99 %9.3f ms/tick   %7zu pairs %6zu wall pairs",
+                name, entity_count, percentile(result.samples, 50.0), percentile(result.samples, 99.0),
+                result.pairs, result.static_pairs);
+
+    if (result.narrow_pairs != 0u) {
+
+        std::printf("   %7zu confirmed", result.narrow_pairs);
+    }
+
+    std::printf("\n");
+}
+
+// -------------------------------------------------------------------
+// False (and says why) if the grid found other pairs than the reference.
+bool check(char const* const name, Result const& grid, char const* const reference_name, Result const& reference) {
+
+    if (grid.pairs == reference.pairs && grid.static_pairs == reference.static_pairs) {
+
+        return true;
+    }
+
+    std::printf("MISMATCH  %s found %zu pairs %zu wall pairs, %s %zu pairs %zu wall pairs\n",
+                name, grid.pairs, grid.static_pairs, reference_name, reference.pairs, reference.static_pairs);
+
+    return false;
+}
+
+// -------------------------------------------------------------------
+Result run_naive(std::size_t const entity_count) {
+
+    Scene  scene = make_scene(entity_count);
+    Result result;
+
+    for (int tick = 0; tick < WARMUP_COUNT + TICK_COUNT; ++tick) {
+
+        move(scene);
+
+        auto const begin = Bench_clock::now();
+
+        std::size_t pairs        = 0u;
+        std::size_t static_pairs = 0u;
+
+        for (std::size_t a = 0u; a < scene.bounds.size(); ++a) {
+
+            for (std::size_t b = a + 1u; b < scene.bounds.size(); ++b) {
+
+                if (collides(scene.layers[a], scene.layers[b]) && is_overlapping(scene.bounds[a], scene.bounds[b])) {
+
+                    ++pairs;
+                }
+            }
+
+            for (sf::FloatRect const& wall : scene.walls) {
+
+                if (is_overlapping(scene.bounds[a], wall)) {
+
+                    ++static_pairs;
+                }
+            }
+        }
+
+        if (tick >= WARMUP_COUNT) {
+
+            result.samples.push_back(elapsed_ns(begin, Bench_clock::now()) / 1'000'000.0);
+        }
+
+        result.pairs        = pairs;
+        result.static_pairs = static_pairs;
+    }
+
+    print("naive", entity_count, result);
+
+    return result;
+}
+
+// -------------------------------------------------------------------
+Result run_grid(std::size_t const entity_count, std::size_t const worker_count) {
+
+    Scene scene = make_scene(entity_count);
+
+    game::Broad_phase_settings settings;
+    settings.cell_size    = 64.0f;
+    settings.worker_count = worker_count;
+
+    game::Broad_phase broad_phase({ { 0.0f, 0.0f }, { scene.map_size, scene.map_size } }, settings);
+    broad_phase.set_collides(BULLET, BULLET, false);
+    broad_phase.set_static(scene.walls, scene.wall_layers);
+
+    // A stand in narrow phase, counting per worker
+    std::vector<std::size_t> narrow_pairs(std::max<std::size_t>(1u, worker_count), 0u);
+
+    game::Broad_phase::Pair_function const on_pairs = [&](std::span<game::Collision_pair const> const pairs, bool const is_static, std::size_t const worker) {
+
+        std::vector<sf::FloatRect> const& others = is_static ? scene.walls : scene.bounds;
+
+        for (game::Collision_pair const& pair : pairs) {
+
+            narrow_pairs[worker] += is_overlapping(scene.bounds[pair.a], others[pair.b]) ? 1u : 0u;
+        }
+    };
+
+    Result result;
+
+    for (int tick = 0; tick < WARMUP_COUNT + TICK_COUNT; ++tick) {
+
+        move(scene);
+
+        std::fill(narrow_pairs.begin(), narrow_pairs.end(), 0u);
+
+        auto const begin = Bench_clock::now();
+
+        broad_phase.update(scene.bounds, scene.layers, on_pairs);
+
+        if (tick >= WARMUP_COUNT) {
+
+            result.samples.push_back(elapsed_ns(begin, Bench_clock::now()) / 1'000'000.0);
+        }
+    }
+
+    result.pairs        = broad_phase.get_stats().pairs;
+    result.static_pairs = broad_phase.get_stats().static_pairs;
+
+    for (std::size_t const count : narrow_pairs) {
+
+        result.narrow_pairs += count;
+    }
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "grid x%zu", worker_count);
+    print(name, entity_count, result);
+
+    return result;
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    std::size_t const core_count = std::max(1u, std::thread::hardware_concurrency());
+
+    std::printf("%zu cores\n", core_count);
+
+    bool is_matching = true;
+
+    for (std::size_t const entity_count : ENTITY_COUNTS) {
+
+        bool const is_naive_run = (entity_count <= NAIVE_MAX_COUNT);
+        Result     naive;
+        Result     single;
+
+        if (is_naive_run) {
+
+            naive = run_naive(entity_count);
+        }
+
+        for (std::size_t const worker_count : WORKER_COUNTS) {
+
+            if (worker_count > core_count) {
+
+                continue;
+            }
+
+            char name[32];
+            std::snprintf(name, sizeof(name), "grid x%zu", worker_count);
+
+            Result const grid = run_grid(entity_count, worker_count);
+
+            // Every pair the grid hands over overlaps, the narrow phase has to confirm them all
+            if (grid.narrow_pairs != grid.pairs + grid.static_pairs) {
+
+                std::printf("MISMATCH  %s handed over %zu pairs, %zu of them overlap\n", name, grid.pairs + grid.static_pairs, grid.narrow_pairs);
+                is_matching = false;
+            }
+
+            if (is_naive_run) {
+
+                is_matching = check(name, grid, "naive", naive) && is_matching;
+            }
+
+            if (worker_count == 1u) {
+
+                single = grid;
+            } else {
+
+                is_matching = check(name, grid, "grid x1", single) && is_matching;
+            }
+        }
+    }
+
+    return is_matching ? 0 : 1;
+}
@@ -0,0 +1,308 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "utils/logger.h"
+#include "widget/batch_renderer.h"
+#include "widget/command_queue.h"
+#include "widget/label.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// A large scene, ENTITY_COUNTS spinning quads over a few textures plus a
+// HUD of labels, drawn two ways into a hidden window:
+//     render thread   the render thread builds a Batch_renderer itself
+//                     (one pass per texture) and draws it
+//     N workers       a Command_queue builds the next frame's lists on N
+//                     threads while the render thread submits this one
+// Prints the render thread's time per frame (build or wait + submit, up
+// to display()), the workers' build time and the whole frame interval.
+// Each workers line also gives its render thread p50 / p99 as a fraction
+// of the single thread baseline's at the same entity count, below 1 is
+// a win. Run from the build's bin/ folder.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr std::size_t ENTITY_COUNTS[] = { 50'000u, 200'000u };
+constexpr std::size_t WORKER_COUNTS[] = { 1u, 2u, 4u, 8u };
+constexpr std::size_t TEXTURE_COUNT   = 4u;
+constexpr int         LABEL_COUNT     = 500;
+constexpr int         WARMUP_COUNT    = 20;
+constexpr int         FRAME_COUNT     = 200;
+
+constexpr std::uint16_t ENTITY_LAYER = 0u;
+constexpr std::uint16_t HUD_LAYER    = 1u;
+
+struct Scene {
+
+    std::vector<sf::Vector2f>                   positions;
+    std::array<sf::Texture, TEXTURE_COUNT>      textures;
+    std::vector<std::unique_ptr<widget::Label>> labels;
+};
+
+// -------------------------------------------------------------------
+Scene make_scene(sf::RenderWindow& window, std::size_t const entity_count) {
+
+    Scene scene;
+
+    scene.positions.reserve(entity_count);
+
+    for (std::size_t i = 0u; i < entity_count; ++i) {
+
+        scene.positions.push_back({ static_cast<float>(i * 7u % 1280u), static_cast<float>(i * 13u % 720u) });
+    }
+
+    for (std::size_t i = 0u; i < TEXTURE_COUNT; ++i) {
+
+        sf::Image const image({ 8u, 8u }, sf::Color(static_cast<std::uint8_t>(60u * i), 200, 120));
+
+        if (!scene.textures[i].loadFromImage(image)) {
+
+            std::printf("Unable to create texture %zu\n", i);
+        }
+    }
+
+    for (int i = 0; i < LABEL_COUNT; ++i) {
+
+        auto label = std::make_unique<widget::Label>(&window, "Unit " + std::to_string(i));
+        label->set_pos({ static_cast<float>(i % 20) * 64.0f, static_cast<float>(i / 20) * 14.0f });
+        label->set_character_size(11u);
+        label->set_background_color(sf::Color(40, 40, 40, 160));
+
+        scene.labels.push_back(std::move(label));
+    }
+
+    return scene;
+}
+
+// -------------------------------------------------------------------
+// One 12 x 8 quad, spinning with the frame.
+sf::Transform entity_transform(Scene const& scene, std::size_t const entity, int const frame) {
+
+    sf::Transform transform;
+    transform.translate(scene.positions[entity]);
+    transform.rotate(sf::degrees(static_cast<float>((static_cast<int>(entity) + frame * 3) % 360)));
+
+    return transform;
+}
+
+std::array<sf::Vertex, 6> const ENTITY_QUAD = {
+    sf::Vertex{ { -6.0f, -4.0f }, sf::Color::White, { 0.0f, 0.0f } },
+    sf::Vertex{ {  6.0f, -4.0f }, sf::Color::White, { 8.0f, 0.0f } },
+    sf::Vertex{ { -6.0f,  4.0f }, sf::Color::White, { 0.0f, 8.0f } },
+    sf::Vertex{ { -6.0f,  4.0f }, sf::Color::White, { 0.0f, 8.0f } },
+    sf::Vertex{ {  6.0f, -4.0f }, sf::Color::White, { 8.0f, 0.0f } },
+    sf::Vertex{ {  6.0f,  4.0f }, sf::Color::White, { 8.0f, 8.0f } }
+};
+
+struct Result {
+
+    std::vector<double> render_ms;
+    std::vector<double> build_ms;
+    std::vector<double> interval_ms;
+    std::size_t         draw_calls = 0u;
+};
+
+// Render thread percentiles of the single thread run, what the workers are measured against.
+struct Baseline {
+
+    double p50_ms = 0.0;
+    double p99_ms = 0.0;
+};
+
+// -------------------------------------------------------------------
+// Without a baseline the line is the baseline.
+Baseline print(char const* const name, std::size_t const entity_count, Result& result, Baseline const* const baseline = nullptr) {
+
+    Baseline const current = { percentile(result.render_ms, 50.0), percentile(result.render_ms, 99.0) };
+
+    std::printf("%-14s %7zu entities   %5zu draw calls   render thread p50 %7.2f ms p99 %7.2f ms"
+                "   build p50 %7.2f ms   frame p50 %7.2f ms",
+                name, entity_count, result.draw_calls,
+                current.p50_ms, current.p99_ms,
+                result.build_ms.empty() ? 0.0 : percentile(result.build_ms, 50.0),
+                percentile(result.interval_ms, 50.0));
+
+    if (baseline != nullptr && baseline->p50_ms > 0.0 && baseline->p99_ms > 0.0) {
+
+        std::printf("   vs render thread p50 %5.2fx p99 %5.2fx", current.p50_ms / baseline->p50_ms, current.p99_ms / baseline->p99_ms);
+    }
+
+    std::printf("\n");
+
+    return current;
+}
+
+// -------------------------------------------------------------------
+Baseline run_render_thread(sf::RenderWindow& window, Scene& scene) {
+
+    widget::Batch_renderer batch;
+    std::vector<sf::Vertex> vertices;
+
+    Result result;
+    auto   last_frame = Bench_clock::now();
+
+    for (int frame = 0; frame < WARMUP_COUNT + FRAME_COUNT; ++frame) {
+
+        auto const begin = Bench_clock::now();
+
+        window.clear();
+        batch.clear();
+
+        for (std::size_t texture = 0u; texture < TEXTURE_COUNT; ++texture) {
+
+            vertices.clear();
+
+            for (std::size_t i = texture; i < scene.positions.size(); i += TEXTURE_COUNT) {
+
+                sf::Transform const transform = entity_transform(scene, i, frame);
+
+                for (sf::Vertex const& vertex : ENTITY_QUAD) {
+
+                    vertices.push_back(sf::Vertex{ transform.transformPoint(vertex.position), vertex.color, vertex.texCoords });
+                }
+            }
+
+            batch.add(vertices, &scene.textures[texture]);
+        }
+
+        for (auto& label : scene.labels) {
+
+            label->draw(batch);
+        }
+
+        batch.draw(window);
+
+        auto const end = Bench_clock::now();
+
+        window.display();
+
+        if (frame >= WARMUP_COUNT) {
+
+            result.render_ms  .push_back(elapsed_ns(begin,      end)   / 1'000'000.0);
+            result.interval_ms.push_back(elapsed_ns(last_frame, begin) / 1'000'000.0);
+        }
+
+        last_frame = begin;
+    }
+
+    result.draw_calls = batch.get_draw_call_count();
+    return print("render thread", scene.positions.size(), result);
+}
+
+// -------------------------------------------------------------------
+void run_workers(sf::RenderWindow& window, Scene& scene, std::size_t const worker_count, Baseline const& baseline) {
+
+    widget::Command_queue queue(worker_count);
+
+    Result result;
+    auto   last_frame = Bench_clock::now();
+
+    for (int frame = 0; frame < WARMUP_COUNT + FRAME_COUNT; ++frame) {
+
+        auto const begin = Bench_clock::now();
+
+        queue.end_build();
+
+        // Entities in equal slices, the HUD goes to the last worker
+        queue.begin_build([&scene, frame](widget::Command_list& list, std::size_t const worker, std::size_t const list_count) {
+
+            std::size_t const count = scene.positions.size();
+            std::size_t const first = count *  worker       / list_count;
+            std::size_t const last  = count * (worker + 1u) / list_count;
+
+            for (std::size_t i = first; i < last; ++i) {
+
+                list.add(ENTITY_QUAD, entity_transform(scene, i, frame), &scene.textures[i % TEXTURE_COUNT], ENTITY_LAYER, widget::Draw_order::By_state);
+            }
+
+            if (worker + 1u == list_count) {
+
+                for (auto& label : scene.labels) {
+
+                    list.add(*label, HUD_LAYER);
+                }
+            }
+        });
+
+        window.clear();
+        queue.submit(window);
+
+        auto const end = Bench_clock::now();
+
+        window.display();
+
+        // The first frame submits nothing
+        if (frame >= WARMUP_COUNT) {
+
+            result.render_ms  .push_back(elapsed_ns(begin,      end)   / 1'000'000.0);
+            result.interval_ms.push_back(elapsed_ns(last_frame, begin) / 1'000'000.0);
+            result.build_ms   .push_back(queue.get_stats().build_ms);
+        }
+
+        last_frame = begin;
+    }
+
+    queue.end_build();
+
+    result.draw_calls = queue.get_stats().draw_calls;
+
+    std::string const name = std::to_string(worker_count) + (worker_count == 1u ? " worker" : " workers");
+    print(name.c_str(), scene.positions.size(), result, &baseline);
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    sf::RenderWindow window(sf::VideoMode({ 1280u, 720u }), "bench_command_lists");
+    window.setVisible(false);
+    window.setVerticalSyncEnabled(false);
+
+    std::size_t const core_count = std::max(1u, std::thread::hardware_concurrency());
+
+    std::printf("%zu cores, %d labels on top\n", core_count, LABEL_COUNT);
+
+    for (std::size_t const entity_count : ENTITY_COUNTS) {
+
+        Scene scene = make_scene(window, entity_count);
+
+        Baseline const baseline = run_render_thread(window, scene);
+
+        for (std::size_t const worker_count : WORKER_COUNTS) {
+
+            // One core stays with the render thread
+            if (worker_count == 1u || worker_count < core_count) {
+
+                run_workers(window, scene, worker_count, baseline);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "utils/allocation_tracker.h"
+#include "utils/logger.h"
+#include "widget/batch_renderer.h"
+#include "widget/label.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// 1,000 counters ("Score 1234") that all change every frame, updated
+// through set_text(std::to_string()) against set_integer(), then drawn
+// one by one and batched into an offscreen render texture. Labels lay
+// their text out when drawn, so the frame time is the one to compare,
+// the update time is only the setters. Allocations per frame are shown
+// when tracking is compiled in (-DTINY_TANKS_TRACK_ALLOCATIONS=ON).
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr int  COUNTER_COUNT = 1'000;
+constexpr int  WARMUP_COUNT  = 20;
+constexpr int  FRAME_COUNT   = 300;
+constexpr auto TARGET_SIZE   = sf::Vector2u(1920u, 1080u);
+
+using Labels = std::vector<std::unique_ptr<widget::Label>>;
+
+// -------------------------------------------------------------------
+Labels make_counters(sf::RenderTarget& target) {
+
+    Labels labels;
+    labels.reserve(COUNTER_COUNT);
+
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+
+        auto label = std::make_unique<widget::Label>(&target, "Score 0");
+        label->set_pos({ static_cast<float>(i % 20) * 96.0f, static_cast<float>(i / 20) * 20.0f });
+        label->set_character_size(14u);
+        label->set_margins(1.0f, 1.0f, 2.0f, 2.0f);
+        label->set_background_color(sf::Color(40, 40, 40));
+
+        labels.push_back(std::move(label));
+    }
+
+    return labels;
+}
+
+// -------------------------------------------------------------------
+template<typename Update_function, typename Draw_function>
+void run(char const* const name, sf::RenderTexture& target, Update_function&& update_function, Draw_function&& draw_function) {
+
+    std::vector<double> update_samples;
+    std::vector<double> frame_samples;
+
+    update_samples.reserve(FRAME_COUNT);
+    frame_samples .reserve(FRAME_COUNT);
+
+    std::uint64_t allocations = 0u;
+
+    for (int frame = 0; frame < WARMUP_COUNT + FRAME_COUNT; ++frame) {
+
+        // Counts climb by a frame dependent step so the digit count changes now and then
+        std::int64_t const value = static_cast<std::int64_t>(frame) * 37;
+
+        utils::Allocation_counts const allocations_before = utils::Allocation_tracker::get_thread_counts();
+
+        auto const begin = Bench_clock::now();
+
+        update_function(value);
+
+        auto const updated = Bench_clock::now();
+
+        target.clear();
+        draw_function();
+        target.display();
+
+        auto const end = Bench_clock::now();
+
+        if (frame >= WARMUP_COUNT) {
+
+            update_samples.push_back(elapsed_ns(begin, updated) / COUNTER_COUNT);
+            frame_samples .push_back(elapsed_ns(begin, end) / 1000.0);
+
+            allocations += utils::Allocation_tracker::get_thread_counts().allocations - allocations_before.allocations;
+        }
+    }
+
+    double const update_p50 = percentile(update_samples, 50.0);
+    double const frame_p50  = percentile(frame_samples,  50.0);
+    double const frame_p99  = percentile(frame_samples,  99.0);
+
+    char allocations_text[32] = "n/a";
+
+    if (utils::Allocation_tracker::is_compiled_in()) {
+
+        std::snprintf(allocations_text, sizeof(allocations_text), "%.1f", static_cast<double>(allocations) / FRAME_COUNT);
+    }
+
+    std::printf("%-22s update p50 %7.1f ns/counter   frame p50 %9.1f us   p99 %9.1f us   allocations/frame %s\n",
+                name, update_p50, frame_p50, frame_p99, allocations_text);
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    sf::RenderTexture target;
+
+    if (!target.resize(TARGET_SIZE)) {
+
+        std::fprintf(stderr, "Unable to create a %ux%u render texture\n", TARGET_SIZE.x, TARGET_SIZE.y);
+        return 1;
+    }
+
+    Labels labels = make_counters(target);
+
+    widget::Batch_renderer batch;
+
+    auto const draw_immediate = [&] {
+
+        for (auto& label : labels) {
+
+            label->draw(target);
+        }
+    };
+
+    auto const draw_batched = [&] {
+
+        batch.clear();
+
+        for (auto& label : labels) {
+
+            label->draw(batch);
+        }
+
+        batch.draw(target);
+    };
+
+    auto const update_text = [&](std::int64_t const value) {
+
+        for (std::size_t i = 0u; i < labels.size(); ++i) {
+
+            labels[i]->set_text("Score " + std::to_string(value + static_cast<std::int64_t>(i)));
+        }
+    };
+
+    auto const update_integer = [&](std::int64_t const value) {
+
+        for (std::size_t i = 0u; i < labels.size(); ++i) {
+
+            labels[i]->set_integer(value + static_cast<std::int64_t>(i), "Score ");
+        }
+    };
+
+    std::printf("%d counters, all changing every frame\n", COUNTER_COUNT);
+
+    run("set_text immediate",    target, update_text,    draw_immediate);
+    run("set_integer immediate", target, update_integer, draw_immediate);
+    run("set_text batched",      target, update_text,    draw_batched);
+    run("set_integer batched",   target, update_integer, draw_batched);
+
+    return 0;
+}
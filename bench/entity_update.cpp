@@ -0,0 +1,229 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "game/entity_store.h"
+#include "utils/logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// PROJECTILE_COUNT projectiles flying over a map for TICK_COUNT 60 Hz
+// ticks on one core, respawning as they leave it, stored three ways:
+//     objects        one heap object each, updated through a virtual call
+//                    (what deriving them from Widget would give)
+//     SoA loop       the Entity_store's arrays with a plain loop, then the
+//                    same destroy_outside()
+//     Entity_store   integrate() + destroy_outside(), SSE2 unless built
+//                    with -DTINY_TANKS_SIMD=OFF
+// Prints the time per tick and per projectile, and the share of a 60 Hz
+// tick it takes.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr std::size_t PROJECTILE_COUNT = 100'000u;
+constexpr int         WARMUP_COUNT     = 50;
+constexpr int         TICK_COUNT       = 1'000;
+constexpr float       DT               = 1.0f / 60.0f;
+constexpr float       MAP_SIZE         = 4096.0f;
+
+sf::FloatRect const MAP_BOUNDS = { { 0.0f, 0.0f }, { MAP_SIZE, MAP_SIZE } };
+
+// -------------------------------------------------------------------
+game::Entity_desc random_projectile(std::mt19937& random) {
+
+    std::uniform_real_distribution<float> position(0.0f, MAP_SIZE);
+    std::uniform_real_distribution<float> speed(-400.0f, 400.0f);
+
+    game::Entity_desc desc;
+    desc.position = { position(random), position(random) };
+    desc.velocity = { speed(random), speed(random) };
+    desc.team     = static_cast<std::uint8_t>(random() % 2u);
+
+    return desc;
+}
+
+// -------------------------------------------------------------------
+template<typename Tick_function>
+void run(char const* const name, Tick_function&& tick) {
+
+    std::vector<double> samples;
+    samples.reserve(TICK_COUNT);
+
+    for (int i = 0; i < WARMUP_COUNT + TICK_COUNT; ++i) {
+
+        auto const begin = Bench_clock::now();
+
+        tick();
+
+        if (i >= WARMUP_COUNT) {
+
+            samples.push_back(elapsed_ns(begin, Bench_clock::now()));
+        }
+    }
+
+    double const p50 = percentile(samples, 50.0);
+    double const p99 = percentile(samples, 99.0);
+
+    std::printf("%-13s %zu projectiles   p50 %8.1f us/tick (%5.2f ns each, %5.2f %% of a tick)   p99 %8.1f us/tick\n",
+                name, PROJECTILE_COUNT, p50 / 1000.0, p50 / static_cast<double>(PROJECTILE_COUNT),
+                p50 / (1'000'000'000.0 / 60.0) * 100.0, p99 / 1000.0);
+}
+
+// ===================================================================
+// Object per projectile
+// -------------------------------------------------------------------
+
+class Game_object {
+
+public:
+    virtual ~Game_object() = default;
+
+    // False once it has left the map.
+    virtual bool update(float const dt) = 0;
+};
+
+class Projectile final : public Game_object {
+
+public:
+    explicit Projectile(game::Entity_desc const& desc)
+        : m_position(desc.position)
+        , m_velocity(desc.velocity)
+        , m_heading (desc.heading)
+        , m_health  (desc.health)
+        , m_team    (desc.team)
+    {
+
+    }
+
+    bool update(float const dt) override {
+
+        m_position += m_velocity * dt;
+        return MAP_BOUNDS.contains(m_position);
+    }
+
+    // Same fields as an Entity_store entity
+    sf::Vector2f m_position;
+    sf::Vector2f m_velocity;
+    float        m_heading;
+    float        m_health;
+    std::uint8_t m_team;
+};
+
+// -------------------------------------------------------------------
+void run_objects() {
+
+    std::mt19937 random(1u);
+
+    std::vector<std::unique_ptr<Game_object>> objects;
+
+    for (std::size_t i = 0u; i < PROJECTILE_COUNT; ++i) {
+
+        objects.push_back(std::make_unique<Projectile>(random_projectile(random)));
+    }
+
+    // Spawned over a game, not all at once, so they aren't neighbours in memory
+    std::shuffle(objects.begin(), objects.end(), random);
+
+    run("objects", [&] {
+
+        for (auto& object : objects) {
+
+            if (!object->update(DT)) {
+
+                object = std::make_unique<Projectile>(random_projectile(random));
+            }
+        }
+    });
+}
+
+// -------------------------------------------------------------------
+void run_soa_loop() {
+
+    std::mt19937 random(1u);
+
+    game::Entity_store store;
+    store.reserve(PROJECTILE_COUNT);
+
+    for (std::size_t i = 0u; i < PROJECTILE_COUNT; ++i) {
+
+        store.create(random_projectile(random));
+    }
+
+    run("SoA loop", [&] {
+
+        game::Entity_arrays const arrays = store.get_arrays();
+
+        for (std::size_t i = 0u; i < arrays.position_x.size(); ++i) {
+
+            arrays.position_x[i] += arrays.velocity_x[i] * DT;
+            arrays.position_y[i] += arrays.velocity_y[i] * DT;
+        }
+
+        std::size_t const destroyed = store.destroy_outside(MAP_BOUNDS);
+
+        for (std::size_t i = 0u; i < destroyed; ++i) {
+
+            store.create(random_projectile(random));
+        }
+    });
+}
+
+// -------------------------------------------------------------------
+void run_entity_store() {
+
+    std::mt19937 random(1u);
+
+    game::Entity_store store;
+    store.reserve(PROJECTILE_COUNT);
+
+    for (std::size_t i = 0u; i < PROJECTILE_COUNT; ++i) {
+
+        store.create(random_projectile(random));
+    }
+
+    run("Entity_store", [&] {
+
+        store.integrate(DT);
+
+        std::size_t const destroyed = store.destroy_outside(MAP_BOUNDS);
+
+        for (std::size_t i = 0u; i < destroyed; ++i) {
+
+            store.create(random_projectile(random));
+        }
+    });
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    std::printf("Entity_store kernels: %s\n", SIMD_COMPILED_IN ? "SSE2" : "scalar");
+
+    run_objects();
+    run_soa_loop();
+    run_entity_store();
+
+    return 0;
+}
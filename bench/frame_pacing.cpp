@@ -0,0 +1,130 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "utils/frame_pacer.h"
+#include "utils/logger.h"
+
+#include <cstdio>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// Runs the same frame (a few ms of busy "update" plus a few hundred
+// rectangles drawn) in a real window under each Frame_pacing mode, and
+// prints the frame interval and its jitter, the input to present
+// latency for input arriving at any moment and the CPU the process
+// burned, so vsync, frame limit and adaptive pacing can be compared on
+// one machine. Needs a display, vsync is up to the driver.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr int          WARMUP_FRAMES = 60;
+constexpr int          FRAME_COUNT   = 600;
+constexpr double       UPDATE_MS     = 3.0;
+constexpr std::size_t  SHAPE_COUNT   = 500u;
+constexpr unsigned int TARGET_RATE   = 60u;
+constexpr auto         WINDOW_SIZE   = sf::Vector2u(640u, 360u);
+
+// -------------------------------------------------------------------
+// Stands in for game logic, keeps a core busy for UPDATE_MS.
+void busy_update() {
+
+    auto const begin = Bench_clock::now();
+
+    while (elapsed_ns(begin, Bench_clock::now()) < UPDATE_MS * 1'000'000.0) {}
+}
+
+// -------------------------------------------------------------------
+void run(sf::RenderWindow& window, utils::Frame_pacer& pacer, utils::Frame_pacing const mode, std::vector<sf::RectangleShape> const& shapes) {
+
+    pacer.set_mode(mode);
+
+    double cpu_begin  = 0.0;
+    auto   wall_begin = Bench_clock::now();
+
+    for (int frame = 0; frame < WARMUP_FRAMES + FRAME_COUNT && window.isOpen(); ++frame) {
+
+        if (frame == WARMUP_FRAMES) {
+
+            pacer.reset_stats();
+
+            cpu_begin  = process_cpu_seconds();
+            wall_begin = Bench_clock::now();
+        }
+
+        pacer.wait_for_input();
+
+        while (std::optional<sf::Event> const event = pacer.poll_event()) {
+
+            if (event->is<sf::Event::Closed>()) {
+
+                window.close();
+            }
+        }
+
+        busy_update();
+
+        window.clear(sf::Color(30, 30, 30));
+
+        for (sf::RectangleShape const& shape : shapes) {
+
+            window.draw(shape);
+        }
+
+        window.display();
+        pacer.frame_presented();
+    }
+
+    double const wall_seconds = elapsed_ns(wall_begin, Bench_clock::now()) / 1'000'000'000.0;
+    double const cpu_percent  = (process_cpu_seconds() - cpu_begin) / wall_seconds * 100.0;
+
+    utils::Frame_pacing_stats const stats = pacer.get_stats();
+
+    std::printf("%-12s interval %6.2f ms  jitter %5.2f ms  p99 %6.2f ms   input to present %6.2f ms  p99 %6.2f ms   cpu %5.1f%%   asleep %5.2f ms  spinning %4.2f ms\n",
+                utils::Frame_pacer::to_string(mode),
+                stats.interval_mean_ms, stats.interval_jitter_ms, stats.interval_p99_ms,
+                stats.latency_mean_ms, stats.latency_p99_ms,
+                cpu_percent, stats.sleep_mean_ms, stats.spin_mean_ms);
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    sf::RenderWindow window(sf::VideoMode(WINDOW_SIZE), "Frame pacing bench");
+
+    std::vector<sf::RectangleShape> shapes(SHAPE_COUNT, sf::RectangleShape({ 12.0f, 12.0f }));
+
+    for (std::size_t i = 0u; i < shapes.size(); ++i) {
+
+        shapes[i].setPosition({ static_cast<float>(i * 37u % WINDOW_SIZE.x), static_cast<float>(i * 61u % WINDOW_SIZE.y) });
+    }
+
+    utils::Frame_pacer pacer(window, { .mode = utils::Frame_pacing::Uncapped, .target_rate = TARGET_RATE });
+
+    std::printf("%d frames per mode, %.1f ms update, target %u Hz for frame limit and adaptive\n", FRAME_COUNT, UPDATE_MS, TARGET_RATE);
+
+    run(window, pacer, utils::Frame_pacing::Uncapped,    shapes);
+    run(window, pacer, utils::Frame_pacing::Vsync,       shapes);
+    run(window, pacer, utils::Frame_pacing::Frame_limit, shapes);
+    run(window, pacer, utils::Frame_pacing::Adaptive,    shapes);
+
+    return 0;
+}
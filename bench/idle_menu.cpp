@@ -0,0 +1,121 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "utils/logger.h"
+#include "utils/render_scheduler.h"
+#include "widget/label.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// CPU use and loop wake ups of an idle menu screen (a few labels, no
+// input) with the old always-draw loop against the render-on-change one.
+// Opens a visible window, don't touch it while it runs. Run from the
+// build's bin/ folder so the assets are found.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr auto RUN_TIME   = std::chrono::seconds(5);
+constexpr int  MENU_ITEMS = 6;
+
+// -------------------------------------------------------------------
+void run(char const* const name, sf::RenderWindow& window, std::vector<std::unique_ptr<widget::Label>>& labels, bool const is_idle_enabled) {
+
+    utils::Render_scheduler scheduler;
+    scheduler.set_idle_enabled(is_idle_enabled);
+
+    // Start from a changed scene like a freshly opened menu
+    scheduler.request_redraw();
+
+    std::uint64_t iterations = 0u;
+
+    double const cpu_begin = process_cpu_seconds();
+    auto const   begin     = Bench_clock::now();
+
+    while (Bench_clock::now() - begin < RUN_TIME) {
+
+        ++iterations;
+
+        if (!scheduler.needs_frame(widget::Widget::get_scene_revision())) {
+
+            (void)scheduler.wait_event(window);
+        }
+
+        while (std::optional<sf::Event> const event = window.pollEvent()) {}
+
+        if (!scheduler.needs_frame(widget::Widget::get_scene_revision())) {
+
+            continue;
+        }
+
+        window.clear(sf::Color::White);
+
+        for (auto& label : labels) {
+
+            label->draw();
+        }
+
+        window.display();
+
+        scheduler.frame_drawn(widget::Widget::get_scene_revision());
+    }
+
+    double const seconds     = elapsed_ns(begin, Bench_clock::now()) / 1'000'000'000.0;
+    double const cpu_seconds = process_cpu_seconds() - cpu_begin;
+
+    utils::Render_scheduler::Stats const stats = scheduler.get_stats();
+
+    std::printf("%-12s CPU %6.1f %%   %10.1f wake ups/s   %10.1f frames/s   %6llu idle waits\n",
+                name,
+                cpu_seconds / seconds * 100.0,
+                static_cast<double>(iterations) / seconds,
+                static_cast<double>(stats.frames_drawn) / seconds,
+                static_cast<unsigned long long>(stats.idle_waits));
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    sf::RenderWindow window(sf::VideoMode({ 800u, 600u }), "bench_idle_menu");
+    window.setVerticalSyncEnabled(false);
+
+    std::vector<std::unique_ptr<widget::Label>> labels;
+
+    for (int i = 0; i < MENU_ITEMS; ++i) {
+
+        auto label = std::make_unique<widget::Label>(&window, "Menu item " + std::to_string(i + 1));
+        label->set_pos({ 300.0f, 150.0f + static_cast<float>(i) * 50.0f });
+        label->set_text_color(sf::Color::Black);
+
+        labels.push_back(std::move(label));
+    }
+
+    run("always draw", window, labels, false);
+    run("idle",        window, labels, true);
+
+    return 0;
+}
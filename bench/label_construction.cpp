@@ -0,0 +1,101 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "utils/defs.h"
+#include "utils/logger.h"
+#include "widget/label.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// Construction time and resident memory of 1,000 labels, with one font
+// per label (what Label used to do) against the shared font cache.
+// Run from the build's bin/ folder so the assets are found.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr int LABEL_COUNT = 1'000;
+
+// What every Label owned before the cache, a font loaded from disk and a text using it.
+struct Font_per_label {
+
+    sf::Font font;
+    sf::Text text;
+
+    explicit Font_per_label(std::string const& string)
+        : font(utils::DEFAULT_TEXT_FONT)
+        , text(font, string)
+    {}
+};
+
+// -------------------------------------------------------------------
+void report(char const* const name, Bench_clock::time_point const begin, Bench_clock::time_point const end, std::size_t const rss_before) {
+
+    double const      total_ms = elapsed_ns(begin, end) / 1'000'000.0;
+    std::size_t const rss      = resident_bytes();
+    double const      rss_kib  = (rss > rss_before) ? static_cast<double>(rss - rss_before) / 1024.0 : 0.0;
+
+    std::printf("%-16s %6d labels   %9.2f ms   %7.2f us/label   RSS +%9.1f KiB\n",
+                name, LABEL_COUNT, total_ms, total_ms * 1000.0 / LABEL_COUNT, rss_kib);
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    // Before: one font per label.
+    {
+        std::vector<std::unique_ptr<Font_per_label>> labels;
+        labels.reserve(LABEL_COUNT);
+
+        std::size_t const rss_before = resident_bytes();
+        auto const        begin      = Bench_clock::now();
+
+        for (int i = 0; i < LABEL_COUNT; ++i) {
+
+            labels.push_back(std::make_unique<Font_per_label>("Label " + std::to_string(i)));
+        }
+
+        report("font per label", begin, Bench_clock::now(), rss_before);
+    }
+
+    // After: Label with the shared font cache.
+    {
+        std::vector<std::unique_ptr<widget::Label>> labels;
+        labels.reserve(LABEL_COUNT);
+
+        std::size_t const rss_before = resident_bytes();
+        auto const        begin      = Bench_clock::now();
+
+        for (int i = 0; i < LABEL_COUNT; ++i) {
+
+            labels.push_back(std::make_unique<widget::Label>(nullptr, "Label " + std::to_string(i)));
+        }
+
+        report("shared font", begin, Bench_clock::now(), rss_before);
+        std::printf("%-16s %zu font(s) loaded\n", "", utils::fonts().size());
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "utils/logger.h"
+#include "widget/label.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// Per frame cost of drawing 1,000 labels that never change, against the
+// same labels dirtied every frame (what every draw used to cost). Draws
+// into a hidden window and finishes the GL work each frame so the numbers
+// include the driver, run from the build's bin/ folder.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr int LABEL_COUNT  = 1'000;
+constexpr int WARMUP_COUNT = 20;
+constexpr int FRAME_COUNT  = 500;
+
+// -------------------------------------------------------------------
+void run(char const* const name, sf::RenderWindow& window, std::vector<std::unique_ptr<widget::Label>>& labels, bool const is_dirtied) {
+
+    std::vector<double> samples;
+    samples.reserve(FRAME_COUNT);
+
+    for (int frame = 0; frame < WARMUP_COUNT + FRAME_COUNT; ++frame) {
+
+        auto const begin = Bench_clock::now();
+
+        window.clear();
+
+        for (auto& label : labels) {
+
+            if (is_dirtied) {
+
+                label->move({});
+            }
+
+            label->draw();
+        }
+
+        window.display();
+
+        if (frame >= WARMUP_COUNT) {
+
+            samples.push_back(elapsed_ns(begin, Bench_clock::now()) / 1000.0);
+        }
+    }
+
+    double const p50 = percentile(samples, 50.0);
+    double const p99 = percentile(samples, 99.0);
+
+    std::printf("%-16s %6d labels   p50 %9.1f us/frame   p99 %9.1f us/frame\n", name, LABEL_COUNT, p50, p99);
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    sf::RenderWindow window(sf::VideoMode({ 1280u, 720u }), "bench_label_draw");
+    window.setVisible(false);
+    window.setVerticalSyncEnabled(false);
+
+    std::vector<std::unique_ptr<widget::Label>> labels;
+    labels.reserve(LABEL_COUNT);
+
+    for (int i = 0; i < LABEL_COUNT; ++i) {
+
+        auto label = std::make_unique<widget::Label>(&window, "Label " + std::to_string(i));
+        label->set_pos({ static_cast<float>(i % 20) * 64.0f, static_cast<float>(i / 20) * 14.0f });
+        label->set_character_size(12u);
+        label->set_margins(2.0f, 2.0f, 4.0f, 4.0f);
+
+        labels.push_back(std::move(label));
+    }
+
+    run("static",        window, labels, false);
+    run("dirty / frame", window, labels, true);
+
+    return 0;
+}
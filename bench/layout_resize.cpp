@@ -0,0 +1,220 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "utils/logger.h"
+#include "widget/batch_renderer.h"
+#include "widget/label.h"
+#include "widget/layout.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// A 5,000 label UI in nested layouts: a header row, a sidebar column and
+// a grid of 99 rows of 50 flexed labels. Times the layout update alone
+// and with the batched draw (labels lay themselves out when drawn) for
+// a window resize every frame, one label's text changing every frame
+// and nothing changing. Fails (exit 1) when a resize frame's p99 goes
+// over FRAME_BUDGET_MS, so it can gate changes to the layout code.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr std::size_t HEADER_COUNT    = 10u;
+constexpr std::size_t SIDEBAR_COUNT   = 40u;
+constexpr std::size_t GRID_ROWS       = 99u;
+constexpr std::size_t GRID_COLUMNS    = 50u;
+constexpr int         WARMUP_COUNT    = 10;
+constexpr int         FRAME_COUNT     = 200;
+constexpr double      FRAME_BUDGET_MS = 1000.0 / 60.0;
+constexpr auto        WINDOW_SIZE     = sf::Vector2f(1920.0f, 1080.0f);
+
+// ===================================================================
+// Test UI
+// -------------------------------------------------------------------
+
+struct Ui {
+
+    std::vector<std::unique_ptr<widget::Label>>  labels;
+    std::vector<std::unique_ptr<widget::Layout>> layouts;
+
+    widget::Layout* root = nullptr;
+};
+
+// -------------------------------------------------------------------
+widget::Layout& make_layout(Ui& ui, widget::Layout_direction const direction) {
+
+    ui.layouts.push_back(std::make_unique<widget::Layout>(nullptr, direction));
+    ui.layouts.back()->set_spacing(2.0f);
+
+    return *ui.layouts.back();
+}
+
+// -------------------------------------------------------------------
+widget::Label& make_label(Ui& ui, sf::RenderTarget& target, std::size_t const index) {
+
+    ui.labels.push_back(std::make_unique<widget::Label>(&target, "Item " + std::to_string(index)));
+    ui.labels.back()->set_character_size(10u);
+    ui.labels.back()->set_margins(1.0f, 1.0f, 2.0f, 2.0f);
+
+    return *ui.labels.back();
+}
+
+// -------------------------------------------------------------------
+// Built bottom up, a layout goes into its parent once its own children are in.
+Ui make_ui(sf::RenderTarget& target) {
+
+    using utils::Alignment;
+
+    Ui ui;
+
+    ui.layouts.reserve(GRID_ROWS + 8u);
+    ui.labels .reserve(HEADER_COUNT + SIDEBAR_COUNT + GRID_ROWS * GRID_COLUMNS);
+
+    widget::Layout& root    = make_layout(ui, widget::Layout_direction::Column);
+    widget::Layout& header  = make_layout(ui, widget::Layout_direction::Row);
+    widget::Layout& body    = make_layout(ui, widget::Layout_direction::Row);
+    widget::Layout& sidebar = make_layout(ui, widget::Layout_direction::Column);
+    widget::Layout& grid    = make_layout(ui, widget::Layout_direction::Column);
+
+    root.set_padding({ 8.0f, 8.0f, 8.0f, 8.0f });
+
+    for (std::size_t i = 0u; i < HEADER_COUNT; ++i) {
+
+        header.add(make_label(ui, target, ui.labels.size()), { Alignment::Center, Alignment::Center, 1.0f, {} });
+    }
+
+    for (std::size_t i = 0u; i < SIDEBAR_COUNT; ++i) {
+
+        sidebar.add(make_label(ui, target, ui.labels.size()));
+    }
+
+    for (std::size_t row = 0u; row < GRID_ROWS; ++row) {
+
+        widget::Layout& grid_row = make_layout(ui, widget::Layout_direction::Row);
+
+        for (std::size_t column = 0u; column < GRID_COLUMNS; ++column) {
+
+            grid_row.add(make_label(ui, target, ui.labels.size()), { Alignment::Right, Alignment::Center, 1.0f, {} });
+        }
+
+        grid.add(grid_row, { Alignment::Left, Alignment::Top, 1.0f, {} });
+    }
+
+    body.add(sidebar);
+    body.add(grid, { Alignment::Left, Alignment::Top, 1.0f, {} });
+
+    root.add(header);
+    root.add(body, { Alignment::Left, Alignment::Top, 1.0f, {} });
+    root.set_size(WINDOW_SIZE);
+
+    ui.root = &root;
+
+    return ui;
+}
+
+// -------------------------------------------------------------------
+// Returns the p99 of the full frame, in milliseconds.
+template<typename Change_function>
+double run(char const* const name, Ui& ui, Change_function&& change_function) {
+
+    widget::Batch_renderer batch;
+
+    std::vector<double> update_samples;
+    std::vector<double> frame_samples;
+
+    update_samples.reserve(FRAME_COUNT);
+    frame_samples .reserve(FRAME_COUNT);
+
+    for (int frame = 0; frame < WARMUP_COUNT + FRAME_COUNT; ++frame) {
+
+        auto const begin = Bench_clock::now();
+
+        change_function(frame);
+        ui.root->update();
+
+        auto const updated = Bench_clock::now();
+
+        batch.clear();
+        ui.root->draw(batch);
+
+        auto const end = Bench_clock::now();
+
+        if (frame >= WARMUP_COUNT) {
+
+            update_samples.push_back(elapsed_ns(begin, updated) / 1'000'000.0);
+            frame_samples .push_back(elapsed_ns(begin, end)     / 1'000'000.0);
+        }
+    }
+
+    double const frame_p99 = percentile(frame_samples, 99.0);
+
+    std::printf("%-20s layout p50 %7.3f ms  p99 %7.3f ms   layout + batch p50 %7.3f ms  p99 %7.3f ms\n",
+                name, percentile(update_samples, 50.0), percentile(update_samples, 99.0), percentile(frame_samples, 50.0), frame_p99);
+
+    return frame_p99;
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    // Labels need a GL context for their glyphs, nothing is drawn to it
+    sf::RenderTexture target;
+
+    if (!target.resize({ 16u, 16u })) {
+
+        std::fprintf(stderr, "Unable to create a render texture\n");
+        return 1;
+    }
+
+    auto const build_begin = Bench_clock::now();
+
+    Ui ui = make_ui(target);
+    ui.root->update();
+
+    std::printf("%zu labels in %zu layouts, first layout %.2f ms\n",
+                ui.labels.size(), ui.layouts.size(), elapsed_ns(build_begin, Bench_clock::now()) / 1'000'000.0);
+
+    double const resize_p99 = run("window resize", ui, [&](int const frame) {
+
+        // Drag the window corner back and forth
+        float const step = static_cast<float>(frame % 40) * 4.0f;
+        ui.root->set_size({ WINDOW_SIZE.x - step, WINDOW_SIZE.y - step * 0.5f });
+    });
+
+    run("one label's text", ui, [&](int const frame) {
+
+        ui.labels[HEADER_COUNT + SIDEBAR_COUNT + static_cast<std::size_t>(frame) * 37u % (GRID_ROWS * GRID_COLUMNS)]->set_integer(frame * 1'000'003);
+    });
+
+    run("nothing changed", ui, [](int const) {});
+
+    if (resize_p99 > FRAME_BUDGET_MS) {
+
+        std::printf("FAIL resize p99 %.3f ms is over the %.3f ms frame budget\n", resize_p99, FRAME_BUDGET_MS);
+        return 1;
+    }
+
+    std::printf("OK resize p99 %.3f ms is within the %.3f ms frame budget\n", resize_p99, FRAME_BUDGET_MS);
+    return 0;
+}
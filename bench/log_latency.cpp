@@ -0,0 +1,90 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "utils/log_async.h"
+#include "utils/logger.h"
+
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::ALL_LOG_LVLS;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// Measures how long a single LOG(...) statement blocks the calling thread.
+// The log output itself goes to stdout, results go to stderr, so run with:
+//     bench_log_latency > /dev/null     (or > NUL on Windows)
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr int RECORD_COUNT = 20'000;
+constexpr int WARMUP_COUNT = 1'000;
+
+// -------------------------------------------------------------------
+std::vector<double> run_logs(int const count) {
+
+    std::vector<double> samples;
+    samples.reserve(static_cast<std::size_t>(count));
+
+    for (int i = 0; i < count; ++i) {
+
+        auto const begin = Bench_clock::now();
+        LOG(Log_lvl::TRACE) << "Label state change: Hidden " << i;
+        auto const end   = Bench_clock::now();
+
+        samples.push_back(elapsed_ns(begin, end));
+    }
+
+    return samples;
+}
+
+// -------------------------------------------------------------------
+void report(char const* const name, std::vector<double> samples) {
+
+    double const p50 = percentile(samples, 50.0);
+    double const p99 = percentile(samples, 99.0);
+    double const max = percentile(samples, 100.0);
+
+    std::fprintf(stderr, "%-22s p50 %10.0f ns   p99 %10.0f ns   max %12.0f ns\n", name, p50, p99, max);
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    // Synchronous path: mutex, console write and flush per record.
+    run_logs(WARMUP_COUNT);
+    report("sync", run_logs(RECORD_COUNT));
+
+    // Async, drop policy: the ring is sized so nothing should be dropped.
+    Log_async::start({ .ring_capacity = 32'768u, .overflow_policy = Log_overflow_policy::Drop });
+    run_logs(WARMUP_COUNT);
+    Log_async::flush();
+    report("async (drop)", run_logs(RECORD_COUNT));
+    Log_async::flush();
+    std::fprintf(stderr, "%-22s %llu record(s) dropped\n", "", static_cast<unsigned long long>(Log_async::get_dropped_count()));
+    Log_async::stop();
+
+    // Async, block policy with a small ring so the producer has to wait sometimes.
+    Log_async::start({ .ring_capacity = 256u, .overflow_policy = Log_overflow_policy::Block });
+    run_logs(WARMUP_COUNT);
+    Log_async::flush();
+    report("async (block, 256)", run_logs(RECORD_COUNT));
+    Log_async::stop();
+
+    return 0;
+}
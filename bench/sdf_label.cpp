@@ -0,0 +1,176 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "utils/defs.h"
+#include "utils/logger.h"
+#include "utils/resource_cache.h"
+#include "widget/batch_renderer.h"
+#include "widget/label.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// Labels at every character size from 8 to 72, drawn batched into an
+// offscreen render texture with the regular font and with the baked SDF
+// font. The first frame is the hitch of rasterising every size, the
+// steady frames the cost once everything is cached, and the texture
+// memory is every font page against the one atlas. Run from the build's
+// bin/ folder, after the Tiny_Tanks_sdf_fonts target baked the atlas.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr unsigned MIN_SIZE     = 8u;
+constexpr unsigned MAX_SIZE     = 72u;
+constexpr int      FRAME_COUNT  = 300;
+constexpr auto     TARGET_SIZE  = sf::Vector2u(1920u, 1080u);
+
+using Labels = std::vector<std::unique_ptr<widget::Label>>;
+
+// -------------------------------------------------------------------
+// The regular run rasterises every size, the SDF run only takes the white square of each page for backgrounds.
+Labels make_labels(sf::RenderTarget& target, utils::Font_handle const& font, utils::Sdf_font_handle const& sdf_font) {
+
+    Labels labels;
+
+    float y = 0.0f;
+
+    // Four labels per row, each row as tall as its last (largest) label
+    for (unsigned size = MIN_SIZE; size <= MAX_SIZE; ++size) {
+
+        auto label = std::make_unique<widget::Label>(&target, "The quick brown fox " + std::to_string(size));
+        label->set_font(font);
+        label->set_sdf_font(sdf_font);
+        label->set_character_size(size);
+        label->set_text_outline_thickness(1.0f);
+        label->set_pos({ static_cast<float>(size % 4u) * 480.0f, y });
+
+        if (size % 4u == 3u) {
+
+            y += static_cast<float>(size);
+        }
+
+        labels.push_back(std::move(label));
+    }
+
+    return labels;
+}
+
+// -------------------------------------------------------------------
+std::size_t get_texture_bytes(sf::Texture const& texture) {
+
+    return static_cast<std::size_t>(texture.getSize().x) * texture.getSize().y * 4u;
+}
+
+// -------------------------------------------------------------------
+void run(char const* const name, sf::RenderTexture& target, Labels& labels, std::size_t const texture_bytes_before) {
+
+    widget::Batch_renderer batch;
+
+    std::vector<double> samples;
+    samples.reserve(FRAME_COUNT);
+
+    double first_frame = 0.0;
+
+    for (int frame = 0; frame <= FRAME_COUNT; ++frame) {
+
+        auto const begin = Bench_clock::now();
+
+        batch.clear();
+
+        for (auto& label : labels) {
+
+            label->draw(batch);
+        }
+
+        target.clear();
+        batch.draw(target);
+        target.display();
+
+        double const frame_us = elapsed_ns(begin, Bench_clock::now()) / 1000.0;
+
+        if (frame == 0) {
+
+            first_frame = frame_us;
+
+        } else {
+
+            samples.push_back(frame_us);
+        }
+    }
+
+    std::size_t texture_bytes = texture_bytes_before;
+
+    for (auto const& label : labels) {
+
+        if (label->get_sdf_font() == nullptr) {
+
+            texture_bytes += get_texture_bytes(label->get_font()->getTexture(label->get_character_size()));
+        }
+    }
+
+    std::printf("%-8s first frame %9.1f us   steady p50 %8.1f us   p99 %8.1f us   font textures %6.1f KiB\n",
+                name, first_frame, percentile(samples, 50.0), percentile(samples, 99.0), static_cast<double>(texture_bytes) / 1024.0);
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    sf::RenderTexture target;
+
+    if (!target.resize(TARGET_SIZE)) {
+
+        std::fprintf(stderr, "Unable to create a %ux%u render texture\n", TARGET_SIZE.x, TARGET_SIZE.y);
+        return 1;
+    }
+
+    std::string const font_path(utils::DEFAULT_TEXT_FONT);
+    std::string const sdf_path (utils::DEFAULT_SDF_FONT);
+
+    auto font = std::make_shared<sf::Font>();
+
+    if (!utils::load_resource(*font, font_path)) {
+
+        std::fprintf(stderr, "Unable to load %s\n", font_path.c_str());
+        return 1;
+    }
+
+    auto sdf_font = std::make_shared<utils::Sdf_font>();
+
+    if (!sdf_font->load(sdf_path)) {
+
+        std::fprintf(stderr, "Unable to load %s, build the Tiny_Tanks_sdf_fonts target first\n", sdf_path.c_str());
+        return 1;
+    }
+
+    std::printf("%u labels, character sizes %u to %u\n", MAX_SIZE - MIN_SIZE + 1u, MIN_SIZE, MAX_SIZE);
+
+    Labels regular_labels = make_labels(target, font, nullptr);
+    run("regular", target, regular_labels, 0u);
+
+    Labels sdf_labels = make_labels(target, font, sdf_font);
+    run("sdf", target, sdf_labels, get_texture_bytes(sdf_font->get_texture()));
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "game/simulation.h"
+#include "utils/logger.h"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// A 60 Hz Simulation of TANK_COUNT driving tanks, read by a stand in
+// render loop (interpolate only, no drawing) paced at 60, 144 and 240
+// Hz. Prints the ticks the simulation ran per second and its step time,
+// which should not move with the render rate, and the render side's
+// interpolate cost and frame interval, which should not move with the
+// simulation's step time.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr std::size_t TANK_COUNT      = 100'000u;
+constexpr double      SECONDS_PER_RUN = 3.0;
+
+// -------------------------------------------------------------------
+game::World make_world() {
+
+    game::World world;
+
+    for (std::size_t i = 0u; i < TANK_COUNT; ++i) {
+
+        world.add_tank({ static_cast<float>(i % 1000u), static_cast<float>(i / 1000u) }, static_cast<float>(i % 360u));
+    }
+
+    return world;
+}
+
+// -------------------------------------------------------------------
+void run(unsigned int const render_rate) {
+
+    game::Simulation simulation(make_world());
+
+    for (std::size_t i = 0u; i < TANK_COUNT; ++i) {
+
+        simulation.push_command({ i, 1.0f, (i % 2u == 0u) ? 0.5f : -0.5f });
+    }
+
+    simulation.start();
+
+    std::vector<game::Tank_state> tanks;
+    tanks.reserve(TANK_COUNT);
+
+    std::vector<double> interpolate_samples;
+    std::vector<double> interval_samples;
+
+    auto const frame_duration = std::chrono::duration_cast<Bench_clock::duration>(std::chrono::duration<double>(1.0 / render_rate));
+    auto const begin          = Bench_clock::now();
+    auto       frame_time     = begin;
+    auto       last_frame     = begin;
+
+    while (elapsed_ns(begin, Bench_clock::now()) < SECONDS_PER_RUN * 1'000'000'000.0) {
+
+        frame_time += frame_duration;
+        std::this_thread::sleep_until(frame_time);
+
+        auto const frame_begin = Bench_clock::now();
+
+        simulation.interpolate(frame_begin, tanks);
+
+        auto const frame_end = Bench_clock::now();
+
+        interpolate_samples.push_back(elapsed_ns(frame_begin, frame_end) / 1000.0);
+        interval_samples   .push_back(elapsed_ns(last_frame,  frame_begin) / 1'000'000.0);
+
+        last_frame = frame_begin;
+    }
+
+    game::Simulation_stats const stats = simulation.get_stats();
+    simulation.stop();
+
+    std::printf("render %3u Hz: %5zu frames, interval p50 %6.2f ms p99 %6.2f ms, interpolate p50 %7.1f us p99 %7.1f us"
+                "   sim %5.1f ticks/s, step last %6.3f ms max %6.3f ms, %llu dropped\n",
+                render_rate, interval_samples.size(), percentile(interval_samples, 50.0), percentile(interval_samples, 99.0),
+                percentile(interpolate_samples, 50.0), percentile(interpolate_samples, 99.0),
+                static_cast<double>(stats.ticks) / SECONDS_PER_RUN, stats.step_last_ms, stats.step_max_ms,
+                static_cast<unsigned long long>(stats.dropped_ticks));
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    std::printf("%zu tanks, 60 Hz simulation\n", TANK_COUNT);
+
+    run(60u);
+    run(144u);
+    run(240u);
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "utils/logger.h"
+#include "widget/batch_renderer.h"
+#include "widget/text_edit.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// A Text_edit holding 100,000 lines (a long console / chat log). Times
+// typing in the middle of it, splitting lines with Enter, appending log
+// lines while following the end, and scrolling a line, a page or to a
+// random line per frame. Each sample is the edit plus the batched draw
+// into an offscreen render texture, all of which should depend on the
+// lines on screen only, not on the size of the buffer.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr std::size_t LINE_COUNT   = 100'000u;
+constexpr int         WARMUP_COUNT = 20;
+constexpr int         SAMPLE_COUNT = 1'000;
+constexpr auto        TARGET_SIZE  = sf::Vector2u(1280u, 720u);
+
+// -------------------------------------------------------------------
+std::string make_line(std::size_t const index) {
+
+    return "[" + std::to_string(index) + "] player_" + std::to_string(index % 97u) + ": the quick brown fox jumps over the lazy dog\n";
+}
+
+// -------------------------------------------------------------------
+template<typename Step_function>
+void run(char const* const name, sf::RenderTexture& target, widget::Text_edit& text_edit, Step_function&& step_function) {
+
+    widget::Batch_renderer batch;
+
+    std::vector<double> samples;
+    samples.reserve(SAMPLE_COUNT);
+
+    for (int i = 0; i < WARMUP_COUNT + SAMPLE_COUNT; ++i) {
+
+        auto const begin = Bench_clock::now();
+
+        step_function(i);
+
+        batch.clear();
+        text_edit.draw(batch);
+
+        target.clear();
+        batch.draw(target);
+        target.display();
+
+        if (i >= WARMUP_COUNT) {
+
+            samples.push_back(elapsed_ns(begin, Bench_clock::now()) / 1000.0);
+        }
+    }
+
+    std::printf("%-26s p50 %8.1f us   p99 %8.1f us   max %8.1f us   (%zu lines)\n",
+                name, percentile(samples, 50.0), percentile(samples, 99.0), percentile(samples, 100.0), text_edit.get_line_count());
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    sf::RenderTexture target;
+
+    if (!target.resize(TARGET_SIZE)) {
+
+        std::fprintf(stderr, "Unable to create a %ux%u render texture\n", TARGET_SIZE.x, TARGET_SIZE.y);
+        return 1;
+    }
+
+    widget::Text_edit text_edit(&target);
+    text_edit.set_size(sf::Vector2f(TARGET_SIZE));
+    text_edit.set_background_color(sf::Color(20, 20, 20));
+    text_edit.set_text_color(sf::Color(220, 220, 220));
+
+    // Filling, one append per line like a log
+    {
+        auto const begin = Bench_clock::now();
+
+        for (std::size_t i = 0u; i < LINE_COUNT; ++i) {
+
+            text_edit.append(make_line(i));
+        }
+
+        double const total_ms = elapsed_ns(begin, Bench_clock::now()) / 1'000'000.0;
+
+        std::printf("append %zu lines: %.1f ms (%.1f ns per line), %zu lines on screen\n",
+                    LINE_COUNT, total_ms, total_ms * 1'000'000.0 / static_cast<double>(LINE_COUNT), text_edit.get_visible_line_count());
+    }
+
+    std::mt19937 random(42u);
+
+    // A few characters into the middle line
+    std::size_t middle = 5u;
+
+    for (std::size_t i = 0u; i < LINE_COUNT / 2u; ++i) {
+
+        middle += make_line(i).size();
+    }
+
+    text_edit.set_cursor(middle);
+
+    run("type in the middle", target, text_edit, [&](int const) {
+
+        text_edit.insert("x");
+    });
+
+    run("backspace in the middle", target, text_edit, [&](int const) {
+
+        text_edit.erase_backward();
+    });
+
+    run("enter in the middle", target, text_edit, [&](int const) {
+
+        text_edit.insert("\n");
+    });
+
+    text_edit.scroll_to_line(text_edit.get_line_count());
+
+    run("append, following the end", target, text_edit, [&](int const i) {
+
+        text_edit.append(make_line(LINE_COUNT + static_cast<std::size_t>(i)));
+    });
+
+    text_edit.scroll_to_line(0u);
+
+    run("scroll one line", target, text_edit, [&](int const) {
+
+        text_edit.scroll(1);
+    });
+
+    run("scroll one page", target, text_edit, [&](int const) {
+
+        text_edit.scroll(static_cast<std::ptrdiff_t>(text_edit.get_visible_line_count()));
+    });
+
+    run("jump to a random line", target, text_edit, [&](int const) {
+
+        text_edit.scroll_to_line(std::uniform_int_distribution<std::size_t>(0u, text_edit.get_line_count() - 1u)(random));
+    });
+
+    run("unchanged frame", target, text_edit, [&](int const) {});
+
+    return 0;
+}
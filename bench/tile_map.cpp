@@ -0,0 +1,325 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "game/tile_map.h"
+#include "utils/logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// A MAP_SIZE x MAP_SIZE map of bricks, steel, water and trees, scrolled
+// through a 1280 x 720 view while walls are shot away every frame, half
+// of them on screen and half anywhere on the map. Drawn as:
+//     shapes      one textured sf::RectangleShape per tile on screen (the
+//                 way Label draws its m_rect), already culled
+//     chunks N    a Tile_map with N x N tile chunks
+//     whole map   a Tile_map with 32 x 32 chunks zoomed out to show all
+//                 of it, nothing culled
+// Draws into a hidden window and waits for display() so the numbers
+// include the driver, vsync off.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr unsigned    MAP_SIZE           = 512u;
+constexpr std::size_t CHUNK_SIZES[]      = { 16u, 32u, 64u };
+constexpr int         DESTROY_PER_FRAME  = 64;
+constexpr int         WARMUP_COUNT       = 20;
+constexpr int         FRAME_COUNT        = 300;
+constexpr float       TILE_SIZE          = 16.0f;
+constexpr float       SCROLL_SPEED       = 6.0f;  // Pixels per frame
+constexpr auto        WINDOW_SIZE        = sf::Vector2u(1280u, 720u);
+
+constexpr game::Tile BRICK  = 1u;
+constexpr game::Tile STEEL  = 2u;
+constexpr game::Tile WATER  = 3u;
+constexpr game::Tile FOREST = 4u;
+
+// -------------------------------------------------------------------
+// Flat coloured 16 px tiles, 0 left empty.
+sf::Texture make_atlas() {
+
+    sf::Color const colors[] = { sf::Color::Transparent, sf::Color(160, 70, 40), sf::Color(170, 170, 180), sf::Color(40, 70, 200), sf::Color(40, 140, 50) };
+
+    sf::Image image({ 16u * 5u, 16u });
+
+    for (unsigned tile = 0u; tile < 5u; ++tile) {
+
+        for (unsigned y = 0u; y < 16u; ++y) {
+
+            for (unsigned x = 0u; x < 16u; ++x) {
+
+                // A darker border so tiles are told apart
+                bool const is_border = (x == 0u || y == 0u || x == 15u || y == 15u);
+
+                sf::Color color = colors[tile];
+                color.r = static_cast<std::uint8_t>(is_border ? color.r / 2 : color.r);
+                color.g = static_cast<std::uint8_t>(is_border ? color.g / 2 : color.g);
+                color.b = static_cast<std::uint8_t>(is_border ? color.b / 2 : color.b);
+
+                image.setPixel({ tile * 16u + x, y }, color);
+            }
+        }
+    }
+
+    sf::Texture texture;
+
+    if (!texture.loadFromImage(image)) {
+
+        std::printf("Couldn't create the atlas\n");
+    }
+
+    return texture;
+}
+
+// -------------------------------------------------------------------
+// About 60 % filled, mostly bricks.
+std::vector<game::Tile> make_tiles() {
+
+    std::mt19937                       random(3u);
+    std::uniform_int_distribution<int> roll(0, 99);
+
+    std::vector<game::Tile> tiles(static_cast<std::size_t>(MAP_SIZE) * MAP_SIZE, game::EMPTY_TILE);
+
+    for (game::Tile& tile : tiles) {
+
+        int const value = roll(random);
+
+        tile = (value < 40) ? BRICK : (value < 48) ? STEEL : (value < 54) ? WATER : (value < 60) ? FOREST : game::EMPTY_TILE;
+    }
+
+    return tiles;
+}
+
+// -------------------------------------------------------------------
+// Scrolls diagonally, bouncing off the map's edges.
+sf::View get_view(int const frame, float const zoom) {
+
+    float const map_pixels = static_cast<float>(MAP_SIZE) * TILE_SIZE;
+    sf::Vector2f const size(static_cast<float>(WINDOW_SIZE.x) * zoom, static_cast<float>(WINDOW_SIZE.y) * zoom);
+
+    auto bounce = [](float const distance, float const range) {
+
+        float const wrapped = std::fmod(distance, 2.0f * range);
+        return (wrapped < range) ? wrapped : 2.0f * range - wrapped;
+    };
+
+    float const travelled = static_cast<float>(frame) * SCROLL_SPEED;
+
+    sf::Vector2f const corner(
+        bounce(travelled,        std::max(1.0f, map_pixels - size.x)),
+        bounce(travelled * 0.6f, std::max(1.0f, map_pixels - size.y))
+    );
+
+    return sf::View(sf::FloatRect(corner, size));
+}
+
+// -------------------------------------------------------------------
+// Destroys up to DESTROY_PER_FRAME bricks, half inside visible.
+template<typename Destroy_function>
+void shoot_walls(std::mt19937& random, std::vector<game::Tile>& tiles, sf::FloatRect const& visible, Destroy_function&& destroy) {
+
+    std::uniform_int_distribution<unsigned> anywhere(0u, MAP_SIZE - 1u);
+    std::uniform_real_distribution<float>   on_screen(0.0f, 1.0f);
+
+    for (int i = 0; i < DESTROY_PER_FRAME; ++i) {
+
+        sf::Vector2u tile_pos = { anywhere(random), anywhere(random) };
+
+        if (i % 2 == 0) {
+
+            sf::Vector2f const pos = visible.position + sf::Vector2f(on_screen(random) * visible.size.x, on_screen(random) * visible.size.y);
+            tile_pos = { std::min(MAP_SIZE - 1u, static_cast<unsigned>(pos.x / TILE_SIZE)), std::min(MAP_SIZE - 1u, static_cast<unsigned>(pos.y / TILE_SIZE)) };
+        }
+
+        game::Tile& tile = tiles[static_cast<std::size_t>(tile_pos.y) * MAP_SIZE + tile_pos.x];
+
+        if (tile == BRICK) {
+
+            tile = game::EMPTY_TILE;
+            destroy(tile_pos);
+        }
+    }
+}
+
+struct Result {
+
+    std::vector<double> samples;
+    double              draw_calls    = 0.0;  // Per frame
+    double              chunks_meshed = 0.0;  // Per frame
+    double              mesh_ms       = 0.0;  // Per frame
+};
+
+// -------------------------------------------------------------------
+void print(char const* const name, Result& result) {
+
+    std::printf("%-10s p50 %8.1f us/frame   p99 %8.1f us/frame   %7.1f draw calls   %5.1f chunks meshed (%6.3f ms)\n",
+                name, percentile(result.samples, 50.0), percentile(result.samples, 99.0),
+                result.draw_calls, result.chunks_meshed, result.mesh_ms);
+}
+
+// -------------------------------------------------------------------
+template<typename Draw_function>
+void run(char const* const name, sf::RenderWindow& window, float const zoom, Draw_function&& draw_function) {
+
+    std::mt19937 random(5u);
+    Result       result;
+
+    for (int frame = 0; frame < WARMUP_COUNT + FRAME_COUNT; ++frame) {
+
+        sf::View const view = get_view(frame, zoom);
+
+        auto const begin = Bench_clock::now();
+
+        window.setView(view);
+        window.clear();
+        Result const frame_result = draw_function(random, view);
+        window.display();
+
+        if (frame >= WARMUP_COUNT) {
+
+            result.samples.push_back(elapsed_ns(begin, Bench_clock::now()) / 1000.0);
+            result.draw_calls    += frame_result.draw_calls    / FRAME_COUNT;
+            result.chunks_meshed += frame_result.chunks_meshed / FRAME_COUNT;
+            result.mesh_ms       += frame_result.mesh_ms       / FRAME_COUNT;
+        }
+    }
+
+    print(name, result);
+}
+
+// -------------------------------------------------------------------
+sf::FloatRect get_visible(sf::View const& view) {
+
+    return { view.getCenter() - view.getSize() / 2.0f, view.getSize() };
+}
+
+// -------------------------------------------------------------------
+void run_shapes(sf::RenderWindow& window, sf::Texture const& atlas) {
+
+    std::vector<game::Tile> tiles = make_tiles();
+
+    sf::RectangleShape shape({ TILE_SIZE, TILE_SIZE });
+    shape.setTexture(&atlas);
+
+    run("shapes", window, 1.0f, [&](std::mt19937& random, sf::View const& view) {
+
+        sf::FloatRect const visible = get_visible(view);
+
+        shoot_walls(random, tiles, visible, [](sf::Vector2u) {});
+
+        unsigned const x_begin = static_cast<unsigned>(visible.position.x / TILE_SIZE);
+        unsigned const y_begin = static_cast<unsigned>(visible.position.y / TILE_SIZE);
+        unsigned const x_end   = std::min(MAP_SIZE, static_cast<unsigned>((visible.position.x + visible.size.x) / TILE_SIZE) + 1u);
+        unsigned const y_end   = std::min(MAP_SIZE, static_cast<unsigned>((visible.position.y + visible.size.y) / TILE_SIZE) + 1u);
+
+        Result frame_result;
+
+        for (unsigned y = y_begin; y < y_end; ++y) {
+
+            for (unsigned x = x_begin; x < x_end; ++x) {
+
+                game::Tile const tile = tiles[static_cast<std::size_t>(y) * MAP_SIZE + x];
+
+                if (tile == game::EMPTY_TILE) {
+
+                    continue;
+                }
+
+                shape.setPosition({ static_cast<float>(x) * TILE_SIZE, static_cast<float>(y) * TILE_SIZE });
+                shape.setTextureRect({ { static_cast<int>(tile) * 16, 0 }, { 16, 16 } });
+                window.draw(shape);
+
+                frame_result.draw_calls += 1.0;
+            }
+        }
+
+        return frame_result;
+    });
+}
+
+// -------------------------------------------------------------------
+void run_chunks(char const* const name, sf::RenderWindow& window, sf::Texture const& atlas, std::size_t const chunk_size, float const zoom) {
+
+    std::vector<game::Tile> tiles = make_tiles();
+
+    game::Tile_map_settings settings;
+    settings.tile_size       = TILE_SIZE;
+    settings.chunk_size      = chunk_size;
+    settings.atlas_tile_size = 16u;
+
+    game::Tile_map map({ MAP_SIZE, MAP_SIZE }, atlas, settings);
+    map.set_tiles(tiles);
+
+    // Mesh everything up front, the first frames shouldn't count
+    window.setView(sf::View(map.get_bounds()));
+    map.draw(window);
+
+    run(name, window, zoom, [&](std::mt19937& random, sf::View const& view) {
+
+        shoot_walls(random, tiles, get_visible(view), [&](sf::Vector2u const tile_pos) {
+
+            map.set_tile(tile_pos, game::EMPTY_TILE);
+        });
+
+        map.draw(window);
+
+        game::Tile_map_stats const stats = map.get_stats();
+
+        Result frame_result;
+        frame_result.draw_calls    = static_cast<double>(stats.chunks_drawn);
+        frame_result.chunks_meshed = static_cast<double>(stats.chunks_meshed);
+        frame_result.mesh_ms       = stats.mesh_ms;
+
+        return frame_result;
+    });
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    sf::RenderWindow window(sf::VideoMode(WINDOW_SIZE), "bench_tile_map");
+    window.setVisible(false);
+    window.setVerticalSyncEnabled(false);
+
+    sf::Texture const atlas = make_atlas();
+
+    std::printf("%u x %u tiles, %d walls shot per frame, vertex buffers %s\n",
+                MAP_SIZE, MAP_SIZE, DESTROY_PER_FRAME, sf::VertexBuffer::isAvailable() ? "available" : "not available");
+
+    run_shapes(window, atlas);
+
+    for (std::size_t const chunk_size : CHUNK_SIZES) {
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "chunks %zu", chunk_size);
+        run_chunks(name, window, atlas, chunk_size, 1.0f);
+    }
+
+    // Zoomed out until the whole map fits the window's height
+    run_chunks("whole map", window, atlas, 32u, static_cast<float>(MAP_SIZE) * TILE_SIZE / static_cast<float>(WINDOW_SIZE.y));
+
+    return 0;
+}
@@ -0,0 +1,293 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "utils/logger.h"
+#include "widget/widget.h"
+#include "widget/widget_manager.h"
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// 100,000 widgets in a Widget_manager, once spread over a large
+// scrolling canvas and once piled up on a single 1920x1080 screen.
+// Times hover (mouse moves), clicks (press and release, the press going
+// down through widgets that don't use it) and bare hit tests at random
+// points, then moving 1% of the widgets and the update that follows.
+// The widgets are bare boxes so only the manager is measured. Fails
+// (exit 1) when hover or click dispatch averages over DISPATCH_BUDGET_NS.
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr std::size_t WIDGET_COUNT       = 100'000u;
+constexpr std::size_t EVENT_COUNT        = 100'000u;
+constexpr int         BATCH_SIZE         = 1'000;
+constexpr std::size_t MOVE_COUNT         = WIDGET_COUNT / 100u;
+constexpr int         MOVE_FRAMES        = 100;
+constexpr double      DISPATCH_BUDGET_NS = 1000.0;
+constexpr auto        SCREEN_SIZE        = sf::Vector2f(1920.0f, 1080.0f);
+
+// ===================================================================
+// Test widget
+// -------------------------------------------------------------------
+
+// Bounds and nothing else.
+class Box final : public widget::Widget {
+
+public:
+    Box(sf::Vector2f const& pos, sf::Vector2f const& size)
+        : Widget(nullptr)
+        , m_size(size)
+    {
+
+        m_pos = pos;
+    }
+
+    void set_pos(sf::Vector2f const& pos) override {
+
+        m_pos = pos;
+        invalidate();
+    }
+
+    void set_origin(sf::Vector2f const& origin) override {
+
+        m_origin = origin;
+        invalidate();
+    }
+
+    widget::Widget_type is() const override { return widget::Widget_type::Image; }
+
+    sf::FloatRect get_global_bounds() const override { return { m_pos - m_origin, m_size }; }
+
+    void draw() override {}
+    void draw(sf::RenderTarget& /*target*/) override {}
+    void draw(widget::Batch_renderer& /*batch*/) override {}
+
+private:
+    sf::Vector2f m_size;
+};
+
+struct Scene {
+
+    std::vector<std::unique_ptr<Box>> boxes;
+    sf::Vector2f                      area;
+};
+
+// -------------------------------------------------------------------
+// Buttons on a grid with a few pixels between them, 10k px by 10k px.
+Scene make_canvas() {
+
+    Scene scene;
+    scene.boxes.reserve(WIDGET_COUNT);
+
+    constexpr std::size_t COLUMNS = 316u;
+    constexpr float       PITCH   = 32.0f;
+
+    for (std::size_t i = 0u; i < WIDGET_COUNT; ++i) {
+
+        sf::Vector2f const pos(static_cast<float>(i % COLUMNS) * PITCH, static_cast<float>(i / COLUMNS) * PITCH);
+        scene.boxes.push_back(std::make_unique<Box>(pos, sf::Vector2f(28.0f, 28.0f)));
+    }
+
+    scene.area = { static_cast<float>(COLUMNS) * PITCH, static_cast<float>(WIDGET_COUNT / COLUMNS + 1u) * PITCH };
+    return scene;
+}
+
+// -------------------------------------------------------------------
+// Random overlapping boxes of 8 to 40 px all on one screen, the worst
+// case for a grid: hundreds of widgets per cell, about 30 under any point.
+Scene make_screen(std::mt19937& random) {
+
+    Scene scene;
+    scene.boxes.reserve(WIDGET_COUNT);
+
+    std::uniform_real_distribution<float> x   (0.0f, SCREEN_SIZE.x - 40.0f);
+    std::uniform_real_distribution<float> y   (0.0f, SCREEN_SIZE.y - 40.0f);
+    std::uniform_real_distribution<float> size(8.0f, 40.0f);
+
+    for (std::size_t i = 0u; i < WIDGET_COUNT; ++i) {
+
+        scene.boxes.push_back(std::make_unique<Box>(sf::Vector2f(x(random), y(random)), sf::Vector2f(size(random), size(random))));
+    }
+
+    scene.area = SCREEN_SIZE;
+    return scene;
+}
+
+// -------------------------------------------------------------------
+std::vector<sf::Vector2i> make_points(std::mt19937& random, sf::Vector2f const& area) {
+
+    std::uniform_int_distribution<int> x(0, static_cast<int>(area.x) - 1);
+    std::uniform_int_distribution<int> y(0, static_cast<int>(area.y) - 1);
+
+    std::vector<sf::Vector2i> points;
+    points.reserve(EVENT_COUNT);
+
+    for (std::size_t i = 0u; i < EVENT_COUNT; ++i) {
+
+        points.emplace_back(x(random), y(random));
+    }
+
+    return points;
+}
+
+// -------------------------------------------------------------------
+// Times step_function over every event in batches, prints and returns
+// the mean in nanoseconds per event.
+template<typename Step_function>
+double run(char const* const name, Step_function&& step_function) {
+
+    std::vector<double> samples;
+    samples.reserve(EVENT_COUNT / BATCH_SIZE);
+
+    for (std::size_t begin_index = 0u; begin_index + BATCH_SIZE <= EVENT_COUNT; begin_index += BATCH_SIZE) {
+
+        auto const begin = Bench_clock::now();
+
+        for (std::size_t i = begin_index; i < begin_index + BATCH_SIZE; ++i) {
+
+            step_function(i);
+        }
+
+        samples.push_back(elapsed_ns(begin, Bench_clock::now()) / BATCH_SIZE);
+    }
+
+    double total = 0.0;
+
+    for (double const sample : samples) {
+
+        total += sample;
+    }
+
+    double const mean = total / static_cast<double>(samples.size());
+
+    std::printf("  %-22s mean %7.1f ns   batch p50 %7.1f ns   p99 %7.1f ns\n",
+                name, mean, percentile(samples, 50.0), percentile(samples, 99.0));
+
+    return mean;
+}
+
+// -------------------------------------------------------------------
+// Returns false when a dispatch average is over the budget.
+bool bench_scene(char const* const name, Scene& scene, std::mt19937& random) {
+
+    widget::Widget_manager manager(nullptr);
+
+    std::size_t handled = 0u;
+
+    auto const build_begin = Bench_clock::now();
+
+    for (std::size_t i = 0u; i < scene.boxes.size(); ++i) {
+
+        // Every third widget ignores clicks, they fall through to the one under it
+        bool const is_clickable = i % 3u != 0u;
+
+        manager.add(*scene.boxes[i], [&handled, is_clickable](sf::Event const& event) {
+
+            ++handled;
+            return is_clickable && !event.is<sf::Event::MouseMoved>();
+        });
+    }
+
+    manager.update();
+
+    std::printf("%s: %zu widgets added in %.2f ms, %zu cells, at most %zu widgets in one\n",
+                name, manager.get_widget_count(), elapsed_ns(build_begin, Bench_clock::now()) / 1'000'000.0,
+                manager.get_cell_count(), manager.get_max_cell_size());
+
+    std::vector<sf::Vector2i> const points = make_points(random, scene.area);
+
+    std::size_t hits = 0u;
+
+    run("hit test", [&](std::size_t const i) {
+
+        hits += manager.hit_test(sf::Vector2f(points[i])) != nullptr ? 1u : 0u;
+    });
+
+    double const hover_ns = run("hover (mouse move)", [&](std::size_t const i) {
+
+        manager.dispatch(sf::Event::MouseMoved{ points[i] });
+    });
+
+    // The budget is per event, a click is two
+    double const click_ns = run("click (press, release)", [&](std::size_t const i) {
+
+        manager.dispatch(sf::Event::MouseButtonPressed { sf::Mouse::Button::Left, points[i] });
+        manager.dispatch(sf::Event::MouseButtonReleased{ sf::Mouse::Button::Left, points[i] });
+    }) / 2.0;
+
+    // Moving widgets, only those are re-binned on the next update
+    std::vector<double> move_samples;
+    move_samples.reserve(MOVE_FRAMES);
+
+    std::uniform_int_distribution<std::size_t> pick(0u, scene.boxes.size() - 1u);
+    std::uniform_real_distribution<float>      step(-48.0f, 48.0f);
+
+    for (int frame = 0; frame < MOVE_FRAMES; ++frame) {
+
+        for (std::size_t i = 0u; i < MOVE_COUNT; ++i) {
+
+            Box& box = *scene.boxes[pick(random)];
+            box.set_pos(box.get_pos() + sf::Vector2f(step(random), step(random)));
+        }
+
+        auto const begin = Bench_clock::now();
+        manager.update();
+        move_samples.push_back(elapsed_ns(begin, Bench_clock::now()) / 1000.0);
+    }
+
+    std::printf("  %-22s p50 %7.1f us   p99 %7.1f us   (%zu widgets moved per frame)\n",
+                "update after moves", percentile(move_samples, 50.0), percentile(move_samples, 99.0), MOVE_COUNT);
+
+    std::printf("  %zu of %zu hit tests hit, %zu handler calls\n", hits, EVENT_COUNT, handled);
+
+    bool const is_ok = hover_ns <= DISPATCH_BUDGET_NS && click_ns <= DISPATCH_BUDGET_NS;
+
+    if (!is_ok) {
+
+        std::printf("FAIL %s: hover %.1f ns or click %.1f ns is over the %.0f ns budget\n", name, hover_ns, click_ns, DISPATCH_BUDGET_NS);
+    }
+
+    return is_ok;
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main() {
+
+    std::mt19937 random(42u);
+
+    Scene canvas = make_canvas();
+    Scene screen = make_screen(random);
+
+    bool const is_canvas_ok = bench_scene("canvas", canvas, random);
+    bool const is_screen_ok = bench_scene("screen", screen, random);
+
+    if (!is_canvas_ok || !is_screen_ok) {
+
+        return 1;
+    }
+
+    std::printf("OK hover and click dispatch are within %.0f ns\n", DISPATCH_BUDGET_NS);
+    return 0;
+}
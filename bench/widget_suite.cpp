@@ -0,0 +1,286 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "utils/logger.h"
+#include "widget/batch_renderer.h"
+#include "widget/label.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// Offscreen widget benchmarks, no window needed: Label construction,
+// layout, immediate and batched draw throughput and memory, for scenes
+// of 10 to 100k labels drawn into an sf::RenderTexture.
+//
+// Results go to stdout and, as JSON, to the --out file so runs can be
+// compared to catch regressions. Uses Mesa's software rasteriser unless
+// --hardware-gl is given, so numbers from different machines are closer
+// and it runs on CI machines without a GPU (the env variables have no
+// effect on other GL drivers). Run from the build's bin/ folder so the
+// assets are found, or through the run_widget_suite target.
+//
+// Usage:
+//     bench_widget_suite [--out results.json] [--hardware-gl]
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr int WIDGET_COUNTS[] = { 10, 100, 1'000, 10'000, 100'000 };
+
+// Draw passes run at least this many frames and stop after the time budget
+constexpr int    MIN_FRAME_COUNT = 3;
+constexpr int    MAX_FRAME_COUNT = 200;
+constexpr double FRAME_BUDGET_NS = 2'000'000'000.0;
+constexpr auto   TARGET_SIZE     = sf::Vector2u(1920u, 1080u);
+
+struct Result {
+
+    int         widget_count;
+    double      construct_ns;           // Per widget
+    double      layout_ns;              // Per widget, text change plus bounds query
+    double      draw_ns;                // Per widget per frame, one draw() each
+    double      batched_draw_ns;        // Per widget per frame, through a Batch_renderer
+    std::size_t batched_draw_calls;
+    std::size_t bytes_per_widget;       // Resident memory growth while constructing
+};
+
+using Labels = std::vector<std::unique_ptr<widget::Label>>;
+
+// -------------------------------------------------------------------
+template<typename Frame_function>
+double time_frames(sf::RenderTexture& target, Frame_function&& frame_function) {
+
+    std::vector<double> samples;
+
+    double total_ns = 0.0;
+
+    while (static_cast<int>(samples.size()) < MAX_FRAME_COUNT
+        && (static_cast<int>(samples.size()) < MIN_FRAME_COUNT || total_ns < FRAME_BUDGET_NS)) {
+
+        auto const begin = Bench_clock::now();
+
+        target.clear();
+        frame_function();
+        target.display();
+
+        samples.push_back(elapsed_ns(begin, Bench_clock::now()));
+        total_ns += samples.back();
+    }
+
+    return percentile(samples, 50.0);
+}
+
+// -------------------------------------------------------------------
+Result run(sf::RenderTexture& target, int const count) {
+
+    Result result{};
+    result.widget_count = count;
+
+    double const per_widget = 1.0 / static_cast<double>(count);
+
+    // Construction and memory
+    Labels labels;
+    labels.reserve(static_cast<std::size_t>(count));
+
+    std::size_t const rss_before = resident_bytes();
+    auto              begin      = Bench_clock::now();
+
+    for (int i = 0; i < count; ++i) {
+
+        auto label = std::make_unique<widget::Label>(&target, "Label " + std::to_string(i));
+        label->set_pos({ static_cast<float>(i % 30) * 64.0f, static_cast<float>(i / 30 % 77) * 14.0f });
+        label->set_character_size(11u);
+        label->set_margins(1.0f, 1.0f, 2.0f, 2.0f);
+
+        labels.push_back(std::move(label));
+    }
+
+    result.construct_ns = elapsed_ns(begin, Bench_clock::now()) * per_widget;
+
+    std::size_t const rss_after = resident_bytes();
+    result.bytes_per_widget     = (rss_after > rss_before) ? (rss_after - rss_before) / static_cast<std::size_t>(count) : 0u;
+
+    // Layout, a new text and a bounds query makes every label lay itself out again
+    begin = Bench_clock::now();
+
+    float bounds_sum = 0.0f;
+
+    for (auto& label : labels) {
+
+        label->set_text("Moved");
+        bounds_sum += label->get_global_bounds().size.x;
+    }
+
+    result.layout_ns = elapsed_ns(begin, Bench_clock::now()) * per_widget;
+
+    if (bounds_sum < 0.0f) {
+
+        std::printf("Impossible bounds\n"); // Keeps the loop from being optimised away
+    }
+
+    // Immediate draws
+    result.draw_ns = time_frames(target, [&] {
+
+        for (auto& label : labels) {
+
+            label->draw();
+        }
+    }) * per_widget;
+
+    // Batched draws
+    widget::Batch_renderer batch;
+
+    result.batched_draw_ns = time_frames(target, [&] {
+
+        batch.clear();
+
+        for (auto& label : labels) {
+
+            label->draw(batch);
+        }
+
+        batch.draw(target);
+    }) * per_widget;
+
+    result.batched_draw_calls = batch.get_draw_call_count();
+
+    return result;
+}
+
+// -------------------------------------------------------------------
+void use_software_gl() {
+
+#ifdef _WIN32
+    _putenv_s("LIBGL_ALWAYS_SOFTWARE", "1");
+    _putenv_s("GALLIUM_DRIVER",        "llvmpipe");
+#else
+    setenv("LIBGL_ALWAYS_SOFTWARE", "1",        1);
+    setenv("GALLIUM_DRIVER",        "llvmpipe", 1);
+#endif
+}
+
+// -------------------------------------------------------------------
+bool write_json(std::string const& path, std::vector<Result> const& results, bool const is_software_gl) {
+
+    std::ofstream out(path, std::ios::trunc);
+
+    if (!out) {
+
+        return false;
+    }
+
+    out << "{\n"
+        << "  \"bench\": \"widget_suite\",\n"
+        << "  \"software_gl\": " << (is_software_gl ? "true" : "false") << ",\n"
+        << "  \"target_size\": [" << TARGET_SIZE.x << ", " << TARGET_SIZE.y << "],\n"
+        << "  \"results\": [\n";
+
+    for (std::size_t i = 0u; i < results.size(); ++i) {
+
+        Result const& result = results[i];
+
+        out << "    { \"widgets\": "                 << result.widget_count
+            << ", \"construct_ns_per_widget\": "     << result.construct_ns
+            << ", \"layout_ns_per_widget\": "        << result.layout_ns
+            << ", \"draw_ns_per_widget\": "          << result.draw_ns
+            << ", \"batched_draw_ns_per_widget\": "  << result.batched_draw_ns
+            << ", \"batched_draw_calls\": "          << result.batched_draw_calls
+            << ", \"bytes_per_widget\": "            << result.bytes_per_widget
+            << " }" << (i + 1u < results.size() ? "," : "") << '\n';
+    }
+
+    out << "  ]\n"
+        << "}\n";
+
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+    std::string out_path       = "widget_suite.json";
+    bool        is_software_gl = true;
+
+    for (int i = 1; i < argc; ++i) {
+
+        std::string_view const arg = argv[i];
+
+        if (arg == "--out" && i + 1 < argc) {
+
+            out_path = argv[++i];
+
+        } else if (arg == "--hardware-gl") {
+
+            is_software_gl = false;
+
+        } else {
+
+            std::fprintf(stderr, "Usage: %s [--out results.json] [--hardware-gl]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Has to happen before SFML creates its first GL context
+    if (is_software_gl) {
+
+        use_software_gl();
+    }
+
+    sf::RenderTexture target;
+
+    if (!target.resize(TARGET_SIZE)) {
+
+        std::fprintf(stderr, "Unable to create a %ux%u render texture\n", TARGET_SIZE.x, TARGET_SIZE.y);
+        return 1;
+    }
+
+    std::vector<Result> results;
+
+    std::printf("%8s %14s %14s %14s %14s %12s %12s\n",
+                "widgets", "construct ns", "layout ns", "draw ns", "batched ns", "draw calls", "bytes");
+
+    for (int const count : WIDGET_COUNTS) {
+
+        Result const result = run(target, count);
+
+        std::printf("%8d %14.1f %14.1f %14.1f %14.1f %12zu %12zu\n",
+                    result.widget_count, result.construct_ns, result.layout_ns, result.draw_ns,
+                    result.batched_draw_ns, result.batched_draw_calls, result.bytes_per_widget);
+
+        results.push_back(result);
+    }
+
+    if (!write_json(out_path, results, is_software_gl)) {
+
+        std::fprintf(stderr, "Unable to write %s\n", out_path.c_str());
+        return 1;
+    }
+
+    std::printf("Results written to %s\n", out_path.c_str());
+
+    return 0;
+}
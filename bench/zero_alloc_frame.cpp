@@ -0,0 +1,207 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "bench_utils.h"
+#include "SFML/Graphics.hpp"
+#include "utils/allocation_tracker.h"
+#include "utils/frame_stats.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+#include "widget/batch_renderer.h"
+#include "widget/cached_group.h"
+#include "widget/label.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Set global logger settings (MUST be done before main)
+int              const ENABLED_LOG_LVLS       = Log_lvl::WARNING | Log_lvl::ERROR;
+std::string_view const LOG_SPECIFIC_FILE_ONLY = "ALL";
+
+// Allocation check rather than a timing: draws a reference scene (labels
+// drawn one by one, labels through a Batch_renderer and a Cached_group)
+// offscreen, with one label moving every frame, and fails if any frame
+// after the warmup allocates. The offending frames are listed and the
+// profiler trace is written with allocations per zone, open it in
+// https://ui.perfetto.dev to find where they come from.
+//
+// Needs -DTINY_TANKS_TRACK_ALLOCATIONS=ON, run through the
+// check_zero_alloc_frame target or from the build's bin/ folder.
+//
+// Usage:
+//     bench_zero_alloc_frame [--trace trace.json]
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks;
+using namespace tiny_tanks::bench;
+
+namespace {
+
+// ===================================================================
+// Bench settings
+// -------------------------------------------------------------------
+
+constexpr int  IMMEDIATE_COUNT = 200;
+constexpr int  BATCHED_COUNT   = 200;
+constexpr int  GROUPED_COUNT   = 50;
+constexpr int  WARMUP_COUNT    = 30;   // Caches, glyph pages and buffers fill up here
+constexpr int  FRAME_COUNT     = 300;
+constexpr auto TARGET_SIZE     = sf::Vector2u(1280u, 720u);
+
+using Labels = std::vector<std::unique_ptr<widget::Label>>;
+
+// -------------------------------------------------------------------
+Labels make_labels(sf::RenderTarget& target, int const count, float const top) {
+
+    Labels labels;
+    labels.reserve(static_cast<std::size_t>(count));
+
+    for (int i = 0; i < count; ++i) {
+
+        auto label = std::make_unique<widget::Label>(&target, "HP " + std::to_string(i));
+        label->set_pos({ static_cast<float>(i % 25) * 48.0f, top + static_cast<float>(i / 25) * 14.0f });
+        label->set_character_size(11u);
+        label->set_margins(1.0f, 1.0f, 2.0f, 2.0f);
+        label->set_background_color(sf::Color(40, 40, 40));
+        label->set_border_thickness(1.0f);
+        label->set_border_color(sf::Color(200, 200, 200));
+
+        labels.push_back(std::move(label));
+    }
+
+    return labels;
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+    std::string trace_path = "zero_alloc_frame_trace.json";
+
+    for (int i = 1; i < argc; ++i) {
+
+        std::string_view const arg = argv[i];
+
+        if (arg == "--trace" && i + 1 < argc) {
+
+            trace_path = argv[++i];
+
+        } else {
+
+            std::fprintf(stderr, "Usage: %s [--trace trace.json]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if constexpr (!utils::Allocation_tracker::is_compiled_in()) {
+
+        std::fprintf(stderr, "Allocation tracking isn't compiled in, configure with -DTINY_TANKS_TRACK_ALLOCATIONS=ON\n");
+        return 2;
+    }
+
+    sf::RenderTexture target;
+
+    if (!target.resize(TARGET_SIZE)) {
+
+        std::fprintf(stderr, "Unable to create a %ux%u render texture\n", TARGET_SIZE.x, TARGET_SIZE.y);
+        return 1;
+    }
+
+    Labels immediate = make_labels(target, IMMEDIATE_COUNT,   0.0f);
+    Labels batched   = make_labels(target, BATCHED_COUNT,   150.0f);
+    Labels grouped   = make_labels(target, GROUPED_COUNT,   300.0f);
+
+    widget::Cached_group group(&target);
+
+    for (auto& label : grouped) {
+
+        group.add(*label);
+    }
+
+    widget::Batch_renderer batch;
+
+    // Recording through the warmup too, the first zones of a thread allocate its buffer
+    utils::Profiler::start(utils::Profiler_settings{});
+
+    std::vector<utils::Frame_counters> steady_frames;
+    steady_frames.reserve(FRAME_COUNT);
+
+    for (int frame = 0; frame < WARMUP_COUNT + FRAME_COUNT; ++frame) {
+
+        {
+            PROFILE_ZONE("Frame");
+
+            // Something has to change, otherwise nothing past the first frame does any work
+            immediate.front()->set_pos({ static_cast<float>(frame % 100), 0.0f });
+
+            target.clear();
+
+            for (auto& label : immediate) {
+
+                label->draw(target);
+            }
+
+            batch.clear();
+
+            for (auto& label : batched) {
+
+                label->draw(batch);
+            }
+
+            batch.draw(target);
+
+            group.draw(target);
+
+            target.display();
+        }
+
+        PROFILE_FRAME();
+
+        utils::Frame_counters const counters = utils::Frame_stats::end_frame();
+
+        if (frame >= WARMUP_COUNT) {
+
+            steady_frames.push_back(counters);
+        }
+    }
+
+    utils::Profiler::stop();
+
+    int failed_count = 0;
+
+    for (std::size_t i = 0u; i < steady_frames.size(); ++i) {
+
+        utils::Frame_counters const& counters = steady_frames[i];
+
+        if (counters.allocations.value_or(0u) != 0u) {
+
+            std::printf("Frame %zu: %llu allocations, %llu bytes\n",
+                        static_cast<std::size_t>(WARMUP_COUNT) + i + 1u,
+                        static_cast<unsigned long long>(*counters.allocations),
+                        static_cast<unsigned long long>(counters.allocated_bytes.value_or(0u)));
+
+            ++failed_count;
+        }
+    }
+
+    if (failed_count == 0) {
+
+        std::printf("PASS: %d steady state frames, no allocations\n", FRAME_COUNT);
+        return 0;
+    }
+
+    utils::Profiler::write_chrome_trace(trace_path);
+
+    std::printf("FAIL: %d of %d steady state frames allocated, see %s\n", failed_count, FRAME_COUNT, trace_path.c_str());
+
+    return 1;
+}
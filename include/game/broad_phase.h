@@ -0,0 +1,209 @@
+#ifndef GAME_BROAD_PHASE_H
+#define GAME_BROAD_PHASE_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::game {
+
+// ===================================================================
+// Broad phase settings
+// -------------------------------------------------------------------
+
+struct Broad_phase_settings {
+
+    // Pixels, around the size of the bigger common objects (a tank). Much
+    // smaller and boxes cover many cells, much bigger and cells get crowded.
+    float cell_size = 64.0f;
+
+    // Pairs handed over per call of the pair function.
+    std::size_t batch_size = 1024u;
+
+    // Threads splitting the grid between them, 0 or 1 runs everything on
+    // the thread calling update().
+    std::size_t worker_count = 0u;
+};
+
+struct Broad_phase_stats {
+
+    std::size_t pairs        = 0u;   // Dynamic against dynamic
+    std::size_t static_pairs = 0u;   // Dynamic against static
+    std::size_t max_cell     = 0u;   // Most dynamic boxes in one cell
+    double      update_ms    = 0.0;
+};
+
+// Indices into the spans given to update() (a < b) or, for static pairs,
+// a into update()'s and b into set_static()'s.
+struct Collision_pair {
+
+    std::uint32_t a;
+    std::uint32_t b;
+};
+
+// ===================================================================
+// class Broad_phase
+// -------------------------------------------------------------------
+
+// Finds which boxes may touch, for the narrow phase to test properly,
+// without testing every box against every other one.
+//
+// The world is cut into a uniform grid. Every update() buckets the
+// dynamic boxes (tanks, bullets) into the cells they cover with a
+// counting sort: count per cell, prefix sum, scatter. A cell's boxes
+// end up next to each other in memory, copied with their bounds, so
+// testing a cell reads one contiguous range. Static boxes (walls) are
+// bucketed the same way once, by set_static().
+//
+// Pairs are only reported when their layers collide (set_collides) and
+// their boxes overlap, by the one cell holding the top left corner of
+// the overlap, so a pair sharing several cells comes out once.
+//
+// With workers, each first finds the cells of an even share of the
+// boxes. Then the grid is split into bands of rows which the workers
+// take in turn, each bucketing and testing its bands on its own, so the
+// pair function is called from several threads at once.
+class Broad_phase final {
+
+public:
+    static constexpr std::size_t LAYER_COUNT = 8u;
+
+    // Called with each full batch and the rest at the end, worker is the
+    // index of the calling worker (0 without workers).
+    using Pair_function = std::function<void(std::span<Collision_pair const> const pairs, bool const is_static, std::size_t const worker)>;
+
+    explicit Broad_phase(sf::FloatRect const& world_bounds, Broad_phase_settings const& settings = {});
+    ~Broad_phase();
+
+    Broad_phase           (Broad_phase const&) = delete;
+    Broad_phase& operator=(Broad_phase const&) = delete;
+
+    // Both ways, every layer collides with every other one to begin with.
+    void set_collides(std::uint8_t const layer_a, std::uint8_t const layer_b, bool const collides);
+
+    // Walls and anything else that doesn't move, kept until the next call.
+    void set_static(std::span<sf::FloatRect const> const bounds, std::span<std::uint8_t const> const layers);
+
+    // Once per tick, bounds and layers one entry per box. Returns when
+    // every pair has been handed to on_pairs.
+    void update(
+        std::span<sf::FloatRect const> const bounds,
+        std::span<std::uint8_t const> const  layers,
+        Pair_function const&                 on_pairs
+    );
+
+    Broad_phase_stats get_stats() const { return m_stats; }
+
+private:
+
+    // A box as bucketed into one cell.
+    struct Cell_item {
+
+        sf::Vector2f  min;
+        sf::Vector2f  max;
+        std::uint32_t index;
+        std::uint8_t  layer;
+    };
+
+    // Cells of a range of rows, counting sorted.
+    struct Band {
+
+        std::size_t                row_begin;
+        std::size_t                row_end;
+        std::vector<std::uint32_t> cell_start;  // Per cell, plus the end
+        std::vector<Cell_item>     items;
+    };
+
+    struct Worker_state {
+
+        std::vector<Collision_pair> pairs;
+        std::vector<Collision_pair> static_pairs;
+        std::size_t                 pair_count;
+        std::size_t                 static_pair_count;
+        std::size_t                 max_cell;
+    };
+
+    // Cells a box covers, ends exclusive.
+    struct Cell_range {
+
+        std::uint32_t x_begin;
+        std::uint32_t x_end;
+        std::uint32_t y_begin;
+        std::uint32_t y_end;
+    };
+
+    enum class Phase {
+
+        Ranges,  // Boxes split evenly, each worker finds the cells of its share
+        Bands    // Bands taken in turn, bucketed and tested
+    };
+
+    Cell_range  get_cell_range(sf::FloatRect const& box) const;
+    std::size_t get_cell(sf::Vector2f const point) const;
+
+    void find_ranges(std::span<sf::FloatRect const> const bounds, std::size_t const first, std::size_t const last);
+
+    // Boxes whose ranges (from find_ranges) cover the band's rows.
+    void bucket(Band& band, std::span<sf::FloatRect const> const bounds, std::span<std::uint8_t const> const layers) const;
+    void find_pairs(Band const& band, Worker_state& worker_state, std::size_t const worker);
+
+    void flush(Worker_state& worker_state, bool const is_static, std::size_t const worker);
+
+    // Runs a phase on every worker, the calling thread included, and
+    // returns once all of them are done.
+    void run_phase(Phase const phase);
+    void run_phase_share(Phase const phase, std::size_t const worker);
+    void run_worker(std::size_t const worker);
+
+    sf::Vector2f         m_origin;
+    Broad_phase_settings m_settings;
+    float                m_cell_scale;  // 1 / cell size
+    std::size_t          m_column_count;
+    std::size_t          m_row_count;
+
+    std::array<std::uint8_t, LAYER_COUNT> m_collides;  // Per layer, a bit per layer it collides with
+
+    Band m_static;
+
+    std::vector<Band>         m_bands;
+    std::vector<Worker_state> m_worker_states;
+
+    // Set for the length of an update()
+    std::span<sf::FloatRect const> m_bounds;
+    std::span<std::uint8_t const>  m_layers;
+    Pair_function const*           m_on_pairs;
+    std::vector<Cell_range>        m_ranges;  // Per box
+    std::atomic<std::size_t>       m_next_band;
+    Phase                          m_phase;
+
+    std::vector<std::thread> m_workers;
+    std::mutex               m_mutex;
+    std::condition_variable  m_start_cv;
+    std::condition_variable  m_done_cv;
+    std::uint64_t            m_generation;
+    std::size_t              m_pending;
+    bool                     m_is_stopping;
+
+    Broad_phase_stats m_stats;
+};
+
+} // tiny_tanks::game
+
+#endif // GAME_BROAD_PHASE_H
@@ -0,0 +1,154 @@
+#ifndef GAME_ENTITY_STORE_H
+#define GAME_ENTITY_STORE_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+// ===================================================================
+// Compile time switch
+// -------------------------------------------------------------------
+
+// 1 runs the Entity_store kernels with SSE2 (always there on x86-64), 0
+// with plain loops. Set from CMake with -DTINY_TANKS_SIMD=OFF.
+#ifndef SIMD_COMPILED_IN
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define SIMD_COMPILED_IN 1
+    #else
+        #define SIMD_COMPILED_IN 0
+    #endif
+#endif
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::game {
+
+// ===================================================================
+// Entity types
+// -------------------------------------------------------------------
+
+// Names an entity for as long as it lives. Stays valid while others are
+// created and destroyed (unlike its index), a destroyed entity's handle
+// never matches a later one's.
+struct Entity_handle {
+
+    static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t slot       = NONE;
+    std::uint32_t generation = 0u;
+
+    friend bool operator==(Entity_handle const&, Entity_handle const&) = default;
+};
+
+struct Entity_desc {
+
+    sf::Vector2f position = {};
+    sf::Vector2f velocity = {};   // Pixels per second
+    float        heading  = 0.0f; // Degrees, like Tank_state
+    float        health   = 1.0f;
+    std::uint8_t team     = 0u;
+};
+
+// One array per field, entity i at index i of each.
+template<typename Float, typename Byte>
+struct Basic_entity_arrays {
+
+    std::span<Float> position_x;
+    std::span<Float> position_y;
+    std::span<Float> velocity_x;
+    std::span<Float> velocity_y;
+    std::span<Float> heading;
+    std::span<Float> health;
+    std::span<Byte>  team;
+};
+
+using Entity_arrays       = Basic_entity_arrays<float,       std::uint8_t>;
+using Const_entity_arrays = Basic_entity_arrays<float const, std::uint8_t const>;
+
+// ===================================================================
+// class Entity_store
+// -------------------------------------------------------------------
+
+// Game objects (tanks, projectiles) as structure of arrays: every field
+// sits in its own contiguous array, so a pass over one field reads only
+// that field and the kernels run 4 entities per SSE2 instruction (see
+// SIMD_COMPILED_IN).
+//
+// The arrays stay dense, destroy() moves the last entity into the hole.
+// Indices therefore change, handles don't: keep handles, look indices up
+// with get_index() when needed.
+class Entity_store final {
+
+public:
+    static constexpr std::size_t NPOS = std::numeric_limits<std::size_t>::max();
+
+    Entity_store() = default;
+
+    void reserve(std::size_t const count);
+
+    Entity_handle create(Entity_desc const& desc);
+
+    // False (and nothing happens) for a dead or unknown handle.
+    bool destroy(Entity_handle const handle);
+
+    // Destroys everything, handles out there are dead after.
+    void clear();
+
+    bool is_alive(Entity_handle const handle) const;
+
+    // NPOS for a dead handle. Only good until the next destroy().
+    std::size_t   get_index (Entity_handle const handle) const;
+    Entity_handle get_handle(std::size_t const index) const;
+
+    std::size_t get_count() const { return m_handles.size(); }
+
+    Entity_arrays       get_arrays();
+    Const_entity_arrays get_arrays() const;
+
+    // -------------------------------------------------------------------
+    // Kernels, over every entity
+
+    // position += velocity * dt
+    void integrate(float const dt);
+
+    // Destroys every entity whose position is outside bounds (e.g.
+    // projectiles leaving the map), returns how many.
+    std::size_t destroy_outside(sf::FloatRect const& bounds);
+
+private:
+    // Swap-remove of a live index.
+    void destroy_at(std::size_t const index);
+
+    // Per handle slot: the entity's index while alive, the next free slot once dead.
+    struct Slot {
+
+        std::uint32_t index;
+        std::uint32_t generation;
+    };
+
+    std::vector<float>         m_position_x;
+    std::vector<float>         m_position_y;
+    std::vector<float>         m_velocity_x;
+    std::vector<float>         m_velocity_y;
+    std::vector<float>         m_heading;
+    std::vector<float>         m_health;
+    std::vector<std::uint8_t>  m_team;
+    std::vector<std::uint32_t> m_handles;  // Index to slot
+
+    std::vector<Slot> m_slots;
+    std::uint32_t     m_free_slot = Entity_handle::NONE;
+};
+
+} // tiny_tanks::game
+
+#endif // GAME_ENTITY_STORE_H
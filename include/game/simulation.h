@@ -0,0 +1,125 @@
+#ifndef GAME_SIMULATION_H
+#define GAME_SIMULATION_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "game/world.h"
+#include "utils/snapshot_buffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::game {
+
+// ===================================================================
+// Simulation settings
+// -------------------------------------------------------------------
+
+struct Simulation_settings {
+
+    // Ticks per second, each one advances the world by 1 / tick_rate seconds.
+    unsigned int tick_rate = 60u;
+
+    // Ticks run back to back to catch up after a hitch, past that the
+    // simulation drops the time instead (slows down rather than spirals).
+    unsigned int max_catch_up_ticks = 5u;
+};
+
+struct Simulation_stats {
+
+    std::uint64_t ticks         = 0u;
+    std::uint64_t dropped_ticks = 0u;    // Given up on after a long hitch
+    double        step_last_ms  = 0.0;   // Commands, step and snapshot
+    double        step_max_ms   = 0.0;
+};
+
+// ===================================================================
+// class Simulation
+// -------------------------------------------------------------------
+
+// Runs the World at a fixed tick on its own thread, so gameplay speed
+// doesn't depend on the frame rate and a slow frame doesn't stall it.
+//
+// Every tick applies the commands pushed since the last one, steps the
+// world and publishes a World_snapshot through a utils::Snapshot_buffer.
+// The render thread never waits for the simulation: interpolate() blends
+// the two latest snapshots for one tick in the past, so drawing at
+// 144 Hz costs the simulation nothing extra and motion stays smooth,
+// and a simulation hitch only holds the picture still for a moment
+// instead of dropping frames.
+class Simulation final {
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit Simulation(World world, Simulation_settings const& settings = {});
+    ~Simulation();
+
+    Simulation           (Simulation const&) = delete;
+    Simulation& operator=(Simulation const&) = delete;
+
+    // The world belongs to the simulation thread from start() to stop().
+    void start();
+    void stop ();
+
+    bool is_running() const;
+
+    // Any thread, applied at the start of the next tick.
+    void push_command(Tank_command const& command);
+
+    // Render thread: the world as it was one tick before time, blended
+    // from the last two snapshots. Returns false (and leaves tanks alone)
+    // until the first snapshot is out.
+    bool interpolate(Clock::time_point const time, std::vector<Tank_state>& tanks);
+
+    // Render thread, after interpolate(): nothing moved in the snapshots
+    // it blends and they include every command pushed so far, so the next
+    // frames would all look the same until another command.
+    bool is_at_rest() const;
+
+    Clock::duration get_tick_duration() const;
+
+    Simulation_stats get_stats() const;
+
+private:
+    void run();
+
+    // Copies the world into the back snapshot and publishes it.
+    void publish(std::uint64_t const tick, Clock::time_point const time);
+
+    World               m_world;
+    Simulation_settings m_settings;
+    Clock::duration     m_tick_duration;
+
+    std::thread       m_thread;
+    std::atomic<bool> m_is_running;
+
+    // Pushed by any thread, swapped out by the simulation once per tick
+    std::mutex                m_command_mutex;
+    std::vector<Tank_command> m_commands;
+    std::vector<Tank_command> m_tick_commands;
+
+    std::atomic<std::uint64_t> m_pushed_command_count;
+    std::uint64_t              m_applied_command_count;  // Simulation thread only
+
+    utils::Snapshot_buffer<World_snapshot> m_snapshots;
+
+    std::atomic<std::uint64_t> m_tick_count;
+    std::atomic<std::uint64_t> m_dropped_ticks;
+    std::atomic<std::int64_t>  m_step_last_ns;
+    std::atomic<std::int64_t>  m_step_max_ns;
+};
+
+} // tiny_tanks::game
+
+#endif // GAME_SIMULATION_H
@@ -0,0 +1,132 @@
+#ifndef GAME_TILE_MAP_H
+#define GAME_TILE_MAP_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::game {
+
+// ===================================================================
+// Tile map settings
+// -------------------------------------------------------------------
+
+// Index of a tile's picture in the atlas, EMPTY_TILE isn't drawn.
+using Tile = std::uint8_t;
+
+constexpr Tile EMPTY_TILE = 0u;
+
+struct Tile_map_settings {
+
+    // Pixels a tile covers in the world.
+    float tile_size = 16.0f;
+
+    // Tiles per chunk side. Bigger chunks mean fewer draw calls but more
+    // to re-mesh when one of their tiles changes and more drawn off screen.
+    std::size_t chunk_size = 32u;
+
+    // Pixels per tile side in the atlas, which holds the tiles left to
+    // right and top to bottom, tile 1 right after the (unused) tile 0.
+    unsigned atlas_tile_size = 16u;
+};
+
+// Of the last draw().
+struct Tile_map_stats {
+
+    std::size_t chunks_drawn   = 0u;  // One draw call each
+    std::size_t chunks_meshed  = 0u;
+    std::size_t vertices_drawn = 0u;
+    double      mesh_ms        = 0.0;
+};
+
+// ===================================================================
+// class Tile_map
+// -------------------------------------------------------------------
+
+// The map's walls, water, trees... as a grid of tiles drawn from one
+// atlas texture.
+//
+// The map is cut into square chunks of chunk_size tiles, each meshed
+// into its own sf::VertexBuffer (two triangles per tile that isn't
+// empty) and drawn with a single draw call. Changing a tile only marks
+// its chunk, which is re-meshed the next time it is drawn, so a frame
+// destroying a few walls re-uploads a few chunks and not the map.
+//
+// draw() skips the chunks outside the target's view, dirty chunks out
+// of sight stay dirty until they come into view.
+//
+// Falls back to plain vertex arrays kept per chunk where the driver
+// has no vertex buffers.
+class Tile_map final {
+
+public:
+    // All EMPTY_TILE. The atlas must outlive the map.
+    Tile_map(sf::Vector2u const& size, sf::Texture const& atlas, Tile_map_settings const& settings = {});
+
+    Tile_map           (Tile_map const&) = delete;
+    Tile_map& operator=(Tile_map const&) = delete;
+
+    // Every tile at once, row by row, size.x * size.y of them.
+    void set_tiles(std::span<Tile const> const tiles);
+
+    void set_tile(sf::Vector2u const& tile_pos, Tile const tile);
+    Tile get_tile(sf::Vector2u const& tile_pos) const;
+
+    sf::Vector2u get_size() const { return m_size; }
+
+    // Tile under a world position, false outside the map.
+    bool get_tile_pos(sf::Vector2f const& world_pos, sf::Vector2u& tile_pos) const;
+
+    // World space, the map's top left corner at 0, 0 (move it with
+    // states.transform).
+    sf::FloatRect get_bounds() const;
+
+    // Re-meshes the visible dirty chunks, then draws the visible ones.
+    void draw(sf::RenderTarget& target, sf::RenderStates states = sf::RenderStates::Default);
+
+    Tile_map_stats get_stats() const { return m_stats; }
+
+private:
+
+    struct Chunk {
+
+        sf::VertexBuffer        buffer;
+        std::vector<sf::Vertex> vertices;      // Without vertex buffers only
+        std::size_t             vertex_count;
+        bool                    is_dirty;
+    };
+
+    Chunk& get_chunk(sf::Vector2u const& tile_pos);
+
+    void mesh(Chunk& chunk, std::size_t const chunk_x, std::size_t const chunk_y);
+
+    sf::Texture const* m_atlas;
+    Tile_map_settings  m_settings;
+    sf::Vector2u       m_size;
+    std::size_t        m_atlas_columns;
+    std::size_t        m_chunk_columns;
+    std::size_t        m_chunk_rows;
+    bool               m_has_vertex_buffers;
+
+    std::vector<Tile>  m_tiles;   // Row by row
+    std::vector<Chunk> m_chunks;  // Row by row
+
+    std::vector<sf::Vertex> m_mesh_vertices;  // Reused by every mesh()
+
+    Tile_map_stats m_stats;
+};
+
+} // tiny_tanks::game
+
+#endif // GAME_TILE_MAP_H
@@ -0,0 +1,102 @@
+#ifndef GAME_WORLD_H
+#define GAME_WORLD_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::game {
+
+// ===================================================================
+// World settings
+// -------------------------------------------------------------------
+
+constexpr float TANK_SPEED      = 160.0f;  // Pixels per second at full throttle
+constexpr float TANK_TURN_SPEED = 180.0f;  // Degrees per second at full turn
+
+// ===================================================================
+// World state
+// -------------------------------------------------------------------
+
+// What drawing a tank needs.
+struct Tank_state {
+
+    sf::Vector2f position = {};
+    float        heading  = 0.0f;  // Degrees, 0 faces right, clockwise like sf::Transformable
+};
+
+// Driving input for one tank, held until the next command for it.
+struct Tank_command {
+
+    std::size_t tank     = 0u;
+    float       throttle = 0.0f;  // -1 reverse to 1 forward
+    float       turn     = 0.0f;  // -1 left to 1 right
+};
+
+// The world as of one simulation tick.
+struct World_snapshot {
+
+    std::uint64_t                         tick          = 0u;
+    std::chrono::steady_clock::time_point time          = {};     // When the tick was due
+    std::vector<Tank_state>               tanks         = {};
+    bool                                  is_moving     = false;  // A tank drove or turned during the tick
+    std::uint64_t                         command_count = 0u;     // Commands applied up to the tick
+};
+
+// ===================================================================
+// class World
+// -------------------------------------------------------------------
+
+// Everything the simulation advances. Only the simulation thread touches
+// it once the Simulation runs, the render thread sees World_snapshots.
+class World final {
+
+public:
+    World() = default;
+
+    // Returns the tank's index, used by Tank_command.
+    std::size_t add_tank(sf::Vector2f const& position, float const heading = 0.0f);
+
+    std::size_t get_tank_count() const;
+
+    void apply(Tank_command const& command);
+
+    // Advances everything by dt seconds.
+    void step(float const dt);
+
+    // Some tank has throttle or turn, the next step() moves it.
+    bool is_moving() const;
+
+    // Reuses the snapshot's storage, no allocation once it is big enough.
+    void write_snapshot(World_snapshot& snapshot) const;
+
+private:
+
+    struct Tank {
+
+        Tank_state state;
+        float      throttle;
+        float      turn;
+    };
+
+    std::vector<Tank> m_tanks;
+};
+
+// Blends two snapshots tank by tank, t = 0 is from and 1 is to. Headings
+// take the short way round, tanks only in to are taken as they are.
+void interpolate(World_snapshot const& from, World_snapshot const& to, float const t, std::vector<Tank_state>& tanks);
+
+} // tiny_tanks::game
+
+#endif // GAME_WORLD_H
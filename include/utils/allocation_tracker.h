@@ -0,0 +1,65 @@
+#ifndef UTILS_ALLOCATION_TRACKER_H
+#define UTILS_ALLOCATION_TRACKER_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include <cstdint>
+
+// ===================================================================
+// Compile time switch
+// -------------------------------------------------------------------
+
+// 1 replaces the global operator new / delete with counting versions, set
+// from CMake with -DTINY_TANKS_TRACK_ALLOCATIONS=ON. Off by default, the
+// hooks cost a few thread local increments per allocation.
+#ifndef ALLOCATION_TRACKING_COMPILED_IN
+    #define ALLOCATION_TRACKING_COMPILED_IN 0
+#endif
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// struct Allocation_counts
+// -------------------------------------------------------------------
+
+struct Allocation_counts {
+
+    std::uint64_t allocations = 0u;
+    std::uint64_t bytes       = 0u;  // Requested by those allocations
+    std::uint64_t frees       = 0u;
+};
+
+// ===================================================================
+// class Allocation_tracker
+// -------------------------------------------------------------------
+
+// Counts what goes through operator new / delete, per thread and for the
+// whole process. Only C++ allocations are seen, malloc from C libraries
+// (e.g. the GL driver) is not. Everything reads zero when tracking isn't
+// compiled in.
+class Allocation_tracker final {
+
+public:
+    Allocation_tracker() = delete;
+
+    static constexpr bool is_compiled_in() { return ALLOCATION_TRACKING_COMPILED_IN != 0; }
+
+    // Running totals of the calling thread since it started.
+    static Allocation_counts get_thread_counts();
+
+    // Running totals of every thread.
+    static Allocation_counts get_total_counts();
+
+    // What the calling thread allocated since its previous end_frame().
+    static Allocation_counts end_frame();
+};
+
+} // tiny_tanks::utils
+
+#endif // UTILS_ALLOCATION_TRACKER_H
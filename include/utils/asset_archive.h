@@ -0,0 +1,115 @@
+#ifndef UTILS_ASSET_ARCHIVE_H
+#define UTILS_ASSET_ARCHIVE_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/mapped_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// Archive format
+// -------------------------------------------------------------------
+
+// An asset archive is written by Tiny_Tanks_asset_pack at build time:
+//
+//     Asset_archive_header
+//     Asset_archive_entry[table_size]   Open addressing hash table, linear probing
+//     path characters                   Referenced by the entries
+//     file contents                     Each one ASSET_ARCHIVE_ALIGNMENT aligned
+//
+// Paths are stored the way the game asks for them, relative with forward
+// slashes, e.g. "assets/fonts/Pennsylvania.otf". An entry with size and
+// offset both zero is an empty slot.
+
+inline constexpr char          ASSET_ARCHIVE_MAGIC[8]  = { 'T', 'T', 'A', 'S', 'S', 'E', 'T', 'S' };
+inline constexpr std::uint32_t ASSET_ARCHIVE_VERSION   = 1u;
+inline constexpr std::size_t   ASSET_ARCHIVE_ALIGNMENT = 64u;
+
+struct Asset_archive_header {
+
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t entry_count;
+    std::uint32_t table_size;     // Slots in the hash table, a power of two
+    std::uint32_t reserved;
+    std::uint64_t table_offset;
+};
+
+struct Asset_archive_entry {
+
+    std::uint64_t hash;
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint32_t path_offset;
+    std::uint32_t path_size;
+};
+
+static_assert(sizeof(Asset_archive_header) == 32u);
+static_assert(sizeof(Asset_archive_entry)  == 32u);
+
+// 64 bit FNV-1a, shared by the packer and the lookup.
+constexpr std::uint64_t hash_asset_path(std::string_view const path) {
+
+    std::uint64_t hash = 14695981039346656037ull;
+
+    for (char const character : path) {
+
+        hash ^= static_cast<std::uint8_t>(character);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+// ===================================================================
+// class Asset_archive
+// -------------------------------------------------------------------
+
+// A packed asset archive mapped into memory. find() hands out views
+// straight into the mapping, so they (and anything loaded from them with
+// SFML's loadFromMemory / openFromMemory) are valid until close().
+class Asset_archive final {
+
+public:
+    bool open(std::filesystem::path const& path);
+    void close();
+
+    bool is_open() const { return m_file.is_open(); }
+
+    // Empty span if the archive is closed or doesn't hold the path.
+    std::span<std::byte const> find(std::string_view const path) const;
+
+    std::size_t get_entry_count() const;
+
+private:
+    Mapped_file m_file;
+};
+
+// ===================================================================
+// Global archive
+// -------------------------------------------------------------------
+
+// The game's archive, opened by main. Resource loading falls back to the
+// loose files under assets/ for anything it doesn't hold.
+inline Asset_archive& assets() {
+
+    static Asset_archive archive;
+    return archive;
+}
+
+} // tiny_tanks::utils
+
+#endif // UTILS_ASSET_ARCHIVE_H
@@ -41,6 +41,7 @@ inline sf::Color constexpr DEFAULT_WIDGET_BACKGROUND = sf::Color::Blue;
 
 // Fonts
 inline std::string_view const DEFAULT_TEXT_FONT = "assets/fonts/Pennsylvania.otf";
+inline std::string_view const DEFAULT_SDF_FONT  = "assets/fonts/Pennsylvania.sdf";
 
 } // tiny_tanks::utils
 
@@ -0,0 +1,194 @@
+#ifndef UTILS_FRAME_PACER_H
+#define UTILS_FRAME_PACER_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// Frame pacer settings
+// -------------------------------------------------------------------
+
+enum class Frame_pacing {
+
+    Uncapped,     // No vsync, no limit, as fast as it draws
+    Vsync,        // display() waits for the vertical blank
+    Frame_limit,  // SFML's frame limit, display() sleeps to the target rate
+    Adaptive      // Sleeps before reading input, as late as the frame's work allows
+};
+
+struct Frame_pacer_settings {
+
+    Frame_pacing mode = Frame_pacing::Adaptive;
+
+    // Frames per second for Frame_limit and Adaptive.
+    unsigned int target_rate = 60u;
+
+    // Adaptive: how often events are read while sleeping, the arrival
+    // stamp of an event is at most this late.
+    std::chrono::microseconds input_poll_interval = std::chrono::microseconds(1000);
+
+    // Adaptive: the end of the wait is spun instead of slept, sleeps overshoot.
+    std::chrono::microseconds spin_time = std::chrono::microseconds(200);
+
+    // Adaptive: wake this much earlier than the slowest recent frame needs.
+    std::chrono::microseconds safety_margin = std::chrono::microseconds(1000);
+};
+
+// All times in milliseconds.
+struct Frame_pacing_stats {
+
+    std::uint64_t frames = 0u;
+
+    // Between two presents.
+    double interval_mean_ms   = 0.0;
+    double interval_jitter_ms = 0.0;  // Standard deviation
+    double interval_p99_ms    = 0.0;
+
+    // Input to present for input arriving at any moment. Worked out from
+    // when each frame stopped reading input, so it needs no input and
+    // compares modes fairly. The p99 is the oldest input a frame could
+    // have presented.
+    double latency_mean_ms = 0.0;
+    double latency_p99_ms  = 0.0;
+
+    // Input to present for the real input events, from their arrival
+    // stamps. Outside Adaptive an event is stamped when it is polled, so
+    // these read low by up to a frame.
+    std::uint64_t input_frames         = 0u;
+    double        input_latency_p50_ms = 0.0;
+    double        input_latency_p99_ms = 0.0;
+
+    // Adaptive: reading input to present for the slowest recent frame, and
+    // the time spent asleep and spinning before reading input, per frame.
+    double work_estimate_ms = 0.0;
+    double sleep_mean_ms    = 0.0;
+    double spin_mean_ms     = 0.0;
+};
+
+// ===================================================================
+// class Frame_pacer
+// -------------------------------------------------------------------
+
+// Paces frames and measures how late input makes it to the screen.
+// Events are read through the pacer instead of the window, so each one
+// gets an arrival stamp:
+//
+//     pacer.wait_for_input();
+//     while (auto event = pacer.poll_event()) { ... }
+//     ... update, draw, display ...
+//     pacer.frame_presented();
+//
+// In Adaptive mode wait_for_input() sleeps until the latest moment that
+// still leaves the slowest of the recent frames (plus the safety margin)
+// to finish by the next present, reading and stamping events as they
+// arrive meanwhile. Input is then read as late as possible and the CPU
+// sleeps instead of waiting in display(). The other modes leave the
+// waiting to the driver or SFML and only measure.
+//
+// After the loop sat idle (Render_scheduler::wait_event()) call resume(),
+// the idle time is neither latency nor a frame interval.
+class Frame_pacer final {
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit Frame_pacer(sf::Window& window, Frame_pacer_settings const& settings = {});
+
+    // Sets the window's vsync and frame limit to match and starts the stats over.
+    void         set_mode(Frame_pacing const mode);
+    Frame_pacing get_mode(/*----------------*/) const;
+
+    // Adaptive: sleeps until it's time to read input, returns right away otherwise.
+    void wait_for_input();
+
+    // Events read while waiting first, then the window's.
+    std::optional<sf::Event> poll_event();
+
+    // Right after display().
+    void frame_presented();
+
+    void resume();
+
+    Frame_pacing_stats get_stats() const;
+    void               reset_stats();
+
+    static char const* to_string(Frame_pacing const mode);
+
+private:
+
+    static constexpr std::size_t SAMPLE_COUNT      = 512u;
+    static constexpr std::size_t WORK_SAMPLE_COUNT = 32u;
+
+    // The last N samples.
+    template<std::size_t N>
+    struct Sample_ring {
+
+        std::array<double, N> values = {};
+        std::size_t           count  = 0u;
+        std::size_t           next   = 0u;
+
+        void push(double const value) {
+
+            values[next] = value;
+            next         = (next + 1u) % N;
+            count        = (count < N) ? count + 1u : N;
+        }
+    };
+
+    // Reads every event waiting in the window into the queue.
+    void drain_window();
+
+    // Stamps the first input event of a frame.
+    void note_event(sf::Event const& event, Clock::time_point const now);
+
+    Clock::duration get_period       () const;
+    Clock::duration get_work_estimate() const;
+
+    sf::Window&          m_window;
+    Frame_pacer_settings m_settings;
+
+    // Events read while waiting, not handed out yet
+    std::vector<sf::Event> m_queue;
+    std::size_t            m_queue_head;
+
+    std::optional<Clock::time_point> m_last_present;
+    std::optional<Clock::time_point> m_next_present;    // Adaptive: when the next frame should be on screen
+    std::optional<Clock::time_point> m_input_stamp;     // First input event not presented yet
+    std::optional<Clock::time_point> m_drain_time;      // Last time the window had no events left
+    std::optional<Clock::time_point> m_previous_drain;  // The same, one frame earlier
+    Clock::time_point                m_wait_end;        // This frame started reading input
+
+    Sample_ring<SAMPLE_COUNT>      m_intervals;
+    Sample_ring<SAMPLE_COUNT>      m_worst_latencies;
+    Sample_ring<SAMPLE_COUNT>      m_input_latencies;
+    Sample_ring<WORK_SAMPLE_COUNT> m_work_times;
+
+    // Latency for input arriving at any moment, weighted by how long each frame read input
+    double m_latency_weighted_sum;
+    double m_latency_weight;
+
+    std::uint64_t m_frames;
+    std::uint64_t m_input_frames;
+    double        m_sleep_total;
+    double        m_spin_total;
+};
+
+} // tiny_tanks::utils
+
+#endif // UTILS_FRAME_PACER_H
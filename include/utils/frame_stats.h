@@ -0,0 +1,78 @@
+#ifndef UTILS_FRAME_STATS_H
+#define UTILS_FRAME_STATS_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/allocation_tracker.h"
+
+#include <cstdint>
+#include <optional>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// struct Frame_counters
+// -------------------------------------------------------------------
+
+struct Frame_counters {
+
+    std::uint32_t draw_calls    = 0u;
+    std::uint32_t widgets_drawn = 0u;
+
+    // Empty unless allocation tracking is compiled in
+    std::optional<std::uint64_t> allocations     = {};
+    std::optional<std::uint64_t> allocated_bytes = {};
+};
+
+// ===================================================================
+// class Frame_stats
+// -------------------------------------------------------------------
+
+// Per frame counters the drawing code bumps as it goes, read and reset
+// once per frame with end_frame(). Plain counters, only the render
+// thread may touch them. Allocations are the render thread's, counted by
+// Allocation_tracker between two end_frame() calls.
+class Frame_stats final {
+
+public:
+    Frame_stats() = delete;
+
+    static void count_draw_calls(std::uint32_t const count) { s_counters.draw_calls += count; }
+    static void count_widget_drawn()                        { ++s_counters.widgets_drawn; }
+
+    // Returns this frame's counters and starts the next frame from zero.
+    static Frame_counters end_frame() {
+
+        Frame_counters counters = s_counters;
+        s_counters = {};
+
+        if constexpr (Allocation_tracker::is_compiled_in()) {
+
+            Allocation_counts const allocations = Allocation_tracker::end_frame();
+
+            counters.allocations     = allocations.allocations;
+            counters.allocated_bytes = allocations.bytes;
+        }
+
+        return counters;
+    }
+
+private:
+    static Frame_counters s_counters;
+};
+
+// ===================================================================
+// Definitions for static members
+// -------------------------------------------------------------------
+
+inline Frame_counters Frame_stats::s_counters = {};
+
+} // tiny_tanks::utils
+
+#endif // UTILS_FRAME_STATS_H
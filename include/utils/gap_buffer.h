@@ -0,0 +1,148 @@
+#ifndef UTILS_GAP_BUFFER_H
+#define UTILS_GAP_BUFFER_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// class Gap_buffer
+// -------------------------------------------------------------------
+
+// A vector with a hole at the last edit. Inserting or erasing at the gap
+// only touches the values edited, moving the gap costs the distance it
+// moves, so edits that stay close together (typing) are O(1) however
+// big the buffer is. Indices are logical, the gap is never visible.
+template<typename Value_type>
+class Gap_buffer final {
+
+    static_assert(std::is_trivially_copyable_v<Value_type>, "Gap_buffer values are moved with plain copies");
+
+public:
+    Gap_buffer() = default;
+
+    std::size_t size    () const { return m_values.size() - get_gap_size(); }
+    bool        empty   () const { return size() == 0u; }
+    std::size_t capacity() const { return m_values.size(); }
+
+    Value_type const& operator[](std::size_t const index) const { return m_values[get_storage_index(index)]; }
+    Value_type&       operator[](std::size_t const index)       { return m_values[get_storage_index(index)]; }
+
+    std::size_t get_gap_position() const { return m_gap_begin; }
+
+    void move_gap(std::size_t const position) {
+
+        if (position < m_gap_begin) {
+
+            // Values [position, gap) go to the end of the gap
+            std::copy_backward(m_values.begin() + static_cast<std::ptrdiff_t>(position),
+                               m_values.begin() + static_cast<std::ptrdiff_t>(m_gap_begin),
+                               m_values.begin() + static_cast<std::ptrdiff_t>(m_gap_end));
+
+            m_gap_end   -= m_gap_begin - position;
+            m_gap_begin  = position;
+
+        } else if (position > m_gap_begin) {
+
+            // Values after the gap, up to position, go to its start
+            std::size_t const count = position - m_gap_begin;
+
+            std::copy_n(m_values.begin() + static_cast<std::ptrdiff_t>(m_gap_end), count,
+                        m_values.begin() + static_cast<std::ptrdiff_t>(m_gap_begin));
+
+            m_gap_begin += count;
+            m_gap_end   += count;
+        }
+    }
+
+    void insert(std::size_t const position, Value_type const* const values, std::size_t const count) {
+
+        if (get_gap_size() < count) {
+
+            grow(count);
+        }
+
+        move_gap(position);
+
+        std::copy_n(values, count, m_values.begin() + static_cast<std::ptrdiff_t>(m_gap_begin));
+        m_gap_begin += count;
+    }
+
+    void insert(std::size_t const position, Value_type const& value) {
+
+        insert(position, &value, 1u);
+    }
+
+    void erase(std::size_t const position, std::size_t const count) {
+
+        move_gap(position);
+        m_gap_end += count;
+    }
+
+    // Keeps the memory.
+    void clear() {
+
+        m_gap_begin = 0u;
+        m_gap_end   = m_values.size();
+    }
+
+    void reserve(std::size_t const capacity) {
+
+        if (capacity > size()) {
+
+            grow(capacity - size());
+        }
+    }
+
+    // Copies [position, position + count) out, two copies at most.
+    void copy(std::size_t const position, std::size_t const count, Value_type* const out) const {
+
+        std::size_t const before = (position < m_gap_begin) ? std::min(count, m_gap_begin - position) : 0u;
+
+        std::copy_n(m_values.begin() + static_cast<std::ptrdiff_t>(position), before, out);
+        std::copy_n(m_values.begin() + static_cast<std::ptrdiff_t>(get_storage_index(position + before)), count - before, out + before);
+    }
+
+private:
+
+    std::size_t get_gap_size() const { return m_gap_end - m_gap_begin; }
+
+    std::size_t get_storage_index(std::size_t const index) const {
+
+        return (index < m_gap_begin) ? index : index + get_gap_size();
+    }
+
+    // Doubles at least, so appending stays amortised O(1).
+    void grow(std::size_t const min_gap_size) {
+
+        std::size_t const after    = m_values.size() - m_gap_end;
+        std::size_t const capacity = std::max({ m_values.size() * 2u, size() + min_gap_size, std::size_t{ 64u } });
+
+        std::vector<Value_type> values(capacity);
+
+        std::copy_n(m_values.begin(), m_gap_begin, values.begin());
+        std::copy_n(m_values.begin() + static_cast<std::ptrdiff_t>(m_gap_end), after, values.end() - static_cast<std::ptrdiff_t>(after));
+
+        m_values.swap(values);
+        m_gap_end = m_values.size() - after;
+    }
+
+    std::vector<Value_type> m_values;
+    std::size_t             m_gap_begin = 0u;
+    std::size_t             m_gap_end   = 0u;
+};
+
+} // tiny_tanks::utils
+
+#endif // UTILS_GAP_BUFFER_H
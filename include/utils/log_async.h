@@ -0,0 +1,86 @@
+#ifndef UTILS_LOG_ASYNC_H
+#define UTILS_LOG_ASYNC_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/log_record.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// ===================================================================
+// Enums
+// -------------------------------------------------------------------
+
+// What a logging thread does when its ring buffer is full.
+enum class Log_overflow_policy {
+
+    Drop,  // Discard the record and count it, never wait on the writer
+    Block  // Sleep until the writer makes room, only records still blocked in stop() are lost
+};
+
+// ===================================================================
+// struct Log_async_settings
+// -------------------------------------------------------------------
+
+struct Log_async_settings {
+
+    // Records per thread, rounded up to a power of two.
+    std::size_t ring_capacity = 1024u;
+
+    Log_overflow_policy overflow_policy = Log_overflow_policy::Drop;
+
+    // Empty means stdout, otherwise the file is truncated and written to.
+    std::filesystem::path file_path = {};
+
+    // How long the writer sleeps between drains when nobody wakes it.
+    std::chrono::milliseconds flush_interval = std::chrono::milliseconds(5);
+};
+
+// ===================================================================
+// class Log_async
+// -------------------------------------------------------------------
+
+// Optional back end for Logger. While running, every LOG(...) moves its
+// finished record into a lock free ring owned by the calling thread and
+// returns. A single writer thread drains all rings in batches and does
+// the formatting, locking and console/file output instead.
+class Log_async final {
+
+public:
+    Log_async() = delete;
+
+    // Starts the writer thread. Does nothing if it is already running.
+    static bool start(Log_async_settings const& settings);
+
+    // Drains everything still queued, then joins the writer thread.
+    // Call once all other logging threads are done.
+    static void stop();
+
+    // Blocks until every record pushed before this call has been written.
+    static void flush();
+
+    static bool is_running() { return s_is_running.load(std::memory_order_acquire); }
+
+    // Returns false if the record was dropped because the ring was full.
+    static bool push(Log_record&& record);
+
+    // Total records dropped since start(), under Drop or by stop() under Block.
+    static std::uint64_t get_dropped_count();
+
+private:
+    static std::atomic<bool> s_is_running;
+};
+
+// ===================================================================
+// Definitions for static members
+// -------------------------------------------------------------------
+
+inline std::atomic<bool> Log_async::s_is_running = false;
+
+#endif // UTILS_LOG_ASYNC_H
@@ -0,0 +1,363 @@
+#ifndef UTILS_LOG_BINARY_H
+#define UTILS_LOG_BINARY_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/log_record.h"
+#include "utils/logger.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <ostream>
+#include <source_location>
+#include <span>
+#include <sstream>
+#include <string_view>
+#include <type_traits>
+
+// ===================================================================
+// Binary log format
+// -------------------------------------------------------------------
+
+// A binary log (the mapped file or a flight recorder dump) is one
+// Log_binary_file_header followed by 8 byte aligned records. Each record
+// starts with a Log_binary_record_header, its first word is written last
+// so a zero word marks the end of the committed records.
+//
+// Site records describe a LOG_BIN call site once (level, line, file and
+// function), message records only carry the site id, a timestamp and the
+// raw << arguments, each as a Log_arg tag followed by its bytes.
+
+inline constexpr char          LOG_BINARY_MAGIC[8]    = { 'T', 'T', 'L', 'O', 'G', 'B', 'I', 'N' };
+inline constexpr std::uint32_t LOG_BINARY_VERSION     = 1u;
+inline constexpr std::size_t   LOG_BINARY_MAX_RECORD  = 256u;
+inline constexpr std::size_t   LOG_BINARY_ALIGNMENT   = 8u;
+inline constexpr std::uint32_t LOG_BINARY_INVALID_SITE = 0xFFFFFFFFu;
+
+enum class Log_record_kind : std::uint8_t {
+
+    Site    = 1u,
+    Message = 2u
+};
+
+enum class Log_arg : std::uint8_t {
+
+    Int       = 1u,  // std::int64_t
+    Uint      = 2u,  // std::uint64_t
+    Float     = 3u,  // double
+    Bool      = 4u,  // std::uint8_t
+    Char      = 5u,  // char
+    String    = 6u,  // std::uint16_t length, then the characters
+    Truncated = 7u   // Nothing follows, the message ran out of room
+};
+
+struct Log_binary_file_header {
+
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;
+
+    // system_clock at start, in nanoseconds since its epoch. Record
+    // timestamps are steady_clock nanoseconds relative to this moment.
+    std::int64_t  wall_clock_base_ns;
+    std::int64_t  reserved;
+};
+
+struct Log_binary_record_header {
+
+    std::uint32_t size_and_kind;  // Size in bytes (header included) in the low 24 bits, kind in the high 8
+    std::uint32_t site_id;
+    std::uint64_t timestamp_ns;
+};
+
+// Payload of a Site record, the file and function names follow it.
+struct Log_binary_site_payload {
+
+    std::uint32_t level;
+    std::uint32_t line;
+    std::uint32_t file_size;
+    std::uint32_t function_size;
+};
+
+static_assert(sizeof(Log_binary_file_header)   == 32u);
+static_assert(sizeof(Log_binary_record_header) == 16u);
+
+// ===================================================================
+// struct Log_binary_settings
+// -------------------------------------------------------------------
+
+struct Log_binary_settings {
+
+    // Empty means flight recorder only, nothing is written to disk until a crash.
+    std::filesystem::path file_path = {};
+
+    // Size the mapped file is created with, records past it are dropped and counted.
+    std::size_t file_capacity = 64u * 1024u * 1024u;
+
+    // Empty means no signal/terminate handlers are installed.
+    std::filesystem::path crash_dump_path = {};
+};
+
+// ===================================================================
+// class Log_binary
+// -------------------------------------------------------------------
+
+// Deferred format sink for LOG_BIN. Records are a memcpy into a fixed
+// in-memory ring of the most recent records (the flight recorder) and,
+// when a file is set, into a memory mapped file. Nothing is formatted
+// until Tiny_Tanks_log_decode turns a file or dump back into text.
+class Log_binary final {
+
+public:
+    Log_binary() = delete;
+
+    static bool start(Log_binary_settings const& settings);
+    static void stop();
+
+    static bool is_running() { return s_is_running.load(std::memory_order_relaxed); }
+
+    // Called once per LOG_BIN call site, returns the id its records refer to.
+    static std::uint32_t register_site(Log_lvl const level, std::source_location const& location);
+
+    static void write(std::uint32_t const site_id, std::byte const* const args, std::size_t const args_size);
+
+    // Writes the flight recorder ring to path in the same format as the mapped file.
+    static bool dump_flight_recorder(std::filesystem::path const& path);
+
+    // Records that did not fit in the mapped file since start().
+    static std::uint64_t get_dropped_count();
+
+    // Prints the << arguments of a message record the way Logger's ostringstream would have.
+    static void format_args(std::ostream& out, std::span<std::byte const> args);
+
+private:
+    static std::atomic<bool> s_is_running;
+};
+
+// ===================================================================
+// class Binary_logger
+// -------------------------------------------------------------------
+
+// The LOG_BIN counterpart of Logger. Arguments are copied as raw bytes
+// into an inline buffer, no allocation and no formatting. If the binary
+// sink is not running the record falls back to the normal text path.
+class Binary_logger final {
+
+public:
+    Binary_logger(Log_lvl const level, std::uint32_t const site_id, std::source_location const loc)
+        : _level   (level  )
+        , _site_id (site_id)
+        , _location(loc    )
+        , _size    (0u     )
+        , _is_truncated(false)
+    {}
+
+    ~Binary_logger() {
+
+        if (_is_truncated) {
+
+            // One byte is always kept free for this tag.
+            _args[_size++] = static_cast<std::byte>(Log_arg::Truncated);
+        }
+
+        if (Log_binary::is_running()) {
+
+            Log_binary::write(_site_id, _args.data(), _size);
+        } else {
+
+            std::ostringstream message;
+            Log_binary::format_args(message, std::span<std::byte const>(_args.data(), _size));
+
+            Logger::submit(Log_record{ _level, _location, std::chrono::system_clock::now(), std::move(message).str() });
+        }
+    }
+
+    Binary_logger           (Binary_logger const&) = delete;
+    Binary_logger& operator=(Binary_logger const&) = delete;
+    Binary_logger           (Binary_logger&&     ) = delete;
+    Binary_logger& operator=(Binary_logger&&     ) = delete;
+
+public:
+    template<typename Input_type>
+    Binary_logger& operator<<(Input_type const& value) {
+
+        using Type = std::remove_cv_t<Input_type>;
+
+        if constexpr (std::is_same_v<Type, bool>) {
+
+            _put(Log_arg::Bool, static_cast<std::uint8_t>(value));
+
+        } else if constexpr (std::is_same_v<Type, char> || std::is_same_v<Type, signed char> || std::is_same_v<Type, unsigned char>) {
+
+            _put(Log_arg::Char, static_cast<char>(value));
+
+        } else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) {
+
+            _put(Log_arg::Int, static_cast<std::int64_t>(value));
+
+        } else if constexpr (std::is_integral_v<Type>) {
+
+            _put(Log_arg::Uint, static_cast<std::uint64_t>(value));
+
+        } else if constexpr (std::is_enum_v<Type>) {
+
+            _put(Log_arg::Int, static_cast<std::int64_t>(value));
+
+        } else if constexpr (std::is_floating_point_v<Type>) {
+
+            _put(Log_arg::Float, static_cast<double>(value));
+
+        } else if constexpr (std::is_convertible_v<Input_type const&, std::string_view>) {
+
+            _put_string(std::string_view(value));
+
+        } else {
+
+            // Anything else is formatted now, this is the slow path.
+            std::ostringstream text;
+            text << value;
+            _put_string(text.str());
+        }
+
+        // Allows chaining << ... << ... << ...etc.
+        return *this;
+    }
+
+private:
+    // Room for the record header in the ring slot, and one byte for Log_arg::Truncated.
+    static constexpr std::size_t s_capacity = LOG_BINARY_MAX_RECORD - sizeof(Log_binary_record_header) - 1u;
+
+    Log_lvl                                        _level;
+    std::uint32_t                                  _site_id;
+    std::source_location                           _location;
+    std::array<std::byte, s_capacity + 1u>         _args;
+    std::size_t                                    _size;
+    bool                                           _is_truncated;
+
+    template<typename Value_type>
+    void _put(Log_arg const tag, Value_type const value) {
+
+        if (_is_truncated || _size + 1u + sizeof(Value_type) > s_capacity) {
+
+            _is_truncated = true;
+            return;
+        }
+
+        _args[_size] = static_cast<std::byte>(tag);
+        std::memcpy(_args.data() + _size + 1u, &value, sizeof(Value_type));
+        _size += 1u + sizeof(Value_type);
+    }
+
+    void _put_string(std::string_view text) {
+
+        std::size_t const header_size = 1u + sizeof(std::uint16_t);
+
+        if (_is_truncated || _size + header_size > s_capacity) {
+
+            _is_truncated = true;
+            return;
+        }
+
+        // Keep as much of the string as fits.
+        if (text.size() > s_capacity - _size - header_size) {
+
+            text          = text.substr(0u, s_capacity - _size - header_size);
+            _is_truncated = true;
+        }
+
+        std::uint16_t const length = static_cast<std::uint16_t>(text.size());
+
+        _args[_size] = static_cast<std::byte>(Log_arg::String);
+        std::memcpy(_args.data() + _size + 1u, &length, sizeof(length));
+        std::memcpy(_args.data() + _size + header_size, text.data(), text.size());
+        _size += header_size + text.size();
+    }
+};
+
+// ===================================================================
+// Inline definitions
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+inline void Log_binary::format_args(std::ostream& out, std::span<std::byte const> args) {
+
+    // Reads a value that may not be aligned, returns false if args ran out.
+    auto read = [&args](auto& value) {
+
+        if (args.size() < sizeof(value)) {
+
+            return false;
+        }
+
+        std::memcpy(&value, args.data(), sizeof(value));
+        args = args.subspan(sizeof(value));
+
+        return true;
+    };
+
+    std::uint8_t tag = 0u;
+
+    while (read(tag)) {
+
+        switch (static_cast<Log_arg>(tag)) {
+
+        case Log_arg::Int:   { std::int64_t  value = 0;     if (!read(value)) { return; } out << value;                  break; }
+        case Log_arg::Uint:  { std::uint64_t value = 0u;    if (!read(value)) { return; } out << value;                  break; }
+        case Log_arg::Float: { double        value = 0.0;   if (!read(value)) { return; } out << value;                  break; }
+        case Log_arg::Bool:  { std::uint8_t  value = 0u;    if (!read(value)) { return; } out << (value != 0u);          break; }
+        case Log_arg::Char:  { char          value = '\0';  if (!read(value)) { return; } out << value;                  break; }
+
+        case Log_arg::String: {
+
+            std::uint16_t length = 0u;
+
+            if (!read(length) || args.size() < length) {
+
+                return;
+            }
+
+            out.write(reinterpret_cast<char const*>(args.data()), static_cast<std::streamsize>(length));
+            args = args.subspan(length);
+            break;
+        }
+
+        case Log_arg::Truncated: out << "..."; return;
+
+        default: return; // Unknown tag, the rest can't be trusted
+        }
+    }
+}
+
+// ===================================================================
+// Macros
+// -------------------------------------------------------------------
+
+// Same filtering as LOG, except that while Log_binary is running every level
+// that is compiled in is recorded (it is cheap enough to leave TRACE on) and
+// the channel levels are applied later by whoever reads the log.
+// The lambda gives every call site its own static id, registered on first use.
+#define LOG_BIN(level)                                                                        \
+    !(std::bool_constant<Log_filter::is_compiled_in(level, __FILE__)>::value &&               \
+      (Log_binary::is_running() || LOG_CHANNEL().is_enabled(level)))                          \
+        ? (void)0                                                                             \
+        : Log_voidify() & Binary_logger(                                                      \
+            level,                                                                            \
+            [](std::source_location const& site_location) {                                   \
+                static std::uint32_t const site_id = Log_binary::register_site(level, site_location); \
+                return site_id;                                                               \
+            }(std::source_location::current()),                                               \
+            std::source_location::current())
+
+// ===================================================================
+// Definitions for static members
+// -------------------------------------------------------------------
+
+inline std::atomic<bool> Log_binary::s_is_running = false;
+
+#endif // UTILS_LOG_BINARY_H
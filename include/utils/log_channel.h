@@ -0,0 +1,100 @@
+#ifndef UTILS_LOG_CHANNEL_H
+#define UTILS_LOG_CHANNEL_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/log_record.h"
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// ===================================================================
+// class Log_channel
+// -------------------------------------------------------------------
+
+// The enabled levels of one source file. LOG caches a reference to its
+// file's channel, so filtering a record is a single relaxed load.
+class Log_channel final {
+
+public:
+    Log_channel(std::string name, int const mask)
+        : m_name(std::move(name))
+        , m_mask(mask)
+    {}
+
+    Log_channel           (Log_channel const&) = delete;
+    Log_channel& operator=(Log_channel const&) = delete;
+
+    bool is_enabled(Log_lvl const level) const {
+
+        return (m_mask.load(std::memory_order_relaxed) & level) == level;
+    }
+
+    std::string_view get_name() const { return m_name; }
+
+    int  get_mask(/*------------*/) const { return m_mask.load(std::memory_order_relaxed); }
+    void set_mask(int const mask)         { m_mask.store(mask, std::memory_order_relaxed); }
+
+private:
+    std::string      m_name;
+    std::atomic<int> m_mask;
+};
+
+// ===================================================================
+// class Log_channels
+// -------------------------------------------------------------------
+
+// Registry of every Log_channel, keyed by file name (e.g. "label.cpp").
+//
+// A new channel starts from the extern ENABLED_LOG_LVLS and
+// LOG_SPECIFIC_FILE_ONLY settings. A config file can override them at
+// runtime, one "name = LEVEL|LEVEL" per line, "*" for every other file:
+//
+//     # log_levels.cfg
+//     *         = WARNING|ERROR
+//     label.cpp = ALL
+//
+// Level names are TRACE, DEBUG, INFO, WARNING, ERROR, ALL and NONE.
+class Log_channels final {
+
+public:
+    Log_channels() = delete;
+
+    // Finds or creates the channel, the reference stays valid for the whole program.
+    static Log_channel& get(std::string_view const name);
+
+    // Overrides the levels of one channel, or of every unlisted one with "*".
+    static void set_mask(std::string_view const name, int const mask);
+
+    // Applies a config file, returns false if it could not be read.
+    // Lines that don't parse are skipped with a warning.
+    static bool load_config(std::filesystem::path const& path);
+
+    // Loads the config now and again from poll() whenever the file changes
+    // or, on POSIX, the process receives SIGHUP.
+    static void watch_config(std::filesystem::path const& path);
+
+    // Cheap enough to call once a frame, only touches the disk every half second.
+    static void poll();
+
+    // "DEBUG|INFO" to a mask, returns false on an unknown name.
+    static bool parse_mask(std::string_view const text, int& mask);
+};
+
+// ===================================================================
+// Macros
+// -------------------------------------------------------------------
+
+// The channel of the file this expands in, looked up once per call site.
+#define LOG_CHANNEL()                                                                         \
+    []() -> Log_channel const& {                                                              \
+        static Log_channel const& channel = Log_channels::get(Log_filter::file_name(__FILE__)); \
+        return channel;                                                                       \
+    }()
+
+#endif // UTILS_LOG_CHANNEL_H
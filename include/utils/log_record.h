@@ -0,0 +1,55 @@
+#ifndef UTILS_LOG_RECORD_H
+#define UTILS_LOG_RECORD_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include <chrono>
+#include <source_location>
+#include <string>
+
+// ===================================================================
+// Enums
+// -------------------------------------------------------------------
+
+enum Log_lvl {
+
+    TRACE    = 1u << 0u,  // Gray         Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 0 0 1
+    DEBUG    = 1u << 1u,  // Cyan         Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 0 1 0
+    INFO     = 1u << 2u,  // Green        Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 1 0 0
+    WARNING  = 1u << 3u,  // Yellow       Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 1 0 0 0
+    ERROR    = 1u << 4u,  // Red          Bits: ...0 0 0 0 0 0 0 0  0 0 0 1 0 0 0 0
+//  CRITICAL = 1u << 5u,  // Bright red   Bits: ...0 0 0 0 0 0 0 0  0 0 1 0 0 0 0 0
+//  SUCCESS  = 1u << 6u,  // Bright green Bits: ...0 0 0 0 0 0 0 0  0 1 0 0 0 0 0 0
+//  UPDATE   = 1u << 7u,  // Blue         Bits: ...0 0 0 0 0 0 0 0  1 0 0 0 0 0 0 0
+//  FATAL    = 1u << 8u,  // Magenta      Bits: ...0 0 0 0 0 0 0 1  0 0 0 0 0 0 0 0
+
+    ALL_LOG_LVLS = TRACE   | //           Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 0 0 1
+                   DEBUG   | //           Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 0 1 1
+                   INFO    | //           Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 1 1 1
+                   WARNING | //           Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 1 1 1 1
+                   ERROR,    //           Bits: ...0 0 0 0 0 0 0 0  0 0 0 1 1 1 1 1
+//                 CRITICAL| //           Bits: ...0 0 0 0 0 0 0 0  0 0 1 1 1 1 1 1
+//                 SUCCESS | //           Bits: ...0 0 0 0 0 0 0 0  0 1 1 1 1 1 1 1
+//                 UPDATE  | //           Bits: ...0 0 0 0 0 0 0 0  1 1 1 1 1 1 1 1
+//                 FATAL,    //           Bits: ...0 0 0 0 0 0 0 1  1 1 1 1 1 1 1 1
+
+    NO_LOG_LVLS = 0u         //           Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 0 0 0
+};
+
+// ===================================================================
+// struct Log_record
+// -------------------------------------------------------------------
+
+// A finished log line. Everything needed to print it later is captured
+// by value at the call site, so formatting can happen on any thread.
+struct Log_record {
+
+    Log_lvl                               level    = Log_lvl::NO_LOG_LVLS;
+    std::source_location                  location = {};
+    std::chrono::system_clock::time_point time     = {};
+    std::string                           message  = {};
+};
+
+#endif // UTILS_LOG_RECORD_H
@@ -5,50 +5,80 @@
 // Includes
 // -------------------------------------------------------------------
 
+#include "utils/log_async.h"
+#include "utils/log_channel.h"
+#include "utils/log_record.h"
+
 #include <chrono>
+#include <cstdint>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
 #include <mutex>
+#include <ostream>
 #include <source_location>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 // ===================================================================
-// Enums
+// Extern logging settings
 // -------------------------------------------------------------------
 
-enum Log_lvl {
-
-    TRACE    = 1u << 0u,  // Gray         Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 0 0 1
-    DEBUG    = 1u << 1u,  // Cyan         Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 0 1 0
-    INFO     = 1u << 2u,  // Green        Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 1 0 0
-    WARNING  = 1u << 3u,  // Yellow       Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 1 0 0 0
-    ERROR    = 1u << 4u,  // Red          Bits: ...0 0 0 0 0 0 0 0  0 0 0 1 0 0 0 0
-//  CRITICAL = 1u << 5u,  // Bright red   Bits: ...0 0 0 0 0 0 0 0  0 0 1 0 0 0 0 0
-//  SUCCESS  = 1u << 6u,  // Bright green Bits: ...0 0 0 0 0 0 0 0  0 1 0 0 0 0 0 0
-//  UPDATE   = 1u << 7u,  // Blue         Bits: ...0 0 0 0 0 0 0 0  1 0 0 0 0 0 0 0
-//  FATAL    = 1u << 8u,  // Magenta      Bits: ...0 0 0 0 0 0 0 1  0 0 0 0 0 0 0 0
-
-    ALL_LOG_LVLS = TRACE   | //           Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 0 0 1
-                   DEBUG   | //           Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 0 1 1
-                   INFO    | //           Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 1 1 1
-                   WARNING | //           Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 1 1 1 1
-                   ERROR,    //           Bits: ...0 0 0 0 0 0 0 0  0 0 0 1 1 1 1 1
-//                 CRITICAL| //           Bits: ...0 0 0 0 0 0 0 0  0 0 1 1 1 1 1 1
-//                 SUCCESS | //           Bits: ...0 0 0 0 0 0 0 0  0 1 1 1 1 1 1 1
-//                 UPDATE  | //           Bits: ...0 0 0 0 0 0 0 0  1 1 1 1 1 1 1 1
-//                 FATAL,    //           Bits: ...0 0 0 0 0 0 0 1  1 1 1 1 1 1 1 1
-
-    NO_LOG_LVLS = 0u         //           Bits: ...0 0 0 0 0 0 0 0  0 0 0 0 0 0 0 0
-};
+extern int              const ENABLED_LOG_LVLS;
+extern std::string_view const LOG_SPECIFIC_FILE_ONLY;
 
 // ===================================================================
-// Extern logging settings
+// Compile time logging settings
 // -------------------------------------------------------------------
 
-extern int              const ENABLED_LOG_LVLS;
-extern std::string_view const LOG_SPECIFIC_FILE_ONLY;
+// Levels and file compiled into the binary. A LOG(...) they exclude is
+// dead code, its << arguments are never evaluated. Set them with the
+// TINY_TANKS_LOG_COMPILED_* CMake options or e.g.
+//     -DLOG_COMPILED_LVLS="(WARNING|ERROR)" -DLOG_COMPILED_FILE_ONLY="\"label.cpp\""
+// Whatever is compiled in is then filtered at runtime by its file's
+// Log_channel (see utils/log_channel.h), which starts from the extern
+// settings above.
+
+#ifndef LOG_COMPILED_LVLS
+    #define LOG_COMPILED_LVLS Log_lvl::ALL_LOG_LVLS
+#endif
+
+#ifndef LOG_COMPILED_FILE_ONLY
+    #define LOG_COMPILED_FILE_ONLY "ALL"
+#endif
+
+// ===================================================================
+// struct Log_filter
+// -------------------------------------------------------------------
+
+struct Log_filter final {
+
+    // File name without its directories, handles both Windows and Unix paths.
+    static constexpr std::string_view file_name(std::string_view const path) {
+
+        size_t const last_slash = path.find_last_of("/\\");
+
+        if (last_slash == std::string_view::npos) {
+
+            return path;
+        } else {
+
+            return path.substr(last_slash + 1u);
+        }
+    }
+
+    static constexpr bool is_compiled_in(Log_lvl const level, std::string_view const path) {
+
+        bool const is_lvl_compiled_in  = (static_cast<int>(LOG_COMPILED_LVLS) & level) == level;
+        std::string_view const only    = LOG_COMPILED_FILE_ONLY;
+        bool const is_file_compiled_in = (only == "ALL") || (file_name(path) == only);
+
+        return is_lvl_compiled_in && is_file_compiled_in;
+    }
+};
 
 // ===================================================================
 // class Logger
@@ -64,7 +94,8 @@ public:
 
     ~Logger() {
 
-        bool const is_buffer_empty = _buffer.str().empty();
+        // Checks the write position rather than copying the buffer out.
+        bool const is_buffer_empty = (_buffer.tellp() == std::streampos(0));
         if (is_buffer_empty) {
 
             // No need to flush since buffer is empty.
@@ -97,41 +128,78 @@ public:
         return *this;
     }
 
-private:
-    void _flush() {
+public:
+    // Prints a record in the [LEVEL]/[Time]/[File]/[Line]/... layout.
+    // Used by the synchronous path and by the Log_async writer thread.
+    static void write_record(std::ostream& out, Log_record const& record, bool const use_color) {
+
+        write_record(out,
+                     record.level,
+                     record.time,
+                     record.location.file_name(),
+                     record.location.line(),
+                     record.location.function_name(),
+                     record.message,
+                     use_color);
+    }
 
-        // Lock the mutex so no other Logger objects can log till this is finished.
-        // Unlocks automatically when this function is out of scope.
-        std::lock_guard<std::mutex> lock(s_mutex);
+    // Same layout from loose fields, for records that were not built from a
+    // std::source_location (e.g. decoded binary logs).
+    static void write_record(
+        std::ostream&                               out,
+        Log_lvl                               const level,
+        std::chrono::system_clock::time_point const time,
+        std::string_view                      const file_path,
+        std::uint_least32_t                   const line,
+        std::string_view                      const function,
+        std::string_view                      const message,
+        bool                                  const use_color
+        ) {
+
+        char const* const reset_color = "\033[0m"; // Reset color
+
+        out << (use_color ? _get_color(level) : "")              << '\n'
+            << '['           << _level_to_str(level)             << "]\n"
+            << "[Time: "     << _curr_time(time)                 << "]\n"
+            << "[File: "     << Log_filter::file_name(file_path) << "]\n"
+            << "[Line: "     << line                             << "]\n"
+            << "[Function: " << function                         << "]\n"
+            << "[Logger: "   << message                          << "]\n"
+            << (use_color ? reset_color : "")                    << '\n';
+    }
 
-        // Only flush if the log level is enabled right now.
-        if (_is_log_lvl_enabled(_level)) {
+    // Prints a finished record now, or queues it when Log_async is running.
+    // Filtering has already happened in the LOG macros.
+    static void submit(Log_record&& record) {
 
-            // Only show logs for allowed files.
-            if (_is_file_allowed()) {
+        if (Log_async::is_running()) {
 
-                char const* const reset_color = "\033[0m"; // Reset color
+            // Hand the record to the writer thread, it does the locking and printing.
+            Log_async::push(std::move(record));
+        } else {
 
-                // Output the buffer log to the console.
-                std::cout << _get_color()   << /*---------------------*/     '\n'
-                          << '['            << _level_to_str(_level)     << "]\n"
-                          << "[Time: "      << _curr_time()              << "]\n"
-                          << "[File: "      << _get_file()               << "]\n"
-                          << "[Line: "      << _location.line()          << "]\n"
-                          << "[Function: "  << _location.function_name() << "]\n"
-                          << "[Logger: "       << _buffer.str()             << "]\n"
-                          << reset_color    << std::endl;
+            // Lock the mutex so no other Logger objects can log till this is finished.
+            // Unlocks automatically when this function is out of scope.
+            std::lock_guard<std::mutex> lock(s_mutex);
 
-                // Reset the buffer (not really needed since object gets deleted).
-                _buffer.str("");
-                _buffer.clear();
-            }
+            // Output the log to the console.
+            write_record(std::cout, record, true);
+            std::cout.flush();
         }
     }
 
-    const char* _get_color() const {
+private:
+    void _flush() {
+
+        // Level and file were already checked by the LOG macro before anything was formatted.
+
+        // Capture everything by value, the buffer is moved out rather than copied.
+        submit(Log_record{ _level, _location, std::chrono::system_clock::now(), std::move(_buffer).str() });
+    }
+
+    static const char* _get_color(Log_lvl const level) {
 
-        switch (_level) {
+        switch (level) {
 
         case Log_lvl::TRACE:    return "\033[90m"; // Gray
         case Log_lvl::DEBUG:    return "\033[36m"; // Cyan
@@ -147,29 +215,7 @@ private:
         }
     }
 
-    std::string _get_file() const {
-
-        std::string const full_filepath = _location.file_name();
-
-        // Find the last slash (handles both Windows and Unix paths)
-        size_t last_slash = full_filepath.find_last_of("/\\");
-
-        // If no slash found, use the entire path as filename
-        if (last_slash == std::string::npos) {
-
-            last_slash = 0u;
-        } else {
-
-            // Move past the slash
-            ++last_slash;
-        }
-
-        std::string const file = full_filepath.substr(last_slash);
-
-        return file;
-    }
-
-    const char* _level_to_str(Log_lvl const level) const {
+    static const char* _level_to_str(Log_lvl const level) {
 
         switch (level) {
 
@@ -187,10 +233,9 @@ private:
         }
     }
 
-    std::string _curr_time() const {
+    static std::string _curr_time(std::chrono::system_clock::time_point const time_point) {
 
-        auto const time_point_now  = std::chrono::system_clock::now();
-        auto const time_now        = std::chrono::system_clock::to_time_t(time_point_now);
+        auto const time_now        = std::chrono::system_clock::to_time_t(time_point);
         std::ostringstream time_stream{};
 
         // If we are using windows then use the non standard windows safer localtime_s function.
@@ -209,35 +254,31 @@ private:
         return time_stream.str();
     }
 
-    bool _is_log_lvl_enabled(Log_lvl const log_lvl) const {
-
-        bool const is_enabled = (ENABLED_LOG_LVLS & log_lvl) == log_lvl;
-        return     is_enabled;
-    }
-
-    bool _is_file_allowed() const {
-
-        std::string const file            = _get_file();
-        bool              is_file_allowed = true;
-
-        if (LOG_SPECIFIC_FILE_ONLY == "ALL") {
-
-            is_file_allowed = true;
-        } else {
+};
 
-            is_file_allowed = (file == LOG_SPECIFIC_FILE_ONLY);
-        }
+// ===================================================================
+// struct Log_voidify
+// -------------------------------------------------------------------
 
-        return is_file_allowed;
-    }
+struct Log_voidify final {
 
+    template<typename Logger_type>
+    void operator&(Logger_type const&) const {}
 };
 
 // ===================================================================
 // Macros
 // -------------------------------------------------------------------
 
-#define LOG(level) Logger(level, std::source_location::current())
+// The condition is checked before the Logger is built, so a disabled LOG(...) costs no
+// allocation or formatting, only a relaxed load of its channel's mask. Compiled out
+// levels/files fold to a constant false and the whole statement is removed. Log_voidify turns the << chain into a void expression so
+// both sides of ?: match, & binds looser than << but tighter than ?:.
+#define LOG(level)                                                                           \
+    !(std::bool_constant<Log_filter::is_compiled_in(level, __FILE__)>::value &&              \
+      LOG_CHANNEL().is_enabled(level))                                                        \
+        ? (void)0                                                                            \
+        : Log_voidify() & Logger(level, std::source_location::current())
 
 // ===================================================================
 // Definitions for static members
@@ -0,0 +1,60 @@
+#ifndef UTILS_MAPPED_FILE_H
+#define UTILS_MAPPED_FILE_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include <cstddef>
+#include <filesystem>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// class Mapped_file
+// -------------------------------------------------------------------
+
+// A whole file mapped into memory, either read only or read/write.
+// Unmapped when destroyed or closed, writes reach the file through the
+// OS page cache even if the process dies without closing it.
+class Mapped_file final {
+
+public:
+    Mapped_file() = default;
+    ~Mapped_file();
+
+    Mapped_file           (Mapped_file const&) = delete;
+    Mapped_file& operator=(Mapped_file const&) = delete;
+
+    Mapped_file           (Mapped_file&& other) noexcept;
+    Mapped_file& operator=(Mapped_file&& other) noexcept;
+
+    // Creates (or truncates) the file, sizes it to size bytes of zeros and maps it read/write.
+    bool create(std::filesystem::path const& path, std::size_t const size);
+
+    // Maps an existing file read only.
+    bool open_read(std::filesystem::path const& path);
+
+    void close();
+
+    bool is_open() const { return m_data != nullptr; }
+
+    std::byte*       data()       { return m_data; }
+    std::byte const* data() const { return m_data; }
+
+    std::size_t size() const { return m_size; }
+
+private:
+    // The native file and mapping handles are closed right after mapping,
+    // the view alone keeps the file mapped on both Windows and POSIX.
+    std::byte*  m_data = nullptr;
+    std::size_t m_size = 0u;
+};
+
+} // tiny_tanks::utils
+
+#endif // UTILS_MAPPED_FILE_H
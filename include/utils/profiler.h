@@ -0,0 +1,179 @@
+#ifndef UTILS_PROFILER_H
+#define UTILS_PROFILER_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/allocation_tracker.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+// ===================================================================
+// Compile time switch
+// -------------------------------------------------------------------
+
+// 0 turns every PROFILE_ZONE / PROFILE_FRAME into nothing, set from CMake
+// with -DTINY_TANKS_PROFILER=OFF.
+#ifndef PROFILER_COMPILED_IN
+    #define PROFILER_COMPILED_IN 1
+#endif
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// struct Profiler_settings
+// -------------------------------------------------------------------
+
+struct Profiler_settings {
+
+    // Zones kept per thread, later ones are dropped (and counted).
+    std::size_t zones_per_thread = 1u << 16u;
+
+    // Frame marks kept, later ones are dropped. Reserved up front so
+    // marking a frame doesn't allocate.
+    std::size_t frames_kept = 1u << 14u;
+};
+
+// ===================================================================
+// class Profiler
+// -------------------------------------------------------------------
+
+// Records PROFILE_ZONE scopes while started. Every thread writes its
+// zones into its own preallocated buffer, so a zone costs two clock reads
+// and no locking. While stopped a zone is a single relaxed load.
+//
+// PROFILE_FRAME() marks the end of a frame, the export shows the frames
+// on their own track. write_chrome_trace() writes the Chrome trace event
+// JSON, open it in chrome://tracing or https://ui.perfetto.dev.
+//
+// With allocation tracking compiled in every zone also records what its
+// thread allocated in it, nested zones included, shown in the export's
+// args.
+//
+// start(), stop() and write_chrome_trace() belong on the main thread,
+// between frames.
+class Profiler final {
+
+public:
+    Profiler() = delete;
+
+    // Clears anything recorded before and starts recording.
+    static void start(Profiler_settings const& settings);
+    static void stop ();
+
+    static bool is_recording() { return s_is_recording.load(std::memory_order_relaxed); }
+
+    // Names the calling thread in the export, "Thread <n>" otherwise.
+    static void set_thread_name(std::string_view const name);
+
+    static void frame_mark();
+
+    // Name must outlive the export, PROFILE_ZONE passes string literals.
+    static void record_zone(
+        char const* const        name,
+        std::uint64_t const      begin_ns,
+        std::uint64_t const      end_ns,
+        Allocation_counts const& allocations = {}
+    );
+
+    // Writes what was recorded since start(), call after stop().
+    static bool write_chrome_trace(std::filesystem::path const& path);
+
+    // Zones lost to full thread buffers since start().
+    static std::uint64_t get_dropped_count();
+
+    static std::uint64_t now_ns() {
+
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count());
+    }
+
+private:
+    static std::atomic<bool> s_is_recording;
+};
+
+// ===================================================================
+// class Profile_zone
+// -------------------------------------------------------------------
+
+// Times its own scope, see PROFILE_ZONE.
+class Profile_zone final {
+
+public:
+    explicit Profile_zone(char const* const name)
+        : m_name(name)
+        , m_begin_ns(Profiler::is_recording() ? Profiler::now_ns() : 0u)
+        , m_begin_allocations(
+            (m_begin_ns != 0u && Allocation_tracker::is_compiled_in()) ? Allocation_tracker::get_thread_counts() : Allocation_counts{}
+        )
+    {}
+
+    ~Profile_zone() {
+
+        if (m_begin_ns != 0u && Profiler::is_recording()) {
+
+            Allocation_counts allocations = {};
+
+            if constexpr (Allocation_tracker::is_compiled_in()) {
+
+                Allocation_counts const end = Allocation_tracker::get_thread_counts();
+
+                allocations.allocations = end.allocations - m_begin_allocations.allocations;
+                allocations.bytes       = end.bytes       - m_begin_allocations.bytes;
+                allocations.frees       = end.frees       - m_begin_allocations.frees;
+            }
+
+            Profiler::record_zone(m_name, m_begin_ns, Profiler::now_ns(), allocations);
+        }
+    }
+
+    Profile_zone           (Profile_zone const&) = delete;
+    Profile_zone& operator=(Profile_zone const&) = delete;
+
+private:
+    char const*       m_name;
+    std::uint64_t     m_begin_ns;
+    Allocation_counts m_begin_allocations;
+};
+
+// ===================================================================
+// Definitions for static members
+// -------------------------------------------------------------------
+
+inline std::atomic<bool> Profiler::s_is_recording = false;
+
+} // tiny_tanks::utils
+
+// ===================================================================
+// Macros
+// -------------------------------------------------------------------
+
+// Usage:
+//     void Label::draw() {
+//         PROFILE_ZONE("Label::draw");
+//         ...
+//     }
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b)      PROFILE_CONCAT_IMPL(a, b)
+
+#if PROFILER_COMPILED_IN
+    #define PROFILE_ZONE(name) ::tiny_tanks::utils::Profile_zone const PROFILE_CONCAT(profile_zone_, __LINE__)(name)
+    #define PROFILE_FRAME()    ::tiny_tanks::utils::Profiler::frame_mark()
+#else
+    #define PROFILE_ZONE(name) static_cast<void>(0)
+    #define PROFILE_FRAME()    static_cast<void>(0)
+#endif
+
+#endif // UTILS_PROFILER_H
@@ -0,0 +1,92 @@
+#ifndef UTILS_RENDER_SCHEDULER_H
+#define UTILS_RENDER_SCHEDULER_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// class Render_scheduler
+// -------------------------------------------------------------------
+
+// Decides whether the main loop has to draw a frame at all. A frame is
+// needed when the scene revision moved on since the last one drawn, an
+// animation is running or a redraw was requested (e.g. on resize).
+// Otherwise the loop can block in wait_event() instead of spinning:
+//
+//     if (!scheduler.needs_frame(Widget::get_scene_revision())) {
+//         handle(scheduler.wait_event(window));
+//     }
+//     ... poll events, update ...
+//     if (scheduler.needs_frame(Widget::get_scene_revision())) {
+//         ... clear, draw, display ...
+//         scheduler.frame_drawn(Widget::get_scene_revision());
+//     }
+//
+// wait_event() never blocks longer than the max idle wait (so periodic
+// work like Log_channels::poll() still runs) or past a wake_at() time.
+class Render_scheduler final {
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+
+        std::uint64_t frames_drawn;
+        std::uint64_t idle_waits;       // Calls to wait_event()
+        std::uint64_t event_wakeups;    // Waits ended by an event
+        std::uint64_t timeout_wakeups;  // Waits ended by a timer or the max idle wait
+    };
+
+    explicit Render_scheduler(Clock::duration const max_idle_wait = std::chrono::milliseconds(500));
+
+    // Off draws every frame like the loop always did, for comparisons.
+    void set_idle_enabled(bool const is_enabled) { m_is_idle_enabled = is_enabled; }
+    bool is_idle_enabled (/*-----------------*/) const { return m_is_idle_enabled; }
+
+    // Draw the next frame even if no widget changed.
+    void request_redraw() { m_is_redraw_requested = true; }
+
+    // Frames are drawn at full rate while any animation is running.
+    void begin_animation();
+    void end_animation  ();
+
+    // Keeps the next wait from blocking past the time point, for timers.
+    void wake_at(Clock::time_point const time);
+
+    bool needs_frame(std::uint64_t const scene_revision) const;
+    void frame_drawn(std::uint64_t const scene_revision);
+
+    // Blocks until an event arrives or the wait times out.
+    std::optional<sf::Event> wait_event(sf::Window& window);
+
+    Stats get_stats() const { return m_stats; }
+
+private:
+    Clock::duration                  m_max_idle_wait;
+    std::optional<Clock::time_point> m_wake_time;
+
+    std::optional<std::uint64_t> m_drawn_revision;
+
+    int  m_animation_count;
+    bool m_is_redraw_requested;
+    bool m_is_idle_enabled;
+
+    Stats m_stats;
+};
+
+} // tiny_tanks::utils
+
+#endif // UTILS_RENDER_SCHEDULER_H
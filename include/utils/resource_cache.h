@@ -0,0 +1,163 @@
+#ifndef UTILS_RESOURCE_CACHE_H
+#define UTILS_RESOURCE_CACHE_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+#include "utils/asset_archive.h"
+#include "utils/logger.h"
+#include "utils/sdf_font.h"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// Handles
+// -------------------------------------------------------------------
+
+// Shared, read only access to a cached resource. Copying a handle is a
+// reference count bump, the resource lives while any handle (or the
+// cache) still refers to it.
+using Font_handle     = std::shared_ptr<sf::Font    const>;
+using Texture_handle  = std::shared_ptr<sf::Texture const>;
+using Sdf_font_handle = std::shared_ptr<Sdf_font    const>;
+
+// ===================================================================
+// Loaders
+// -------------------------------------------------------------------
+
+// Straight from the mapped archive when it holds the path (no copy, no
+// open()), otherwise from the loose file on disk.
+
+inline bool load_resource(sf::Font& font, std::string const& path) {
+
+    if (auto const bytes = assets().find(path); !bytes.empty()) {
+
+        return font.openFromMemory(bytes.data(), bytes.size());
+    }
+
+    return font.openFromFile(path);
+}
+
+inline bool load_resource(sf::Texture& texture, std::string const& path) {
+
+    if (auto const bytes = assets().find(path); !bytes.empty()) {
+
+        return texture.loadFromMemory(bytes.data(), bytes.size());
+    }
+
+    return texture.loadFromFile(path);
+}
+
+inline bool load_resource(Sdf_font& font, std::string const& path) {
+
+    return font.load(path);
+}
+
+// ===================================================================
+// class Resource_cache
+// -------------------------------------------------------------------
+
+// Loads every path from disk once and hands out shared handles to it.
+// A path that fails to load is logged and cached as an empty resource,
+// so callers always get a valid handle and the disk is not hit again.
+template<typename Resource_type>
+class Resource_cache final {
+
+public:
+    using Handle = std::shared_ptr<Resource_type const>;
+
+    Resource_cache() = default;
+
+    Resource_cache           (Resource_cache const&) = delete;
+    Resource_cache& operator=(Resource_cache const&) = delete;
+
+    Handle load(std::string_view const path) {
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::string key(path);
+
+        if (auto const found = m_resources.find(key); found != m_resources.end()) {
+
+            return found->second;
+        }
+
+        auto resource = std::make_shared<Resource_type>();
+
+        if (!load_resource(*resource, key)) {
+
+            LOG(Log_lvl::ERROR) << "Unable to load resource: " << key;
+        }
+
+        Handle handle = std::move(resource);
+        m_resources.emplace(std::move(key), handle);
+
+        return handle;
+    }
+
+    // Drops resources nobody outside the cache holds a handle to.
+    void release_unused() {
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::erase_if(m_resources, [](auto const& entry) { return entry.second.use_count() == 1; });
+    }
+
+    std::size_t size() const {
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_resources.size();
+    }
+
+private:
+    mutable std::mutex                      m_mutex;
+    std::unordered_map<std::string, Handle> m_resources;
+};
+
+// ===================================================================
+// Global caches
+// -------------------------------------------------------------------
+
+// All touch assets() first so the archive is constructed before, and
+// destroyed after, the resources that may point into its mapping.
+
+inline Resource_cache<sf::Font>& fonts() {
+
+    assets();
+
+    static Resource_cache<sf::Font> cache;
+    return cache;
+}
+
+inline Resource_cache<sf::Texture>& textures() {
+
+    assets();
+
+    static Resource_cache<sf::Texture> cache;
+    return cache;
+}
+
+inline Resource_cache<Sdf_font>& sdf_fonts() {
+
+    assets();
+
+    static Resource_cache<Sdf_font> cache;
+    return cache;
+}
+
+} // tiny_tanks::utils
+
+#endif // UTILS_RESOURCE_CACHE_H
@@ -0,0 +1,135 @@
+#ifndef UTILS_SDF_FONT_H
+#define UTILS_SDF_FONT_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// File format
+// -------------------------------------------------------------------
+
+// A signed distance field font is baked by Tiny_Tanks_sdf_atlas at build
+// time into two files next to each other:
+//
+//     <name>.sdf        Sdf_font_header, Sdf_glyph[glyph_count] sorted by
+//                       codepoint, Sdf_kerning[kerning_count] sorted by pair
+//     <name>.sdf.png    The atlas, distance in the alpha channel with 0.5
+//                       on the outline, RGB white
+//
+// Metrics are in pixels at base_size, the atlas rects include the
+// distance_range padding on every side so a glyph quad is drawn exactly
+// over bounds.
+
+inline constexpr char          SDF_FONT_MAGIC[8]  = { 'T', 'T', 'S', 'D', 'F', 'O', 'N', 'T' };
+inline constexpr std::uint32_t SDF_FONT_VERSION   = 1u;
+inline constexpr char          SDF_ATLAS_SUFFIX[] = ".png";
+
+struct Sdf_font_header {
+
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t glyph_count;
+    std::uint32_t kerning_count;
+    float         base_size;       // Pixel size the glyphs were rasterised at
+    float         distance_range;  // Atlas pixels from the outline to distance 0 (or 1)
+    float         line_spacing;
+};
+
+struct Sdf_glyph {
+
+    std::uint32_t codepoint;
+    float         advance;
+    float         left;            // Quad bounds relative to the pen on the baseline
+    float         top;
+    float         width;
+    float         height;
+    std::uint32_t texture_x;       // Atlas rect, same size as the bounds
+    std::uint32_t texture_y;
+};
+
+struct Sdf_kerning {
+
+    std::uint32_t first;
+    std::uint32_t second;
+    float         amount;
+};
+
+static_assert(sizeof(Sdf_font_header) == 32u);
+static_assert(sizeof(Sdf_glyph)       == 32u);
+static_assert(sizeof(Sdf_kerning)     == 12u);
+
+// ===================================================================
+// class Sdf_font
+// -------------------------------------------------------------------
+
+// A baked SDF font: one atlas drawn smoothly at any size and scale, so
+// nothing is rasterised at runtime. Load through sdf_fonts() (see
+// utils/resource_cache.h) to share it.
+class Sdf_font final {
+
+public:
+    Sdf_font() = default;
+
+    Sdf_font           (Sdf_font const&) = delete;
+    Sdf_font& operator=(Sdf_font const&) = delete;
+
+    // Reads <path> and its atlas <path>.png, from the archive or the disk.
+    bool load(std::string const& path);
+
+    bool is_loaded() const { return !m_glyphs.empty(); }
+
+    // Falls back to '?' for codepoints that weren't baked, nullptr if that is missing too.
+    Sdf_glyph const* find_glyph(char32_t const codepoint) const;
+
+    // In pixels at base size.
+    float get_kerning(char32_t const first, char32_t const second) const;
+
+    float get_base_size     () const { return m_header.base_size;      }
+    float get_distance_range() const { return m_header.distance_range; }
+    float get_line_spacing  () const { return m_header.line_spacing;   }
+
+    sf::Texture const& get_texture() const { return m_texture; }
+
+    // Draws this font's quads (texture coordinates in atlas pixels) with
+    // an outline of the given thickness in screen pixels, up to about
+    // distance_range times the text scale. There is one shader per font,
+    // compiled the first time it is asked for, and this sets its outline
+    // uniforms: draw with it before asking again for another outline.
+    // nullptr if shaders aren't available. Render thread only.
+    sf::Shader const* get_shader(float const outline_thickness, sf::Color const outline_color) const;
+
+private:
+
+    Sdf_font_header          m_header = {};
+    std::vector<Sdf_glyph>   m_glyphs;
+    std::vector<Sdf_kerning> m_kerning;
+    sf::Texture              m_texture;
+
+    // Printable ASCII looked up directly, the rest by binary search
+    std::array<Sdf_glyph const*, 128u> m_ascii = {};
+
+    // Its outline uniforms as last set, most labels share them
+    mutable std::unique_ptr<sf::Shader> m_shader;
+    mutable float                       m_outline_thickness = 0.0f;
+    mutable sf::Color                   m_outline_color     = sf::Color::Transparent;
+    mutable bool                        m_is_shader_failed  = false;
+};
+
+} // tiny_tanks::utils
+
+#endif // UTILS_SDF_FONT_H
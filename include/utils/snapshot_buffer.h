@@ -0,0 +1,98 @@
+#ifndef UTILS_SNAPSHOT_BUFFER_H
+#define UTILS_SNAPSHOT_BUFFER_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// class Snapshot_buffer
+// -------------------------------------------------------------------
+
+// Hands snapshots from one writer thread to one reader thread without
+// locks or copies between them. Like a triple buffer, plus a fourth
+// slot so the reader keeps the snapshot before the latest one too, to
+// interpolate between the two.
+//
+// The writer fills get_back() and calls publish(), the reader calls
+// update() and reads get_previous() and get_current() until its next
+// update(). Neither ever waits for the other. The reader only sees the
+// latest snapshot published, ones it was too slow for are skipped.
+//
+// Slots are reused, a snapshot holding vectors keeps their capacity so
+// steady state publishing doesn't allocate.
+template<typename Snapshot>
+class Snapshot_buffer final {
+
+public:
+    Snapshot_buffer() = default;
+
+    Snapshot_buffer           (Snapshot_buffer const&) = delete;
+    Snapshot_buffer& operator=(Snapshot_buffer const&) = delete;
+
+    // Writer thread: the slot to fill next, whatever was in it last time.
+    Snapshot& get_back() { return m_slots[m_back]; }
+
+    // Writer thread: makes the back slot the latest snapshot.
+    void publish() {
+
+        m_back = m_middle.exchange(static_cast<std::uint8_t>(m_back | FRESH), std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader thread: takes the latest snapshot if there is a new one, the
+    // current one becomes the previous. Returns true if it did.
+    bool update() {
+
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0u) {
+
+            return false;
+        }
+
+        std::uint8_t const free_slot = m_previous;
+
+        m_previous = m_current;
+        m_current  = m_middle.exchange(free_slot, std::memory_order_acq_rel) & INDEX_MASK;
+
+        if (m_update_count < 2u) {
+
+            ++m_update_count;
+        }
+
+        return true;
+    }
+
+    // Reader thread. Default constructed snapshots until the first (second) update.
+    Snapshot const& get_current () const { return m_slots[m_current];  }
+    Snapshot const& get_previous() const { return m_slots[m_previous]; }
+
+    bool has_current () const { return m_update_count >= 1u; }
+    bool has_previous() const { return m_update_count >= 2u; }
+
+private:
+    static constexpr std::uint8_t INDEX_MASK = 0x03u;
+    static constexpr std::uint8_t FRESH      = 0x04u;  // Set when the middle slot wasn't read yet
+
+    std::array<Snapshot, 4> m_slots = {};
+
+    // Each slot belongs to exactly one of these at any time
+    std::uint8_t              m_back     = 0u;  // Writer's
+    std::atomic<std::uint8_t> m_middle   = 1u;  // In between, plus FRESH
+    std::uint8_t              m_current  = 2u;  // Reader's
+    std::uint8_t              m_previous = 3u;  // Reader's
+
+    std::uint8_t m_update_count = 0u;
+};
+
+} // tiny_tanks::utils
+
+#endif // UTILS_SNAPSHOT_BUFFER_H
@@ -0,0 +1,76 @@
+#ifndef UTILS_TEXT_BUFFER_H
+#define UTILS_TEXT_BUFFER_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/gap_buffer.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// class Text_buffer
+// -------------------------------------------------------------------
+
+// Editable text split in lines by '\n', for text far too long to rebuild
+// on every change (console, chat log). The characters sit in one gap
+// buffer and the line starts in another with its gap at the last edited
+// line, the starts after it are stored without the characters inserted
+// since and fixed up as the gap passes them. An edit costs its length
+// plus the lines the gap moves over, finding where a line starts is
+// O(1) and finding the line of an offset O(log lines).
+//
+// Offsets are in chars, the text isn't decoded.
+class Text_buffer final {
+
+public:
+    Text_buffer();
+
+    void insert(std::size_t const offset, std::string_view const text);
+    void erase (std::size_t const offset, std::size_t const count);
+    void append(std::string_view const text);
+
+    // Keeps the memory.
+    void clear();
+
+    std::size_t size() const { return m_text.size(); }
+
+    char operator[](std::size_t const offset) const { return m_text[offset]; }
+
+    // At least one, an empty buffer is one empty line.
+    std::size_t get_line_count() const { return m_line_starts.size(); }
+
+    std::size_t get_line_start(std::size_t const line) const;
+
+    // Offset of the line's '\n', size() for the last line.
+    std::size_t get_line_end(std::size_t const line) const;
+
+    std::size_t get_line_of(std::size_t const offset) const;
+
+    void        copy(std::size_t const offset, std::size_t const count, char* const out) const;
+    std::string get_text() const;
+
+private:
+
+    void move_line_gap(std::size_t const line);
+
+    Gap_buffer<char>        m_text;
+    Gap_buffer<std::size_t> m_line_starts;
+
+    // Chars inserted minus chars erased since the starts after the line
+    // gap were stored. Unsigned wrap around makes erasing work too.
+    std::size_t m_line_delta;
+};
+
+} // tiny_tanks::utils
+
+#endif // UTILS_TEXT_BUFFER_H
@@ -0,0 +1,124 @@
+#ifndef WIDGET_BATCH_RENDERER_H
+#define WIDGET_BATCH_RENDERER_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+#include "utils/sdf_font.h"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+// ===================================================================
+// Geometry helpers
+// -------------------------------------------------------------------
+
+// Append the triangles SFML would draw for the shape / text, already
+// transformed, so they can be drawn together with other widgets.
+//
+// Font pages keep a white square at the top left for underlines, shapes
+// are textured from it (WHITE_TEXEL) so a label's background and its
+// glyphs share the font texture and end up in the same draw call.
+
+inline constexpr sf::Vector2f WHITE_TEXEL = { 1.0f, 1.0f };
+
+void append_rect_vertices(std::vector<sf::Vertex>& vertices, sf::RectangleShape const& rect);
+void append_text_vertices(std::vector<sf::Vertex>& vertices, sf::Text const& text);
+
+// Writes the 6 vertices of one glyph, untransformed, for the pen at
+// position (on the baseline). Shear is the italic slant, 0 for upright.
+void write_glyph_vertices(
+    sf::Vertex* const  vertices,
+    sf::Vector2f const position,
+    sf::Glyph const&   glyph,
+    float const        italic_shear,
+    sf::Color const    color
+);
+
+// ===================================================================
+// class Batch_renderer
+// -------------------------------------------------------------------
+
+// Collects widget geometry over a frame and draws it with as few draw
+// calls as possible. Consecutive geometry using the same texture, blend
+// mode and shader is merged into one batch, a change starts a new one,
+// so the draw order is exactly the order things were added in.
+//
+// Usage, once per frame:
+//     batch.clear();
+//     for (auto& widget : widgets) { widget->draw(batch); }
+//     batch.draw(window);
+class Batch_renderer final {
+
+public:
+    Batch_renderer() = default;
+
+    // Drops last frame's geometry, keeps the memory.
+    void clear();
+
+    // Triangles (PrimitiveType::Triangles), texture coordinates in pixels.
+    // A shader is part of the batch state like the texture, it has to be
+    // configured already, uniforms aren't touched.
+    void add(
+        std::span<sf::Vertex const> const vertices,
+        sf::Texture const* const          texture,
+        sf::BlendMode const&              blend_mode = sf::BlendAlpha,
+        sf::Shader const* const           shader     = nullptr
+    );
+
+    // Text in an SDF font's atlas. All of the font's text shares one
+    // shader, its outline is set right before the batch is drawn, so
+    // labels with the same outline still end up in one batch.
+    void add_sdf_text(
+        std::span<sf::Vertex const> const vertices,
+        utils::Sdf_font const&            font,
+        float const                       outline_thickness,
+        sf::Color const                   outline_color
+    );
+
+    // Moves everything added afterwards, for containers drawing their
+    // children in their own coordinates. Restore the old offset after.
+    void         set_offset(sf::Vector2f const offset) { m_offset = offset; }
+    sf::Vector2f get_offset(/*-------------------*/) const { return m_offset; }
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states = sf::RenderStates::Default) const;
+
+    // What the last draw() will cost, one draw call per batch.
+    std::size_t get_draw_call_count() const { return m_batches.size();  }
+    std::size_t get_vertex_count   () const { return m_vertices.size(); }
+
+private:
+
+    struct Batch {
+
+        sf::Texture const* texture;
+        sf::BlendMode      blend_mode;
+        sf::Shader const*  shader;
+        std::size_t        first;
+        std::size_t        count;
+
+        // SDF text only, the shader comes from the font at draw time
+        utils::Sdf_font const* sdf_font;
+        float                  outline_thickness;
+        sf::Color              outline_color;
+    };
+
+    void add_batch(std::span<sf::Vertex const> const vertices, Batch const& state);
+
+    std::vector<sf::Vertex> m_vertices;
+    std::vector<Batch>      m_batches;
+    sf::Vector2f            m_offset;
+};
+
+} // tiny_tanks::widget
+
+#endif // WIDGET_BATCH_RENDERER_H
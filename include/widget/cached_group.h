@@ -0,0 +1,145 @@
+#ifndef WIDGET_CACHED_GROUP_H
+#define WIDGET_CACHED_GROUP_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+#include "utils/logger.h"
+#include "utils/resource_cache.h"
+#include "widget/batch_renderer.h"
+#include "widget/widget.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+// ===================================================================
+// class Cached_group
+// -------------------------------------------------------------------
+
+// Draws its children once into a render texture and then only that
+// texture, until a child's revision changes or invalidate_cache() is
+// called. Meant for UI that looks the same for many frames, menus,
+// scoreboards, HUD frames.
+//
+// Children are laid out in the group's own coordinates, the group's
+// position (minus its origin) moves all of them. The group doesn't own
+// its children, they must outlive it.
+//
+// All groups share one texture memory budget. A group whose texture
+// would go over it draws its children directly every frame instead.
+class Cached_group final : public Widget {
+
+public:
+    // Texture memory all groups together may use, 64 MiB unless changed.
+    static void        set_memory_budget(std::size_t const bytes);
+    static std::size_t get_memory_budget();
+
+    struct Stats {
+
+        std::uint64_t hits;           // Frames drawn from the cached texture
+        std::uint64_t misses;         // Frames the texture had to be redrawn
+        std::uint64_t bypasses;       // Frames drawn without a cache, over budget
+        std::size_t   texture_bytes;  // Texture memory in use by all groups
+    };
+
+    // Totals over every group since startup (texture_bytes is current).
+    static Stats get_stats();
+
+    // Outlines every group green on a hit, red on a miss and orange when
+    // bypassed, with the group's hit and miss counts next to it.
+    static void set_debug_overlay(bool const is_enabled);
+    static bool is_debug_overlay (/*-----------------*/);
+
+    explicit Cached_group(sf::RenderTarget* render_target);
+    ~Cached_group() override;
+
+    Cached_group           (Cached_group const&) = delete;
+    Cached_group& operator=(Cached_group const&) = delete;
+
+    void set_pos(sf::Vector2f const& pos) override;
+
+    void set_origin(sf::Vector2f const& origin) override;
+
+    Widget_type is() const override;
+
+    void add   (Widget& child);
+    void remove(Widget& child);
+
+    // Forces a redraw of the texture on the next draw.
+    void invalidate_cache();
+
+    // Also moves on whenever a child's revision does. Moving the group
+    // changes it too (for its parent and the frame scheduler), but not
+    // the texture, which is only redrawn when a child changes.
+    std::uint64_t get_revision() const override;
+
+    sf::FloatRect get_global_bounds() const override;
+
+    void draw() override;
+    void draw(sf::RenderTarget& target) override;
+    void draw(Batch_renderer& batch) override;
+
+private:
+
+    enum class Cache_result {
+
+        Hit,
+        Miss,
+        Bypass
+    };
+
+    // Redraws the texture if it is out of date, false if the group can't be cached.
+    bool update_cache();
+    void release_texture();
+
+    sf::Vector2f  get_offset       () const;
+    sf::FloatRect get_local_bounds () const;
+
+    // What the texture is keyed on, moving the group doesn't change it.
+    std::uint64_t get_content_revision() const;
+
+    void draw_overlay(sf::RenderTarget& target);
+    void draw_overlay(Batch_renderer& batch);
+    void update_overlay();
+
+    static std::size_t s_memory_budget;
+    static Stats       s_stats;
+    static bool        s_is_debug_overlay;
+
+    std::vector<Widget*> m_children;
+
+    std::unique_ptr<sf::RenderTexture> m_texture;
+    std::size_t                        m_texture_bytes;
+    sf::FloatRect                      m_cache_bounds;
+    std::uint64_t                      m_cached_revision;
+
+    Cache_result  m_last_result;
+    bool          m_is_over_budget_logged;
+    std::uint64_t m_hits;
+    std::uint64_t m_misses;
+
+    // Debug overlay, only touched while it is enabled
+    utils::Font_handle        m_overlay_font;
+    std::unique_ptr<sf::Text> m_overlay_text;
+    sf::RectangleShape        m_overlay_rect;
+    std::vector<sf::Vertex>   m_overlay_vertices;
+};
+
+inline std::size_t         Cached_group::s_memory_budget    = 64u * 1024u * 1024u;
+inline Cached_group::Stats Cached_group::s_stats            = {};
+inline bool                Cached_group::s_is_debug_overlay = false;
+
+} // tiny_tanks::widget
+
+#endif // WIDGET_CACHED_GROUP_H
@@ -0,0 +1,133 @@
+#ifndef WIDGET_COMMAND_LIST_H
+#define WIDGET_COMMAND_LIST_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+class Widget;
+
+// ===================================================================
+// Enums
+// -------------------------------------------------------------------
+
+// How commands are ordered inside one layer, layers always draw from 0 up.
+// Keep to one per layer, As_recorded commands in a By_state layer end up
+// before the groups.
+enum class Draw_order {
+
+    As_recorded,  // List by list, each in the order it was added
+    By_state      // Grouped by texture / blend mode / shader, for things that don't overlap
+};
+
+// ===================================================================
+// class Command_list
+// -------------------------------------------------------------------
+
+// Draw commands recorded for one frame, instead of drawing right away, so
+// a worker thread can build them while the render thread is busy (see
+// widget/command_queue.h). Nothing here touches OpenGL or a font.
+//
+// Geometry is copied into the list, already transformed, and consecutive
+// geometry with the same state and sort key extends one command. Widgets
+// and other drawables are only referenced, the render thread draws them
+// at submit time, which is how text gets in: glyph lookups load font
+// pages and can't run on a worker.
+class Command_list final {
+
+public:
+    Command_list() = default;
+
+    // Drops the recorded commands, keeps the memory.
+    void clear();
+
+    // Triangles (PrimitiveType::Triangles), texture coordinates in pixels.
+    void add(
+        std::span<sf::Vertex const> const vertices,
+        sf::Transform const&              transform,
+        sf::Texture const* const          texture,
+        std::uint16_t const               layer,
+        Draw_order const                  order      = Draw_order::As_recorded,
+        sf::BlendMode const&              blend_mode = sf::BlendAlpha,
+        sf::Shader const* const           shader     = nullptr
+    );
+
+    // Fill and outline, textured from texture's WHITE_TEXEL (or untextured).
+    void add(
+        sf::RectangleShape const& rect,
+        sf::Texture const* const  texture,
+        std::uint16_t const       layer,
+        Draw_order const          order = Draw_order::As_recorded
+    );
+
+    // Drawn with widget.draw(Batch_renderer&) on the render thread, the
+    // widget has to live until the frame is submitted.
+    void add(Widget& widget, std::uint16_t const layer);
+
+    // Drawn as is on the render thread, same lifetime rule as widgets.
+    void add(sf::Drawable const& drawable, sf::RenderStates const& states, std::uint16_t const layer);
+
+    // Sorts the commands for the render thread, called by whoever recorded
+    // them once they are done so the sort runs on the worker too. Grouped
+    // (By_state) geometry is copied into draw order here as well.
+    void finish();
+
+    std::size_t get_command_count() const { return m_commands.size(); }
+    std::size_t get_vertex_count () const { return m_vertices.size(); }
+
+private:
+    friend class Command_queue;
+
+    enum class Kind : std::uint8_t {
+
+        Geometry,
+        Widget,
+        Drawable
+    };
+
+    struct Command {
+
+        std::uint64_t       key;
+        Kind                kind;
+        sf::RenderStates    states;    // Geometry's transform is baked in, left as identity
+        std::size_t         first;     // Geometry: vertex range
+        std::size_t         count;
+        Widget*             widget;
+        sf::Drawable const* drawable;
+    };
+
+    struct Sort_entry {
+
+        std::uint64_t key;
+        std::uint32_t command;
+    };
+
+    // Layer, then state (By_state only), then list, then sequence.
+    std::uint64_t make_key(std::uint16_t const layer, Draw_order const order, sf::RenderStates const& states) const;
+
+    void add_geometry(std::size_t const first, sf::RenderStates const& states, std::uint16_t const layer, Draw_order const order);
+
+    std::vector<sf::Vertex> m_vertices;
+    std::vector<Command>    m_commands;
+    std::vector<Sort_entry> m_sorted;
+    std::vector<sf::Vertex> m_grouped_vertices;    // finish() lays grouped geometry out here, then swaps
+    bool                    m_is_grouped = false;  // Has By_state geometry
+    std::uint8_t            m_list_index = 0u;     // Set by the Command_queue, orders lists within a layer
+};
+
+} // tiny_tanks::widget
+
+#endif // WIDGET_COMMAND_LIST_H
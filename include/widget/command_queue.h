@@ -0,0 +1,122 @@
+#ifndef WIDGET_COMMAND_QUEUE_H
+#define WIDGET_COMMAND_QUEUE_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+#include "widget/batch_renderer.h"
+#include "widget/command_list.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+// ===================================================================
+// Command queue stats
+// -------------------------------------------------------------------
+
+// For the last frame submitted (build) / the last call (wait, submit).
+struct Command_queue_stats {
+
+    std::size_t commands   = 0u;
+    std::size_t vertices   = 0u;
+    std::size_t draw_calls = 0u;
+    double      build_ms   = 0.0;  // Workers, begin_build() until the last list was finished
+    double      wait_ms    = 0.0;  // Render thread, blocked in end_build()
+    double      submit_ms  = 0.0;  // Render thread, merging and drawing in submit()
+};
+
+// ===================================================================
+// class Command_queue
+// -------------------------------------------------------------------
+
+// Builds each frame's Command_lists on worker threads, one list per
+// worker, while the render thread submits the frame before. Lists are
+// double buffered: the workers fill the back set, end_build() swaps it
+// to the front and submit() draws the front set.
+//
+// The lists come back sorted from the workers, submit() only merges
+// them (in key order, see Draw_order) and issues one draw call per run
+// of geometry that shares a state and sits next to each other in one
+// list. Deferred widgets are batched together the same way.
+//
+// Usage, once per frame on the render thread:
+//     queue.end_build();             // Frame N is ready
+//     queue.begin_build(build);      // Workers start on frame N + 1
+//     queue.submit(window);          // Draw frame N meanwhile
+//     window.display();
+//
+// Whatever the build function reads must hold still until end_build().
+class Command_queue final {
+
+public:
+    using Clock          = std::chrono::steady_clock;
+    using Build_function = std::function<void(Command_list& list, std::size_t const worker, std::size_t const worker_count)>;
+
+    // Up to 16 workers, the list index only gets 4 bits of the sort key.
+    explicit Command_queue(std::size_t const worker_count);
+    ~Command_queue();
+
+    Command_queue           (Command_queue const&) = delete;
+    Command_queue& operator=(Command_queue const&) = delete;
+
+    std::size_t get_worker_count() const { return m_workers.size(); }
+
+    // Returns right away, build runs once per worker on its own list.
+    void begin_build(Build_function build);
+
+    // Waits for the workers, then makes their lists the ones submit() draws.
+    void end_build();
+
+    void submit(sf::RenderTarget& target, sf::RenderStates const& states = sf::RenderStates::Default);
+
+    Command_queue_stats get_stats() const { return m_stats; }
+
+private:
+    void run_worker(std::size_t const worker);
+
+    // Heads of the front lists, a min heap on key for the merge.
+    struct Merge_head {
+
+        std::uint64_t       key;
+        Command_list const* list;
+        std::size_t         next;
+    };
+
+    std::array<std::vector<Command_list>, 2> m_lists;
+    std::size_t                              m_back;  // Set the workers fill
+
+    std::vector<std::thread> m_workers;
+    std::mutex               m_mutex;
+    std::condition_variable  m_start_cv;
+    std::condition_variable  m_done_cv;
+    Build_function           m_build;
+    std::uint64_t            m_generation;
+    std::size_t              m_pending;
+    bool                     m_is_building;
+    bool                     m_is_stopping;
+    Clock::time_point        m_build_begin;
+    Clock::time_point        m_build_end;
+
+    std::vector<Merge_head> m_heads;
+    Batch_renderer          m_widget_batch;
+    Command_queue_stats     m_stats;
+};
+
+} // tiny_tanks::widget
+
+#endif // WIDGET_COMMAND_QUEUE_H
@@ -7,8 +7,17 @@
 
 #include "SFML/Graphics.hpp"
 #include "utils/logger.h"
+#include "widget/batch_renderer.h"
 #include "widget/widget.h"
 #include "utils/defs.h"
+#include "utils/resource_cache.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
 
 // ===================================================================
 // Namespaces
@@ -23,9 +32,12 @@ namespace tiny_tanks::widget {
 class Label final : public Widget {
 
 public:
-    explicit Label(sf::RenderWindow* render_window);
+    // Characters the dynamic text fast path holds, see set_dynamic_text().
+    static constexpr std::size_t DYNAMIC_TEXT_CAPACITY = 32u;
+
+    explicit Label(sf::RenderTarget* render_target);
 
-    Label(sf::RenderWindow* render_window, std::string const& text);
+    Label(sf::RenderTarget* render_target, std::string const& text);
 
     void set_pos(sf::Vector2f const& pos) override;
 
@@ -34,12 +46,37 @@ public:
     Widget_type is() const override;
 
     void draw() override;
+    void draw(sf::RenderTarget& target) override;
+    void draw(Batch_renderer& batch) override;
 
     void        set_text(std::string const& text);
     std::string get_text(/*-------------------*/) const;
 
     void clear();
 
+    // Fast path for text that changes every frame (scores, ammo, timers).
+    // The text lives in an inline buffer and only the glyph quads that
+    // differ from the last layout are rewritten, nothing is allocated
+    // once the label has been drawn. Setting the same text again is free.
+    //
+    // ASCII only (anything else shows as '?'), at most
+    // DYNAMIC_TEXT_CAPACITY characters on one line, underline and strike
+    // through are ignored. set_text() / clear() go back to regular text.
+    void set_dynamic_text(std::string_view const text);
+    void set_integer     (std::int64_t const value, std::string_view const prefix = {});
+    void set_decimal     (double const value, int const precision, std::string_view const prefix = {});
+    bool is_dynamic_text () const;
+
+    // Draws the text from a baked signed distance field font (see
+    // tools/sdf_atlas.cpp) instead of the font's glyph pages: one atlas
+    // for every character size and scale, nothing rasterised at runtime,
+    // and the outline (set_text_outline_thickness / color, in screen
+    // pixels) comes from the shader. Regular and dynamic text both work,
+    // bold, underline and strike through are ignored. nullptr goes back
+    // to the regular font.
+    void                   set_sdf_font(utils::Sdf_font_handle font);
+    utils::Sdf_font_handle get_sdf_font(/*-----------------------*/) const;
+
     void scale_content    (bool const is_content_scaled);
     bool is_content_scaled(/*------------------------*/) const;
 
@@ -58,8 +95,9 @@ public:
     float get_margin_left  () const;
     float get_margin_right () const;
 
-    void     set_font(sf::Font const& font);
-    sf::Font get_font(/*----------------*/) const;
+    void               set_font(utils::Font_handle font);
+    void               set_font(sf::Font const& font);
+    utils::Font_handle get_font(/*-------------------*/) const;
 
     void  set_border_thickness(float const thickness);
     float get_border_thickness(/*-----------------*/) const;
@@ -86,7 +124,7 @@ public:
     sf::Color get_border_color(/*------------------*/) const;
 
     sf::FloatRect get_local_bounds () const;
-    sf::FloatRect get_global_bounds() const;
+    sf::FloatRect get_global_bounds() const override;
 
     void move(sf::Vector2f const& delta_offset);
 
@@ -107,14 +145,62 @@ private:
         Hidden
     };
 
-    sf::Font m_font;
-    sf::Text m_text;
+    // Setters that move or resize anything only mark the layout dirty, it
+    // is redone once on the next draw or bounds query instead of every frame.
+    void mark_layout_dirty();
+    void update_layout() const;
+
+    // Glyph quads the label lays out itself (dynamic and SDF text) carry the
+    // font, size, style and colours, this has them rewritten on the next layout.
+    void mark_glyphs_dirty();
+    void update_dynamic_glyphs() const;
+    void update_sdf_glyphs() const;
+
+    sf::FloatRect get_text_global_bounds() const;
+
+    // Dynamic text, drawn with m_text's transform instead of m_text
+    struct Dynamic_text {
+
+        std::array<char, DYNAMIC_TEXT_CAPACITY> chars;
+        std::size_t                             size;
+
+        // What each quad slot shows and the pen position it was written at
+        std::array<char,  DYNAMIC_TEXT_CAPACITY> drawn_chars;
+        std::array<float, DYNAMIC_TEXT_CAPACITY> drawn_pen_x;
+        std::size_t                              drawn_size;
+
+        // Fill quads in the first DYNAMIC_TEXT_CAPACITY slots, outline quads after them
+        std::vector<sf::Vertex> vertices;
+        sf::FloatRect           local_bounds;
+    };
+
+    utils::Font_handle m_font;
+
+    // Mutable since laying them out is a cache refresh, not a visible change.
+    mutable sf::Text           m_text;
+    mutable sf::RectangleShape m_rect;
 
-    sf::RectangleShape m_rect;
+    // Rect size from set_rect_size(), the margins are added on top of it.
+    sf::Vector2f m_rect_base_size;
 
     bool  m_is_content_scaled;
     State m_state;
 
+    mutable bool m_is_layout_dirty;
+
+    mutable Dynamic_text m_dynamic_text;
+    bool                 m_is_dynamic_text;
+
+    // SDF text, local quads drawn with m_text's transform like dynamic text
+    utils::Sdf_font_handle          m_sdf_font;
+    mutable std::vector<sf::Vertex> m_sdf_vertices;
+    mutable sf::FloatRect           m_sdf_bounds;
+
+    // Background and glyph triangles for batched drawing, rebuilt when the revision moves on.
+    std::vector<sf::Vertex> m_batch_vertices;
+    std::uint64_t           m_batch_revision;
+    std::size_t             m_batch_text_first;  // SDF text goes in its own batch, it has its own texture
+
     sf::Vector2f m_delta_offset;
 
     struct {
@@ -0,0 +1,181 @@
+#ifndef WIDGET_LAYOUT_H
+#define WIDGET_LAYOUT_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+#include "utils/defs.h"
+#include "widget/batch_renderer.h"
+#include "widget/widget.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+// ===================================================================
+// Layout settings
+// -------------------------------------------------------------------
+
+enum class Layout_direction {
+
+    Row,     // Children side by side, left to right
+    Column,  // Children top to bottom
+    Stack    // Every child anchored in the whole layout, on top of each other
+};
+
+struct Layout_margins {
+
+    float top    = 0.0f;
+    float bottom = 0.0f;
+    float left   = 0.0f;
+    float right  = 0.0f;
+};
+
+// How one child is placed. Along a row (column) a child gets a slot as
+// wide (tall) as its own size, plus its flex share of the space left
+// over, and as tall (wide) as the layout. The alignments place it inside
+// its slot, in a stack the slot is the whole layout. A child layout
+// isn't aligned, it fills its slot.
+struct Layout_item {
+
+    utils::Alignment horizontal = utils::Alignment::Left;    // Left, Right or Center
+    utils::Alignment vertical   = utils::Alignment::Top;     // Top, Bottom or Center
+    float            flex       = 0.0f;                      // Share of the space left over, 0 for none
+    Layout_margins   margins    = {};
+};
+
+// ===================================================================
+// class Layout
+// -------------------------------------------------------------------
+
+// Arranges its children in a row, a column or a stack, by alignment,
+// margins and flex weights. Layouts nest, a child layout fills the slot
+// it is given.
+//
+// Layout is incremental. A child that changes tells its layout through
+// Widget::invalidate(), which tells its own, up to the root, so the next
+// draw or bounds query only measures the children that changed, only
+// rearranges the layouts whose children changed size or that were
+// resized themselves, and only moves the subtrees that were moved. An
+// unchanged frame costs nothing, one label's text changing costs its
+// row and the layouts around it.
+//
+// Like Cached_group the layout draws its children but doesn't own them,
+// they must outlive it. A widget is in one layout at most.
+class Layout final : public Widget {
+
+public:
+    explicit Layout(sf::RenderTarget* render_target, Layout_direction const direction = Layout_direction::Column);
+    ~Layout() override;
+
+    Layout           (Layout const&) = delete;
+    Layout& operator=(Layout const&) = delete;
+
+    void set_pos(sf::Vector2f const& pos) override;
+
+    void set_origin(sf::Vector2f const& origin) override;
+
+    Widget_type is() const override;
+
+    void add   (Widget& child, Layout_item const& item = {});
+    void remove(Widget& child);
+
+    void        set_item(Widget& child, Layout_item const& item);
+    Layout_item get_item(Widget& child) const;
+
+    std::size_t get_child_count() const;
+
+    // The size of a root layout, e.g. the window's. {0, 0} (the default)
+    // sizes it to its children. Child layouts are sized by their parent.
+    void         set_size(sf::Vector2f const& size);
+    sf::Vector2f get_size(/*--------------------*/) const;
+
+    void             set_direction(Layout_direction const direction);
+    Layout_direction get_direction(/*--------------------------*/) const;
+
+    // Inside the layout, around all children.
+    void           set_padding(Layout_margins const& padding);
+    Layout_margins get_padding(/*-------------------------*/) const;
+
+    // Between two children of a row or column.
+    void  set_spacing(float const spacing);
+    float get_spacing(/*----------------*/) const;
+
+    // Also moves on whenever a child's revision does.
+    std::uint64_t get_revision() const override;
+
+    // Brings every child up to date, draws and bounds queries do it anyway.
+    // On a child layout it updates the whole tree from the root.
+    void update() const;
+
+    sf::FloatRect get_global_bounds() const override;
+
+    void draw() override;
+    void draw(sf::RenderTarget& target) override;
+    void draw(Batch_renderer& batch) override;
+
+private:
+
+    struct Child {
+
+        Widget*       widget;
+        Layout*       layout;         // widget as a Layout, nullptr for anything else
+        Layout_item   item;
+        sf::Vector2f  size;           // Global bounds size, natural size for a layout
+        sf::Vector2f  bounds_offset;  // From the widget's position to its bounds
+        sf::FloatRect slot;           // Margins included
+        bool          is_changed;     // Waiting in m_changed_children
+    };
+
+    void on_child_invalidated(Widget& child) override;
+
+    // Something about this layout itself changed, redo it and tell the parent.
+    void mark_dirty();
+
+    Child*       find_child(Widget const& child);
+    Child const* find_child(Widget const& child) const;
+
+    // Refreshes the sizes of the children that changed, returns the
+    // layout's natural size (what its children need).
+    sf::Vector2f measure() const;
+    void         measure_child(Child& child) const;
+
+    // Places the children in rect, skipping whatever is already there.
+    void arrange(sf::FloatRect const& rect) const;
+    void arrange_children(sf::FloatRect const& rect) const;
+    void place_child(Child& child, sf::FloatRect const& slot) const;
+
+    // Mutable since laying out is a cache refresh, the children are only pointed to.
+    mutable std::vector<Child>                     m_children;
+    std::unordered_map<Widget const*, std::size_t> m_child_indices;
+
+    // Children that invalidated themselves since the last measure, and the
+    // child layouts among them that need arranging even if their slot didn't change
+    mutable std::vector<Widget*> m_changed_children;
+    mutable std::vector<Layout*> m_dirty_layouts;
+
+    Layout_direction m_direction;
+    Layout_margins   m_padding;
+    float            m_spacing;
+    sf::Vector2f     m_size;
+
+    mutable sf::Vector2f  m_natural_size;
+    mutable sf::FloatRect m_arranged_rect;
+
+    mutable bool m_is_measure_dirty;  // Some child changed, or one was added or removed
+    mutable bool m_is_arrange_dirty;  // A child's size or item changed, the slots must be redone
+    mutable bool m_is_arranging;      // Children moved by the layout itself aren't changes
+};
+
+} // tiny_tanks::widget
+
+#endif // WIDGET_LAYOUT_H
@@ -0,0 +1,106 @@
+#ifndef WIDGET_PERF_HUD_H
+#define WIDGET_PERF_HUD_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+#include "utils/frame_stats.h"
+#include "widget/batch_renderer.h"
+#include "widget/label.h"
+#include "widget/widget.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+// ===================================================================
+// class Perf_hud
+// -------------------------------------------------------------------
+
+// In game performance overlay: FPS, p50/p95/p99 frame times and a
+// histogram of the last HISTORY_SIZE frames, draw calls, widget count
+// and allocations per frame.
+//
+// Everything it keeps is sized up front, adding a frame doesn't
+// allocate, and the text is only rewritten TEXT_UPDATE_INTERVAL apart so
+// the overlay barely shows up in the numbers it reports. Each line is a
+// Label on the dynamic text path, so rewriting it doesn't allocate either. While visible
+// it changes every frame, so it keeps the idle main loop drawing.
+class Perf_hud final : public Widget {
+
+public:
+    static constexpr std::size_t HISTORY_SIZE = 240u;  // Frames in the rolling window
+    static constexpr std::size_t BUCKET_COUNT = 34u;   // 1 ms each, the last holds everything slower
+    static constexpr std::size_t LINE_COUNT   = 5u;    // Of text, one Label each
+    static constexpr auto        TEXT_UPDATE_INTERVAL = std::chrono::milliseconds(250);
+
+    explicit Perf_hud(sf::RenderTarget* render_target);
+
+    void set_pos(sf::Vector2f const& pos) override;
+
+    void set_origin(sf::Vector2f const& origin) override;
+
+    Widget_type is() const override;
+
+    void hide     (bool const is_hidden);
+    bool is_hidden(/*----------------*/) const;
+    void toggle   ();
+
+    // Call once per frame, after display(), with the time since the last call.
+    void add_frame(std::chrono::nanoseconds const frame_time, utils::Frame_counters const& counters);
+
+    sf::FloatRect get_global_bounds() const override;
+
+    void draw() override;
+    void draw(sf::RenderTarget& target) override;
+    void draw(Batch_renderer& batch) override;
+
+private:
+
+    void place_lines();
+    void update_text();
+    void update_graph();
+
+    // Background of the text lines.
+    sf::FloatRect get_text_bounds() const;
+
+    sf::Texture const& get_texture() const;
+
+    // Rolling window of frame times in milliseconds
+    std::array<float, HISTORY_SIZE>         m_history;
+    std::array<float, HISTORY_SIZE>         m_scratch;  // Reordered by the percentile queries
+    std::array<std::uint32_t, BUCKET_COUNT> m_buckets;
+    std::size_t                             m_history_next;
+    std::size_t                             m_history_count;
+
+    utils::Frame_counters m_last_counters;
+
+    std::chrono::nanoseconds m_since_text_update;
+    std::uint32_t            m_frames_since_text_update;
+
+    float m_p50;
+    float m_p95;
+    float m_p99;
+
+    bool m_is_hidden;
+    bool m_is_graph_dirty;
+
+    std::array<Label, LINE_COUNT> m_lines;
+
+    // Text and graph backgrounds, one bar per bucket and the three percentile markers, sized once
+    std::vector<sf::Vertex> m_graph_vertices;
+};
+
+} // tiny_tanks::widget
+
+#endif // WIDGET_PERF_HUD_H
@@ -0,0 +1,164 @@
+#ifndef WIDGET_TEXT_EDIT_H
+#define WIDGET_TEXT_EDIT_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+#include "utils/resource_cache.h"
+#include "utils/text_buffer.h"
+#include "widget/batch_renderer.h"
+#include "widget/widget.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+// ===================================================================
+// class Text_edit
+// -------------------------------------------------------------------
+
+// Multi line text box for text too long for a Label (console, chat log),
+// tens of thousands of lines are fine. The text lives in a
+// utils::Text_buffer, only the lines inside the box are laid out, and a
+// line keeps its glyph quads until it is edited or scrolls out, so
+// typing and scrolling cost what is on screen, not what is in the
+// buffer.
+//
+// Scrolls by whole lines and doesn't wrap, glyphs past the right edge
+// are culled. Text is Latin-1, one char per character.
+class Text_edit final : public Widget {
+
+public:
+    explicit Text_edit(sf::RenderTarget* render_target);
+
+    void set_pos(sf::Vector2f const& pos) override;
+
+    void set_origin(sf::Vector2f const& origin) override;
+
+    Widget_type is() const override;
+
+    void draw() override;
+    void draw(sf::RenderTarget& target) override;
+    void draw(Batch_renderer& batch) override;
+
+    void         set_size(sf::Vector2f const& size);
+    sf::Vector2f get_size(/*--------------------*/) const;
+
+    void        set_text(std::string_view const text);
+    std::string get_text(/*------------------------*/) const;
+
+    void clear();
+
+    // At the cursor, the cursor ends up after it.
+    void insert(std::string_view const text);
+
+    // At the end, for logs. The view follows the end if it was showing it.
+    void append(std::string_view const text);
+
+    void erase_backward();
+    void erase_forward ();
+
+    // Chars from the start of the text.
+    void        set_cursor(std::size_t const offset);
+    std::size_t get_cursor(/*--------------------*/) const;
+
+    std::size_t get_line_count() const;
+
+    // First line shown, clamped so the box isn't scrolled past the end.
+    void        scroll_to_line        (std::size_t const line);
+    void        scroll                (std::ptrdiff_t const lines);
+    std::size_t get_first_visible_line() const;
+    std::size_t get_visible_line_count() const;
+
+    // Typing, cursor keys and the mouse wheel. Returns true when the event was used.
+    bool handle_event(sf::Event const& event);
+
+    // No cursor and no editing through handle_event(), insert() and append() still work.
+    void set_read_only(bool const is_read_only);
+    bool is_read_only (/*-------------------*/) const;
+
+    void hide     (bool const is_hidden);
+    bool is_hidden(/*----------------*/) const;
+
+    void               set_font(utils::Font_handle font);
+    utils::Font_handle get_font(/*-------------------*/) const;
+
+    void         set_character_size(unsigned int const size);
+    unsigned int get_character_size(/*-------------------*/) const;
+
+    void      set_text_color(sf::Color const& color);
+    sf::Color get_text_color(/*------------------*/) const;
+
+    void      set_background_color(sf::Color const& color);
+    sf::Color get_background_color(/*------------------*/) const;
+
+    sf::FloatRect get_global_bounds() const override;
+
+private:
+
+    static constexpr std::size_t NO_LINE = std::numeric_limits<std::size_t>::max();
+
+    // Glyph quads of one line with its top left at 0, 0
+    struct Line_layout {
+
+        std::size_t             line     = NO_LINE;
+        bool                    is_dirty = true;
+        std::vector<sf::Vertex> vertices;
+    };
+
+    void mark_layout_dirty();
+    void mark_all_lines_dirty();
+
+    // Keeps the cached layouts in step with an edit of the buffer
+    void on_lines_inserted(std::size_t const line, std::size_t const count);
+    void on_lines_erased  (std::size_t const first_line, std::size_t const last_line);
+
+    void erase_range(std::size_t const offset, std::size_t const count);
+
+    void scroll_to_cursor();
+
+    void update_layout() const;
+    void layout_line(Line_layout& layout) const;
+
+    float get_line_height() const;
+    float get_cursor_x   () const;
+
+    sf::Texture const& get_texture() const;
+
+    utils::Text_buffer m_buffer;
+    utils::Font_handle m_font;
+
+    sf::Vector2f m_size;
+    unsigned int m_character_size;
+    sf::Color    m_text_color;
+    sf::Color    m_background_color;
+
+    std::size_t m_cursor;
+    std::size_t m_first_line;
+
+    bool m_is_read_only;
+    bool m_is_hidden;
+
+    // One per visible line, top to bottom, and last layout's for recycling
+    mutable std::vector<Line_layout> m_line_layouts;
+    mutable std::vector<Line_layout> m_previous_layouts;
+
+    // Background, the visible lines moved into place and the cursor
+    mutable std::vector<sf::Vertex> m_vertices;
+    mutable bool                    m_is_layout_dirty;
+};
+
+} // tiny_tanks::widget
+
+#endif // WIDGET_TEXT_EDIT_H
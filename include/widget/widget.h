@@ -8,12 +8,21 @@
 #include "SFML/Graphics.hpp"
 #include "utils/logger.h"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
 // ===================================================================
 // Namespaces
 // -------------------------------------------------------------------
 
 namespace tiny_tanks::widget {
 
+class Batch_renderer;
+class Layout;
+class Widget;
+class Widget_manager;
+
 // ===================================================================
 // Enums
 // -------------------------------------------------------------------
@@ -22,12 +31,31 @@ enum class Widget_type {
 
     // Add as we make widgets
     Button,
+    Cached_group,
     Label,
+    Layout,
+    Perf_hud,
     Text_edit,
     Image,
     Sprite
 };
 
+// ===================================================================
+// class Widget_observer
+// -------------------------------------------------------------------
+
+// Told about the widgets it watches, apart from their layout parent, e.g.
+// a Widget_manager keeping their bounds in its hit test grid.
+class Widget_observer {
+
+public:
+    virtual void on_widget_invalidated(Widget& widget) = 0;
+    virtual void on_widget_destroyed  (Widget& widget) = 0;
+
+protected:
+    ~Widget_observer() = default;
+};
+
 // ===================================================================
 // class Widget
 // -------------------------------------------------------------------
@@ -35,18 +63,54 @@ enum class Widget_type {
 class Widget {
 
 protected:
-    explicit Widget(sf::RenderWindow* render_window)
-        : m_render_window(render_window)
+    explicit Widget(sf::RenderTarget* render_target)
+        : m_render_target(render_target)
         , m_origin       ({})
         , m_pos          ({})
-    {}
+        , m_revision     (0u)
+        , m_parent       (nullptr)
+        , m_observer     (nullptr)
+    {
 
-    sf::RenderWindow* m_render_window;
+        s_widget_count.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    // Not copyable, so the live widget count stays exact
+    Widget           (Widget const&) = delete;
+    Widget& operator=(Widget const&) = delete;
+
+    // Call whenever something that changes how the widget looks is set.
+    void invalidate() {
+
+        ++m_revision;
+        s_scene_revision.fetch_add(1u, std::memory_order_relaxed);
+
+        if (m_parent != nullptr) {
+
+            m_parent->on_child_invalidated(*this);
+        }
+
+        if (m_observer != nullptr) {
+
+            m_observer->on_widget_invalidated(*this);
+        }
+    }
+
+    sf::RenderTarget*       m_render_target;
     sf::Vector2f            m_origin;
     sf::Vector2f            m_pos;
+    std::uint64_t           m_revision;
 
 public:
-    virtual ~Widget() = default;
+    virtual ~Widget() {
+
+        if (m_observer != nullptr) {
+
+            m_observer->on_widget_destroyed(*this);
+        }
+
+        s_widget_count.fetch_sub(1u, std::memory_order_relaxed);
+    }
 
     virtual void set_pos(sf::Vector2f const& pos) = 0;
     sf::Vector2f get_pos() const { return m_pos; }
@@ -56,20 +120,63 @@ public:
 
     virtual Widget_type is() const = 0;
 
+    // Changes every time the widget's appearance changes, so anything
+    // caching what the widget looked like can tell when to redo it.
+    virtual std::uint64_t get_revision() const { return m_revision; }
+
+    // Moves on whenever any widget's revision does, the main loop only
+    // needs to draw a new frame when it differs from the last one drawn.
+    static std::uint64_t get_scene_revision() { return s_scene_revision.load(std::memory_order_relaxed); }
+
+    // Widgets alive right now.
+    static std::size_t get_widget_count() { return s_widget_count.load(std::memory_order_relaxed); }
+
+    virtual sf::FloatRect get_global_bounds() const = 0;
+
+    // Draws into the widget's render target.
     virtual void draw() = 0;
 
-    void set_render_target(sf::RenderWindow* render_window) {
+    // Same as draw() but into any other target, e.g. a cached group's texture.
+    virtual void draw(sf::RenderTarget& target) = 0;
+
+    // Adds the widget's geometry to the batch instead of drawing it right away.
+    virtual void draw(Batch_renderer& batch) = 0;
+
+    // Any target works, a window or an sf::RenderTexture for offscreen drawing.
+    void set_render_target(sf::RenderTarget* render_target) {
 
-        if (render_window == nullptr) {
+        if (render_target == nullptr) {
 
-            LOG(Log_lvl::ERROR) << "Render window pointer is null";
+            LOG(Log_lvl::ERROR) << "Render target pointer is null";
         } else {
 
-            m_render_window = render_window;
+            m_render_target = render_target;
         }
     }
+
+    sf::RenderTarget* get_render_target() const { return m_render_target; }
+
+    // The layout arranging this widget (see widget/layout.h), nullptr if none.
+    Widget* get_parent() const { return m_parent; }
+
+private:
+    friend class Layout;
+    friend class Widget_manager;
+
+    // Called by a child's invalidate(), containers laying their children
+    // out use it to only redo the parts of the tree that changed.
+    virtual void on_child_invalidated(Widget& /*child*/) {}
+
+    Widget*          m_parent;
+    Widget_observer* m_observer;  // At most one, see Widget_manager
+
+    static std::atomic<std::uint64_t> s_scene_revision;
+    static std::atomic<std::size_t>   s_widget_count;
 };
 
+inline std::atomic<std::uint64_t> Widget::s_scene_revision = 0u;
+inline std::atomic<std::size_t>   Widget::s_widget_count   = 0u;
+
 } // tiny_tanks::widget
 
 #endif // WIDGET_BASE_WIDGET_H
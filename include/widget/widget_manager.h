@@ -0,0 +1,189 @@
+#ifndef WIDGET_WIDGET_MANAGER_H
+#define WIDGET_WIDGET_MANAGER_H
+
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+#include "widget/widget.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+// ===================================================================
+// class Widget_manager
+// -------------------------------------------------------------------
+
+// Routes window events to the widgets under the mouse and to the one
+// with the keyboard focus, instead of asking every widget.
+//
+// The bounds of the widgets added are kept in a uniform grid of cells
+// (a hash map, so the area is unbounded). A widget tells the manager
+// when it changes through Widget::invalidate(), and on the next
+// update() only those widgets have their bounds read again and move
+// cells if they moved, so a hit test costs one cell's widgets however
+// many there are in total. Widgets in a Layout move when the layout
+// updates (on its draw), not when it is resized.
+//
+// Widgets added later are on top. A widget added for MOUSE gets
+// sf::Event::MouseEntered and MouseLeft as the mouse goes over it and
+// off it, then the buttons and the wheel. A press gives it the mouse
+// until the release, and the keyboard focus if it was added for
+// KEYBOARD too. Like Layout, the manager doesn't own its widgets, a
+// widget destroyed first takes itself out.
+class Widget_manager final : private Widget_observer {
+
+public:
+    // Which events a widget can receive
+    static constexpr std::uint32_t MOUSE    = 1u << 0u;  // Hover, buttons and wheel over the widget
+    static constexpr std::uint32_t KEYBOARD = 1u << 1u;  // Keys and text while it has the focus
+
+    // Returns true when the widget used the event. An unused button or
+    // wheel event goes on to the widget under it.
+    using Event_handler = std::function<bool(sf::Event const& event)>;
+
+    // Mouse positions are mapped to render_target's view, nullptr uses pixels.
+    explicit Widget_manager(sf::RenderTarget* render_target, float const cell_size = 64.0f);
+    ~Widget_manager();
+
+    Widget_manager           (Widget_manager const&) = delete;
+    Widget_manager& operator=(Widget_manager const&) = delete;
+
+    // A widget is in one manager at most.
+    void add   (Widget& widget, Event_handler handler, std::uint32_t const events = MOUSE);
+    void remove(Widget& widget);
+
+    bool        contains        (Widget const& widget) const;
+    std::size_t get_widget_count(/*-----------------*/) const;
+
+    // Puts a widget on top of every other one.
+    void raise(Widget& widget);
+
+    // Disabled widgets get no events and aren't hit.
+    void set_enabled(Widget& widget, bool const is_enabled);
+    bool is_enabled (Widget const& widget) const;
+
+    // Topmost enabled MOUSE widget at point (render target coordinates),
+    // nullptr if none.
+    Widget* hit_test(sf::Vector2f const& point);
+
+    // Routes one window event, returns true if a widget used it.
+    bool dispatch(sf::Event const& event);
+
+    Widget* get_hovered() const;
+    Widget* get_captured() const;
+
+    // nullptr clears the focus. Only KEYBOARD widgets can have it.
+    void    set_focus(Widget* widget);
+    Widget* get_focus(/*----------*/) const;
+
+    // Rereads the bounds of the widgets that changed since the last call.
+    // hit_test() and dispatch() call it first.
+    void update();
+
+    // Cells holding a widget, and the most widgets in any one of them.
+    std::size_t get_cell_count   () const;
+    std::size_t get_max_cell_size() const;
+
+private:
+
+    using Entry_index = std::uint32_t;
+
+    static constexpr Entry_index NO_ENTRY = std::numeric_limits<Entry_index>::max();
+
+    // Cell coordinates covered by a widget, inclusive.
+    struct Cell_range {
+
+        std::int32_t left   = 0;
+        std::int32_t top    = 0;
+        std::int32_t right  = -1;  // Empty
+        std::int32_t bottom = -1;
+    };
+
+    // A widget's bounds and order copied into each cell it covers, so a
+    // hit test doesn't leave the cell. A cell is sorted by order, a hit
+    // test stops at the first (topmost) widget containing the point.
+    struct Cell_item {
+
+        sf::FloatRect bounds;
+        std::uint64_t order;
+        Entry_index   entry;
+    };
+
+    struct Entry {
+
+        Widget*       widget;
+        Event_handler handler;
+        std::uint32_t events;
+        std::uint64_t order;       // Higher is on top
+        sf::FloatRect bounds;
+        Cell_range    cells;
+        bool          is_enabled;
+        bool          is_dirty;    // Waiting in m_dirty_entries
+    };
+
+    void on_widget_invalidated(Widget& widget) override;
+    void on_widget_destroyed  (Widget& widget) override;
+
+    Entry_index find_entry(Widget const& widget) const;
+
+    // Puts the entry in the cells its bounds cover, or takes it out.
+    void insert_cells(Entry_index const index);
+    void erase_cells (Entry_index const index);
+
+    // Refreshes the entry's bounds in the cells it is already in.
+    void refresh_cells(Entry_index const index);
+
+    Cell_range get_cell_range(sf::FloatRect const& bounds) const;
+
+    static std::uint64_t get_cell_key(std::int32_t const x, std::int32_t const y);
+
+    // Topmost enabled MOUSE entry at point below the order given.
+    Entry_index find_hit(sf::Vector2f const& point, std::uint64_t const below_order) const;
+
+    // Sends the event to the entry's handler.
+    bool send(Entry_index const index, sf::Event const& event);
+
+    // Moves the hover to the entry (may be NO_ENTRY), sending MouseLeft and MouseEntered.
+    void set_hovered(Entry_index const index);
+
+    // Moves the keyboard focus, sending FocusLost and FocusGained.
+    void set_focus_entry(Entry_index const index);
+
+    // From the topmost entry at point down until one uses the event.
+    bool send_at(sf::Vector2f const& point, sf::Event const& event, bool const is_press);
+
+    sf::Vector2f map_pixel(sf::Vector2i const& pixel) const;
+
+    sf::RenderTarget* m_render_target;
+    float             m_cell_size;
+    float             m_inverse_cell_size;
+
+    std::vector<Entry>                             m_entries;
+    std::vector<Entry_index>                       m_free_entries;
+    std::unordered_map<Widget const*, Entry_index> m_entry_indices;
+    std::vector<Entry_index>                       m_dirty_entries;
+
+    std::unordered_map<std::uint64_t, std::vector<Cell_item>> m_cells;
+
+    std::uint64_t m_next_order;
+
+    Entry_index m_hovered;
+    Entry_index m_captured;  // Pressed on, gets the mouse until the release
+    Entry_index m_focused;
+};
+
+} // tiny_tanks::widget
+
+#endif // WIDGET_WIDGET_MANAGER_H
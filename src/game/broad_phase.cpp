@@ -0,0 +1,530 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "game/broad_phase.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::game {
+
+// ===================================================================
+// Using directives
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks::utils;
+
+namespace {
+
+// Bands per worker, more than one so a crowded band doesn't hold the rest up.
+// Not many more, every band reads through all the cell ranges.
+constexpr std::size_t BANDS_PER_WORKER = 2u;
+
+// -------------------------------------------------------------------
+bool is_overlapping(sf::Vector2f const a_min, sf::Vector2f const a_max, sf::Vector2f const b_min, sf::Vector2f const b_max) {
+
+    return a_min.x < b_max.x && b_min.x < a_max.x
+        && a_min.y < b_max.y && b_min.y < a_max.y;
+}
+
+// -------------------------------------------------------------------
+// Clamped to [0, max_cell] while still a float, converting a value out
+// of the integer's range is undefined. NaN isn't ordered and would get
+// through std::clamp, it goes to 0.
+float clamp_cell(float const cell, float const max_cell) {
+
+    return (cell > 0.0f) ? std::min(cell, max_cell) : 0.0f;
+}
+
+} // namespace
+
+// ===================================================================
+// class Broad_phase
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Broad_phase::Broad_phase(sf::FloatRect const& world_bounds, Broad_phase_settings const& settings)
+    : m_origin       (world_bounds.position)
+    , m_settings     (settings)
+    , m_cell_scale   (0.0f)
+    , m_column_count (1u)
+    , m_row_count    (1u)
+    , m_collides     ()
+    , m_static       ()
+    , m_bands        ()
+    , m_worker_states()
+    , m_bounds       ()
+    , m_layers       ()
+    , m_on_pairs     (nullptr)
+    , m_ranges       ()
+    , m_next_band    (0u)
+    , m_phase        (Phase::Ranges)
+    , m_workers      ()
+    , m_mutex        ()
+    , m_start_cv     ()
+    , m_done_cv      ()
+    , m_generation   (0u)
+    , m_pending      (0u)
+    , m_is_stopping  (false)
+    , m_stats        ()
+{
+
+    if (!(m_settings.cell_size > 0.0f)) {
+
+        LOG(Log_lvl::ERROR) << "Cell size must be above 0, using 64";
+        m_settings.cell_size = 64.0f;
+    }
+
+    if (m_settings.batch_size == 0u) {
+
+        LOG(Log_lvl::ERROR) << "Batch size must be above 0, using 1024";
+        m_settings.batch_size = 1024u;
+    }
+
+    m_cell_scale   = 1.0f / m_settings.cell_size;
+    m_column_count = std::max<std::size_t>(1u, static_cast<std::size_t>(std::ceil(world_bounds.size.x / m_settings.cell_size)));
+    m_row_count    = std::max<std::size_t>(1u, static_cast<std::size_t>(std::ceil(world_bounds.size.y / m_settings.cell_size)));
+
+    m_collides.fill(0xFFu);
+
+    m_static.row_begin = 0u;
+    m_static.row_end   = m_row_count;
+    m_static.cell_start.assign(m_column_count * m_row_count + 1u, 0u);
+
+    std::size_t const worker_count = std::max<std::size_t>(1u, m_settings.worker_count);
+    std::size_t const band_count   = (worker_count == 1u) ? 1u : std::min(m_row_count, worker_count * BANDS_PER_WORKER);
+
+    m_bands.resize(band_count);
+
+    for (std::size_t i = 0u; i < band_count; ++i) {
+
+        m_bands[i].row_begin = m_row_count *  i       / band_count;
+        m_bands[i].row_end   = m_row_count * (i + 1u) / band_count;
+    }
+
+    m_worker_states.resize(worker_count);
+
+    for (Worker_state& worker_state : m_worker_states) {
+
+        worker_state.pairs       .reserve(m_settings.batch_size);
+        worker_state.static_pairs.reserve(m_settings.batch_size);
+    }
+
+    // The thread calling update() is worker 0
+    for (std::size_t i = 1u; i < worker_count; ++i) {
+
+        m_workers.emplace_back(&Broad_phase::run_worker, this, i);
+    }
+}
+
+// -------------------------------------------------------------------
+Broad_phase::~Broad_phase() {
+
+    {
+        std::lock_guard<std::mutex> const lock(m_mutex);
+        m_is_stopping = true;
+    }
+
+    m_start_cv.notify_all();
+
+    for (std::thread& worker : m_workers) {
+
+        worker.join();
+    }
+}
+
+// -------------------------------------------------------------------
+void Broad_phase::set_collides(std::uint8_t const layer_a, std::uint8_t const layer_b, bool const collides) {
+
+    if (layer_a >= LAYER_COUNT || layer_b >= LAYER_COUNT) {
+
+        LOG(Log_lvl::ERROR) << "Layers go up to " << LAYER_COUNT - 1u << ", not " << +layer_a << " / " << +layer_b;
+        return;
+    }
+
+    if (collides) {
+
+        m_collides[layer_a] |= static_cast<std::uint8_t>(1u << layer_b);
+        m_collides[layer_b] |= static_cast<std::uint8_t>(1u << layer_a);
+    } else {
+
+        m_collides[layer_a] &= static_cast<std::uint8_t>(~(1u << layer_b));
+        m_collides[layer_b] &= static_cast<std::uint8_t>(~(1u << layer_a));
+    }
+}
+
+// -------------------------------------------------------------------
+void Broad_phase::set_static(std::span<sf::FloatRect const> const bounds, std::span<std::uint8_t const> const layers) {
+
+    PROFILE_ZONE("Broad_phase::set_static");
+
+    if (bounds.size() != layers.size()) {
+
+        LOG(Log_lvl::ERROR) << bounds.size() << " static boxes but " << layers.size() << " layers, ignoring them";
+        m_static.cell_start.assign(m_column_count * m_row_count + 1u, 0u);
+        m_static.items.clear();
+        return;
+    }
+
+    m_ranges.resize(bounds.size());
+    find_ranges(bounds, 0u, bounds.size());
+
+    bucket(m_static, bounds, layers);
+}
+
+// -------------------------------------------------------------------
+void Broad_phase::update(
+    std::span<sf::FloatRect const> const bounds,
+    std::span<std::uint8_t const> const  layers,
+    Pair_function const&                 on_pairs
+) {
+
+    PROFILE_ZONE("Broad_phase::update");
+
+    if (bounds.size() != layers.size()) {
+
+        LOG(Log_lvl::ERROR) << bounds.size() << " boxes but " << layers.size() << " layers";
+        return;
+    }
+
+    auto const begin = std::chrono::steady_clock::now();
+
+    m_bounds   = bounds;
+    m_layers   = layers;
+    m_on_pairs = &on_pairs;
+    m_ranges.resize(bounds.size());
+    m_next_band.store(0u, std::memory_order_relaxed);
+
+    for (Worker_state& worker_state : m_worker_states) {
+
+        worker_state.pair_count        = 0u;
+        worker_state.static_pair_count = 0u;
+        worker_state.max_cell          = 0u;
+    }
+
+    run_phase(Phase::Ranges);
+    run_phase(Phase::Bands);
+
+    m_on_pairs = nullptr;
+
+    m_stats = {};
+
+    for (Worker_state const& worker_state : m_worker_states) {
+
+        m_stats.pairs        += worker_state.pair_count;
+        m_stats.static_pairs += worker_state.static_pair_count;
+        m_stats.max_cell      = std::max(m_stats.max_cell, worker_state.max_cell);
+    }
+
+    m_stats.update_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// -------------------------------------------------------------------
+// Clamped to the grid, boxes outside the world share its edge cells.
+Broad_phase::Cell_range Broad_phase::get_cell_range(sf::FloatRect const& box) const {
+
+    float const max_column = static_cast<float>(m_column_count - 1u);
+    float const max_row    = static_cast<float>(m_row_count    - 1u);
+
+    sf::Vector2f const min = (box.position            - m_origin) * m_cell_scale;
+    sf::Vector2f const max = (box.position + box.size - m_origin) * m_cell_scale;
+
+    // NaN bounds overlap nothing, the box stays out of the world's cells
+    if (std::isnan(min.x) || std::isnan(min.y) || std::isnan(max.x) || std::isnan(max.y)) {
+
+        return Cell_range{ 0u, 0u, 0u, 0u };
+    }
+
+    // Clamped at 0 first, truncating is flooring then (and much cheaper than std::floor)
+    return Cell_range{
+        static_cast<std::uint32_t>(clamp_cell(min.x, max_column)),
+        static_cast<std::uint32_t>(clamp_cell(max.x, max_column)) + 1u,
+        static_cast<std::uint32_t>(clamp_cell(min.y, max_row)),
+        static_cast<std::uint32_t>(clamp_cell(max.y, max_row)) + 1u
+    };
+}
+
+// -------------------------------------------------------------------
+std::size_t Broad_phase::get_cell(sf::Vector2f const point) const {
+
+    sf::Vector2f const cell = (point - m_origin) * m_cell_scale;
+
+    // As get_cell_range()
+    std::size_t const column = static_cast<std::size_t>(clamp_cell(cell.x, static_cast<float>(m_column_count - 1u)));
+    std::size_t const row    = static_cast<std::size_t>(clamp_cell(cell.y, static_cast<float>(m_row_count    - 1u)));
+
+    return row * m_column_count + column;
+}
+
+// -------------------------------------------------------------------
+void Broad_phase::find_ranges(std::span<sf::FloatRect const> const bounds, std::size_t const first, std::size_t const last) {
+
+    for (std::size_t i = first; i < last; ++i) {
+
+        m_ranges[i] = get_cell_range(bounds[i]);
+    }
+}
+
+// -------------------------------------------------------------------
+// Counting sort of the boxes covering the band's rows into its cells.
+void Broad_phase::bucket(Band& band, std::span<sf::FloatRect const> const bounds, std::span<std::uint8_t const> const layers) const {
+
+    std::size_t const cell_count = (band.row_end - band.row_begin) * m_column_count;
+
+    band.cell_start.assign(cell_count + 1u, 0u);
+
+    // Count, shifted by one so the prefix sum leaves each cell's start
+    for (Cell_range const& range : m_ranges) {
+
+        std::size_t const y_begin = std::max<std::size_t>(range.y_begin, band.row_begin);
+        std::size_t const y_end   = std::min<std::size_t>(range.y_end,   band.row_end);
+
+        for (std::size_t y = y_begin; y < y_end; ++y) {
+
+            std::uint32_t* const row = band.cell_start.data() + (y - band.row_begin) * m_column_count + 1u;
+
+            for (std::size_t x = range.x_begin; x < range.x_end; ++x) {
+
+                ++row[x];
+            }
+        }
+    }
+
+    for (std::size_t i = 1u; i <= cell_count; ++i) {
+
+        band.cell_start[i] += band.cell_start[i - 1u];
+    }
+
+    band.items.resize(band.cell_start[cell_count]);
+
+    // Scatter, the starts move up to the next cell's start on the way and
+    // are moved back after
+    for (std::size_t i = 0u; i < bounds.size(); ++i) {
+
+        Cell_range const& range = m_ranges[i];
+
+        if (range.y_end <= band.row_begin || range.y_begin >= band.row_end) {
+
+            continue;
+        }
+
+        sf::FloatRect const& box = bounds[i];
+
+        std::size_t const y_begin = std::max<std::size_t>(range.y_begin, band.row_begin);
+        std::size_t const y_end   = std::min<std::size_t>(range.y_end,   band.row_end);
+
+        Cell_item const item{ box.position, box.position + box.size, static_cast<std::uint32_t>(i), layers[i] };
+
+        for (std::size_t y = y_begin; y < y_end; ++y) {
+
+            std::uint32_t* const row = band.cell_start.data() + (y - band.row_begin) * m_column_count;
+
+            for (std::size_t x = range.x_begin; x < range.x_end; ++x) {
+
+                band.items[row[x]++] = item;
+            }
+        }
+    }
+
+    for (std::size_t i = cell_count; i > 0u; --i) {
+
+        band.cell_start[i] = band.cell_start[i - 1u];
+    }
+
+    band.cell_start[0] = 0u;
+}
+
+// -------------------------------------------------------------------
+void Broad_phase::find_pairs(Band const& band, Worker_state& worker_state, std::size_t const worker) {
+
+    std::size_t const batch_size = m_settings.batch_size;
+
+    for (std::size_t y = band.row_begin; y < band.row_end; ++y) {
+
+        for (std::size_t x = 0u; x < m_column_count; ++x) {
+
+            std::size_t const local_cell = (y - band.row_begin) * m_column_count + x;
+            std::size_t const cell       = y * m_column_count + x;
+
+            Cell_item const* const begin = band.items.data() + band.cell_start[local_cell];
+            Cell_item const* const end   = band.items.data() + band.cell_start[local_cell + 1u];
+
+            worker_state.max_cell = std::max(worker_state.max_cell, static_cast<std::size_t>(end - begin));
+
+            Cell_item const* const static_begin = m_static.items.data() + m_static.cell_start[cell];
+            Cell_item const* const static_end   = m_static.items.data() + m_static.cell_start[cell + 1u];
+
+            for (Cell_item const* a = begin; a != end; ++a) {
+
+                std::uint8_t const collides = m_collides[a->layer];
+
+                for (Cell_item const* b = a + 1; b != end; ++b) {
+
+                    if ((collides & (1u << b->layer)) == 0u || !is_overlapping(a->min, a->max, b->min, b->max)) {
+
+                        continue;
+                    }
+
+                    // Only the cell with the overlap's top left corner reports it
+                    if (get_cell({ std::max(a->min.x, b->min.x), std::max(a->min.y, b->min.y) }) != cell) {
+
+                        continue;
+                    }
+
+                    worker_state.pairs.push_back(Collision_pair{ std::min(a->index, b->index), std::max(a->index, b->index) });
+
+                    if (worker_state.pairs.size() == batch_size) {
+
+                        flush(worker_state, false, worker);
+                    }
+                }
+
+                for (Cell_item const* b = static_begin; b != static_end; ++b) {
+
+                    if ((collides & (1u << b->layer)) == 0u || !is_overlapping(a->min, a->max, b->min, b->max)) {
+
+                        continue;
+                    }
+
+                    if (get_cell({ std::max(a->min.x, b->min.x), std::max(a->min.y, b->min.y) }) != cell) {
+
+                        continue;
+                    }
+
+                    worker_state.static_pairs.push_back(Collision_pair{ a->index, b->index });
+
+                    if (worker_state.static_pairs.size() == batch_size) {
+
+                        flush(worker_state, true, worker);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// -------------------------------------------------------------------
+void Broad_phase::flush(Worker_state& worker_state, bool const is_static, std::size_t const worker) {
+
+    std::vector<Collision_pair>& pairs = is_static ? worker_state.static_pairs : worker_state.pairs;
+
+    if (pairs.empty()) {
+
+        return;
+    }
+
+    (is_static ? worker_state.static_pair_count : worker_state.pair_count) += pairs.size();
+
+    (*m_on_pairs)(pairs, is_static, worker);
+    pairs.clear();
+}
+
+// -------------------------------------------------------------------
+void Broad_phase::run_phase(Phase const phase) {
+
+    m_phase = phase;
+
+    if (m_workers.empty()) {
+
+        run_phase_share(phase, 0u);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> const lock(m_mutex);
+        m_pending = m_workers.size();
+        ++m_generation;
+    }
+
+    m_start_cv.notify_all();
+
+    run_phase_share(phase, 0u);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_cv.wait(lock, [this] { return m_pending == 0u; });
+}
+
+// -------------------------------------------------------------------
+void Broad_phase::run_phase_share(Phase const phase, std::size_t const worker) {
+
+    if (phase == Phase::Ranges) {
+
+        PROFILE_ZONE("Broad_phase::find_ranges");
+
+        std::size_t const count = m_bounds.size();
+        std::size_t const share = m_worker_states.size();
+
+        find_ranges(m_bounds, count * worker / share, count * (worker + 1u) / share);
+        return;
+    }
+
+    PROFILE_ZONE("Broad_phase::bands");
+
+    Worker_state& worker_state = m_worker_states[worker];
+
+    while (true) {
+
+        std::size_t const band_index = m_next_band.fetch_add(1u, std::memory_order_relaxed);
+
+        if (band_index >= m_bands.size()) {
+
+            break;
+        }
+
+        Band& band = m_bands[band_index];
+
+        bucket(band, m_bounds, m_layers);
+        find_pairs(band, worker_state, worker);
+    }
+
+    flush(worker_state, false, worker);
+    flush(worker_state, true,  worker);
+}
+
+// -------------------------------------------------------------------
+void Broad_phase::run_worker(std::size_t const worker) {
+
+    Profiler::set_thread_name("Broad phase worker " + std::to_string(worker));
+
+    std::uint64_t generation = 0u;
+
+    while (true) {
+
+        Phase phase = Phase::Ranges;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start_cv.wait(lock, [&] { return m_is_stopping || m_generation != generation; });
+
+            if (m_is_stopping) {
+
+                return;
+            }
+
+            generation = m_generation;
+            phase      = m_phase;
+        }
+
+        run_phase_share(phase, worker);
+
+        {
+            std::lock_guard<std::mutex> const lock(m_mutex);
+
+            if (--m_pending == 0u) {
+
+                m_done_cv.notify_all();
+            }
+        }
+    }
+}
+
+} // tiny_tanks::game
@@ -0,0 +1,273 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "game/entity_store.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+
+#if SIMD_COMPILED_IN
+    #include <emmintrin.h>
+#endif
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::game {
+
+namespace {
+
+// -------------------------------------------------------------------
+// Same as sf::FloatRect::contains, written out so it matches the SSE2 path.
+bool is_outside(float const x, float const y, sf::Vector2f const min, sf::Vector2f const max) {
+
+    return !(x >= min.x && x < max.x && y >= min.y && y < max.y);
+}
+
+} // namespace
+
+// ===================================================================
+// class Entity_store
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+void Entity_store::reserve(std::size_t const count) {
+
+    m_position_x.reserve(count);
+    m_position_y.reserve(count);
+    m_velocity_x.reserve(count);
+    m_velocity_y.reserve(count);
+    m_heading   .reserve(count);
+    m_health    .reserve(count);
+    m_team      .reserve(count);
+    m_handles   .reserve(count);
+    m_slots     .reserve(count);
+}
+
+// -------------------------------------------------------------------
+Entity_handle Entity_store::create(Entity_desc const& desc) {
+
+    std::uint32_t slot = m_free_slot;
+
+    if (slot == Entity_handle::NONE) {
+
+        slot = static_cast<std::uint32_t>(m_slots.size());
+        m_slots.push_back(Slot{ 0u, 0u });
+    } else {
+
+        m_free_slot = m_slots[slot].index;
+    }
+
+    m_slots[slot].index = static_cast<std::uint32_t>(m_handles.size());
+
+    m_position_x.push_back(desc.position.x);
+    m_position_y.push_back(desc.position.y);
+    m_velocity_x.push_back(desc.velocity.x);
+    m_velocity_y.push_back(desc.velocity.y);
+    m_heading   .push_back(desc.heading);
+    m_health    .push_back(desc.health);
+    m_team      .push_back(desc.team);
+    m_handles   .push_back(slot);
+
+    return Entity_handle{ slot, m_slots[slot].generation };
+}
+
+// -------------------------------------------------------------------
+bool Entity_store::destroy(Entity_handle const handle) {
+
+    std::size_t const index = get_index(handle);
+
+    if (index == NPOS) {
+
+        LOG(Log_lvl::ERROR) << "Entity " << handle.slot << " (generation " << handle.generation << ") isn't alive";
+        return false;
+    }
+
+    destroy_at(index);
+    return true;
+}
+
+// -------------------------------------------------------------------
+void Entity_store::clear() {
+
+    while (!m_handles.empty()) {
+
+        destroy_at(m_handles.size() - 1u);
+    }
+}
+
+// -------------------------------------------------------------------
+bool Entity_store::is_alive(Entity_handle const handle) const {
+
+    return get_index(handle) != NPOS;
+}
+
+// -------------------------------------------------------------------
+std::size_t Entity_store::get_index(Entity_handle const handle) const {
+
+    if (handle.slot >= m_slots.size() || m_slots[handle.slot].generation != handle.generation) {
+
+        return NPOS;
+    }
+
+    return m_slots[handle.slot].index;
+}
+
+// -------------------------------------------------------------------
+Entity_handle Entity_store::get_handle(std::size_t const index) const {
+
+    if (index >= m_handles.size()) {
+
+        LOG(Log_lvl::ERROR) << "No entity at " << index << ", there are " << m_handles.size();
+        return {};
+    }
+
+    std::uint32_t const slot = m_handles[index];
+
+    return Entity_handle{ slot, m_slots[slot].generation };
+}
+
+// -------------------------------------------------------------------
+Entity_arrays Entity_store::get_arrays() {
+
+    return { m_position_x, m_position_y, m_velocity_x, m_velocity_y, m_heading, m_health, m_team };
+}
+
+// -------------------------------------------------------------------
+Const_entity_arrays Entity_store::get_arrays() const {
+
+    return { m_position_x, m_position_y, m_velocity_x, m_velocity_y, m_heading, m_health, m_team };
+}
+
+// -------------------------------------------------------------------
+void Entity_store::integrate(float const dt) {
+
+    PROFILE_ZONE("Entity_store::integrate");
+
+    std::size_t const count = m_handles.size();
+
+    float*       position_x = m_position_x.data();
+    float*       position_y = m_position_y.data();
+    float const* velocity_x = m_velocity_x.data();
+    float const* velocity_y = m_velocity_y.data();
+
+    std::size_t i = 0u;
+
+#if SIMD_COMPILED_IN
+    __m128 const step = _mm_set1_ps(dt);
+
+    for (; i + 4u <= count; i += 4u) {
+
+        __m128 const x = _mm_loadu_ps(position_x + i);
+        __m128 const y = _mm_loadu_ps(position_y + i);
+
+        _mm_storeu_ps(position_x + i, _mm_add_ps(x, _mm_mul_ps(_mm_loadu_ps(velocity_x + i), step)));
+        _mm_storeu_ps(position_y + i, _mm_add_ps(y, _mm_mul_ps(_mm_loadu_ps(velocity_y + i), step)));
+    }
+#endif
+
+    // The last few (or all of them without SIMD)
+    for (; i < count; ++i) {
+
+        position_x[i] += velocity_x[i] * dt;
+        position_y[i] += velocity_y[i] * dt;
+    }
+}
+
+// -------------------------------------------------------------------
+// Back to front, so whatever destroy_at() moves into a hole has been tested already.
+std::size_t Entity_store::destroy_outside(sf::FloatRect const& bounds) {
+
+    PROFILE_ZONE("Entity_store::destroy_outside");
+
+    sf::Vector2f const min = bounds.position;
+    sf::Vector2f const max = bounds.position + bounds.size;
+
+    std::size_t const count     = m_handles.size();
+    std::size_t       end       = count;
+    std::size_t       destroyed = 0u;
+
+#if SIMD_COMPILED_IN
+    __m128 const min_x = _mm_set1_ps(min.x);
+    __m128 const min_y = _mm_set1_ps(min.y);
+    __m128 const max_x = _mm_set1_ps(max.x);
+    __m128 const max_y = _mm_set1_ps(max.y);
+
+    for (; end >= 4u; end -= 4u) {
+
+        std::size_t const first = end - 4u;
+
+        __m128 const x = _mm_loadu_ps(m_position_x.data() + first);
+        __m128 const y = _mm_loadu_ps(m_position_y.data() + first);
+
+        __m128 const inside = _mm_and_ps(
+            _mm_and_ps(_mm_cmpge_ps(x, min_x), _mm_cmplt_ps(x, max_x)),
+            _mm_and_ps(_mm_cmpge_ps(y, min_y), _mm_cmplt_ps(y, max_y))
+        );
+
+        // Usually all 4 are inside, one compare for the lot
+        int const outside = _mm_movemask_ps(inside) ^ 0xF;
+
+        for (int lane = 3; lane >= 0 && outside != 0; --lane) {
+
+            if ((outside & (1 << lane)) != 0) {
+
+                destroy_at(first + static_cast<std::size_t>(lane));
+                ++destroyed;
+            }
+        }
+    }
+#endif
+
+    while (end > 0u) {
+
+        --end;
+
+        if (is_outside(m_position_x[end], m_position_y[end], min, max)) {
+
+            destroy_at(end);
+            ++destroyed;
+        }
+    }
+
+    return destroyed;
+}
+
+// -------------------------------------------------------------------
+void Entity_store::destroy_at(std::size_t const index) {
+
+    std::size_t const last = m_handles.size() - 1u;
+
+    std::uint32_t const slot = m_handles[index];
+
+    if (index != last) {
+
+        m_position_x[index] = m_position_x[last];
+        m_position_y[index] = m_position_y[last];
+        m_velocity_x[index] = m_velocity_x[last];
+        m_velocity_y[index] = m_velocity_y[last];
+        m_heading   [index] = m_heading   [last];
+        m_health    [index] = m_health    [last];
+        m_team      [index] = m_team      [last];
+        m_handles   [index] = m_handles   [last];
+
+        m_slots[m_handles[index]].index = static_cast<std::uint32_t>(index);
+    }
+
+    m_position_x.pop_back();
+    m_position_y.pop_back();
+    m_velocity_x.pop_back();
+    m_velocity_y.pop_back();
+    m_heading   .pop_back();
+    m_health    .pop_back();
+    m_team      .pop_back();
+    m_handles   .pop_back();
+
+    // A new generation kills the old handles, the slot joins the free list
+    ++m_slots[slot].generation;
+    m_slots[slot].index = m_free_slot;
+    m_free_slot         = slot;
+}
+
+} // tiny_tanks::game
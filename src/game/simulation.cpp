@@ -0,0 +1,242 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "game/simulation.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <utility>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::game {
+
+// ===================================================================
+// Using directives
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks::utils;
+
+// ===================================================================
+// class Simulation
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Simulation::Simulation(World world, Simulation_settings const& settings)
+    : m_world(std::move(world))
+    , m_settings(settings)
+    , m_tick_duration()
+    , m_thread()
+    , m_is_running(false)
+    , m_command_mutex()
+    , m_commands()
+    , m_tick_commands()
+    , m_pushed_command_count(0u)
+    , m_applied_command_count(0u)
+    , m_snapshots()
+    , m_tick_count(0u)
+    , m_dropped_ticks(0u)
+    , m_step_last_ns(0)
+    , m_step_max_ns(0)
+{
+
+    if (m_settings.tick_rate == 0u) {
+
+        LOG(Log_lvl::ERROR) << "Tick rate must be above 0, using 60";
+        m_settings.tick_rate = 60u;
+    }
+
+    m_tick_duration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_settings.tick_rate));
+}
+
+// -------------------------------------------------------------------
+Simulation::~Simulation() {
+
+    stop();
+}
+
+// -------------------------------------------------------------------
+void Simulation::start() {
+
+    if (m_is_running.exchange(true)) {
+
+        return;
+    }
+
+    m_thread = std::thread(&Simulation::run, this);
+}
+
+// -------------------------------------------------------------------
+void Simulation::stop() {
+
+    if (!m_is_running.exchange(false)) {
+
+        return;
+    }
+
+    m_thread.join();
+}
+
+// -------------------------------------------------------------------
+bool Simulation::is_running() const {
+
+    return m_is_running.load(std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------------------
+void Simulation::push_command(Tank_command const& command) {
+
+    std::lock_guard<std::mutex> const lock(m_command_mutex);
+    m_commands.push_back(command);
+
+    m_pushed_command_count.fetch_add(1u, std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------------------
+bool Simulation::interpolate(Clock::time_point const time, std::vector<Tank_state>& tanks) {
+
+    m_snapshots.update();
+
+    if (!m_snapshots.has_current()) {
+
+        return false;
+    }
+
+    World_snapshot const& current = m_snapshots.get_current();
+
+    if (!m_snapshots.has_previous()) {
+
+        tanks = current.tanks;
+        return true;
+    }
+
+    World_snapshot const& previous = m_snapshots.get_previous();
+
+    // One tick behind, so the snapshot after the time shown is usually out
+    // already. Past the latest (a hitch) the picture holds still.
+    Clock::time_point const shown_time = time - m_tick_duration;
+
+    float t = 1.0f;
+
+    if (current.time > previous.time) {
+
+        t = std::chrono::duration<float>(shown_time - previous.time).count()
+          / std::chrono::duration<float>(current.time - previous.time).count();
+    }
+
+    game::interpolate(previous, current, std::clamp(t, 0.0f, 1.0f), tanks);
+    return true;
+}
+
+// -------------------------------------------------------------------
+bool Simulation::is_at_rest() const {
+
+    if (!m_snapshots.has_previous()) {
+
+        return false;
+    }
+
+    World_snapshot const& current  = m_snapshots.get_current();
+    World_snapshot const& previous = m_snapshots.get_previous();
+
+    // A command still on its way could set a tank going
+    return !current.is_moving && !previous.is_moving
+        && current.command_count == m_pushed_command_count.load(std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------------------
+Simulation::Clock::duration Simulation::get_tick_duration() const {
+
+    return m_tick_duration;
+}
+
+// -------------------------------------------------------------------
+Simulation_stats Simulation::get_stats() const {
+
+    Simulation_stats stats;
+
+    stats.ticks         = m_tick_count   .load(std::memory_order_relaxed);
+    stats.dropped_ticks = m_dropped_ticks.load(std::memory_order_relaxed);
+    stats.step_last_ms  = static_cast<double>(m_step_last_ns.load(std::memory_order_relaxed)) / 1'000'000.0;
+    stats.step_max_ms   = static_cast<double>(m_step_max_ns .load(std::memory_order_relaxed)) / 1'000'000.0;
+
+    return stats;
+}
+
+// -------------------------------------------------------------------
+void Simulation::run() {
+
+    Profiler::set_thread_name("Simulation");
+
+    float const dt = std::chrono::duration<float>(m_tick_duration).count();
+
+    std::uint64_t     tick      = m_tick_count.load(std::memory_order_relaxed);
+    Clock::time_point tick_time = Clock::now();
+
+    // Something to draw before the first tick
+    publish(tick, tick_time);
+
+    while (m_is_running.load(std::memory_order_relaxed)) {
+
+        tick_time += m_tick_duration;
+
+        Clock::time_point now = Clock::now();
+
+        while (now < tick_time) {
+
+            // sf::sleep asks Windows for a 1 ms timer, std::this_thread would get 15 ms
+            sf::sleep(sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(tick_time - now).count()));
+            now = Clock::now();
+        }
+
+        // Too far behind to catch up, skip to now
+        if (now - tick_time > m_tick_duration * m_settings.max_catch_up_ticks) {
+
+            m_dropped_ticks.fetch_add(static_cast<std::uint64_t>((now - tick_time) / m_tick_duration), std::memory_order_relaxed);
+            tick_time = now;
+        }
+
+        PROFILE_ZONE("Simulation::tick");
+
+        {
+            std::lock_guard<std::mutex> const lock(m_command_mutex);
+            std::swap(m_commands, m_tick_commands);
+        }
+
+        for (Tank_command const& command : m_tick_commands) {
+
+            m_world.apply(command);
+        }
+
+        m_applied_command_count += m_tick_commands.size();
+        m_tick_commands.clear();
+
+        m_world.step(dt);
+        publish(++tick, tick_time);
+
+        std::int64_t const step_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - now).count();
+
+        m_step_last_ns.store(step_ns, std::memory_order_relaxed);
+        m_step_max_ns .store(std::max(step_ns, m_step_max_ns.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+        m_tick_count  .store(tick, std::memory_order_relaxed);
+    }
+}
+
+// -------------------------------------------------------------------
+void Simulation::publish(std::uint64_t const tick, Clock::time_point const time) {
+
+    World_snapshot& snapshot = m_snapshots.get_back();
+
+    snapshot.tick          = tick;
+    snapshot.time          = time;
+    snapshot.command_count = m_applied_command_count;
+    m_world.write_snapshot(snapshot);
+
+    m_snapshots.publish();
+}
+
+} // tiny_tanks::game
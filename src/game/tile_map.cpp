@@ -0,0 +1,315 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "game/tile_map.h"
+#include "utils/frame_stats.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::game {
+
+// ===================================================================
+// Using directives
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks::utils;
+
+namespace {
+
+constexpr std::size_t VERTICES_PER_TILE = 6u;
+
+// -------------------------------------------------------------------
+// First and last + 1 chunk along one axis overlapping [min, max), clamped to [0, count].
+void get_chunk_span(float const min, float const max, float const chunk_size, std::size_t const count, std::size_t& begin, std::size_t& end) {
+
+    float const last = static_cast<float>(count);
+
+    begin = static_cast<std::size_t>(std::clamp(std::floor(min / chunk_size), 0.0f, last));
+    end   = static_cast<std::size_t>(std::clamp(std::ceil (max / chunk_size), 0.0f, last));
+}
+
+} // namespace
+
+// ===================================================================
+// class Tile_map
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Tile_map::Tile_map(sf::Vector2u const& size, sf::Texture const& atlas, Tile_map_settings const& settings)
+    : m_atlas             (&atlas)
+    , m_settings          (settings)
+    , m_size              (size)
+    , m_atlas_columns     (1u)
+    , m_chunk_columns     (0u)
+    , m_chunk_rows        (0u)
+    , m_has_vertex_buffers(sf::VertexBuffer::isAvailable())
+    , m_tiles             ()
+    , m_chunks            ()
+    , m_mesh_vertices     ()
+    , m_stats             ()
+{
+
+    if (!(m_settings.tile_size > 0.0f)) {
+
+        LOG(Log_lvl::ERROR) << "Tile size must be above 0, using 16";
+        m_settings.tile_size = 16.0f;
+    }
+
+    if (m_settings.chunk_size == 0u) {
+
+        LOG(Log_lvl::ERROR) << "Chunk size must be above 0, using 32";
+        m_settings.chunk_size = 32u;
+    }
+
+    if (m_settings.atlas_tile_size == 0u) {
+
+        LOG(Log_lvl::ERROR) << "Atlas tile size must be above 0, using 16";
+        m_settings.atlas_tile_size = 16u;
+    }
+
+    if (!m_has_vertex_buffers) {
+
+        LOG(Log_lvl::WARNING) << "No vertex buffers, the tile map keeps its chunks in vertex arrays";
+    }
+
+    m_atlas_columns = std::max<std::size_t>(1u, atlas.getSize().x / m_settings.atlas_tile_size);
+    m_chunk_columns = (m_size.x + m_settings.chunk_size - 1u) / m_settings.chunk_size;
+    m_chunk_rows    = (m_size.y + m_settings.chunk_size - 1u) / m_settings.chunk_size;
+
+    m_tiles .assign(static_cast<std::size_t>(m_size.x) * m_size.y, EMPTY_TILE);
+    m_chunks.resize(m_chunk_columns * m_chunk_rows);
+
+    for (Chunk& chunk : m_chunks) {
+
+        // Re-uploaded whenever one of its walls is shot, a few chunks every
+        // frame in a fight, so the driver shouldn't expect it to stay put
+        chunk.buffer.setPrimitiveType(sf::PrimitiveType::Triangles);
+        chunk.buffer.setUsage(sf::VertexBuffer::Usage::Dynamic);
+        chunk.vertex_count = 0u;
+        chunk.is_dirty     = false;
+    }
+
+    m_mesh_vertices.reserve(m_settings.chunk_size * m_settings.chunk_size * VERTICES_PER_TILE);
+}
+
+// -------------------------------------------------------------------
+void Tile_map::set_tiles(std::span<Tile const> const tiles) {
+
+    if (tiles.size() != m_tiles.size()) {
+
+        LOG(Log_lvl::ERROR) << tiles.size() << " tiles for a " << m_size.x << " x " << m_size.y << " map";
+        return;
+    }
+
+    std::copy(tiles.begin(), tiles.end(), m_tiles.begin());
+
+    for (Chunk& chunk : m_chunks) {
+
+        chunk.is_dirty = true;
+    }
+}
+
+// -------------------------------------------------------------------
+void Tile_map::set_tile(sf::Vector2u const& tile_pos, Tile const tile) {
+
+    if (tile_pos.x >= m_size.x || tile_pos.y >= m_size.y) {
+
+        LOG(Log_lvl::ERROR) << "No tile " << tile_pos.x << ", " << tile_pos.y << " on a " << m_size.x << " x " << m_size.y << " map";
+        return;
+    }
+
+    Tile& current = m_tiles[static_cast<std::size_t>(tile_pos.y) * m_size.x + tile_pos.x];
+
+    if (current == tile) {
+
+        return;
+    }
+
+    current = tile;
+    get_chunk(tile_pos).is_dirty = true;
+}
+
+// -------------------------------------------------------------------
+Tile Tile_map::get_tile(sf::Vector2u const& tile_pos) const {
+
+    if (tile_pos.x >= m_size.x || tile_pos.y >= m_size.y) {
+
+        LOG(Log_lvl::ERROR) << "No tile " << tile_pos.x << ", " << tile_pos.y << " on a " << m_size.x << " x " << m_size.y << " map";
+        return EMPTY_TILE;
+    }
+
+    return m_tiles[static_cast<std::size_t>(tile_pos.y) * m_size.x + tile_pos.x];
+}
+
+// -------------------------------------------------------------------
+bool Tile_map::get_tile_pos(sf::Vector2f const& world_pos, sf::Vector2u& tile_pos) const {
+
+    float const x = std::floor(world_pos.x / m_settings.tile_size);
+    float const y = std::floor(world_pos.y / m_settings.tile_size);
+
+    // Written so NaN fails it too, converting NaN to unsigned is undefined
+    if (!(x >= 0.0f && y >= 0.0f && x < static_cast<float>(m_size.x) && y < static_cast<float>(m_size.y))) {
+
+        return false;
+    }
+
+    tile_pos = { static_cast<unsigned>(x), static_cast<unsigned>(y) };
+    return true;
+}
+
+// -------------------------------------------------------------------
+sf::FloatRect Tile_map::get_bounds() const {
+
+    return { { 0.0f, 0.0f }, { static_cast<float>(m_size.x) * m_settings.tile_size, static_cast<float>(m_size.y) * m_settings.tile_size } };
+}
+
+// -------------------------------------------------------------------
+void Tile_map::draw(sf::RenderTarget& target, sf::RenderStates states) {
+
+    PROFILE_ZONE("Tile_map::draw");
+
+    m_stats = {};
+
+    states.texture = m_atlas;
+
+    // What the view shows, in map space: its clip space square taken back
+    // through the view and the map's own transform
+    sf::Transform to_clip = target.getView().getTransform();
+    to_clip.combine(states.transform);
+
+    sf::FloatRect const visible = to_clip.getInverse().transformRect({ { -1.0f, -1.0f }, { 2.0f, 2.0f } });
+
+    float const chunk_world_size = static_cast<float>(m_settings.chunk_size) * m_settings.tile_size;
+
+    std::size_t x_begin, x_end, y_begin, y_end;
+    get_chunk_span(visible.position.x, visible.position.x + visible.size.x, chunk_world_size, m_chunk_columns, x_begin, x_end);
+    get_chunk_span(visible.position.y, visible.position.y + visible.size.y, chunk_world_size, m_chunk_rows,    y_begin, y_end);
+
+    for (std::size_t y = y_begin; y < y_end; ++y) {
+
+        for (std::size_t x = x_begin; x < x_end; ++x) {
+
+            Chunk& chunk = m_chunks[y * m_chunk_columns + x];
+
+            if (chunk.is_dirty) {
+
+                auto const begin = std::chrono::steady_clock::now();
+
+                mesh(chunk, x, y);
+
+                m_stats.mesh_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+                ++m_stats.chunks_meshed;
+            }
+
+            if (chunk.vertex_count == 0u) {
+
+                continue;
+            }
+
+            if (m_has_vertex_buffers) {
+
+                target.draw(chunk.buffer, 0u, chunk.vertex_count, states);
+            } else {
+
+                target.draw(chunk.vertices.data(), chunk.vertex_count, sf::PrimitiveType::Triangles, states);
+            }
+
+            ++m_stats.chunks_drawn;
+            m_stats.vertices_drawn += chunk.vertex_count;
+        }
+    }
+
+    Frame_stats::count_draw_calls(static_cast<std::uint32_t>(m_stats.chunks_drawn));
+}
+
+// -------------------------------------------------------------------
+Tile_map::Chunk& Tile_map::get_chunk(sf::Vector2u const& tile_pos) {
+
+    std::size_t const chunk_x = tile_pos.x / m_settings.chunk_size;
+    std::size_t const chunk_y = tile_pos.y / m_settings.chunk_size;
+
+    return m_chunks[chunk_y * m_chunk_columns + chunk_x];
+}
+
+// -------------------------------------------------------------------
+void Tile_map::mesh(Chunk& chunk, std::size_t const chunk_x, std::size_t const chunk_y) {
+
+    std::size_t const x_begin = chunk_x * m_settings.chunk_size;
+    std::size_t const y_begin = chunk_y * m_settings.chunk_size;
+    std::size_t const x_end   = std::min<std::size_t>(x_begin + m_settings.chunk_size, m_size.x);
+    std::size_t const y_end   = std::min<std::size_t>(y_begin + m_settings.chunk_size, m_size.y);
+
+    float const tile_size       = m_settings.tile_size;
+    float const atlas_tile_size = static_cast<float>(m_settings.atlas_tile_size);
+
+    m_mesh_vertices.clear();
+
+    for (std::size_t y = y_begin; y < y_end; ++y) {
+
+        Tile const* const row = m_tiles.data() + y * m_size.x;
+
+        for (std::size_t x = x_begin; x < x_end; ++x) {
+
+            Tile const tile = row[x];
+
+            if (tile == EMPTY_TILE) {
+
+                continue;
+            }
+
+            sf::Vector2f const min(static_cast<float>(x) * tile_size, static_cast<float>(y) * tile_size);
+            sf::Vector2f const max = min + sf::Vector2f(tile_size, tile_size);
+
+            sf::Vector2f const uv1(static_cast<float>(tile % m_atlas_columns) * atlas_tile_size, static_cast<float>(tile / m_atlas_columns) * atlas_tile_size);
+            sf::Vector2f const uv2 = uv1 + sf::Vector2f(atlas_tile_size, atlas_tile_size);
+
+            // Same corner order as the batch renderer's quads
+            sf::Vector2f const corners   [4] = { min, { max.x, min.y }, { min.x, max.y }, max };
+            sf::Vector2f const tex_coords[4] = { uv1, { uv2.x, uv1.y }, { uv1.x, uv2.y }, uv2 };
+
+            for (int const index : { 0, 1, 2, 2, 1, 3 }) {
+
+                m_mesh_vertices.push_back(sf::Vertex{ corners[index], sf::Color::White, tex_coords[index] });
+            }
+        }
+    }
+
+    chunk.vertex_count = m_mesh_vertices.size();
+    chunk.is_dirty     = false;
+
+    if (!m_has_vertex_buffers) {
+
+        chunk.vertices.assign(m_mesh_vertices.begin(), m_mesh_vertices.end());
+        return;
+    }
+
+    if (chunk.vertex_count == 0u) {
+
+        return;
+    }
+
+    // Walls only ever go away in a game, so this mostly happens once per chunk
+    if (chunk.vertex_count > chunk.buffer.getVertexCount() && !chunk.buffer.create(chunk.vertex_count)) {
+
+        LOG(Log_lvl::ERROR) << "Couldn't create a vertex buffer of " << chunk.vertex_count << " vertices";
+        chunk.vertex_count = 0u;
+        return;
+    }
+
+    if (!chunk.buffer.update(m_mesh_vertices.data(), chunk.vertex_count, 0u)) {
+
+        LOG(Log_lvl::ERROR) << "Couldn't update a chunk's vertex buffer";
+        chunk.vertex_count = 0u;
+    }
+}
+
+} // tiny_tanks::game
@@ -0,0 +1,129 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "game/world.h"
+#include "utils/logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::game {
+
+namespace {
+
+// -------------------------------------------------------------------
+// Heading in [0, 360).
+float wrap_heading(float const heading) {
+
+    float const wrapped = std::fmod(heading, 360.0f);
+
+    return (wrapped < 0.0f) ? wrapped + 360.0f : wrapped;
+}
+
+} // namespace
+
+// ===================================================================
+// class World
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+std::size_t World::add_tank(sf::Vector2f const& position, float const heading) {
+
+    m_tanks.push_back({ { position, wrap_heading(heading) }, 0.0f, 0.0f });
+
+    return m_tanks.size() - 1u;
+}
+
+// -------------------------------------------------------------------
+std::size_t World::get_tank_count() const {
+
+    return m_tanks.size();
+}
+
+// -------------------------------------------------------------------
+void World::apply(Tank_command const& command) {
+
+    if (command.tank >= m_tanks.size()) {
+
+        LOG(Log_lvl::ERROR) << "No tank " << command.tank << ", there are " << m_tanks.size();
+        return;
+    }
+
+    Tank& tank = m_tanks[command.tank];
+    tank.throttle = std::clamp(command.throttle, -1.0f, 1.0f);
+    tank.turn     = std::clamp(command.turn,     -1.0f, 1.0f);
+}
+
+// -------------------------------------------------------------------
+void World::step(float const dt) {
+
+    constexpr float DEGREES_TO_RADIANS = std::numbers::pi_v<float> / 180.0f;
+
+    for (Tank& tank : m_tanks) {
+
+        tank.state.heading = wrap_heading(tank.state.heading + tank.turn * TANK_TURN_SPEED * dt);
+
+        float const radians  = tank.state.heading * DEGREES_TO_RADIANS;
+        float const distance = tank.throttle * TANK_SPEED * dt;
+
+        tank.state.position.x += std::cos(radians) * distance;
+        tank.state.position.y += std::sin(radians) * distance;
+    }
+}
+
+// -------------------------------------------------------------------
+bool World::is_moving() const {
+
+    return std::any_of(m_tanks.begin(), m_tanks.end(), [](Tank const& tank) { return tank.throttle != 0.0f || tank.turn != 0.0f; });
+}
+
+// -------------------------------------------------------------------
+void World::write_snapshot(World_snapshot& snapshot) const {
+
+    snapshot.is_moving = is_moving();
+    snapshot.tanks.resize(m_tanks.size());
+
+    for (std::size_t i = 0u; i < m_tanks.size(); ++i) {
+
+        snapshot.tanks[i] = m_tanks[i].state;
+    }
+}
+
+// -------------------------------------------------------------------
+void interpolate(World_snapshot const& from, World_snapshot const& to, float const t, std::vector<Tank_state>& tanks) {
+
+    tanks.resize(to.tanks.size());
+
+    std::size_t const blended_count = std::min(from.tanks.size(), to.tanks.size());
+
+    for (std::size_t i = 0u; i < blended_count; ++i) {
+
+        Tank_state const& a = from.tanks[i];
+        Tank_state const& b = to.tanks[i];
+
+        // Short way round, 350 to 10 goes through 0
+        float turn = b.heading - a.heading;
+
+        if (turn > 180.0f) {
+
+            turn -= 360.0f;
+
+        } else if (turn < -180.0f) {
+
+            turn += 360.0f;
+        }
+
+        tanks[i].position = a.position + (b.position - a.position) * t;
+        tanks[i].heading  = wrap_heading(a.heading + turn * t);
+    }
+
+    std::copy(to.tanks.begin() + static_cast<std::ptrdiff_t>(blended_count), to.tanks.end(), tanks.begin() + static_cast<std::ptrdiff_t>(blended_count));
+}
+
+} // tiny_tanks::game
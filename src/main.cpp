@@ -1,6 +1,17 @@
 #include "SFML/Graphics.hpp"
+#include "game/simulation.h"
+#include "utils/asset_archive.h"
+#include "widget/perf_hud.h"
 #include "widget/widget.h"
+#include "widget/widget_manager.h"
+#include "utils/log_async.h"
+#include "utils/log_binary.h"
+#include "utils/log_channel.h"
+#include "utils/frame_pacer.h"
+#include "utils/frame_stats.h"
 #include "utils/logger.h"
+#include "utils/profiler.h"
+#include "utils/render_scheduler.h"
 
 // Set global logger settings (MUST be done before main)
 int              const ENABLED_LOG_LVLS	      = Log_lvl::ALL_LOG_LVLS;
@@ -20,6 +31,22 @@ int main() {
 
 	using namespace tiny_tanks::widget;
 
+	//Print logs from a background thread so LOG(...) never stalls a frame
+	Log_async::start({});
+
+	//Keep the last LOG_BIN records in memory, written out only if we crash
+	//Decode the dump with Tiny_Tanks_log_decode
+	Log_binary::start({ .crash_dump_path = "tiny_tanks_crash.tlog" });
+
+	//Per file log levels, edit the file (or send SIGHUP) while running to change them
+	Log_channels::watch_config("log_levels.cfg");
+
+	//Map the packed assets, anything not in it is loaded from the assets folder instead
+	if (!tiny_tanks::utils::assets().open("assets.pak")) {
+
+		LOG(Log_lvl::INFO) << "No assets.pak, loading loose asset files";
+	}
+
 	//Create default render window, not full screen, 8 levels of gpu anti aliasing
 	sf::ContextSettings settings;
 	settings.antiAliasingLevel = 8u;
@@ -27,19 +54,202 @@ int main() {
 	//Here is the window
 	sf::RenderWindow window(sf::VideoMode({ 1200u,800u }), "Window", sf::Style::Default, sf::State::Windowed, settings);
 
+	//Only draws when something changed, otherwise sleeps in waitEvent
+	tiny_tanks::utils::Render_scheduler scheduler;
+
+	//Reads input as late as the frame allows and measures input to screen latency
+	//F4 switches between adaptive, vsync, frame limit and uncapped, logging the last one's stats
+	using tiny_tanks::utils::Frame_pacer;
+	using tiny_tanks::utils::Frame_pacing;
+	Frame_pacer pacer(window);
+
+	auto const log_pacing_stats = [&]() {
+
+		tiny_tanks::utils::Frame_pacing_stats const stats = pacer.get_stats();
+
+		LOG(Log_lvl::INFO) << "Frame pacing " << Frame_pacer::to_string(pacer.get_mode()) << ": " << stats.frames << " frames"
+		                   << ", interval " << stats.interval_mean_ms << " ms (jitter " << stats.interval_jitter_ms << " ms, p99 " << stats.interval_p99_ms << " ms)"
+		                   << ", input to present " << stats.latency_mean_ms << " ms (p99 " << stats.latency_p99_ms << " ms)"
+		                   << ", measured p50 " << stats.input_latency_p50_ms << " ms p99 " << stats.input_latency_p99_ms << " ms over " << stats.input_frames << " frames"
+		                   << ", asleep " << stats.sleep_mean_ms << " ms spinning " << stats.spin_mean_ms << " ms per frame";
+	};
+
+	//Performance overlay, F3 shows and hides it
+	Perf_hud perf_hud(&window);
+	perf_hud.set_pos({ 8.0f, 8.0f });
+	perf_hud.hide(true);
+
+	//Hands mouse and keyboard events to the widgets under the mouse or with the focus
+	//Add interactive widgets with widget_manager.add(widget, handler)
+	Widget_manager widget_manager(&window);
+
+	//The game runs at a fixed tick on its own thread, frames show it interpolated
+	//The arrow keys drive the player's tank
+	using tiny_tanks::game::Simulation;
+	using tiny_tanks::game::Tank_state;
+
+	tiny_tanks::game::World world;
+	std::size_t const player_tank = world.add_tank({ 600.0f, 400.0f }, -90.0f);
+
+	Simulation simulation(std::move(world));
+	simulation.start();
+
+	//Draw every frame while the tanks move, the render-on-change mode takes over once they stop
+	bool is_animating = false;
+
+	auto const set_animating = [&](bool const animating) {
+
+		if (animating == is_animating) {
+
+			return;
+		}
+
+		is_animating = animating;
+
+		if (animating) {
+
+			scheduler.begin_animation();
+		} else {
+
+			scheduler.end_animation();
+		}
+	};
+
+	//Draw until the first snapshots are out
+	set_animating(true);
+
+	std::vector<Tank_state> tanks;
+
+	sf::RectangleShape tank_shape({ 40.0f, 26.0f });
+	tank_shape.setOrigin({ 20.0f, 13.0f });
+	tank_shape.setFillColor(sf::Color(70, 110, 50));
+
+	auto last_frame_time = std::chrono::steady_clock::now();
+
+	//F9 starts a profiler capture and F9 again writes it out, open it in ui.perfetto.dev
+	using tiny_tanks::utils::Profiler;
+	Profiler::set_thread_name("Main");
+
+	auto const handle_event = [&](sf::Event const& event) {
+
+		//Widgets get the event first, anything they used goes no further
+		if (widget_manager.dispatch(event)) {
+
+			return;
+		}
+
+		//Top right exit button event, mouse click it
+		if (event.is<sf::Event::Closed>()) {
+
+			window.close();
+		}
+
+		//Toggle the performance overlay
+		if (auto const* key = event.getIf<sf::Event::KeyPressed>(); key != nullptr && key->code == sf::Keyboard::Key::F3) {
+
+			perf_hud.toggle();
+		}
+
+		//Drive the player's tank, the simulation picks it up on its next tick
+		if (event.is<sf::Event::KeyPressed>() || event.is<sf::Event::KeyReleased>()) {
+
+			auto const axis = [](sf::Keyboard::Key const negative, sf::Keyboard::Key const positive) {
+
+				return (sf::Keyboard::isKeyPressed(positive) ? 1.0f : 0.0f) - (sf::Keyboard::isKeyPressed(negative) ? 1.0f : 0.0f);
+			};
+
+			tiny_tanks::game::Tank_command const command = {
+				player_tank,
+				axis(sf::Keyboard::Key::Down, sf::Keyboard::Key::Up),
+				axis(sf::Keyboard::Key::Left, sf::Keyboard::Key::Right)
+			};
+
+			simulation.push_command(command);
+
+			//Animate as soon as a movement key is held, the frame loop stops once the tank has settled
+			if (command.throttle != 0.0f || command.turn != 0.0f) {
+
+				set_animating(true);
+			}
+		}
+
+		//Next frame pacing mode
+		if (auto const* key = event.getIf<sf::Event::KeyPressed>(); key != nullptr && key->code == sf::Keyboard::Key::F4) {
+
+			log_pacing_stats();
+
+			switch (pacer.get_mode()) {
+
+				case Frame_pacing::Adaptive:    pacer.set_mode(Frame_pacing::Vsync);       break;
+				case Frame_pacing::Vsync:       pacer.set_mode(Frame_pacing::Frame_limit); break;
+				case Frame_pacing::Frame_limit: pacer.set_mode(Frame_pacing::Uncapped);    break;
+				case Frame_pacing::Uncapped:    pacer.set_mode(Frame_pacing::Adaptive);    break;
+			}
+		}
+
+		//Toggle the profiler capture
+		if (auto const* key = event.getIf<sf::Event::KeyPressed>(); key != nullptr && key->code == sf::Keyboard::Key::F9) {
+
+			if (Profiler::is_recording()) {
+
+				Profiler::stop();
+				Profiler::write_chrome_trace("tiny_tanks_trace.json");
+			} else {
+
+				Profiler::start({});
+			}
+
+			//Draw at least one frame into the new capture
+			scheduler.request_redraw();
+		}
+
+		//The window contents are gone after these, draw them again
+		if (event.is<sf::Event::Resized>() || event.is<sf::Event::FocusGained>()) {
+
+			scheduler.request_redraw();
+		}
+	};
+
 	//Create main window loop
 	while (window.isOpen()) {
 
-		//Poll for events
-		while (std::optional<sf::Event> current_event = window.pollEvent()) {
+		//Pick up log level changes
+		Log_channels::poll();
+
+		//Nothing to draw, block until an event or a timer instead of spinning
+		if (!scheduler.needs_frame(Widget::get_scene_revision())) {
+
+			if (std::optional<sf::Event> const current_event = scheduler.wait_event(window)) {
+
+				handle_event(*current_event);
+			}
+
+			//The time spent idle isn't frame time
+			pacer.resume();
+		}
+
+		//Sleep until the latest moment to read input for this frame
+		if (scheduler.needs_frame(Widget::get_scene_revision())) {
 
-			//Top right exit button event, mouse click it
-			if (current_event->is<sf::Event::Closed> () ){
+			pacer.wait_for_input();
+		}
+
+		//Poll for events, the pacer stamps each one
+		{
+			PROFILE_ZONE("Event polling");
+
+			while (std::optional<sf::Event> current_event = pacer.poll_event()) {
 
-				window.close();
+				handle_event(*current_event);
 			}
 		}
 
+		//Skip clear and display until a widget changes
+		if (!window.isOpen() || !scheduler.needs_frame(Widget::get_scene_revision())) {
+
+			continue;
+		}
+
 		//Clear every frame before drawing
 		window.clear(sf::Color::White);
 
@@ -49,9 +259,56 @@ int main() {
 		--------------------------
 		*/
 
+		//The world one tick ago, blended between the last two ticks
+		if (simulation.interpolate(std::chrono::steady_clock::now(), tanks)) {
+
+			for (Tank_state const& tank : tanks) {
+
+				tank_shape.setPosition(tank.position);
+				tank_shape.setRotation(sf::degrees(tank.heading));
+				window.draw(tank_shape);
+			}
+		}
+
+		//Keep going while the tanks move or a key holds them, stop drawing once they are at rest
+		set_animating(!simulation.is_at_rest());
+
+		//Overlay goes on top of everything else
+		perf_hud.draw();
+
 		//Displays everything drawn
-		window.display();
+		{
+			PROFILE_ZONE("Display");
+			window.display();
+		}
+
+		pacer.frame_presented();
+
+		//Frame boundary for the profiler
+		PROFILE_FRAME();
+
+		//Feed the overlay this frame's time and counters
+		auto const frame_time = std::chrono::steady_clock::now();
+		perf_hud.add_frame(frame_time - last_frame_time, tiny_tanks::utils::Frame_stats::end_frame());
+		last_frame_time = frame_time;
+
+		scheduler.frame_drawn(Widget::get_scene_revision());
 	}
 
+	log_pacing_stats();
+
+	simulation.stop();
+
+	//Keep a capture that was still running
+	if (Profiler::is_recording()) {
+
+		Profiler::stop();
+		Profiler::write_chrome_trace("tiny_tanks_trace.json");
+	}
+
+	//Write out anything still queued before exiting
+	Log_binary::stop();
+	Log_async::stop();
+
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,204 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/allocation_tracker.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+namespace {
+
+// ===================================================================
+// Counters
+// -------------------------------------------------------------------
+
+// Plain data so they are usable from operator new at any point of a
+// thread's life, including before and after its other thread_locals.
+thread_local Allocation_counts t_counts      = {};
+thread_local Allocation_counts t_frame_start = {};
+
+std::atomic<std::uint64_t> s_total_allocations = 0u;
+std::atomic<std::uint64_t> s_total_bytes       = 0u;
+std::atomic<std::uint64_t> s_total_frees       = 0u;
+
+} // namespace
+
+// ===================================================================
+// class Allocation_tracker
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Allocation_counts Allocation_tracker::get_thread_counts() {
+
+    return t_counts;
+}
+
+// -------------------------------------------------------------------
+Allocation_counts Allocation_tracker::get_total_counts() {
+
+    return Allocation_counts{
+        s_total_allocations.load(std::memory_order_relaxed),
+        s_total_bytes      .load(std::memory_order_relaxed),
+        s_total_frees      .load(std::memory_order_relaxed)
+    };
+}
+
+// -------------------------------------------------------------------
+Allocation_counts Allocation_tracker::end_frame() {
+
+    Allocation_counts const frame{
+        t_counts.allocations - t_frame_start.allocations,
+        t_counts.bytes       - t_frame_start.bytes,
+        t_counts.frees       - t_frame_start.frees
+    };
+
+    t_frame_start = t_counts;
+
+    return frame;
+}
+
+} // tiny_tanks::utils
+
+#if ALLOCATION_TRACKING_COMPILED_IN
+
+// ===================================================================
+// Global operator new / delete
+// -------------------------------------------------------------------
+
+namespace {
+
+// -------------------------------------------------------------------
+void count_allocation(std::size_t const size) {
+
+    using namespace tiny_tanks::utils;
+
+    ++t_counts.allocations;
+    t_counts.bytes += size;
+
+    s_total_allocations.fetch_add(1u,   std::memory_order_relaxed);
+    s_total_bytes      .fetch_add(size, std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------------------
+void count_free() {
+
+    using namespace tiny_tanks::utils;
+
+    ++t_counts.frees;
+    s_total_frees.fetch_add(1u, std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------------------
+// nullptr instead of throwing, the callers below decide.
+void* try_allocate(std::size_t const size, std::size_t const alignment) {
+
+    std::size_t const bytes = (size == 0u) ? 1u : size;
+
+    while (true) {
+
+        void* pointer = nullptr;
+
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+
+            pointer = std::malloc(bytes);
+
+        } else {
+
+#ifdef _WIN32
+            pointer = _aligned_malloc(bytes, alignment);
+#else
+            // aligned_alloc wants the size to be a multiple of the alignment
+            pointer = std::aligned_alloc(alignment, (bytes + alignment - 1u) / alignment * alignment);
+#endif
+        }
+
+        if (pointer != nullptr) {
+
+            count_allocation(size);
+            return pointer;
+        }
+
+        // Same contract as the default operator new, let the handler free memory and retry
+        std::new_handler const handler = std::get_new_handler();
+
+        if (handler == nullptr) {
+
+            return nullptr;
+        }
+
+        handler();
+    }
+}
+
+// -------------------------------------------------------------------
+void* allocate(std::size_t const size, std::size_t const alignment) {
+
+    void* const pointer = try_allocate(size, alignment);
+
+    if (pointer == nullptr) {
+
+        throw std::bad_alloc();
+    }
+
+    return pointer;
+}
+
+// -------------------------------------------------------------------
+void deallocate(void* const pointer, std::size_t const alignment) {
+
+    if (pointer == nullptr) {
+
+        return;
+    }
+
+    count_free();
+
+#ifdef _WIN32
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+
+        _aligned_free(pointer);
+        return;
+    }
+#else
+    static_cast<void>(alignment);
+#endif
+
+    std::free(pointer);
+}
+
+constexpr std::size_t DEFAULT_ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+} // namespace
+
+void* operator new  (std::size_t size)                                    { return allocate(size, DEFAULT_ALIGNMENT); }
+void* operator new[](std::size_t size)                                    { return allocate(size, DEFAULT_ALIGNMENT); }
+void* operator new  (std::size_t size, std::align_val_t align)            { return allocate(size, static_cast<std::size_t>(align)); }
+void* operator new[](std::size_t size, std::align_val_t align)            { return allocate(size, static_cast<std::size_t>(align)); }
+void* operator new  (std::size_t size, std::nothrow_t const&) noexcept    { return try_allocate(size, DEFAULT_ALIGNMENT); }
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept    { return try_allocate(size, DEFAULT_ALIGNMENT); }
+void* operator new  (std::size_t size, std::align_val_t align, std::nothrow_t const&) noexcept { return try_allocate(size, static_cast<std::size_t>(align)); }
+void* operator new[](std::size_t size, std::align_val_t align, std::nothrow_t const&) noexcept { return try_allocate(size, static_cast<std::size_t>(align)); }
+
+void operator delete  (void* pointer) noexcept                                     { deallocate(pointer, DEFAULT_ALIGNMENT); }
+void operator delete[](void* pointer) noexcept                                     { deallocate(pointer, DEFAULT_ALIGNMENT); }
+void operator delete  (void* pointer, std::size_t) noexcept                        { deallocate(pointer, DEFAULT_ALIGNMENT); }
+void operator delete[](void* pointer, std::size_t) noexcept                        { deallocate(pointer, DEFAULT_ALIGNMENT); }
+void operator delete  (void* pointer, std::align_val_t align) noexcept             { deallocate(pointer, static_cast<std::size_t>(align)); }
+void operator delete[](void* pointer, std::align_val_t align) noexcept             { deallocate(pointer, static_cast<std::size_t>(align)); }
+void operator delete  (void* pointer, std::size_t, std::align_val_t align) noexcept { deallocate(pointer, static_cast<std::size_t>(align)); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t align) noexcept { deallocate(pointer, static_cast<std::size_t>(align)); }
+void operator delete  (void* pointer, std::nothrow_t const&) noexcept              { deallocate(pointer, DEFAULT_ALIGNMENT); }
+void operator delete[](void* pointer, std::nothrow_t const&) noexcept              { deallocate(pointer, DEFAULT_ALIGNMENT); }
+void operator delete  (void* pointer, std::align_val_t align, std::nothrow_t const&) noexcept { deallocate(pointer, static_cast<std::size_t>(align)); }
+void operator delete[](void* pointer, std::align_val_t align, std::nothrow_t const&) noexcept { deallocate(pointer, static_cast<std::size_t>(align)); }
+
+#endif // ALLOCATION_TRACKING_COMPILED_IN
@@ -0,0 +1,129 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/asset_archive.h"
+#include "utils/logger.h"
+
+#include <cstring>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// class Asset_archive
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+bool Asset_archive::open(std::filesystem::path const& path) {
+
+    close();
+
+    if (!m_file.open_read(path)) {
+
+        return false;
+    }
+
+    Asset_archive_header header{};
+
+    bool is_valid = m_file.size() >= sizeof(header);
+
+    if (is_valid) {
+
+        std::memcpy(&header, m_file.data(), sizeof(header));
+
+        std::uint64_t const table_end = header.table_offset + std::uint64_t{ header.table_size } * sizeof(Asset_archive_entry);
+
+        is_valid = std::memcmp(header.magic, ASSET_ARCHIVE_MAGIC, sizeof(ASSET_ARCHIVE_MAGIC)) == 0
+                && header.version == ASSET_ARCHIVE_VERSION
+                && header.table_size != 0u
+                && (header.table_size & (header.table_size - 1u)) == 0u
+                && header.table_offset % alignof(Asset_archive_entry) == 0u
+                && table_end <= m_file.size();
+    }
+
+    if (!is_valid) {
+
+        LOG(Log_lvl::ERROR) << "Not a valid asset archive: " << path.string();
+        close();
+        return false;
+    }
+
+    LOG(Log_lvl::INFO) << "Opened asset archive " << path.string() << " with " << header.entry_count << " entries";
+
+    return true;
+}
+
+// -------------------------------------------------------------------
+void Asset_archive::close() {
+
+    m_file.close();
+}
+
+// -------------------------------------------------------------------
+std::span<std::byte const> Asset_archive::find(std::string_view const path) const {
+
+    if (!is_open()) {
+
+        return {};
+    }
+
+    std::byte const* const base = m_file.data();
+
+    Asset_archive_header header{};
+    std::memcpy(&header, base, sizeof(header));
+
+    // The table is aligned in the file and the mapping is page aligned, so it can be read in place.
+    auto const* const table = reinterpret_cast<Asset_archive_entry const*>(base + header.table_offset);
+
+    std::uint64_t const hash = hash_asset_path(path);
+    std::uint32_t const mask = header.table_size - 1u;
+
+    for (std::uint32_t probe = 0u; probe < header.table_size; ++probe) {
+
+        Asset_archive_entry const& entry = table[(hash + probe) & mask];
+
+        if (entry.offset == 0u && entry.size == 0u) {
+
+            break; // Empty slot, the path isn't in the archive
+        }
+
+        if (entry.hash != hash || entry.path_size != path.size()) {
+
+            continue;
+        }
+
+        if (entry.path_offset + std::uint64_t{ entry.path_size } > m_file.size() || entry.offset + entry.size > m_file.size()) {
+
+            break; // Corrupt entry
+        }
+
+        std::string_view const entry_path(reinterpret_cast<char const*>(base + entry.path_offset), entry.path_size);
+
+        if (entry_path == path) {
+
+            return { base + entry.offset, static_cast<std::size_t>(entry.size) };
+        }
+    }
+
+    return {};
+}
+
+// -------------------------------------------------------------------
+std::size_t Asset_archive::get_entry_count() const {
+
+    if (!is_open()) {
+
+        return 0u;
+    }
+
+    Asset_archive_header header{};
+    std::memcpy(&header, m_file.data(), sizeof(header));
+
+    return header.entry_count;
+}
+
+} // tiny_tanks::utils
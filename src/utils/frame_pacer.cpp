@@ -0,0 +1,385 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/frame_pacer.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+namespace {
+
+// -------------------------------------------------------------------
+double to_ms(Frame_pacer::Clock::duration const duration) {
+
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// -------------------------------------------------------------------
+// Events whose effect we wait to see on screen.
+bool is_input(sf::Event const& event) {
+
+    return event.is<sf::Event::KeyPressed>()
+        || event.is<sf::Event::KeyReleased>()
+        || event.is<sf::Event::TextEntered>()
+        || event.is<sf::Event::MouseMoved>()
+        || event.is<sf::Event::MouseButtonPressed>()
+        || event.is<sf::Event::MouseButtonReleased>()
+        || event.is<sf::Event::MouseWheelScrolled>();
+}
+
+// -------------------------------------------------------------------
+template<std::size_t N>
+std::vector<double> get_values(std::array<double, N> const& values, std::size_t const count) {
+
+    return std::vector<double>(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(count));
+}
+
+// -------------------------------------------------------------------
+double percentile(std::vector<double> samples, double const p) {
+
+    if (samples.empty()) {
+
+        return 0.0;
+    }
+
+    std::size_t const index = static_cast<std::size_t>(p / 100.0 * static_cast<double>(samples.size() - 1u) + 0.5);
+
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+    return samples[index];
+}
+
+} // namespace
+
+// ===================================================================
+// class Frame_pacer
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Frame_pacer::Frame_pacer(sf::Window& window, Frame_pacer_settings const& settings)
+    : m_window(window)
+    , m_settings(settings)
+    , m_queue()
+    , m_queue_head(0u)
+    , m_last_present()
+    , m_next_present()
+    , m_input_stamp()
+    , m_drain_time()
+    , m_previous_drain()
+    , m_wait_end(Clock::now())
+    , m_intervals()
+    , m_worst_latencies()
+    , m_input_latencies()
+    , m_work_times()
+    , m_latency_weighted_sum(0.0)
+    , m_latency_weight(0.0)
+    , m_frames(0u)
+    , m_input_frames(0u)
+    , m_sleep_total(0.0)
+    , m_spin_total(0.0)
+{
+
+    if (m_settings.target_rate == 0u) {
+
+        LOG(Log_lvl::ERROR) << "Target rate must be above 0, using 60";
+        m_settings.target_rate = 60u;
+    }
+
+    set_mode(m_settings.mode);
+}
+
+// -------------------------------------------------------------------
+void Frame_pacer::set_mode(Frame_pacing const mode) {
+
+    m_settings.mode = mode;
+
+    m_window.setVerticalSyncEnabled(mode == Frame_pacing::Vsync);
+    m_window.setFramerateLimit(mode == Frame_pacing::Frame_limit ? m_settings.target_rate : 0u);
+
+    reset_stats();
+}
+
+// -------------------------------------------------------------------
+Frame_pacing Frame_pacer::get_mode() const {
+
+    return m_settings.mode;
+}
+
+// -------------------------------------------------------------------
+void Frame_pacer::wait_for_input() {
+
+    Clock::time_point now = Clock::now();
+
+    if (m_settings.mode != Frame_pacing::Adaptive || !m_next_present) {
+
+        m_wait_end = now;
+        return;
+    }
+
+    PROFILE_ZONE("Frame_pacer::wait_for_input");
+
+    // A late frame just doesn't wait
+    Clock::time_point const wake_time = *m_next_present - get_work_estimate() - m_settings.safety_margin;
+
+    while (now < wake_time) {
+
+        drain_window();
+
+        Clock::duration const remaining = wake_time - now;
+
+        if (remaining > m_settings.spin_time) {
+
+            Clock::duration const sleep_time = std::min<Clock::duration>(m_settings.input_poll_interval, remaining - m_settings.spin_time);
+
+            sf::sleep(sf::microseconds(std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(sleep_time).count(), 1)));
+
+            Clock::time_point const woken = Clock::now();
+            m_sleep_total += to_ms(woken - now);
+            now = woken;
+        } else {
+
+            std::this_thread::yield();
+
+            Clock::time_point const spun = Clock::now();
+            m_spin_total += to_ms(spun - now);
+            now = spun;
+        }
+    }
+
+    m_wait_end = now;
+}
+
+// -------------------------------------------------------------------
+std::optional<sf::Event> Frame_pacer::poll_event() {
+
+    if (m_queue_head < m_queue.size()) {
+
+        sf::Event const event = m_queue[m_queue_head++];
+
+        if (m_queue_head == m_queue.size()) {
+
+            m_queue.clear();
+            m_queue_head = 0u;
+        }
+
+        return event;
+    }
+
+    std::optional<sf::Event> event = m_window.pollEvent();
+    Clock::time_point const  now   = Clock::now();
+
+    if (event) {
+
+        note_event(*event, now);
+    } else {
+
+        m_drain_time = now;
+    }
+
+    return event;
+}
+
+// -------------------------------------------------------------------
+void Frame_pacer::frame_presented() {
+
+    Clock::time_point const now = Clock::now();
+
+    ++m_frames;
+
+    if (m_last_present) {
+
+        m_intervals.push(to_ms(now - *m_last_present));
+    }
+
+    // Input arriving between the previous frame's last read and this one's
+    // is presented now: from now - end (just caught) to now - start
+    if (m_previous_drain && m_drain_time && *m_drain_time > *m_previous_drain) {
+
+        double const start = to_ms(now - *m_previous_drain);
+        double const end   = to_ms(now - *m_drain_time);
+        double const width = start - end;
+
+        m_latency_weighted_sum += width * (start + end) * 0.5;
+        m_latency_weight       += width;
+
+        m_worst_latencies.push(start);
+    }
+
+    if (m_drain_time) {
+
+        m_previous_drain = m_drain_time;
+    }
+
+    if (m_input_stamp) {
+
+        m_input_latencies.push(to_ms(now - *m_input_stamp));
+        m_input_stamp.reset();
+
+        ++m_input_frames;
+    }
+
+    m_work_times.push(to_ms(now - m_wait_end));
+    m_last_present = now;
+
+    // Presents aim at a fixed grid, waking early by the safety margin
+    // every frame doesn't speed the rate up. Half a period late or more
+    // starts the grid over from here.
+    Clock::duration const period = get_period();
+
+    if (m_next_present && now < *m_next_present + period / 2) {
+
+        *m_next_present += period;
+    } else {
+
+        m_next_present = now + period;
+    }
+}
+
+// -------------------------------------------------------------------
+void Frame_pacer::resume() {
+
+    m_previous_drain = Clock::now();
+    m_last_present.reset();
+    m_next_present.reset();
+}
+
+// -------------------------------------------------------------------
+Frame_pacing_stats Frame_pacer::get_stats() const {
+
+    Frame_pacing_stats stats;
+
+    stats.frames       = m_frames;
+    stats.input_frames = m_input_frames;
+
+    std::vector<double> const intervals = get_values(m_intervals.values, m_intervals.count);
+
+    if (!intervals.empty()) {
+
+        double sum = 0.0;
+
+        for (double const interval : intervals) {
+
+            sum += interval;
+        }
+
+        double const mean = sum / static_cast<double>(intervals.size());
+
+        double variance = 0.0;
+
+        for (double const interval : intervals) {
+
+            variance += (interval - mean) * (interval - mean);
+        }
+
+        stats.interval_mean_ms   = mean;
+        stats.interval_jitter_ms = std::sqrt(variance / static_cast<double>(intervals.size()));
+        stats.interval_p99_ms    = percentile(intervals, 99.0);
+    }
+
+    if (m_latency_weight > 0.0) {
+
+        stats.latency_mean_ms = m_latency_weighted_sum / m_latency_weight;
+    }
+
+    stats.latency_p99_ms       = percentile(get_values(m_worst_latencies.values, m_worst_latencies.count), 99.0);
+    stats.input_latency_p50_ms = percentile(get_values(m_input_latencies.values, m_input_latencies.count), 50.0);
+    stats.input_latency_p99_ms = percentile(get_values(m_input_latencies.values, m_input_latencies.count), 99.0);
+    stats.work_estimate_ms     = to_ms(get_work_estimate());
+
+    if (m_frames > 0u) {
+
+        stats.sleep_mean_ms = m_sleep_total / static_cast<double>(m_frames);
+        stats.spin_mean_ms  = m_spin_total  / static_cast<double>(m_frames);
+    }
+
+    return stats;
+}
+
+// -------------------------------------------------------------------
+void Frame_pacer::reset_stats() {
+
+    m_last_present.reset();
+    m_next_present.reset();
+    m_input_stamp.reset();
+    m_previous_drain.reset();
+
+    m_intervals       = {};
+    m_worst_latencies = {};
+    m_input_latencies = {};
+    m_work_times      = {};
+
+    m_latency_weighted_sum = 0.0;
+    m_latency_weight       = 0.0;
+
+    m_frames       = 0u;
+    m_input_frames = 0u;
+    m_sleep_total  = 0.0;
+    m_spin_total   = 0.0;
+}
+
+// -------------------------------------------------------------------
+char const* Frame_pacer::to_string(Frame_pacing const mode) {
+
+    switch (mode) {
+
+        case Frame_pacing::Uncapped:    return "uncapped";
+        case Frame_pacing::Vsync:       return "vsync";
+        case Frame_pacing::Frame_limit: return "frame limit";
+        case Frame_pacing::Adaptive:    return "adaptive";
+    }
+
+    return "unknown";
+}
+
+// -------------------------------------------------------------------
+void Frame_pacer::drain_window() {
+
+    while (std::optional<sf::Event> event = m_window.pollEvent()) {
+
+        note_event(*event, Clock::now());
+        m_queue.push_back(*event);
+    }
+
+    m_drain_time = Clock::now();
+}
+
+// -------------------------------------------------------------------
+void Frame_pacer::note_event(sf::Event const& event, Clock::time_point const now) {
+
+    if (!m_input_stamp && is_input(event)) {
+
+        m_input_stamp = now;
+    }
+}
+
+// -------------------------------------------------------------------
+Frame_pacer::Clock::duration Frame_pacer::get_period() const {
+
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_settings.target_rate));
+}
+
+// -------------------------------------------------------------------
+// The slowest of the last WORK_SAMPLE_COUNT frames, one slow frame keeps
+// the wait short for about half a second at 60 Hz.
+Frame_pacer::Clock::duration Frame_pacer::get_work_estimate() const {
+
+    double slowest = 0.0;
+
+    for (std::size_t i = 0u; i < m_work_times.count; ++i) {
+
+        slowest = std::max(slowest, m_work_times.values[i]);
+    }
+
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(slowest));
+}
+
+} // tiny_tanks::utils
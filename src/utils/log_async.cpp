@@ -0,0 +1,407 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/log_async.h"
+#include "utils/logger.h"
+
+#include <algorithm>
+#include <bit>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ===================================================================
+// Internal types
+// -------------------------------------------------------------------
+
+namespace {
+
+// -------------------------------------------------------------------
+// Single producer (the owning thread), single consumer (the writer).
+class Log_ring final {
+
+public:
+    explicit Log_ring(std::size_t const capacity)
+        : m_slots   (std::bit_ceil(std::max<std::size_t>(capacity, 2u)))
+        , m_mask    (m_slots.size() - 1u)
+        , m_head    (0u)
+        , m_tail    (0u)
+        , m_dropped (0u)
+        , m_is_owner_alive(true)
+    {}
+
+    bool try_push(Log_record&& record) {
+
+        std::size_t const head = m_head.load(std::memory_order_relaxed);
+        std::size_t const tail = m_tail.load(std::memory_order_acquire);
+
+        if (head - tail == m_slots.size()) {
+
+            return false;
+        }
+
+        m_slots[head & m_mask] = std::move(record);
+        m_head.store(head + 1u, std::memory_order_release);
+
+        return true;
+    }
+
+    // Moves every queued record into out, returns how many were moved.
+    std::size_t drain(std::vector<Log_record>& out) {
+
+        std::size_t const tail = m_tail.load(std::memory_order_relaxed);
+        std::size_t const head = m_head.load(std::memory_order_acquire);
+
+        for (std::size_t i = tail; i != head; ++i) {
+
+            out.push_back(std::move(m_slots[i & m_mask]));
+        }
+
+        m_tail.store(head, std::memory_order_release);
+
+        return head - tail;
+    }
+
+    void count_drop() { m_dropped.fetch_add(1u, std::memory_order_relaxed); }
+
+    std::uint64_t take_dropped() { return m_dropped.exchange(0u, std::memory_order_relaxed); }
+
+    void orphan()          { m_is_owner_alive.store(false, std::memory_order_release); }
+    bool is_orphan() const { return !m_is_owner_alive.load(std::memory_order_acquire); }
+
+private:
+    std::vector<Log_record> m_slots;
+    std::size_t             m_mask;
+
+    // Head and tail on separate cache lines so producer and writer don't false share.
+    alignas(64) std::atomic<std::size_t>   m_head;
+    alignas(64) std::atomic<std::size_t>   m_tail;
+    alignas(64) std::atomic<std::uint64_t> m_dropped;
+
+    std::atomic<bool> m_is_owner_alive;
+};
+
+// -------------------------------------------------------------------
+struct Backend {
+
+    Log_async_settings settings;
+
+    std::mutex                            rings_mutex;
+    std::vector<std::shared_ptr<Log_ring>> rings;
+
+    std::thread             writer;
+    std::mutex              wake_mutex;
+    std::condition_variable wake_cv;
+    std::condition_variable flushed_cv;
+    std::condition_variable space_cv;
+    bool                    is_stop_requested = false;
+    std::uint64_t           flush_requested   = 0u;
+    std::uint64_t           flush_completed   = 0u;
+    std::size_t             space_wanted      = 0u;  // Producers blocked on a full ring
+    std::uint64_t           drain_count       = 0u;  // Bumped after every drain
+
+    std::atomic<std::uint64_t> dropped_total = 0u;
+
+    // Bumped by every start(), rings from an earlier run are replaced on next use.
+    std::atomic<std::uint64_t> generation = 0u;
+
+    std::ofstream file;
+    std::ostream* out = &std::cout;
+};
+
+Backend s_backend;
+
+// -------------------------------------------------------------------
+// Registers the ring on first use and orphans it when the thread exits,
+// the writer frees it once everything left in it has been printed.
+struct Thread_ring {
+
+    std::shared_ptr<Log_ring> ring;
+    std::uint64_t             generation = 0u;
+
+    Log_ring& get() {
+
+        std::uint64_t const current_generation = s_backend.generation.load(std::memory_order_acquire);
+
+        if (!ring || generation != current_generation) {
+
+            ring       = std::make_shared<Log_ring>(s_backend.settings.ring_capacity);
+            generation = current_generation;
+
+            std::lock_guard<std::mutex> lock(s_backend.rings_mutex);
+            s_backend.rings.push_back(ring);
+        }
+
+        return *ring;
+    }
+
+    ~Thread_ring() {
+
+        if (ring) {
+
+            ring->orphan();
+        }
+    }
+};
+
+thread_local Thread_ring t_ring;
+
+// -------------------------------------------------------------------
+void write_dropped_notice(std::ostream& out, std::uint64_t const dropped, bool const use_color) {
+
+    std::ostringstream message;
+    message << "Log_async dropped " << dropped << " record(s), the ring buffer was full";
+
+    Log_record const notice{ Log_lvl::WARNING, std::source_location::current(), std::chrono::system_clock::now(), message.str() };
+    Logger::write_record(out, notice, use_color);
+}
+
+// -------------------------------------------------------------------
+// Moves everything out of every ring and prints it as one batch.
+void drain_all(std::vector<Log_record>& batch) {
+
+    std::uint64_t dropped = 0u;
+
+    {
+        std::lock_guard<std::mutex> lock(s_backend.rings_mutex);
+
+        for (auto& ring : s_backend.rings) {
+
+            // Checked before draining, an orphan can't push anything after this.
+            bool const was_orphan = ring->is_orphan();
+
+            ring->drain(batch);
+            dropped += ring->take_dropped();
+
+            if (was_orphan) {
+
+                ring.reset();
+            }
+        }
+
+        // Rings of exited threads are empty now, forget them.
+        std::erase(s_backend.rings, nullptr);
+    }
+
+    if (batch.empty() && dropped == 0u) {
+
+        return;
+    }
+
+    // Records from different threads interleave, print them in the order they were logged.
+    std::stable_sort(batch.begin(), batch.end(), [](Log_record const& lhs, Log_record const& rhs) { return lhs.time < rhs.time; });
+
+    bool const use_color = (s_backend.out == &std::cout);
+
+    for (Log_record const& record : batch) {
+
+        Logger::write_record(*s_backend.out, record, use_color);
+    }
+
+    if (dropped != 0u) {
+
+        write_dropped_notice(*s_backend.out, dropped, use_color);
+    }
+
+    // One flush for the whole batch instead of one per record.
+    s_backend.out->flush();
+
+    batch.clear();
+}
+
+// -------------------------------------------------------------------
+void writer_loop() {
+
+    std::vector<Log_record> batch;
+
+    batch.reserve(s_backend.settings.ring_capacity);
+
+    while (true) {
+
+        std::uint64_t flush_target = 0u;
+        bool          is_stopping  = false;
+
+        {
+            std::unique_lock<std::mutex> lock(s_backend.wake_mutex);
+
+            s_backend.wake_cv.wait_for(lock, s_backend.settings.flush_interval, [] {
+
+                return s_backend.is_stop_requested
+                    || s_backend.flush_requested != s_backend.flush_completed
+                    || s_backend.space_wanted != 0u;
+            });
+
+            // Read the request before draining, so the drain covers every record
+            // the flushing thread pushed before asking.
+            flush_target = s_backend.flush_requested;
+            is_stopping  = s_backend.is_stop_requested;
+        }
+
+        drain_all(batch);
+
+        {
+            std::lock_guard<std::mutex> lock(s_backend.wake_mutex);
+            s_backend.flush_completed = flush_target;
+            ++s_backend.drain_count;
+        }
+        s_backend.flushed_cv.notify_all();
+        s_backend.space_cv  .notify_all();
+
+        if (is_stopping) {
+
+            break;
+        }
+    }
+}
+
+} // namespace
+
+// ===================================================================
+// class Log_async
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+bool Log_async::start(Log_async_settings const& settings) {
+
+    if (is_running()) {
+
+        return true;
+    }
+
+    s_backend.settings = settings;
+    s_backend.out      = &std::cout;
+
+    if (!settings.file_path.empty()) {
+
+        s_backend.file.open(settings.file_path, std::ios::out | std::ios::trunc);
+
+        if (!s_backend.file.is_open()) {
+
+            LOG(Log_lvl::ERROR) << "Unable to open log file: " << settings.file_path.string();
+            return false;
+        }
+
+        s_backend.out = &s_backend.file;
+    }
+
+    s_backend.is_stop_requested = false;
+    s_backend.dropped_total     = 0u;
+    s_backend.generation.fetch_add(1u, std::memory_order_release);
+    s_backend.writer            = std::thread(writer_loop);
+
+    s_is_running.store(true, std::memory_order_release);
+
+    return true;
+}
+
+// -------------------------------------------------------------------
+void Log_async::stop() {
+
+    if (!is_running()) {
+
+        return;
+    }
+
+    // New records go through the synchronous path from here on.
+    s_is_running.store(false, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(s_backend.wake_mutex);
+        s_backend.is_stop_requested = true;
+    }
+    s_backend.wake_cv.notify_one();
+
+    s_backend.writer.join();
+
+    {
+        std::lock_guard<std::mutex> lock(s_backend.rings_mutex);
+        s_backend.rings.clear();
+    }
+
+    if (s_backend.file.is_open()) {
+
+        s_backend.file.close();
+    }
+
+    s_backend.out = &std::cout;
+}
+
+// -------------------------------------------------------------------
+void Log_async::flush() {
+
+    if (!is_running()) {
+
+        std::cout.flush();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(s_backend.wake_mutex);
+
+    std::uint64_t const target = ++s_backend.flush_requested;
+    s_backend.wake_cv.notify_one();
+
+    s_backend.flushed_cv.wait(lock, [target] { return s_backend.flush_completed >= target; });
+}
+
+// -------------------------------------------------------------------
+bool Log_async::push(Log_record&& record) {
+
+    Log_ring& ring = t_ring.get();
+
+    if (ring.try_push(std::move(record))) {
+
+        return true;
+    }
+
+    if (s_backend.settings.overflow_policy == Log_overflow_policy::Drop) {
+
+        ring.count_drop();
+        s_backend.dropped_total.fetch_add(1u, std::memory_order_relaxed);
+
+        return false;
+    }
+
+    // Log_overflow_policy::Block, wake the writer and sleep until it has drained.
+    // try_push only moves from the record when it succeeds.
+    std::unique_lock<std::mutex> lock(s_backend.wake_mutex);
+
+    while (!ring.try_push(std::move(record))) {
+
+        // Stopping, the writer's last drain is done or about to be, nothing makes room after it
+        if (s_backend.is_stop_requested) {
+
+            ring.count_drop();
+            s_backend.dropped_total.fetch_add(1u, std::memory_order_relaxed);
+
+            return false;
+        }
+
+        // Taken under the lock the writer bumps it under, a drain can't slip in between
+        std::uint64_t const drain_count = s_backend.drain_count;
+
+        ++s_backend.space_wanted;
+        s_backend.wake_cv.notify_one();
+
+        s_backend.space_cv.wait(lock, [drain_count] {
+
+            return s_backend.drain_count != drain_count || s_backend.is_stop_requested;
+        });
+
+        --s_backend.space_wanted;
+    }
+
+    return true;
+}
+
+// -------------------------------------------------------------------
+std::uint64_t Log_async::get_dropped_count() {
+
+    return s_backend.dropped_total.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,471 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/log_binary.h"
+#include "utils/logger.h"
+#include "utils/mapped_file.h"
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+    #include <sys/stat.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+// ===================================================================
+// Internal state
+// -------------------------------------------------------------------
+
+namespace {
+
+using tiny_tanks::utils::Mapped_file;
+
+// ===================================================================
+// Settings
+// -------------------------------------------------------------------
+
+constexpr std::size_t MAX_SITES          = 4096u;
+constexpr std::size_t FLIGHT_RING_SLOTS  = 4096u;   // Power of two
+constexpr std::size_t MAX_DUMP_PATH_SIZE = 512u;
+
+constexpr int FATAL_SIGNALS[] = {
+    SIGSEGV,
+    SIGABRT,
+    SIGFPE,
+    SIGILL,
+#ifndef _WIN32
+    SIGBUS,
+#endif
+};
+
+// ===================================================================
+// Types
+// -------------------------------------------------------------------
+
+struct Site {
+
+    Log_lvl              level;
+    std::source_location location;
+};
+
+// One record in the flight recorder. sequence is the ring index + 1 of the
+// record stored in it, written after the bytes so a reader can tell a
+// finished slot from one that is being overwritten.
+struct Ring_slot {
+
+    std::atomic<std::uint64_t>                   sequence = 0u;
+    std::uint32_t                                size     = 0u;
+    alignas(8) std::byte                         bytes[LOG_BINARY_MAX_RECORD];
+};
+
+// ===================================================================
+// Globals
+// -------------------------------------------------------------------
+
+// Sites are never removed, so a signal handler can read the first
+// s_site_count entries without a lock.
+std::mutex                 s_sites_mutex;
+std::array<Site, MAX_SITES> s_sites;
+std::atomic<std::uint32_t> s_site_count = 0u;
+
+// Static storage so a crash dump never has to allocate.
+std::array<Ring_slot, FLIGHT_RING_SLOTS> s_ring;
+std::atomic<std::uint64_t>               s_ring_next = 0u;
+
+Mapped_file                s_file;
+std::atomic<std::uint64_t> s_file_cursor  = 0u;
+std::atomic<std::uint64_t> s_dropped      = 0u;
+
+// Writers count themselves in before checking s_is_file_open, stop()
+// clears it and waits for the count to reach 0 before unmapping. Both
+// sides use seq_cst, so one of them always sees the other.
+std::atomic<bool>          s_is_file_open = false;
+std::atomic<std::uint32_t> s_file_writers = 0u;
+
+std::chrono::steady_clock::time_point s_steady_base;
+std::int64_t                          s_wall_base_ns = 0;
+
+char              s_dump_path[MAX_DUMP_PATH_SIZE] = {};
+std::atomic<bool> s_has_dumped                    = false;
+
+// What start() replaced, put back by stop()
+using Signal_handler = void (*)(int);
+
+std::array<Signal_handler, std::size(FATAL_SIGNALS)> s_previous_signal_handlers = {};
+std::terminate_handler                               s_previous_terminate       = nullptr;
+
+// ===================================================================
+// Record building
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+constexpr std::size_t align_up(std::size_t const size) {
+
+    return (size + LOG_BINARY_ALIGNMENT - 1u) & ~(LOG_BINARY_ALIGNMENT - 1u);
+}
+
+// -------------------------------------------------------------------
+constexpr std::uint32_t make_size_and_kind(std::size_t const size, Log_record_kind const kind) {
+
+    return static_cast<std::uint32_t>(size) | (static_cast<std::uint32_t>(kind) << 24u);
+}
+
+// -------------------------------------------------------------------
+Log_binary_file_header make_file_header() {
+
+    Log_binary_file_header header{};
+
+    std::copy(std::begin(LOG_BINARY_MAGIC), std::end(LOG_BINARY_MAGIC), header.magic);
+    header.version            = LOG_BINARY_VERSION;
+    header.header_size        = sizeof(Log_binary_file_header);
+    header.wall_clock_base_ns = s_wall_base_ns;
+
+    return header;
+}
+
+// -------------------------------------------------------------------
+// Builds a Site record into out (at least LOG_BINARY_MAX_RECORD bytes) and
+// returns its size. Long names are cut to fit, no allocation so it can run
+// inside a signal handler.
+std::size_t build_site_record(std::byte* const out, std::uint32_t const site_id, Site const& site) {
+
+    std::string_view const file     = site.location.file_name();
+    std::string_view const function = site.location.function_name();
+
+    std::size_t const room          = LOG_BINARY_MAX_RECORD - sizeof(Log_binary_record_header) - sizeof(Log_binary_site_payload);
+    std::size_t const file_size     = std::min(file.size(), room / 2u);
+    std::size_t const function_size = std::min(function.size(), room - file_size);
+    std::size_t const size          = align_up(sizeof(Log_binary_record_header) + sizeof(Log_binary_site_payload) + file_size + function_size);
+
+    Log_binary_record_header const header{ make_size_and_kind(size, Log_record_kind::Site), site_id, 0u };
+
+    Log_binary_site_payload const payload{
+        static_cast<std::uint32_t>(site.level),
+        static_cast<std::uint32_t>(site.location.line()),
+        static_cast<std::uint32_t>(file_size),
+        static_cast<std::uint32_t>(function_size)
+    };
+
+    std::byte* cursor = out;
+
+    std::memset(out, 0, size);
+    std::memcpy(cursor, &header,  sizeof(header));  cursor += sizeof(header);
+    std::memcpy(cursor, &payload, sizeof(payload)); cursor += sizeof(payload);
+    std::memcpy(cursor, file.data(), file_size);    cursor += file_size;
+    std::memcpy(cursor, function.data(), function_size);
+
+    return size;
+}
+
+// -------------------------------------------------------------------
+// Copies a finished record into the mapped file. The first word goes in
+// last with release so a reader never sees a half written record.
+void append_to_file(std::byte const* const record, std::size_t const size) {
+
+    // Flight recorder only, skip the counting
+    if (!s_is_file_open.load(std::memory_order_relaxed)) {
+
+        return;
+    }
+
+    s_file_writers.fetch_add(1u);
+
+    if (!s_is_file_open.load()) {
+
+        s_file_writers.fetch_sub(1u, std::memory_order_release);
+        return;
+    }
+
+    std::uint64_t const offset = s_file_cursor.fetch_add(size, std::memory_order_relaxed);
+
+    if (offset + size > s_file.size()) {
+
+        s_dropped.fetch_add(1u, std::memory_order_relaxed);
+        s_file_writers.fetch_sub(1u, std::memory_order_release);
+        return;
+    }
+
+    std::byte* const destination = s_file.data() + offset;
+    std::memcpy(destination + sizeof(std::uint32_t), record + sizeof(std::uint32_t), size - sizeof(std::uint32_t));
+
+    std::uint32_t first_word = 0u;
+    std::memcpy(&first_word, record, sizeof(first_word));
+    std::atomic_ref<std::uint32_t>(*reinterpret_cast<std::uint32_t*>(destination)).store(first_word, std::memory_order_release);
+
+    s_file_writers.fetch_sub(1u, std::memory_order_release);
+}
+
+// -------------------------------------------------------------------
+void append_to_ring(std::byte const* const record, std::size_t const size) {
+
+    std::uint64_t const index = s_ring_next.fetch_add(1u, std::memory_order_relaxed);
+    Ring_slot&          slot  = s_ring[index & (FLIGHT_RING_SLOTS - 1u)];
+
+    slot.sequence.store(0u, std::memory_order_relaxed);
+    std::memcpy(slot.bytes, record, size);
+    slot.size = static_cast<std::uint32_t>(size);
+    slot.sequence.store(index + 1u, std::memory_order_release);
+}
+
+// ===================================================================
+// Crash dump (async signal safe from here down)
+// -------------------------------------------------------------------
+
+#ifdef _WIN32
+    int  open_dump (char const* const path) { return ::_open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE); }
+    void close_dump(int const fd)           { ::_close(fd); }
+    bool write_dump(int const fd, void const* const data, std::size_t const size) { return ::_write(fd, data, static_cast<unsigned int>(size)) == static_cast<int>(size); }
+#else
+    int  open_dump (char const* const path) { return ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644); }
+    void close_dump(int const fd)           { ::close(fd); }
+    bool write_dump(int const fd, void const* const data, std::size_t const size) { return ::write(fd, data, size) == static_cast<ssize_t>(size); }
+#endif
+
+// -------------------------------------------------------------------
+bool write_ring_dump(char const* const path) {
+
+    int const fd = open_dump(path);
+
+    if (fd < 0) {
+
+        return false;
+    }
+
+    Log_binary_file_header const header = make_file_header();
+    bool                         ok     = write_dump(fd, &header, sizeof(header));
+
+    // Every site first, the decoder needs them before the messages.
+    std::uint32_t const site_count = std::min<std::uint32_t>(s_site_count.load(std::memory_order_acquire), MAX_SITES);
+    alignas(8) std::byte record[LOG_BINARY_MAX_RECORD];
+
+    for (std::uint32_t id = 0u; ok && id < site_count; ++id) {
+
+        std::size_t const size = build_site_record(record, id, s_sites[id]);
+        ok = write_dump(fd, record, size);
+    }
+
+    // Then the ring from oldest to newest, skipping slots caught mid write.
+    std::uint64_t const next  = s_ring_next.load(std::memory_order_acquire);
+    std::uint64_t const first = (next > FLIGHT_RING_SLOTS) ? next - FLIGHT_RING_SLOTS : 0u;
+
+    for (std::uint64_t index = first; ok && index < next; ++index) {
+
+        Ring_slot const& slot = s_ring[index & (FLIGHT_RING_SLOTS - 1u)];
+
+        if (slot.sequence.load(std::memory_order_acquire) == index + 1u) {
+
+            ok = write_dump(fd, slot.bytes, slot.size);
+        }
+    }
+
+    close_dump(fd);
+
+    return ok;
+}
+
+// -------------------------------------------------------------------
+void on_fatal_signal(int const signal) {
+
+    if (!s_has_dumped.exchange(true)) {
+
+        write_ring_dump(s_dump_path);
+    }
+
+    // Let the default handler finish the process (and make a core dump if enabled).
+    std::signal(signal, SIG_DFL);
+    std::raise(signal);
+}
+
+// -------------------------------------------------------------------
+void on_terminate() {
+
+    if (!s_has_dumped.exchange(true)) {
+
+        write_ring_dump(s_dump_path);
+    }
+
+    std::abort();
+}
+
+} // namespace
+
+// ===================================================================
+// class Log_binary
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+bool Log_binary::start(Log_binary_settings const& settings) {
+
+    if (is_running()) {
+
+        return true;
+    }
+
+    s_steady_base  = std::chrono::steady_clock::now();
+    s_wall_base_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    s_dropped      = 0u;
+    s_ring_next    = 0u;
+
+    for (Ring_slot& slot : s_ring) {
+
+        slot.sequence.store(0u, std::memory_order_relaxed);
+    }
+
+    if (!settings.file_path.empty()) {
+
+        if (!s_file.create(settings.file_path, std::max(settings.file_capacity, sizeof(Log_binary_file_header)))) {
+
+            return false;
+        }
+
+        Log_binary_file_header const header = make_file_header();
+        std::memcpy(s_file.data(), &header, sizeof(header));
+        s_file_cursor = sizeof(header);
+        s_is_file_open.store(true);
+
+        // Sites registered before start() have to be in the file too.
+        std::lock_guard<std::mutex> lock(s_sites_mutex);
+
+        alignas(8) std::byte record[LOG_BINARY_MAX_RECORD];
+        std::uint32_t const  site_count = s_site_count.load(std::memory_order_relaxed);
+
+        for (std::uint32_t id = 0u; id < site_count; ++id) {
+
+            append_to_file(record, build_site_record(record, id, s_sites[id]));
+        }
+    }
+
+    if (!settings.crash_dump_path.empty()) {
+
+        std::string const path = settings.crash_dump_path.string();
+
+        if (path.size() >= MAX_DUMP_PATH_SIZE) {
+
+            LOG(Log_lvl::WARNING) << "Crash dump path is too long, no crash handlers installed: " << path;
+        } else {
+
+            std::copy(path.begin(), path.end(), s_dump_path);
+            s_dump_path[path.size()] = '\0';
+            s_has_dumped             = false;
+
+            for (std::size_t i = 0u; i < std::size(FATAL_SIGNALS); ++i) {
+
+                s_previous_signal_handlers[i] = std::signal(FATAL_SIGNALS[i], on_fatal_signal);
+            }
+
+            s_previous_terminate = std::set_terminate(on_terminate);
+        }
+    }
+
+    s_is_running.store(true, std::memory_order_release);
+
+    return true;
+}
+
+// -------------------------------------------------------------------
+void Log_binary::stop() {
+
+    if (!is_running()) {
+
+        return;
+    }
+
+    s_is_running.store(false, std::memory_order_release);
+
+    if (s_dump_path[0] != '\0') {
+
+        for (std::size_t i = 0u; i < std::size(FATAL_SIGNALS); ++i) {
+
+            // SIG_ERR when start() couldn't install ours, nothing to put back then
+            if (s_previous_signal_handlers[i] != SIG_ERR) {
+
+                std::signal(FATAL_SIGNALS[i], s_previous_signal_handlers[i]);
+            }
+        }
+
+        std::set_terminate(s_previous_terminate);
+
+        s_dump_path[0] = '\0';
+    }
+
+    // Threads that got past the is_running() check before the store above
+    // may still be copying into the mapping, wait for them before unmapping.
+    s_is_file_open.store(false);
+
+    while (s_file_writers.load(std::memory_order_acquire) != 0u) {
+
+        std::this_thread::yield();
+    }
+
+    // The file keeps its full capacity, the decoder stops at the first zero word.
+    s_file.close();
+}
+
+// -------------------------------------------------------------------
+std::uint32_t Log_binary::register_site(Log_lvl const level, std::source_location const& location) {
+
+    std::lock_guard<std::mutex> lock(s_sites_mutex);
+
+    std::uint32_t const id = s_site_count.load(std::memory_order_relaxed);
+
+    if (id >= MAX_SITES) {
+
+        return LOG_BINARY_INVALID_SITE;
+    }
+
+    s_sites[id] = Site{ level, location };
+    s_site_count.store(id + 1u, std::memory_order_release);
+
+    if (is_running()) {
+
+        alignas(8) std::byte record[LOG_BINARY_MAX_RECORD];
+        append_to_file(record, build_site_record(record, id, s_sites[id]));
+    }
+
+    return id;
+}
+
+// -------------------------------------------------------------------
+void Log_binary::write(std::uint32_t const site_id, std::byte const* const args, std::size_t const args_size) {
+
+    auto const          now          = std::chrono::steady_clock::now();
+    std::uint64_t const timestamp_ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - s_steady_base).count());
+
+    std::size_t const size = align_up(sizeof(Log_binary_record_header) + args_size);
+
+    Log_binary_record_header const header{ make_size_and_kind(size, Log_record_kind::Message), site_id, timestamp_ns };
+
+    // Build it once on the stack, then it's two memcpys.
+    alignas(8) std::byte record[LOG_BINARY_MAX_RECORD];
+
+    std::memcpy(record, &header, sizeof(header));
+    std::memcpy(record + sizeof(header), args, args_size);
+    std::memset(record + sizeof(header) + args_size, 0, size - sizeof(header) - args_size);
+
+    append_to_ring(record, size);
+    append_to_file(record, size);
+}
+
+// -------------------------------------------------------------------
+bool Log_binary::dump_flight_recorder(std::filesystem::path const& path) {
+
+    return write_ring_dump(path.string().c_str());
+}
+
+// -------------------------------------------------------------------
+std::uint64_t Log_binary::get_dropped_count() {
+
+    return s_dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,270 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/log_channel.h"
+#include "utils/logger.h"
+
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ===================================================================
+// Internal state
+// -------------------------------------------------------------------
+
+namespace {
+
+constexpr auto CONFIG_POLL_INTERVAL = std::chrono::milliseconds(500);
+
+// Channels are never removed, LOG call sites keep references to them.
+std::mutex                                s_mutex;
+std::vector<std::unique_ptr<Log_channel>> s_channels;
+
+// Overrides from set_mask() / the config file, also applied to channels created later.
+std::unordered_map<std::string, int> s_overrides;
+std::optional<int>                   s_default_override;
+
+std::filesystem::path                 s_config_path;
+std::filesystem::file_time_type       s_config_write_time;
+std::chrono::steady_clock::time_point s_next_poll;
+std::atomic<bool>                     s_is_reload_requested = false;
+
+// -------------------------------------------------------------------
+// Levels a channel starts with, s_mutex must be held.
+int initial_mask(std::string_view const name) {
+
+    if (auto const found = s_overrides.find(std::string(name)); found != s_overrides.end()) {
+
+        return found->second;
+    }
+
+    if (s_default_override) {
+
+        return *s_default_override;
+    }
+
+    // No override, fall back to the extern settings from main.cpp.
+    bool const is_file_allowed = (LOG_SPECIFIC_FILE_ONLY == "ALL") || (name == LOG_SPECIFIC_FILE_ONLY);
+
+    return is_file_allowed ? ENABLED_LOG_LVLS : Log_lvl::NO_LOG_LVLS;
+}
+
+// -------------------------------------------------------------------
+// Re-derives every channel's mask after the overrides changed, s_mutex must be held.
+void apply_overrides() {
+
+    for (auto const& channel : s_channels) {
+
+        channel->set_mask(initial_mask(channel->get_name()));
+    }
+}
+
+// -------------------------------------------------------------------
+std::string_view trim(std::string_view text) {
+
+    auto const first = text.find_first_not_of(" \t\r");
+
+    if (first == std::string_view::npos) {
+
+        return {};
+    }
+
+    auto const last = text.find_last_not_of(" \t\r");
+
+    return text.substr(first, last - first + 1u);
+}
+
+// -------------------------------------------------------------------
+void on_reload_signal(int const) {
+
+    s_is_reload_requested.store(true, std::memory_order_relaxed);
+}
+
+} // namespace
+
+// ===================================================================
+// class Log_channels
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Log_channel& Log_channels::get(std::string_view const name) {
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    for (auto const& channel : s_channels) {
+
+        if (channel->get_name() == name) {
+
+            return *channel;
+        }
+    }
+
+    s_channels.push_back(std::make_unique<Log_channel>(std::string(name), initial_mask(name)));
+
+    return *s_channels.back();
+}
+
+// -------------------------------------------------------------------
+void Log_channels::set_mask(std::string_view const name, int const mask) {
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    if (name == "*") {
+
+        s_default_override = mask;
+    } else {
+
+        s_overrides[std::string(name)] = mask;
+    }
+
+    apply_overrides();
+}
+
+// -------------------------------------------------------------------
+bool Log_channels::load_config(std::filesystem::path const& path) {
+
+    std::ifstream file(path);
+
+    if (!file) {
+
+        return false;
+    }
+
+    std::unordered_map<std::string, int> overrides;
+    std::optional<int>                   default_override;
+
+    std::string line;
+    int         line_number = 0;
+
+    while (std::getline(file, line)) {
+
+        ++line_number;
+
+        std::string_view text = line;
+
+        // Everything after a # is a comment.
+        text = trim(text.substr(0u, text.find('#')));
+
+        if (text.empty()) {
+
+            continue;
+        }
+
+        auto const equals = text.find('=');
+        int        mask   = Log_lvl::NO_LOG_LVLS;
+
+        if (equals == std::string_view::npos || !parse_mask(trim(text.substr(equals + 1u)), mask)) {
+
+            LOG(Log_lvl::WARNING) << "Skipping bad log config line " << line_number << " in " << path.string() << ": " << line;
+            continue;
+        }
+
+        std::string_view const name = trim(text.substr(0u, equals));
+
+        if (name == "*") {
+
+            default_override = mask;
+        } else {
+
+            overrides[std::string(name)] = mask;
+        }
+    }
+
+    // The file replaces every earlier override, so removing a line resets that channel.
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        s_overrides        = std::move(overrides);
+        s_default_override = default_override;
+
+        apply_overrides();
+    }
+
+    LOG(Log_lvl::INFO) << "Loaded log levels from " << path.string();
+
+    return true;
+}
+
+// -------------------------------------------------------------------
+void Log_channels::watch_config(std::filesystem::path const& path) {
+
+    s_config_path = path;
+
+    std::error_code error;
+    s_config_write_time = std::filesystem::last_write_time(path, error);
+
+    if (!error) {
+
+        load_config(path);
+    }
+
+#ifdef SIGHUP
+    std::signal(SIGHUP, on_reload_signal);
+#endif
+
+    s_next_poll = std::chrono::steady_clock::now() + CONFIG_POLL_INTERVAL;
+}
+
+// -------------------------------------------------------------------
+void Log_channels::poll() {
+
+    if (s_config_path.empty()) {
+
+        return;
+    }
+
+    bool is_reload_requested = s_is_reload_requested.exchange(false, std::memory_order_relaxed);
+
+    auto const now = std::chrono::steady_clock::now();
+
+    if (now >= s_next_poll) {
+
+        s_next_poll = now + CONFIG_POLL_INTERVAL;
+
+        std::error_code error;
+        auto const      write_time = std::filesystem::last_write_time(s_config_path, error);
+
+        if (!error && write_time != s_config_write_time) {
+
+            s_config_write_time = write_time;
+            is_reload_requested = true;
+        }
+    }
+
+    if (is_reload_requested) {
+
+        load_config(s_config_path);
+    }
+}
+
+// -------------------------------------------------------------------
+bool Log_channels::parse_mask(std::string_view text, int& mask) {
+
+    mask = Log_lvl::NO_LOG_LVLS;
+
+    while (!text.empty()) {
+
+        auto const             separator = text.find_first_of("|,");
+        std::string_view const name      = trim(text.substr(0u, separator));
+
+        if      (name == "TRACE")   { mask |= Log_lvl::TRACE;        }
+        else if (name == "DEBUG")   { mask |= Log_lvl::DEBUG;        }
+        else if (name == "INFO")    { mask |= Log_lvl::INFO;         }
+        else if (name == "WARNING") { mask |= Log_lvl::WARNING;      }
+        else if (name == "ERROR")   { mask |= Log_lvl::ERROR;        }
+        else if (name == "ALL")     { mask |= Log_lvl::ALL_LOG_LVLS; }
+        else if (name == "NONE")    { /* Adds nothing */             }
+        else                        { return false;                  }
+
+        text = (separator == std::string_view::npos) ? std::string_view{} : text.substr(separator + 1u);
+    }
+
+    return true;
+}
@@ -0,0 +1,242 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/mapped_file.h"
+#include "utils/logger.h"
+
+#include <utility>
+
+#ifdef _WIN32
+    // NOGDI keeps wingdi.h from defining an ERROR macro that breaks Log_lvl::ERROR.
+    #ifndef NOGDI
+        #define NOGDI
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// class Mapped_file
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Mapped_file::~Mapped_file() {
+
+    close();
+}
+
+// -------------------------------------------------------------------
+Mapped_file::Mapped_file(Mapped_file&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0u))
+{}
+
+// -------------------------------------------------------------------
+Mapped_file& Mapped_file::operator=(Mapped_file&& other) noexcept {
+
+    if (this != &other) {
+
+        close();
+
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0u);
+    }
+
+    return *this;
+}
+
+#ifdef _WIN32
+
+// -------------------------------------------------------------------
+bool Mapped_file::create(std::filesystem::path const& path, std::size_t const size) {
+
+    close();
+
+    HANDLE const file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) {
+
+        LOG(Log_lvl::ERROR) << "Unable to create file: " << path.string();
+        return false;
+    }
+
+    ULARGE_INTEGER const file_size{ .QuadPart = static_cast<ULONGLONG>(size) };
+    HANDLE const mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, file_size.HighPart, file_size.LowPart, nullptr);
+
+    if (mapping != nullptr) {
+
+        m_data = static_cast<std::byte*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0u, 0u, size));
+        CloseHandle(mapping);
+    }
+
+    CloseHandle(file);
+
+    if (m_data == nullptr) {
+
+        LOG(Log_lvl::ERROR) << "Unable to map file: " << path.string();
+        return false;
+    }
+
+    m_size = size;
+
+    return true;
+}
+
+// -------------------------------------------------------------------
+bool Mapped_file::open_read(std::filesystem::path const& path) {
+
+    close();
+
+    HANDLE const file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) {
+
+        LOG(Log_lvl::ERROR) << "Unable to open file: " << path.string();
+        return false;
+    }
+
+    LARGE_INTEGER file_size{};
+    GetFileSizeEx(file, &file_size);
+
+    HANDLE const mapping = (file_size.QuadPart > 0) ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0u, 0u, nullptr) : nullptr;
+
+    if (mapping != nullptr) {
+
+        m_data = static_cast<std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0u, 0u, 0u));
+        CloseHandle(mapping);
+    }
+
+    CloseHandle(file);
+
+    if (m_data == nullptr) {
+
+        LOG(Log_lvl::ERROR) << "Unable to map file: " << path.string();
+        return false;
+    }
+
+    m_size = static_cast<std::size_t>(file_size.QuadPart);
+
+    return true;
+}
+
+// -------------------------------------------------------------------
+void Mapped_file::close() {
+
+    if (m_data != nullptr) {
+
+        UnmapViewOfFile(m_data);
+    }
+
+    m_data = nullptr;
+    m_size = 0u;
+}
+
+#else
+
+// -------------------------------------------------------------------
+bool Mapped_file::create(std::filesystem::path const& path, std::size_t const size) {
+
+    close();
+
+    int const fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0) {
+
+        LOG(Log_lvl::ERROR) << "Unable to create file: " << path.string();
+        return false;
+    }
+
+    // ftruncate fills the new size with zeros.
+    if (::ftruncate(fd, static_cast<off_t>(size)) == 0) {
+
+        void* const data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (data != MAP_FAILED) {
+
+            m_data = static_cast<std::byte*>(data);
+        }
+    }
+
+    ::close(fd);
+
+    if (m_data == nullptr) {
+
+        LOG(Log_lvl::ERROR) << "Unable to map file: " << path.string();
+        return false;
+    }
+
+    m_size = size;
+
+    return true;
+}
+
+// -------------------------------------------------------------------
+bool Mapped_file::open_read(std::filesystem::path const& path) {
+
+    close();
+
+    int const fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+
+        LOG(Log_lvl::ERROR) << "Unable to open file: " << path.string();
+        return false;
+    }
+
+    struct stat file_stat{};
+
+    if (::fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+
+        std::size_t const size = static_cast<std::size_t>(file_stat.st_size);
+        void* const       data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data != MAP_FAILED) {
+
+            m_data = static_cast<std::byte*>(data);
+            m_size = size;
+        }
+    }
+
+    ::close(fd);
+
+    if (m_data == nullptr) {
+
+        LOG(Log_lvl::ERROR) << "Unable to map file: " << path.string();
+        return false;
+    }
+
+    return true;
+}
+
+// -------------------------------------------------------------------
+void Mapped_file::close() {
+
+    if (m_data != nullptr) {
+
+        ::munmap(m_data, m_size);
+    }
+
+    m_data = nullptr;
+    m_size = 0u;
+}
+
+#endif
+
+} // tiny_tanks::utils
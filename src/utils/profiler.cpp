@@ -0,0 +1,335 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/profiler.h"
+#include "utils/logger.h"
+
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+namespace {
+
+// ===================================================================
+// Zone buffers
+// -------------------------------------------------------------------
+
+struct Zone {
+
+    char const*       name;
+    std::uint64_t     begin_ns;
+    std::uint64_t     end_ns;
+    Allocation_counts allocations;
+};
+
+// -------------------------------------------------------------------
+// Written only by its thread. The count is published with release so the
+// export can read every zone below it without a lock.
+struct Zone_buffer {
+
+    Zone_buffer(std::size_t const capacity, std::uint32_t const index, std::string name)
+        : zones(capacity)
+        , thread_index(index)
+        , thread_name(std::move(name))
+    {}
+
+    std::vector<Zone>          zones;
+    std::atomic<std::size_t>   count   = 0u;
+    std::atomic<std::uint64_t> dropped = 0u;
+
+    std::uint32_t thread_index;
+    std::string   thread_name;  // Guarded by the backend mutex
+};
+
+// -------------------------------------------------------------------
+struct Backend {
+
+    std::mutex mutex;
+
+    Profiler_settings                         settings;
+    std::vector<std::shared_ptr<Zone_buffer>> buffers;
+    std::vector<std::uint64_t>                frame_marks;
+
+    std::uint64_t start_ns          = 0u;
+    std::uint32_t next_thread_index = 1u;  // 0 is the frames track
+
+    // Bumped by every start(), buffers from an earlier run are replaced on next use.
+    std::atomic<std::uint64_t> generation = 0u;
+};
+
+Backend s_backend;
+
+// -------------------------------------------------------------------
+struct Thread_buffer {
+
+    std::shared_ptr<Zone_buffer> buffer;
+    std::uint64_t                generation   = 0u;
+    std::uint32_t                thread_index = 0u;
+    std::string                  thread_name;
+
+    Zone_buffer& get() {
+
+        std::uint64_t const current_generation = s_backend.generation.load(std::memory_order_acquire);
+
+        if (!buffer || generation != current_generation) {
+
+            std::lock_guard<std::mutex> lock(s_backend.mutex);
+
+            // Keep the same track in the export across runs
+            if (thread_index == 0u) {
+
+                thread_index = s_backend.next_thread_index++;
+            }
+
+            if (thread_name.empty()) {
+
+                thread_name = "Thread " + std::to_string(thread_index);
+            }
+
+            buffer     = std::make_shared<Zone_buffer>(s_backend.settings.zones_per_thread, thread_index, thread_name);
+            generation = current_generation;
+
+            s_backend.buffers.push_back(buffer);
+        }
+
+        return *buffer;
+    }
+};
+
+thread_local Thread_buffer t_buffer;
+
+// -------------------------------------------------------------------
+// Zone names are code, but keep the JSON valid whatever they hold.
+void write_json_string(std::ostream& out, std::string_view const string) {
+
+    out << '"';
+
+    for (char const character : string) {
+
+        switch (character) {
+
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n";  break;
+            case '\t': out << "\\t";  break;
+            default:   out << character; break;
+        }
+    }
+
+    out << '"';
+}
+
+// -------------------------------------------------------------------
+void write_complete_event(
+    std::ostream&                  out,
+    std::string_view const         name,
+    std::uint32_t const            thread_index,
+    std::uint64_t const            begin_ns,
+    std::uint64_t const            end_ns,
+    Allocation_counts const* const allocations = nullptr
+) {
+
+    // Chrome trace times are in microseconds
+    out << ",\n{\"name\":";
+    write_json_string(out, name);
+    out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread_index
+        << ",\"ts\":"  << static_cast<double>(begin_ns - s_backend.start_ns) / 1000.0
+        << ",\"dur\":" << static_cast<double>(end_ns   - begin_ns)           / 1000.0;
+
+    if (allocations != nullptr) {
+
+        out << ",\"args\":{\"allocations\":" << allocations->allocations
+            << ",\"bytes\":"  << allocations->bytes
+            << ",\"frees\":"  << allocations->frees << '}';
+    }
+
+    out << '}';
+}
+
+// -------------------------------------------------------------------
+void write_thread_name(std::ostream& out, std::uint32_t const thread_index, std::string_view const name) {
+
+    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread_index << ",\"args\":{\"name\":";
+    write_json_string(out, name);
+    out << "}}";
+}
+
+} // namespace
+
+// ===================================================================
+// class Profiler
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+void Profiler::start(Profiler_settings const& settings) {
+
+    std::lock_guard<std::mutex> lock(s_backend.mutex);
+
+    s_is_recording.store(false, std::memory_order_relaxed);
+
+    // Buffers of threads that are gone have nobody left to reuse them
+    s_backend.buffers.clear();
+    s_backend.frame_marks.clear();
+    s_backend.frame_marks.reserve(settings.frames_kept);
+
+    s_backend.settings = settings;
+    s_backend.start_ns = now_ns();
+
+    s_backend.generation.fetch_add(1u, std::memory_order_release);
+    s_is_recording.store(true, std::memory_order_release);
+}
+
+// -------------------------------------------------------------------
+void Profiler::stop() {
+
+    s_is_recording.store(false, std::memory_order_release);
+}
+
+// -------------------------------------------------------------------
+void Profiler::set_thread_name(std::string_view const name) {
+
+    std::lock_guard<std::mutex> lock(s_backend.mutex);
+
+    t_buffer.thread_name = name;
+
+    if (t_buffer.buffer) {
+
+        t_buffer.buffer->thread_name = name;
+    }
+}
+
+// -------------------------------------------------------------------
+void Profiler::frame_mark() {
+
+    if (!is_recording()) {
+
+        return;
+    }
+
+    std::uint64_t const time_ns = now_ns();
+
+    std::lock_guard<std::mutex> lock(s_backend.mutex);
+
+    // Past the reserved capacity a push would allocate mid frame
+    if (s_backend.frame_marks.size() < s_backend.settings.frames_kept) {
+
+        s_backend.frame_marks.push_back(time_ns);
+    }
+}
+
+// -------------------------------------------------------------------
+void Profiler::record_zone(
+    char const* const        name,
+    std::uint64_t const      begin_ns,
+    std::uint64_t const      end_ns,
+    Allocation_counts const& allocations
+) {
+
+    Zone_buffer& buffer = t_buffer.get();
+
+    std::size_t const index = buffer.count.load(std::memory_order_relaxed);
+
+    if (index == buffer.zones.size()) {
+
+        buffer.dropped.fetch_add(1u, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer.zones[index] = Zone{ name, begin_ns, end_ns, allocations };
+    buffer.count.store(index + 1u, std::memory_order_release);
+}
+
+// -------------------------------------------------------------------
+bool Profiler::write_chrome_trace(std::filesystem::path const& path) {
+
+    if (is_recording()) {
+
+        LOG(Log_lvl::WARNING) << "Writing a trace while still recording, zones from other threads may be missing";
+    }
+
+    std::ofstream out(path, std::ios::trunc);
+
+    if (!out) {
+
+        LOG(Log_lvl::ERROR) << "Unable to write trace " << path.string();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s_backend.mutex);
+
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+        << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Tiny Tanks\"}}";
+
+    write_thread_name(out, 0u, "Frames");
+
+    // Each frame spans from the previous mark (or the start) to its own
+    std::uint64_t frame_begin_ns = s_backend.start_ns;
+
+    for (std::size_t i = 0u; i < s_backend.frame_marks.size(); ++i) {
+
+        write_complete_event(out, "Frame " + std::to_string(i + 1u), 0u, frame_begin_ns, s_backend.frame_marks[i]);
+        frame_begin_ns = s_backend.frame_marks[i];
+    }
+
+    std::size_t zone_count = 0u;
+
+    for (auto const& buffer : s_backend.buffers) {
+
+        write_thread_name(out, buffer->thread_index, buffer->thread_name);
+
+        std::size_t const count = buffer->count.load(std::memory_order_acquire);
+
+        for (std::size_t i = 0u; i < count; ++i) {
+
+            Zone const& zone = buffer->zones[i];
+            write_complete_event(
+                out, zone.name, buffer->thread_index, zone.begin_ns, zone.end_ns,
+                Allocation_tracker::is_compiled_in() ? &zone.allocations : nullptr
+            );
+        }
+
+        zone_count += count;
+    }
+
+    out << "\n]}\n";
+
+    if (!out) {
+
+        LOG(Log_lvl::ERROR) << "Unable to write trace " << path.string();
+        return false;
+    }
+
+    LOG(Log_lvl::INFO) << "Wrote " << zone_count << " zones and " << s_backend.frame_marks.size() << " frames to " << path.string();
+
+    return true;
+}
+
+// -------------------------------------------------------------------
+std::uint64_t Profiler::get_dropped_count() {
+
+    std::lock_guard<std::mutex> lock(s_backend.mutex);
+
+    std::uint64_t dropped = 0u;
+
+    for (auto const& buffer : s_backend.buffers) {
+
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+
+    return dropped;
+}
+
+} // tiny_tanks::utils
@@ -0,0 +1,118 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/render_scheduler.h"
+#include "utils/logger.h"
+
+#include <algorithm>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// class Render_scheduler
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Render_scheduler::Render_scheduler(Clock::duration const max_idle_wait)
+    : m_max_idle_wait(max_idle_wait)
+    , m_wake_time()
+    , m_drawn_revision()
+    , m_animation_count(0)
+    , m_is_redraw_requested(false)
+    , m_is_idle_enabled(true)
+    , m_stats({})
+{}
+
+// -------------------------------------------------------------------
+void Render_scheduler::begin_animation() {
+
+    ++m_animation_count;
+}
+
+// -------------------------------------------------------------------
+void Render_scheduler::end_animation() {
+
+    if (m_animation_count == 0) {
+
+        LOG(Log_lvl::ERROR) << "end_animation() without a matching begin_animation()";
+        return;
+    }
+
+    --m_animation_count;
+
+    // Draw the animation's last state
+    m_is_redraw_requested = true;
+}
+
+// -------------------------------------------------------------------
+void Render_scheduler::wake_at(Clock::time_point const time) {
+
+    if (!m_wake_time || time < *m_wake_time) {
+
+        m_wake_time = time;
+    }
+}
+
+// -------------------------------------------------------------------
+bool Render_scheduler::needs_frame(std::uint64_t const scene_revision) const {
+
+    return !m_is_idle_enabled
+        || m_is_redraw_requested
+        || m_animation_count > 0
+        || m_drawn_revision != scene_revision;
+}
+
+// -------------------------------------------------------------------
+void Render_scheduler::frame_drawn(std::uint64_t const scene_revision) {
+
+    m_drawn_revision      = scene_revision;
+    m_is_redraw_requested = false;
+
+    ++m_stats.frames_drawn;
+}
+
+// -------------------------------------------------------------------
+std::optional<sf::Event> Render_scheduler::wait_event(sf::Window& window) {
+
+    Clock::time_point const now = Clock::now();
+
+    Clock::duration timeout = m_max_idle_wait;
+
+    if (m_wake_time) {
+
+        timeout = std::min(timeout, *m_wake_time - now);
+    }
+
+    ++m_stats.idle_waits;
+
+    std::optional<sf::Event> event;
+
+    // A zero timeout would block forever, a timer that is already due just skips the wait
+    if (timeout > Clock::duration::zero()) {
+
+        auto const microseconds = std::chrono::duration_cast<std::chrono::microseconds>(timeout).count();
+        event = window.waitEvent(sf::microseconds(std::max<std::int64_t>(microseconds, 1)));
+    }
+
+    if (m_wake_time && Clock::now() >= *m_wake_time) {
+
+        m_wake_time.reset();
+    }
+
+    if (event) {
+
+        ++m_stats.event_wakeups;
+    } else {
+
+        ++m_stats.timeout_wakeups;
+    }
+
+    return event;
+}
+
+} // tiny_tanks::utils
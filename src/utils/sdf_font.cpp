@@ -0,0 +1,247 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/sdf_font.h"
+#include "utils/asset_archive.h"
+#include "utils/logger.h"
+#include "utils/resource_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+namespace {
+
+// -------------------------------------------------------------------
+// Archive first, loose file otherwise, like the other loaders.
+std::vector<std::byte> read_bytes(std::string const& path) {
+
+    if (auto const bytes = assets().find(path); !bytes.empty()) {
+
+        return std::vector<std::byte>(bytes.begin(), bytes.end());
+    }
+
+    std::ifstream in(path, std::ios::binary);
+
+    if (!in) {
+
+        return {};
+    }
+
+    std::vector<char> const contents{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    std::vector<std::byte>  bytes(contents.size());
+
+    std::memcpy(bytes.data(), contents.data(), contents.size());
+
+    return bytes;
+}
+
+// -------------------------------------------------------------------
+// The distance is converted to screen pixels with the rate the atlas
+// coordinates change across the quad, so edges stay one pixel soft and
+// the outline keeps its width at any size and scale.
+constexpr char const* SDF_FRAGMENT_SHADER = R"(
+    uniform sampler2D texture;
+    uniform vec2      texture_size;
+    uniform float     distance_range;
+    uniform float     outline_thickness;
+    uniform vec4      outline_color;
+
+    void main() {
+
+        vec2  uv       = gl_TexCoord[0].xy;
+        float distance = texture2D(texture, uv).a;
+
+        vec2  texels = fwidth(uv * texture_size);
+        float scale  = max(0.5 * (texels.x + texels.y), 0.0001);
+
+        // Screen pixels from the outline, positive inside
+        float inside = (distance - 0.5) * 2.0 * distance_range / scale;
+
+        float fill    = clamp(inside + 0.5, 0.0, 1.0);
+        float outline = clamp(inside + outline_thickness + 0.5, 0.0, 1.0);
+
+        vec4 edge_color = (outline_thickness > 0.0) ? outline_color : gl_Color;
+        vec4 color      = mix(edge_color, gl_Color, fill);
+
+        gl_FragColor = vec4(color.rgb, color.a * outline);
+    }
+)";
+
+// -------------------------------------------------------------------
+constexpr std::uint64_t get_pair_key(std::uint32_t const first, std::uint32_t const second) {
+
+    return (std::uint64_t{ first } << 32u) | second;
+}
+
+} // namespace
+
+// ===================================================================
+// class Sdf_font
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+bool Sdf_font::load(std::string const& path) {
+
+    std::vector<std::byte> const bytes = read_bytes(path);
+
+    Sdf_font_header header{};
+
+    bool is_valid = bytes.size() >= sizeof(header);
+
+    if (is_valid) {
+
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        std::uint64_t const size = sizeof(header)
+                                 + std::uint64_t{ header.glyph_count   } * sizeof(Sdf_glyph)
+                                 + std::uint64_t{ header.kerning_count } * sizeof(Sdf_kerning);
+
+        is_valid = std::memcmp(header.magic, SDF_FONT_MAGIC, sizeof(SDF_FONT_MAGIC)) == 0
+                && header.version == SDF_FONT_VERSION
+                && header.glyph_count != 0u
+                && header.base_size > 0.0f
+                && header.distance_range > 0.0f
+                && size <= bytes.size();
+    }
+
+    if (!is_valid) {
+
+        LOG(Log_lvl::ERROR) << "Not a valid SDF font: " << path;
+        return false;
+    }
+
+    std::vector<Sdf_glyph>   glyphs (header.glyph_count);
+    std::vector<Sdf_kerning> kerning(header.kerning_count);
+
+    std::byte const* const glyph_bytes   = bytes.data() + sizeof(header);
+    std::byte const* const kerning_bytes = glyph_bytes + glyphs.size() * sizeof(Sdf_glyph);
+
+    std::memcpy(glyphs .data(), glyph_bytes,   glyphs .size() * sizeof(Sdf_glyph));
+    std::memcpy(kerning.data(), kerning_bytes, kerning.size() * sizeof(Sdf_kerning));
+
+    std::string const atlas_path = path + SDF_ATLAS_SUFFIX;
+
+    if (!load_resource(m_texture, atlas_path)) {
+
+        LOG(Log_lvl::ERROR) << "Unable to load SDF atlas: " << atlas_path;
+        return false;
+    }
+
+    // Distances are interpolated between texels, that is what keeps edges smooth at any scale
+    m_texture.setSmooth(true);
+
+    m_header  = header;
+    m_glyphs  = std::move(glyphs);
+    m_kerning = std::move(kerning);
+    m_ascii   = {};
+
+    for (Sdf_glyph const& glyph : m_glyphs) {
+
+        if (glyph.codepoint < m_ascii.size()) {
+
+            m_ascii[glyph.codepoint] = &glyph;
+        }
+    }
+
+    return true;
+}
+
+// -------------------------------------------------------------------
+Sdf_glyph const* Sdf_font::find_glyph(char32_t const codepoint) const {
+
+    if (codepoint < m_ascii.size() && m_ascii[codepoint] != nullptr) {
+
+        return m_ascii[codepoint];
+    }
+
+    auto const found = std::lower_bound(m_glyphs.begin(), m_glyphs.end(), codepoint, [](Sdf_glyph const& glyph, char32_t const value) {
+
+        return glyph.codepoint < value;
+    });
+
+    if (found != m_glyphs.end() && found->codepoint == codepoint) {
+
+        return &*found;
+    }
+
+    return m_ascii['?'];
+}
+
+// -------------------------------------------------------------------
+float Sdf_font::get_kerning(char32_t const first, char32_t const second) const {
+
+    if (m_kerning.empty() || first == 0u) {
+
+        return 0.0f;
+    }
+
+    std::uint64_t const key = get_pair_key(first, second);
+
+    auto const found = std::lower_bound(m_kerning.begin(), m_kerning.end(), key, [](Sdf_kerning const& pair, std::uint64_t const value) {
+
+        return get_pair_key(pair.first, pair.second) < value;
+    });
+
+    if (found != m_kerning.end() && get_pair_key(found->first, found->second) == key) {
+
+        return found->amount;
+    }
+
+    return 0.0f;
+}
+
+// -------------------------------------------------------------------
+sf::Shader const* Sdf_font::get_shader(float const outline_thickness, sf::Color const outline_color) const {
+
+    if (m_is_shader_failed) {
+
+        return nullptr;
+    }
+
+    if (!m_shader) {
+
+        auto shader = std::make_unique<sf::Shader>();
+
+        if (!sf::Shader::isAvailable() || !shader->loadFromMemory(SDF_FRAGMENT_SHADER, sf::Shader::Type::Fragment)) {
+
+            LOG(Log_lvl::ERROR) << "Unable to create the SDF text shader, SDF text is drawn without it";
+
+            m_is_shader_failed = true;
+            return nullptr;
+        }
+
+        shader->setUniform("texture",           sf::Shader::CurrentTexture);
+        shader->setUniform("texture_size",      sf::Vector2f(m_texture.getSize()));
+        shader->setUniform("distance_range",    m_header.distance_range);
+        shader->setUniform("outline_thickness", m_outline_thickness);
+        shader->setUniform("outline_color",     sf::Glsl::Vec4(m_outline_color));
+
+        m_shader = std::move(shader);
+    }
+
+    // Each setUniform binds the program, skip them while the outline stays the same
+    if (outline_thickness != m_outline_thickness) {
+
+        m_shader->setUniform("outline_thickness", outline_thickness);
+        m_outline_thickness = outline_thickness;
+    }
+
+    if (outline_color != m_outline_color) {
+
+        m_shader->setUniform("outline_color", sf::Glsl::Vec4(outline_color));
+        m_outline_color = outline_color;
+    }
+
+    return m_shader.get();
+}
+
+} // tiny_tanks::utils
@@ -0,0 +1,166 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/text_buffer.h"
+
+#include <algorithm>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::utils {
+
+// ===================================================================
+// class Text_buffer
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Text_buffer::Text_buffer()
+    : m_text()
+    , m_line_starts()
+    , m_line_delta(0u)
+{
+
+    m_line_starts.insert(0u, std::size_t{ 0u });
+}
+
+// -------------------------------------------------------------------
+void Text_buffer::insert(std::size_t const offset, std::string_view const text) {
+
+    std::size_t const position = std::min(offset, size());
+    std::size_t const line     = get_line_of(position);
+
+    // The lines up to the edited one keep their starts, the ones after move by text.size()
+    move_line_gap(line + 1u);
+
+    m_text.insert(position, text.data(), text.size());
+
+    for (std::size_t i = 0u; i < text.size(); ++i) {
+
+        if (text[i] == '\n') {
+
+            m_line_starts.insert(m_line_starts.get_gap_position(), position + i + 1u);
+        }
+    }
+
+    m_line_delta += text.size();
+}
+
+// -------------------------------------------------------------------
+void Text_buffer::erase(std::size_t const offset, std::size_t const count) {
+
+    std::size_t const position = std::min(offset, size());
+    std::size_t const erased   = std::min(count, size() - position);
+
+    if (erased == 0u) {
+
+        return;
+    }
+
+    std::size_t const first_line = get_line_of(position);
+    std::size_t const last_line  = get_line_of(position + erased);
+
+    // Every '\n' erased joins two lines, their starts are right after the gap
+    move_line_gap(first_line + 1u);
+    m_line_starts.erase(first_line + 1u, last_line - first_line);
+
+    m_text.erase(position, erased);
+
+    m_line_delta -= erased;
+}
+
+// -------------------------------------------------------------------
+void Text_buffer::append(std::string_view const text) {
+
+    insert(size(), text);
+}
+
+// -------------------------------------------------------------------
+void Text_buffer::clear() {
+
+    m_text.clear();
+    m_line_starts.clear();
+    m_line_starts.insert(0u, std::size_t{ 0u });
+
+    m_line_delta = 0u;
+}
+
+// -------------------------------------------------------------------
+std::size_t Text_buffer::get_line_start(std::size_t const line) const {
+
+    return (line < m_line_starts.get_gap_position()) ? m_line_starts[line] : m_line_starts[line] + m_line_delta;
+}
+
+// -------------------------------------------------------------------
+std::size_t Text_buffer::get_line_end(std::size_t const line) const {
+
+    return (line + 1u < get_line_count()) ? get_line_start(line + 1u) - 1u : size();
+}
+
+// -------------------------------------------------------------------
+// Last line starting at or before offset, the starts only ever grow.
+std::size_t Text_buffer::get_line_of(std::size_t const offset) const {
+
+    std::size_t first = 1u;
+    std::size_t count = get_line_count() - 1u;
+
+    while (count > 0u) {
+
+        std::size_t const half = count / 2u;
+
+        if (get_line_start(first + half) <= offset) {
+
+            first += half + 1u;
+            count -= half + 1u;
+
+        } else {
+
+            count = half;
+        }
+    }
+
+    return first - 1u;
+}
+
+// -------------------------------------------------------------------
+void Text_buffer::copy(std::size_t const offset, std::size_t const count, char* const out) const {
+
+    m_text.copy(offset, count, out);
+}
+
+// -------------------------------------------------------------------
+std::string Text_buffer::get_text() const {
+
+    std::string text(size(), '\0');
+    m_text.copy(0u, text.size(), text.data());
+
+    return text;
+}
+
+// -------------------------------------------------------------------
+void Text_buffer::move_line_gap(std::size_t const line) {
+
+    std::size_t const gap = m_line_starts.get_gap_position();
+
+    m_line_starts.move_gap(line);
+
+    // Starts that crossed the gap change between absolute and stored without the delta
+    if (line < gap) {
+
+        for (std::size_t i = line; i < gap; ++i) {
+
+            m_line_starts[i] -= m_line_delta;
+        }
+
+    } else {
+
+        for (std::size_t i = gap; i < line; ++i) {
+
+            m_line_starts[i] += m_line_delta;
+        }
+    }
+}
+
+} // tiny_tanks::utils
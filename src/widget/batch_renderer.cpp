@@ -0,0 +1,380 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "widget/batch_renderer.h"
+#include "utils/frame_stats.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+namespace {
+
+// ===================================================================
+// Quad helpers
+// -------------------------------------------------------------------
+
+// Two triangles, corners given top left, top right, bottom left, bottom right.
+void append_quad(
+    std::vector<sf::Vertex>& vertices,
+    sf::Transform const&     transform,
+    sf::Vector2f const       (&corners)[4],
+    sf::Vector2f const       (&tex_coords)[4],
+    sf::Color const          color
+) {
+
+    for (int const index : { 0, 1, 2, 2, 1, 3 }) {
+
+        vertices.push_back(sf::Vertex{ transform.transformPoint(corners[index]), color, tex_coords[index] });
+    }
+}
+
+// -------------------------------------------------------------------
+void append_solid_rect(
+    std::vector<sf::Vertex>& vertices,
+    sf::Transform const&     transform,
+    sf::Vector2f const       min,
+    sf::Vector2f const       max,
+    sf::Color const          color
+) {
+
+    if (min.x >= max.x || min.y >= max.y) {
+
+        return;
+    }
+
+    append_quad(
+        vertices,
+        transform,
+        { min, { max.x, min.y }, { min.x, max.y }, max },
+        { WHITE_TEXEL, WHITE_TEXEL, WHITE_TEXEL, WHITE_TEXEL },
+        color
+    );
+}
+
+// -------------------------------------------------------------------
+void append_glyph(
+    std::vector<sf::Vertex>& vertices,
+    sf::Transform const&     transform,
+    sf::Vector2f const       position,
+    sf::Glyph const&         glyph,
+    float const              italic_shear,
+    sf::Color const          color
+) {
+
+    std::size_t const first = vertices.size();
+    vertices.resize(first + 6u);
+
+    write_glyph_vertices(vertices.data() + first, position, glyph, italic_shear, color);
+
+    for (std::size_t i = first; i < vertices.size(); ++i) {
+
+        vertices[i].position = transform.transformPoint(vertices[i].position);
+    }
+}
+
+// -------------------------------------------------------------------
+// Underline / strike through, rounded to whole pixels like sf::Text does.
+void append_line(
+    std::vector<sf::Vertex>& vertices,
+    sf::Transform const&     transform,
+    float const              line_length,
+    float const              line_top,
+    float const              offset,
+    float const              thickness,
+    float const              outline_thickness,
+    sf::Color const          color
+) {
+
+    float const top    = std::floor(line_top + offset - (thickness / 2.0f) + 0.5f);
+    float const bottom = top + std::floor(thickness + 0.5f);
+
+    append_solid_rect(
+        vertices,
+        transform,
+        { -outline_thickness,              top    - outline_thickness },
+        { line_length + outline_thickness, bottom + outline_thickness },
+        color
+    );
+}
+
+} // namespace
+
+// ===================================================================
+// Geometry helpers
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+// Same placement and padding as sf::Text, the padding keeps smoothed glyph edges intact.
+void write_glyph_vertices(
+    sf::Vertex* const  vertices,
+    sf::Vector2f const position,
+    sf::Glyph const&   glyph,
+    float const        italic_shear,
+    sf::Color const    color
+) {
+
+    sf::Vector2f const padding(1.0f, 1.0f);
+
+    sf::Vector2f const p1 = glyph.bounds.position - padding;
+    sf::Vector2f const p2 = glyph.bounds.position + glyph.bounds.size + padding;
+
+    sf::Vector2f const uv1 = sf::Vector2f(glyph.textureRect.position) - padding;
+    sf::Vector2f const uv2 = sf::Vector2f(glyph.textureRect.position + glyph.textureRect.size) + padding;
+
+    sf::Vector2f const corners[4] = {
+        position + sf::Vector2f(p1.x - italic_shear * p1.y, p1.y),
+        position + sf::Vector2f(p2.x - italic_shear * p1.y, p1.y),
+        position + sf::Vector2f(p1.x - italic_shear * p2.y, p2.y),
+        position + sf::Vector2f(p2.x - italic_shear * p2.y, p2.y)
+    };
+
+    sf::Vector2f const tex_coords[4] = { uv1, { uv2.x, uv1.y }, { uv1.x, uv2.y }, uv2 };
+
+    sf::Vertex* vertex = vertices;
+
+    for (int const index : { 0, 1, 2, 2, 1, 3 }) {
+
+        *vertex++ = sf::Vertex{ corners[index], color, tex_coords[index] };
+    }
+}
+
+// -------------------------------------------------------------------
+void append_rect_vertices(std::vector<sf::Vertex>& vertices, sf::RectangleShape const& rect) {
+
+    sf::Transform const& transform = rect.getTransform();
+    sf::Vector2f const   size      = rect.getSize();
+
+    if (rect.getFillColor().a != 0u) {
+
+        append_solid_rect(vertices, transform, { 0.0f, 0.0f }, size, rect.getFillColor());
+    }
+
+    float const thickness = rect.getOutlineThickness();
+
+    if (thickness == 0.0f || rect.getOutlineColor().a == 0u) {
+
+        return;
+    }
+
+    // The outline grows outwards for a positive thickness and inwards for a negative one,
+    // either way it is the band between these two rects.
+    sf::Vector2f const outer_min(std::min(0.0f, -thickness),         std::min(0.0f, -thickness));
+    sf::Vector2f const outer_max(std::max(size.x, size.x + thickness), std::max(size.y, size.y + thickness));
+    sf::Vector2f const inner_min(std::max(0.0f, -thickness),         std::max(0.0f, -thickness));
+    sf::Vector2f const inner_max(std::min(size.x, size.x + thickness), std::min(size.y, size.y + thickness));
+
+    sf::Color const color = rect.getOutlineColor();
+
+    append_solid_rect(vertices, transform, outer_min,                  { outer_max.x, inner_min.y }, color); // Top
+    append_solid_rect(vertices, transform, { outer_min.x, inner_max.y }, outer_max,                  color); // Bottom
+    append_solid_rect(vertices, transform, { outer_min.x, inner_min.y }, { inner_min.x, inner_max.y }, color); // Left
+    append_solid_rect(vertices, transform, { inner_max.x, inner_min.y }, { outer_max.x, inner_max.y }, color); // Right
+}
+
+// -------------------------------------------------------------------
+// Follows sf::Text's own geometry update so batched text looks the same as text drawn on its own.
+void append_text_vertices(std::vector<sf::Vertex>& vertices, sf::Text const& text) {
+
+    sf::String const& string = text.getString();
+
+    if (string.isEmpty()) {
+
+        return;
+    }
+
+    sf::Font const&      font      = text.getFont();
+    sf::Transform const& transform = text.getTransform();
+
+    unsigned int  const character_size = text.getCharacterSize();
+    std::uint32_t const style          = text.getStyle();
+
+    bool const is_bold           = (style & sf::Text::Bold)          != 0u;
+    bool const is_underlined     = (style & sf::Text::Underlined)    != 0u;
+    bool const is_strike_through = (style & sf::Text::StrikeThrough) != 0u;
+
+    // 12 degrees, as sf::Text
+    float const italic_shear = ((style & sf::Text::Italic) != 0u) ? 12.0f * std::numbers::pi_v<float> / 180.0f : 0.0f;
+
+    float const underline_offset    = font.getUnderlinePosition (character_size);
+    float const underline_thickness = font.getUnderlineThickness(character_size);
+
+    sf::FloatRect const x_bounds              = font.getGlyph(U'x', character_size, is_bold).bounds;
+    float const         strike_through_offset = x_bounds.position.y + x_bounds.size.y / 2.0f;
+
+    float       whitespace_width = font.getGlyph(U' ', character_size, is_bold).advance;
+    float const letter_spacing   = (whitespace_width / 3.0f) * (text.getLetterSpacing() - 1.0f);
+    whitespace_width            += letter_spacing;
+
+    float const line_spacing = font.getLineSpacing(character_size) * text.getLineSpacing();
+
+    // sf::Text draws every outline first and the fill on top of them, so do the same in two passes.
+    auto const append_pass = [&](float const outline_thickness, sf::Color const color) {
+
+        float    x         = 0.0f;
+        float    y         = static_cast<float>(character_size);
+        char32_t prev_char = U'\0';
+
+        auto const append_lines = [&] {
+
+            if (is_underlined) {
+
+                append_line(vertices, transform, x, y, underline_offset, underline_thickness, outline_thickness, color);
+            }
+
+            if (is_strike_through) {
+
+                append_line(vertices, transform, x, y, strike_through_offset, underline_thickness, outline_thickness, color);
+            }
+        };
+
+        for (std::size_t i = 0u; i < string.getSize(); ++i) {
+
+            char32_t const curr_char = string[i];
+
+            if (curr_char == U'\r') {
+
+                continue;
+            }
+
+            x += font.getKerning(prev_char, curr_char, character_size, is_bold);
+
+            if (curr_char == U'\n' && prev_char != U'\n') {
+
+                append_lines();
+            }
+
+            prev_char = curr_char;
+
+            if (curr_char == U' ' || curr_char == U'\n' || curr_char == U'\t') {
+
+                switch (curr_char) {
+
+                    case U' ':  x += whitespace_width;          break;
+                    case U'\t': x += whitespace_width * 4.0f;   break;
+                    case U'\n': y += line_spacing; x = 0.0f;    break;
+                    default:                                    break;
+                }
+
+                continue;
+            }
+
+            sf::Glyph const& glyph = font.getGlyph(curr_char, character_size, is_bold, outline_thickness);
+            append_glyph(vertices, transform, { x, y }, glyph, italic_shear, color);
+
+            // Advance with the fill glyph so the outline pass lines up with it
+            x += font.getGlyph(curr_char, character_size, is_bold).advance + letter_spacing;
+        }
+
+        if (x > 0.0f) {
+
+            append_lines();
+        }
+    };
+
+    float const outline_thickness = text.getOutlineThickness();
+
+    if (outline_thickness != 0.0f) {
+
+        append_pass(outline_thickness, text.getOutlineColor());
+    }
+
+    append_pass(0.0f, text.getFillColor());
+}
+
+// ===================================================================
+// class Batch_renderer
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+void Batch_renderer::clear() {
+
+    m_vertices.clear();
+    m_batches.clear();
+    m_offset = {};
+}
+
+// -------------------------------------------------------------------
+void Batch_renderer::add(
+    std::span<sf::Vertex const> const vertices,
+    sf::Texture const* const          texture,
+    sf::BlendMode const&              blend_mode,
+    sf::Shader const* const           shader
+) {
+
+    add_batch(vertices, Batch{ texture, blend_mode, shader, 0u, 0u, nullptr, 0.0f, sf::Color::Transparent });
+}
+
+// -------------------------------------------------------------------
+void Batch_renderer::add_sdf_text(
+    std::span<sf::Vertex const> const vertices,
+    utils::Sdf_font const&            font,
+    float const                       outline_thickness,
+    sf::Color const                   outline_color
+) {
+
+    add_batch(vertices, Batch{ &font.get_texture(), sf::BlendAlpha, nullptr, 0u, 0u, &font, outline_thickness, outline_color });
+}
+
+// -------------------------------------------------------------------
+void Batch_renderer::add_batch(std::span<sf::Vertex const> const vertices, Batch const& state) {
+
+    if (vertices.empty()) {
+
+        return;
+    }
+
+    // Extend the last batch if the state didn't change, that keeps the draw order as is.
+    if (!m_batches.empty()
+        && m_batches.back().texture           == state.texture
+        && m_batches.back().blend_mode        == state.blend_mode
+        && m_batches.back().shader            == state.shader
+        && m_batches.back().sdf_font          == state.sdf_font
+        && m_batches.back().outline_thickness == state.outline_thickness
+        && m_batches.back().outline_color     == state.outline_color) {
+
+        m_batches.back().count += vertices.size();
+    } else {
+
+        m_batches.push_back(state);
+        m_batches.back().first = m_vertices.size();
+        m_batches.back().count = vertices.size();
+    }
+
+    std::size_t const first = m_vertices.size();
+    m_vertices.insert(m_vertices.end(), vertices.begin(), vertices.end());
+
+    if (m_offset != sf::Vector2f()) {
+
+        for (std::size_t i = first; i < m_vertices.size(); ++i) {
+
+            m_vertices[i].position += m_offset;
+        }
+    }
+}
+
+// -------------------------------------------------------------------
+void Batch_renderer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+
+    PROFILE_ZONE("Batch_renderer::draw");
+
+    for (Batch const& batch : m_batches) {
+
+        states.texture   = batch.texture;
+        states.blendMode = batch.blend_mode;
+        states.shader    = batch.sdf_font ? batch.sdf_font->get_shader(batch.outline_thickness, batch.outline_color) : batch.shader;
+        target.draw(m_vertices.data() + batch.first, batch.count, sf::PrimitiveType::Triangles, states);
+    }
+
+    utils::Frame_stats::count_draw_calls(static_cast<std::uint32_t>(m_batches.size()));
+}
+
+} // tiny_tanks::widget
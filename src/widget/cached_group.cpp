@@ -0,0 +1,458 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "widget/cached_group.h"
+#include "utils/defs.h"
+#include "utils/frame_stats.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+// ===================================================================
+// Using directives
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks::utils;
+
+namespace {
+
+// The texture holds colours already multiplied by their alpha (that's what
+// alpha blending into a transparent texture gives), blending it again
+// with the usual alpha mode would darken every anti aliased edge.
+sf::BlendMode const PREMULTIPLIED_ALPHA(sf::BlendMode::Factor::One, sf::BlendMode::Factor::OneMinusSrcAlpha);
+
+constexpr std::uint64_t NO_REVISION = std::numeric_limits<std::uint64_t>::max();
+
+} // namespace
+
+// ===================================================================
+// class Cached_group
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+void Cached_group::set_memory_budget(std::size_t const bytes) {
+
+    s_memory_budget = bytes;
+}
+
+// -------------------------------------------------------------------
+std::size_t Cached_group::get_memory_budget() {
+
+    return s_memory_budget;
+}
+
+// -------------------------------------------------------------------
+Cached_group::Stats Cached_group::get_stats() {
+
+    return s_stats;
+}
+
+// -------------------------------------------------------------------
+void Cached_group::set_debug_overlay(bool const is_enabled) {
+
+    s_is_debug_overlay = is_enabled;
+}
+
+// -------------------------------------------------------------------
+bool Cached_group::is_debug_overlay() {
+
+    return s_is_debug_overlay;
+}
+
+// -------------------------------------------------------------------
+Cached_group::Cached_group(sf::RenderTarget* render_target)
+    : Widget(render_target)
+    , m_children()
+    , m_texture()
+    , m_texture_bytes(0u)
+    , m_cache_bounds()
+    , m_cached_revision(NO_REVISION)
+    , m_last_result(Cache_result::Miss)
+    , m_is_over_budget_logged(false)
+    , m_hits(0u)
+    , m_misses(0u)
+    , m_overlay_font()
+    , m_overlay_text()
+    , m_overlay_rect()
+    , m_overlay_vertices()
+{}
+
+// -------------------------------------------------------------------
+Cached_group::~Cached_group() {
+
+    release_texture();
+}
+
+// -------------------------------------------------------------------
+void Cached_group::set_pos(sf::Vector2f const& pos) {
+
+    m_pos = pos;
+
+    // For the parent and the frame scheduler, the texture stays as it is
+    invalidate();
+}
+
+// -------------------------------------------------------------------
+void Cached_group::set_origin(sf::Vector2f const& origin) {
+
+    m_origin = origin;
+
+    // As set_pos()
+    invalidate();
+}
+
+// -------------------------------------------------------------------
+Widget_type Cached_group::is() const {
+
+    return Widget_type::Cached_group;
+}
+
+// -------------------------------------------------------------------
+void Cached_group::add(Widget& child) {
+
+    if (&child == this) {
+
+        LOG(Log_lvl::ERROR) << "A cached group can't contain itself";
+        return;
+    }
+
+    m_children.push_back(&child);
+    invalidate_cache();
+}
+
+// -------------------------------------------------------------------
+void Cached_group::remove(Widget& child) {
+
+    std::erase(m_children, &child);
+    invalidate_cache();
+}
+
+// -------------------------------------------------------------------
+void Cached_group::invalidate_cache() {
+
+    // The revision sum could come back to the cached value after a remove, never compare against it
+    m_cached_revision = NO_REVISION;
+    invalidate();
+}
+
+// -------------------------------------------------------------------
+std::uint64_t Cached_group::get_revision() const {
+
+    return m_revision + get_content_revision();
+}
+
+// -------------------------------------------------------------------
+// The children's revisions only, the group's own position and origin are
+// applied when the texture is drawn and don't need a new one.
+std::uint64_t Cached_group::get_content_revision() const {
+
+    // Every revision only ever goes up, so the sum changes whenever any of them does
+    std::uint64_t revision = 0u;
+
+    for (Widget const* const child : m_children) {
+
+        revision += child->get_revision();
+    }
+
+    return revision;
+}
+
+// -------------------------------------------------------------------
+sf::FloatRect Cached_group::get_global_bounds() const {
+
+    sf::FloatRect bounds = get_local_bounds();
+    bounds.position += get_offset();
+
+    return bounds;
+}
+
+// -------------------------------------------------------------------
+void Cached_group::draw() {
+
+    if (m_render_target == nullptr) {
+
+        LOG(Log_lvl::ERROR) << "No render target to draw to";
+        return;
+    }
+
+    draw(*m_render_target);
+}
+
+// -------------------------------------------------------------------
+void Cached_group::draw(sf::RenderTarget& target) {
+
+    if (update_cache()) {
+
+        sf::Sprite sprite(m_texture->getTexture());
+        sprite.setPosition(get_offset() + m_cache_bounds.position);
+
+        target.draw(sprite, sf::RenderStates(PREMULTIPLIED_ALPHA));
+
+        Frame_stats::count_draw_calls(1u);
+
+    } else {
+
+        // Not cached, draw the children straight into the target with the group's offset applied to the view
+        sf::View const view = target.getView();
+
+        sf::View shifted_view = view;
+        shifted_view.move(-get_offset());
+        target.setView(shifted_view);
+
+        for (Widget* const child : m_children) {
+
+            child->draw(target);
+        }
+
+        target.setView(view);
+    }
+
+    if (s_is_debug_overlay) {
+
+        draw_overlay(target);
+    }
+}
+
+// -------------------------------------------------------------------
+void Cached_group::draw(Batch_renderer& batch) {
+
+    if (update_cache()) {
+
+        sf::Vector2f const min = get_offset() + m_cache_bounds.position;
+        sf::Vector2f const max = min + m_cache_bounds.size;
+        sf::Vector2f const uv  = m_cache_bounds.size;
+
+        sf::Vertex const vertices[] = {
+            { min,              sf::Color::White, { 0.0f, 0.0f } },
+            { { max.x, min.y }, sf::Color::White, { uv.x, 0.0f } },
+            { { min.x, max.y }, sf::Color::White, { 0.0f, uv.y } },
+            { { min.x, max.y }, sf::Color::White, { 0.0f, uv.y } },
+            { { max.x, min.y }, sf::Color::White, { uv.x, 0.0f } },
+            { max,              sf::Color::White, uv             }
+        };
+
+        batch.add(vertices, &m_texture->getTexture(), PREMULTIPLIED_ALPHA);
+
+    } else {
+
+        sf::Vector2f const offset = batch.get_offset();
+        batch.set_offset(offset + get_offset());
+
+        for (Widget* const child : m_children) {
+
+            child->draw(batch);
+        }
+
+        batch.set_offset(offset);
+    }
+
+    if (s_is_debug_overlay) {
+
+        draw_overlay(batch);
+    }
+}
+
+// -------------------------------------------------------------------
+bool Cached_group::update_cache() {
+
+    std::uint64_t const revision = get_content_revision();
+
+    if (m_texture != nullptr && revision == m_cached_revision) {
+
+        ++m_hits;
+        ++s_stats.hits;
+        m_last_result = Cache_result::Hit;
+
+        return true;
+    }
+
+    PROFILE_ZONE("Cached_group::update_cache");
+
+    // Whole pixels so the cached text stays as sharp as when drawn directly
+    sf::FloatRect const bounds = get_local_bounds();
+
+    sf::Vector2f const min(std::floor(bounds.position.x),                 std::floor(bounds.position.y));
+    sf::Vector2f const max(std::ceil (bounds.position.x + bounds.size.x), std::ceil (bounds.position.y + bounds.size.y));
+
+    sf::Vector2u const size(static_cast<unsigned int>(std::max(max.x - min.x, 1.0f)), static_cast<unsigned int>(std::max(max.y - min.y, 1.0f)));
+
+    std::size_t const bytes = std::size_t{ size.x } * size.y * 4u;
+
+    if (m_texture != nullptr && m_texture->getSize() != size) {
+
+        release_texture();
+    }
+
+    if (m_texture == nullptr) {
+
+        if (s_stats.texture_bytes + bytes > s_memory_budget) {
+
+            if (!m_is_over_budget_logged) {
+
+                LOG(Log_lvl::WARNING) << "Cached group needs " << bytes << " bytes of texture, over the budget of "
+                                      << s_memory_budget << " (" << s_stats.texture_bytes << " in use), drawing it uncached";
+                m_is_over_budget_logged = true;
+            }
+
+            ++s_stats.bypasses;
+            m_last_result = Cache_result::Bypass;
+
+            return false;
+        }
+
+        auto texture = std::make_unique<sf::RenderTexture>();
+
+        if (!texture->resize(size)) {
+
+            if (!m_is_over_budget_logged) {
+
+                LOG(Log_lvl::ERROR) << "Unable to create a " << size.x << "x" << size.y << " texture for a cached group, drawing it uncached";
+                m_is_over_budget_logged = true;
+            }
+
+            ++s_stats.bypasses;
+            m_last_result = Cache_result::Bypass;
+
+            return false;
+        }
+
+        m_texture       = std::move(texture);
+        m_texture_bytes = bytes;
+
+        s_stats.texture_bytes += bytes;
+    }
+
+    m_cache_bounds = sf::FloatRect(min, sf::Vector2f(size));
+
+    m_texture->clear(sf::Color::Transparent);
+    m_texture->setView(sf::View(m_cache_bounds));
+
+    for (Widget* const child : m_children) {
+
+        child->draw(*m_texture);
+    }
+
+    m_texture->display();
+
+    m_cached_revision = revision;
+
+    ++m_misses;
+    ++s_stats.misses;
+    m_last_result = Cache_result::Miss;
+
+    return true;
+}
+
+// -------------------------------------------------------------------
+void Cached_group::release_texture() {
+
+    if (m_texture == nullptr) {
+
+        return;
+    }
+
+    s_stats.texture_bytes -= m_texture_bytes;
+
+    m_texture.reset();
+    m_texture_bytes   = 0u;
+    m_cached_revision = NO_REVISION;
+}
+
+// -------------------------------------------------------------------
+sf::Vector2f Cached_group::get_offset() const {
+
+    return m_pos - m_origin;
+}
+
+// -------------------------------------------------------------------
+sf::FloatRect Cached_group::get_local_bounds() const {
+
+    if (m_children.empty()) {
+
+        return {};
+    }
+
+    sf::Vector2f min( std::numeric_limits<float>::max(),  std::numeric_limits<float>::max());
+    sf::Vector2f max(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+
+    for (Widget const* const child : m_children) {
+
+        sf::FloatRect const bounds = child->get_global_bounds();
+
+        min.x = std::min(min.x, bounds.position.x);
+        min.y = std::min(min.y, bounds.position.y);
+        max.x = std::max(max.x, bounds.position.x + bounds.size.x);
+        max.y = std::max(max.y, bounds.position.y + bounds.size.y);
+    }
+
+    return { min, max - min };
+}
+
+// -------------------------------------------------------------------
+void Cached_group::update_overlay() {
+
+    if (m_overlay_text == nullptr) {
+
+        m_overlay_font = fonts().load(DEFAULT_TEXT_FONT);
+        m_overlay_text = std::make_unique<sf::Text>(*m_overlay_font, "", 12u);
+
+        m_overlay_rect.setFillColor(sf::Color::Transparent);
+        m_overlay_rect.setOutlineThickness(1.0f);
+    }
+
+    sf::Color color;
+
+    switch (m_last_result) {
+
+        case Cache_result::Hit:    color = sf::Color::Green;          break;
+        case Cache_result::Miss:   color = sf::Color::Red;            break;
+        case Cache_result::Bypass: color = sf::Color(255u, 165u, 0u); break;
+    }
+
+    sf::FloatRect const bounds = get_global_bounds();
+
+    m_overlay_rect.setPosition(bounds.position);
+    m_overlay_rect.setSize(bounds.size);
+    m_overlay_rect.setOutlineColor(color);
+
+    m_overlay_text->setString("hits " + std::to_string(m_hits) + "  misses " + std::to_string(m_misses));
+    m_overlay_text->setFillColor(color);
+    m_overlay_text->setPosition({ bounds.position.x, bounds.position.y + bounds.size.y + 2.0f });
+}
+
+// -------------------------------------------------------------------
+void Cached_group::draw_overlay(sf::RenderTarget& target) {
+
+    update_overlay();
+
+    target.draw(m_overlay_rect);
+    target.draw(*m_overlay_text);
+}
+
+// -------------------------------------------------------------------
+void Cached_group::draw_overlay(Batch_renderer& batch) {
+
+    update_overlay();
+
+    m_overlay_vertices.clear();
+    append_rect_vertices(m_overlay_vertices, m_overlay_rect);
+    append_text_vertices(m_overlay_vertices, *m_overlay_text);
+
+    // Positions are already global, undo any offset a parent group applies
+    sf::Vector2f const offset = batch.get_offset();
+    batch.set_offset({});
+    batch.add(m_overlay_vertices, &m_overlay_font->getTexture(m_overlay_text->getCharacterSize()));
+    batch.set_offset(offset);
+}
+
+} // tiny_tanks::widget
@@ -0,0 +1,244 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "widget/command_list.h"
+#include "widget/batch_renderer.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+namespace {
+
+// ===================================================================
+// Sort keys
+// -------------------------------------------------------------------
+
+// 64 bit keys: layer 16, state 12, list 4, sequence 32. Commands sharing
+// everything above the sequence may be merged into one.
+constexpr int LAYER_SHIFT = 48;
+constexpr int STATE_SHIFT = 36;
+constexpr int LIST_SHIFT  = 32;
+
+constexpr std::uint64_t STATE_MASK = 0xFFFu;
+constexpr std::uint64_t LIST_MASK  = 0xFu;
+
+// -------------------------------------------------------------------
+// Only groups, two states sharing a hash just end up interleaved.
+std::uint64_t hash_state(sf::RenderStates const& states) {
+
+    std::uint64_t hash = reinterpret_cast<std::uintptr_t>(states.texture);
+
+    hash ^= reinterpret_cast<std::uintptr_t>(states.shader) << 1u;
+    hash ^= static_cast<std::uint64_t>(states.blendMode.colorSrcFactor) << 3u;
+    hash ^= static_cast<std::uint64_t>(states.blendMode.colorDstFactor) << 7u;
+
+    return (hash * 0x9E3779B97F4A7C15u) >> (64 - 12);
+}
+
+// -------------------------------------------------------------------
+bool is_same_state(sf::RenderStates const& a, sf::RenderStates const& b) {
+
+    return a.texture   == b.texture
+        && a.blendMode == b.blendMode
+        && a.shader    == b.shader;
+}
+
+} // namespace
+
+// ===================================================================
+// class Command_list
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+void Command_list::clear() {
+
+    m_vertices.clear();
+    m_commands.clear();
+    m_sorted.clear();
+    m_is_grouped = false;
+}
+
+// -------------------------------------------------------------------
+void Command_list::add(
+    std::span<sf::Vertex const> const vertices,
+    sf::Transform const&              transform,
+    sf::Texture const* const          texture,
+    std::uint16_t const               layer,
+    Draw_order const                  order,
+    sf::BlendMode const&              blend_mode,
+    sf::Shader const* const           shader
+) {
+
+    if (vertices.empty()) {
+
+        return;
+    }
+
+    std::size_t const first = m_vertices.size();
+
+    if (transform == sf::Transform::Identity) {
+
+        m_vertices.insert(m_vertices.end(), vertices.begin(), vertices.end());
+    } else {
+
+        for (sf::Vertex const& vertex : vertices) {
+
+            m_vertices.push_back(sf::Vertex{ transform.transformPoint(vertex.position), vertex.color, vertex.texCoords });
+        }
+    }
+
+    sf::RenderStates states;
+    states.texture   = texture;
+    states.blendMode = blend_mode;
+    states.shader    = shader;
+
+    add_geometry(first, states, layer, order);
+}
+
+// -------------------------------------------------------------------
+void Command_list::add(
+    sf::RectangleShape const& rect,
+    sf::Texture const* const  texture,
+    std::uint16_t const       layer,
+    Draw_order const          order
+) {
+
+    std::size_t const first = m_vertices.size();
+
+    append_rect_vertices(m_vertices, rect);
+
+    if (m_vertices.size() == first) {
+
+        return;
+    }
+
+    sf::RenderStates states;
+    states.texture = texture;
+
+    add_geometry(first, states, layer, order);
+}
+
+// -------------------------------------------------------------------
+void Command_list::add(Widget& widget, std::uint16_t const layer) {
+
+    Command command{};
+
+    command.key    = make_key(layer, Draw_order::As_recorded, command.states);
+    command.kind   = Kind::Widget;
+    command.widget = &widget;
+
+    m_commands.push_back(command);
+}
+
+// -------------------------------------------------------------------
+void Command_list::add(sf::Drawable const& drawable, sf::RenderStates const& states, std::uint16_t const layer) {
+
+    Command command{};
+
+    command.key      = make_key(layer, Draw_order::As_recorded, states);
+    command.kind     = Kind::Drawable;
+    command.states   = states;
+    command.drawable = &drawable;
+
+    m_commands.push_back(command);
+}
+
+// -------------------------------------------------------------------
+void Command_list::finish() {
+
+    PROFILE_ZONE("Command_list::finish");
+
+    m_sorted.resize(m_commands.size());
+
+    for (std::size_t i = 0u; i < m_commands.size(); ++i) {
+
+        m_sorted[i] = Sort_entry{ m_commands[i].key, static_cast<std::uint32_t>(i) };
+    }
+
+    // Keys are unique (the sequence), no need for a stable sort
+    std::sort(m_sorted.begin(), m_sorted.end(), [](Sort_entry const& a, Sort_entry const& b) { return a.key < b.key; });
+
+    if (!m_is_grouped) {
+
+        return;
+    }
+
+    // Grouping moved geometry around, lay the vertices out in draw order
+    // so each group is one range and the render thread one draw call.
+    m_grouped_vertices.clear();
+    m_grouped_vertices.reserve(m_vertices.size());
+
+    for (Sort_entry const& entry : m_sorted) {
+
+        Command& command = m_commands[entry.command];
+
+        if (command.kind == Kind::Geometry) {
+
+            auto const begin = m_vertices.begin() + static_cast<std::ptrdiff_t>(command.first);
+
+            command.first = m_grouped_vertices.size();
+            m_grouped_vertices.insert(m_grouped_vertices.end(), begin, begin + static_cast<std::ptrdiff_t>(command.count));
+        }
+    }
+
+    std::swap(m_vertices, m_grouped_vertices);
+}
+
+// -------------------------------------------------------------------
+std::uint64_t Command_list::make_key(std::uint16_t const layer, Draw_order const order, sf::RenderStates const& states) const {
+
+    std::uint64_t key = static_cast<std::uint64_t>(layer) << LAYER_SHIFT;
+
+    if (order == Draw_order::By_state) {
+
+        key |= (hash_state(states) & STATE_MASK) << STATE_SHIFT;
+    }
+
+    key |= (static_cast<std::uint64_t>(m_list_index) & LIST_MASK) << LIST_SHIFT;
+    key |= static_cast<std::uint32_t>(m_commands.size());
+
+    return key;
+}
+
+// -------------------------------------------------------------------
+void Command_list::add_geometry(std::size_t const first, sf::RenderStates const& states, std::uint16_t const layer, Draw_order const order) {
+
+    std::uint64_t const key   = make_key(layer, order, states);
+    std::size_t const   count = m_vertices.size() - first;
+
+    m_is_grouped = m_is_grouped || order == Draw_order::By_state;
+
+    // Right after the last command with the same key and state, that keeps the draw order as is.
+    if (!m_commands.empty()) {
+
+        Command& last = m_commands.back();
+
+        if (last.kind == Kind::Geometry
+            && (last.key >> LIST_SHIFT) == (key >> LIST_SHIFT)
+            && last.first + last.count  == first
+            && is_same_state(last.states, states)) {
+
+            last.count += count;
+            return;
+        }
+    }
+
+    Command command{};
+
+    command.key    = key;
+    command.kind   = Kind::Geometry;
+    command.states = states;
+    command.first  = first;
+    command.count  = count;
+
+    m_commands.push_back(command);
+}
+
+} // tiny_tanks::widget
@@ -0,0 +1,346 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "widget/command_queue.h"
+#include "widget/widget.h"
+#include "utils/frame_stats.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+// ===================================================================
+// Using directives
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks::utils;
+
+namespace {
+
+constexpr std::size_t MAX_WORKER_COUNT = 16u;
+
+// -------------------------------------------------------------------
+double to_ms(Command_queue::Clock::duration const duration) {
+
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+// ===================================================================
+// class Command_queue
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Command_queue::Command_queue(std::size_t const worker_count)
+    : m_lists       ()
+    , m_back        (0u)
+    , m_workers     ()
+    , m_mutex       ()
+    , m_start_cv    ()
+    , m_done_cv     ()
+    , m_build       ()
+    , m_generation  (0u)
+    , m_pending     (0u)
+    , m_is_building (false)
+    , m_is_stopping (false)
+    , m_build_begin ()
+    , m_build_end   ()
+    , m_heads       ()
+    , m_widget_batch()
+    , m_stats       ()
+{
+
+    std::size_t count = worker_count;
+
+    if (count == 0u) {
+
+        LOG(Log_lvl::ERROR) << "Command queue needs at least one worker, using 1";
+        count = 1u;
+
+    } else if (count > MAX_WORKER_COUNT) {
+
+        LOG(Log_lvl::WARNING) << "Command queue is limited to " << MAX_WORKER_COUNT << " workers, not " << count;
+        count = MAX_WORKER_COUNT;
+    }
+
+    for (std::vector<Command_list>& lists : m_lists) {
+
+        lists.resize(count);
+
+        for (std::size_t i = 0u; i < count; ++i) {
+
+            lists[i].m_list_index = static_cast<std::uint8_t>(i);
+        }
+    }
+
+    m_heads.reserve(count);
+    m_workers.reserve(count);
+
+    for (std::size_t i = 0u; i < count; ++i) {
+
+        m_workers.emplace_back(&Command_queue::run_worker, this, i);
+    }
+}
+
+// -------------------------------------------------------------------
+Command_queue::~Command_queue() {
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        // A build still running may be reading widgets the owner is about to destroy
+        m_done_cv.wait(lock, [this] { return m_pending == 0u; });
+        m_is_stopping = true;
+    }
+
+    m_start_cv.notify_all();
+
+    for (std::thread& worker : m_workers) {
+
+        worker.join();
+    }
+}
+
+// -------------------------------------------------------------------
+void Command_queue::begin_build(Build_function build) {
+
+    {
+        std::lock_guard<std::mutex> const lock(m_mutex);
+
+        if (m_is_building) {
+
+            LOG(Log_lvl::ERROR) << "Command queue is already building, call end_build() first";
+            return;
+        }
+
+        m_build       = std::move(build);
+        m_pending     = m_workers.size();
+        m_is_building = true;
+        m_build_begin = Clock::now();
+        ++m_generation;
+    }
+
+    m_start_cv.notify_all();
+}
+
+// -------------------------------------------------------------------
+void Command_queue::end_build() {
+
+    PROFILE_ZONE("Command_queue::end_build");
+
+    auto const begin = Clock::now();
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (!m_is_building) {
+
+            // The first frame has nothing to wait for
+            m_stats.wait_ms = 0.0;
+            return;
+        }
+
+        m_done_cv.wait(lock, [this] { return m_pending == 0u; });
+
+        m_is_building = false;
+        m_back       ^= 1u;
+        m_stats.build_ms = to_ms(m_build_end - m_build_begin);
+    }
+
+    m_stats.wait_ms = to_ms(Clock::now() - begin);
+}
+
+// -------------------------------------------------------------------
+void Command_queue::submit(sf::RenderTarget& target, sf::RenderStates const& states) {
+
+    PROFILE_ZONE("Command_queue::submit");
+
+    auto const begin = Clock::now();
+
+    std::vector<Command_list> const& lists = m_lists[m_back ^ 1u];
+
+    auto const is_after = [](Merge_head const& a, Merge_head const& b) { return a.key > b.key; };
+
+    m_heads.clear();
+    m_stats.commands = 0u;
+    m_stats.vertices = 0u;
+
+    for (Command_list const& list : lists) {
+
+        m_stats.commands += list.m_commands.size();
+        m_stats.vertices += list.m_vertices.size();
+
+        if (!list.m_sorted.empty()) {
+
+            m_heads.push_back(Merge_head{ list.m_sorted.front().key, &list, 0u });
+        }
+    }
+
+    std::make_heap(m_heads.begin(), m_heads.end(), is_after);
+
+    std::size_t draw_calls        = 0u;
+    std::size_t widget_draw_calls = 0u;
+
+    // Geometry waiting to be drawn, one range of one list
+    Command_list const* run_list  = nullptr;
+    std::size_t         run_first = 0u;
+    std::size_t         run_count = 0u;
+    sf::RenderStates    run_states = states;
+
+    auto const flush_run = [&] {
+
+        if (run_count > 0u) {
+
+            target.draw(run_list->m_vertices.data() + run_first, run_count, sf::PrimitiveType::Triangles, run_states);
+            ++draw_calls;
+            run_count = 0u;
+        }
+    };
+
+    auto const flush_widgets = [&] {
+
+        if (m_widget_batch.get_vertex_count() > 0u) {
+
+            m_widget_batch.draw(target, states);
+            widget_draw_calls += m_widget_batch.get_draw_call_count();
+        }
+
+        m_widget_batch.clear();
+    };
+
+    m_widget_batch.clear();
+
+    while (!m_heads.empty()) {
+
+        std::pop_heap(m_heads.begin(), m_heads.end(), is_after);
+        Merge_head& head = m_heads.back();
+
+        Command_list const&           list    = *head.list;
+        Command_list::Command const& command = list.m_commands[list.m_sorted[head.next].command];
+
+        switch (command.kind) {
+
+            case Command_list::Kind::Geometry: {
+
+                flush_widgets();
+
+                bool const is_next_in_run = run_count > 0u
+                                         && run_list == &list
+                                         && run_first + run_count  == command.first
+                                         && run_states.texture     == command.states.texture
+                                         && run_states.blendMode   == command.states.blendMode
+                                         && run_states.shader      == command.states.shader;
+
+                if (is_next_in_run) {
+
+                    run_count += command.count;
+                } else {
+
+                    flush_run();
+
+                    run_list             = &list;
+                    run_first            = command.first;
+                    run_count            = command.count;
+                    run_states.texture   = command.states.texture;
+                    run_states.blendMode = command.states.blendMode;
+                    run_states.shader    = command.states.shader;
+                }
+
+                break;
+            }
+
+            case Command_list::Kind::Widget:
+
+                flush_run();
+                command.widget->draw(m_widget_batch);
+                break;
+
+            case Command_list::Kind::Drawable: {
+
+                flush_run();
+                flush_widgets();
+
+                sf::RenderStates drawable_states = command.states;
+                drawable_states.transform = states.transform * command.states.transform;
+
+                target.draw(*command.drawable, drawable_states);
+                ++draw_calls;
+                break;
+            }
+        }
+
+        if (++head.next < list.m_sorted.size()) {
+
+            head.key = list.m_sorted[head.next].key;
+            std::push_heap(m_heads.begin(), m_heads.end(), is_after);
+        } else {
+
+            m_heads.pop_back();
+        }
+    }
+
+    flush_run();
+    flush_widgets();
+
+    // The widget batch counted its own
+    Frame_stats::count_draw_calls(static_cast<std::uint32_t>(draw_calls));
+
+    m_stats.draw_calls = draw_calls + widget_draw_calls;
+    m_stats.submit_ms  = to_ms(Clock::now() - begin);
+}
+
+// -------------------------------------------------------------------
+void Command_queue::run_worker(std::size_t const worker) {
+
+    Profiler::set_thread_name("Command worker " + std::to_string(worker));
+
+    std::uint64_t generation = 0u;
+
+    while (true) {
+
+        Command_list* list = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start_cv.wait(lock, [&] { return m_is_stopping || m_generation != generation; });
+
+            if (m_is_stopping) {
+
+                return;
+            }
+
+            generation = m_generation;
+            list       = &m_lists[m_back][worker];
+        }
+
+        {
+            PROFILE_ZONE("Command_queue::build");
+
+            list->clear();
+            m_build(*list, worker, m_workers.size());
+            list->finish();
+        }
+
+        {
+            std::lock_guard<std::mutex> const lock(m_mutex);
+
+            if (--m_pending == 0u) {
+
+                m_build_end = Clock::now();
+                m_done_cv.notify_all();
+            }
+        }
+    }
+}
+
+} // tiny_tanks::widget
@@ -4,7 +4,17 @@
 
 #include "widget/label.h"
 #include "utils/defs.h"
+#include "utils/frame_stats.h"
+#include "utils/log_binary.h"
 #include "utils/logger.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <system_error>
 
 // ===================================================================
 // Namespaces
@@ -18,30 +28,103 @@ namespace tiny_tanks::widget {
 
 using namespace tiny_tanks::utils;
 
+namespace {
+
+// -------------------------------------------------------------------
+void append_transformed_vertices(
+    std::vector<sf::Vertex>& vertices,
+    sf::Vertex const* const  first,
+    std::size_t const        count,
+    sf::Transform const&     transform
+) {
+
+    for (std::size_t i = 0u; i < count; ++i) {
+
+        sf::Vertex vertex = first[i];
+        vertex.position   = transform.transformPoint(vertex.position);
+
+        vertices.push_back(vertex);
+    }
+}
+
+// -------------------------------------------------------------------
+// Glyph quad at scale, the atlas rect already holds the distance padding so there is none to add.
+void append_sdf_glyph(
+    std::vector<sf::Vertex>& vertices,
+    sf::Vector2f const       position,
+    Sdf_glyph const&         glyph,
+    float const              scale,
+    float const              italic_shear,
+    sf::Color const          color
+) {
+
+    sf::Vector2f const p1(glyph.left * scale, glyph.top * scale);
+    sf::Vector2f const p2(p1.x + glyph.width * scale, p1.y + glyph.height * scale);
+
+    sf::Vector2f const uv1(static_cast<float>(glyph.texture_x), static_cast<float>(glyph.texture_y));
+    sf::Vector2f const uv2(uv1.x + glyph.width, uv1.y + glyph.height);
+
+    sf::Vector2f const corners[4] = {
+        position + sf::Vector2f(p1.x - italic_shear * p1.y, p1.y),
+        position + sf::Vector2f(p2.x - italic_shear * p1.y, p1.y),
+        position + sf::Vector2f(p1.x - italic_shear * p2.y, p2.y),
+        position + sf::Vector2f(p2.x - italic_shear * p2.y, p2.y)
+    };
+
+    sf::Vector2f const tex_coords[4] = { uv1, { uv2.x, uv1.y }, { uv1.x, uv2.y }, uv2 };
+
+    for (int const index : { 0, 1, 2, 2, 1, 3 }) {
+
+        vertices.push_back(sf::Vertex{ corners[index], color, tex_coords[index] });
+    }
+}
+
+} // namespace
+
 // ===================================================================
 // class Label
 // -------------------------------------------------------------------
 
 // -------------------------------------------------------------------
-Label::Label(sf::RenderWindow* render_window)
-    : Widget(render_window)
-    , m_font(DEFAULT_TEXT_FONT)
-    , m_text(m_font, "")
-    , m_rect({})
+Label::Label(sf::RenderTarget* render_target)
+    : Widget(render_target)
+    , m_font(fonts().load(DEFAULT_TEXT_FONT))
+    , m_text(*m_font, "")
+    , m_rect()
+    , m_rect_base_size({})
     , m_is_content_scaled(true)
     , m_state(State::Visible)
+    , m_is_layout_dirty(true)
+    , m_dynamic_text()
+    , m_is_dynamic_text(false)
+    , m_sdf_font()
+    , m_sdf_vertices()
+    , m_sdf_bounds()
+    , m_batch_vertices()
+    , m_batch_revision(std::numeric_limits<std::uint64_t>::max())
+    , m_batch_text_first(0u)
     , m_delta_offset({})
     , m_margins({})
 {}
 
 // -------------------------------------------------------------------
-Label::Label(sf::RenderWindow* render_window, std::string const& text)
-    : Widget(render_window)
-    , m_font(DEFAULT_TEXT_FONT)
-    , m_text(m_font, text)
-    , m_rect({})
+Label::Label(sf::RenderTarget* render_target, std::string const& text)
+    : Widget(render_target)
+    , m_font(fonts().load(DEFAULT_TEXT_FONT))
+    , m_text(*m_font, text)
+    , m_rect()
+    , m_rect_base_size({})
     , m_is_content_scaled(true)
     , m_state(State::Visible)
+    , m_is_layout_dirty(true)
+    , m_dynamic_text()
+    , m_is_dynamic_text(false)
+    , m_sdf_font()
+    , m_sdf_vertices()
+    , m_sdf_bounds()
+    , m_batch_vertices()
+    , m_batch_revision(std::numeric_limits<std::uint64_t>::max())
+    , m_batch_text_first(0u)
     , m_delta_offset({})
     , m_margins({})
 {}
@@ -49,13 +132,16 @@ Label::Label(sf::RenderWindow* render_window, std::string const& text)
 void Label::set_pos(sf::Vector2f const& pos) {
 
     m_pos = pos;
+    mark_layout_dirty();
 }
 
 // -------------------------------------------------------------------
 void Label::set_origin(sf::Vector2f const& origin) {
 
+    m_origin = origin;
     m_text.setOrigin(origin);
     m_rect.setOrigin(origin);
+    mark_layout_dirty();
 }
 
 // -------------------------------------------------------------------
@@ -67,77 +153,579 @@ Widget_type Label::is() const {
 // -------------------------------------------------------------------
 void Label::draw() {
 
+    if (m_render_target == nullptr) {
+
+        LOG(Log_lvl::ERROR) << "No render target to draw to";
+        return;
+    }
+
+    draw(*m_render_target);
+}
+
+// -------------------------------------------------------------------
+void Label::draw(sf::RenderTarget& target) {
+
+    PROFILE_ZONE("Label::draw");
+
+    if (m_state == State::Hidden) {
+
+        return;
+    }
+
+    // Only does work if something changed since the last frame
+    update_layout();
+
+    // Draw the shapes
+    target.draw(m_rect);
+
+    if (m_sdf_font) {
+
+        sf::RenderStates states(&m_sdf_font->get_texture());
+        states.transform = m_text.getTransform();
+        states.shader    = m_sdf_font->get_shader(m_text.getOutlineThickness(), m_text.getOutlineColor());
+
+        target.draw(m_sdf_vertices.data(), m_sdf_vertices.size(), sf::PrimitiveType::Triangles, states);
+
+    } else if (!m_is_dynamic_text) {
+
+        target.draw(m_text);
+
+    } else if (m_dynamic_text.size > 0u) {
+
+        sf::RenderStates states(&m_font->getTexture(m_text.getCharacterSize()));
+        states.transform = m_text.getTransform();
+
+        std::size_t const vertex_count = m_dynamic_text.size * 6u;
+
+        // Outlines first, under the fill, like sf::Text
+        if (m_text.getOutlineThickness() != 0.0f) {
+
+            target.draw(m_dynamic_text.vertices.data() + DYNAMIC_TEXT_CAPACITY * 6u, vertex_count, sf::PrimitiveType::Triangles, states);
+            Frame_stats::count_draw_calls(1u);
+        }
+
+        target.draw(m_dynamic_text.vertices.data(), vertex_count, sf::PrimitiveType::Triangles, states);
+    }
+
+    Frame_stats::count_draw_calls(2u);
+    Frame_stats::count_widget_drawn();
+}
+
+// -------------------------------------------------------------------
+void Label::draw(Batch_renderer& batch) {
+
+    PROFILE_ZONE("Label::draw (batched)");
+
     if (m_state == State::Hidden) {
 
         return;
     }
 
+    update_layout();
+
+    if (m_batch_revision != m_revision) {
+
+        m_batch_vertices.clear();
+        append_rect_vertices(m_batch_vertices, m_rect);
+
+        m_batch_text_first = m_batch_vertices.size();
+
+        if (m_sdf_font) {
+
+            append_transformed_vertices(m_batch_vertices, m_sdf_vertices.data(), m_sdf_vertices.size(), m_text.getTransform());
+
+        } else if (!m_is_dynamic_text) {
+
+            append_text_vertices(m_batch_vertices, m_text);
+
+        } else if (m_dynamic_text.size > 0u) {
+
+            std::size_t const vertex_count = m_dynamic_text.size * 6u;
+
+            if (m_text.getOutlineThickness() != 0.0f) {
+
+                append_transformed_vertices(m_batch_vertices, m_dynamic_text.vertices.data() + DYNAMIC_TEXT_CAPACITY * 6u, vertex_count, m_text.getTransform());
+            }
+
+            append_transformed_vertices(m_batch_vertices, m_dynamic_text.vertices.data(), vertex_count, m_text.getTransform());
+        }
+
+        m_batch_revision = m_revision;
+    }
+
+    if (m_sdf_font) {
+
+        std::span<sf::Vertex const> const vertices(m_batch_vertices);
+
+        batch.add(vertices.first(m_batch_text_first), &m_font->getTexture(m_text.getCharacterSize()));
+        batch.add_sdf_text(vertices.subspan(m_batch_text_first), *m_sdf_font, m_text.getOutlineThickness(), m_text.getOutlineColor());
+
+    } else {
+
+        // The background is textured from the font page's white square, one texture for the whole label
+        batch.add(m_batch_vertices, &m_font->getTexture(m_text.getCharacterSize()));
+    }
+
+    Frame_stats::count_widget_drawn();
+}
+
+// -------------------------------------------------------------------
+void Label::mark_layout_dirty() {
+
+    m_is_layout_dirty = true;
+    invalidate();
+}
+
+// -------------------------------------------------------------------
+void Label::update_layout() const {
+
+    if (!m_is_layout_dirty) {
+
+        return;
+    }
+
+    PROFILE_ZONE("Label::update_layout");
+
+    if (m_sdf_font) {
+
+        update_sdf_glyphs();
+
+    } else if (m_is_dynamic_text) {
+
+        update_dynamic_glyphs();
+    }
+
     // Set text position first so global bounds are accurate
-    m_text.setPosition(m_pos);
-    m_text.move(m_delta_offset);
+    m_text.setPosition(m_pos + m_delta_offset);
 
     // Check if rect should be scaled or not
     if (m_is_content_scaled) {
 
         // Get the global text bounds after all positional updates
-        sf::FloatRect const text_bounds = m_text.getGlobalBounds();
+        sf::FloatRect const text_bounds = get_text_global_bounds();
 
         // Update the rect size based on margins and text size
         m_rect.setSize({
-            text_bounds.size.x + static_cast<float>(m_margins.left) + static_cast<float>(m_margins.right),
-            text_bounds.size.y + static_cast<float>(m_margins.top)  + static_cast<float>(m_margins.bottom)
+            text_bounds.size.x + m_margins.left + m_margins.right,
+            text_bounds.size.y + m_margins.top  + m_margins.bottom
         });
 
         // Reposition the rect to contain the text, account for margins also
         m_rect.setPosition({
-            text_bounds.position.x - static_cast<float>(m_margins.left),
-            text_bounds.position.y - static_cast<float>(m_margins.top)
+            text_bounds.position.x - m_margins.left,
+            text_bounds.position.y - m_margins.top
         });
 
     } else {
-        // Get the base size of the rect which was adjusted by the user not automatically scaled
-        sf::Vector2f const base_size = m_rect.getSize();
 
-        // Update the rect size based on margins only
+        // Update the rect size based on margins and the size set by the user. Starting from
+        // the stored base size means the margins are only ever added once.
         m_rect.setSize({
-            base_size.x + static_cast<float>(m_margins.left) + static_cast<float>(m_margins.right),
-            base_size.y + static_cast<float>(m_margins.top)  + static_cast<float>(m_margins.bottom)
+            m_rect_base_size.x + m_margins.left + m_margins.right,
+            m_rect_base_size.y + m_margins.top  + m_margins.bottom
         });
 
         // Reposition the rect based on the user settings and account for margins also
         m_rect.setPosition({
-            m_pos.x + m_delta_offset.x - static_cast<float>(m_margins.left),
-            m_pos.y + m_delta_offset.y - static_cast<float>(m_margins.top)
+            m_pos.x + m_delta_offset.x - m_margins.left,
+            m_pos.y + m_delta_offset.y - m_margins.top
         });
     }
 
-    // Draw the shapes
-    m_render_window->draw(m_rect);
-    m_render_window->draw(m_text);
+    m_is_layout_dirty = false;
+}
+
+// -------------------------------------------------------------------
+void Label::mark_glyphs_dirty() {
+
+    m_dynamic_text.drawn_size = 0u;
+
+    if (m_is_dynamic_text || m_sdf_font) {
+
+        m_is_layout_dirty = true;
+    }
+}
+
+// -------------------------------------------------------------------
+// Lays the text out like sf::Text, but only writes the quads whose character or pen position changed.
+void Label::update_dynamic_glyphs() const {
+
+    PROFILE_ZONE("Label::update_dynamic_glyphs");
+
+    Dynamic_text& dynamic = m_dynamic_text;
+
+    sf::Font const&     font              = *m_font;
+    unsigned int const  character_size    = m_text.getCharacterSize();
+    std::uint32_t const style             = m_text.getStyle();
+    bool const          is_bold           = (style & sf::Text::Bold) != 0u;
+    float const         outline_thickness = m_text.getOutlineThickness();
+    bool const          has_outline       = outline_thickness != 0.0f;
+
+    // 12 degrees, as sf::Text
+    float const italic_shear   = ((style & sf::Text::Italic) != 0u) ? 12.0f * std::numbers::pi_v<float> / 180.0f : 0.0f;
+    float const letter_spacing = (font.getGlyph(U' ', character_size, is_bold).advance / 3.0f) * (m_text.getLetterSpacing() - 1.0f);
+
+    // Only ever grows, once for the fill slots and once more when an outline shows up
+    std::size_t const slot_count = has_outline ? DYNAMIC_TEXT_CAPACITY * 2u : DYNAMIC_TEXT_CAPACITY;
+
+    if (dynamic.vertices.size() < slot_count * 6u) {
+
+        dynamic.vertices.resize(slot_count * 6u);
+    }
+
+    float const y     = static_cast<float>(character_size);
+    float       x     = 0.0f;
+    float       min_x = static_cast<float>(character_size);
+    float       min_y = static_cast<float>(character_size);
+    float       max_x = 0.0f;
+    float       max_y = 0.0f;
+
+    char prev_char = '\0';
+
+    for (std::size_t i = 0u; i < dynamic.size; ++i) {
+
+        char const curr_char = dynamic.chars[i];
+
+        x += font.getKerning(static_cast<unsigned char>(prev_char), static_cast<unsigned char>(curr_char), character_size, is_bold);
+        prev_char = curr_char;
+
+        sf::Glyph const& glyph = font.getGlyph(static_cast<unsigned char>(curr_char), character_size, is_bold);
+
+        bool const is_unchanged = i < dynamic.drawn_size && dynamic.drawn_chars[i] == curr_char && dynamic.drawn_pen_x[i] == x;
+
+        if (!is_unchanged) {
+
+            sf::Vertex* const fill    = dynamic.vertices.data() + i * 6u;
+            sf::Vertex* const outline = dynamic.vertices.data() + (DYNAMIC_TEXT_CAPACITY + i) * 6u;
+
+            if (curr_char == ' ') {
+
+                // Nothing to draw, keep the slot as a degenerate quad
+                std::fill_n(fill, 6u, sf::Vertex{ { x, y }, sf::Color::Transparent });
+
+                if (has_outline) {
+
+                    std::fill_n(outline, 6u, sf::Vertex{ { x, y }, sf::Color::Transparent });
+                }
+
+            } else {
+
+                write_glyph_vertices(fill, { x, y }, glyph, italic_shear, m_text.getFillColor());
+
+                if (has_outline) {
+
+                    sf::Glyph const& outline_glyph = font.getGlyph(static_cast<unsigned char>(curr_char), character_size, is_bold, outline_thickness);
+                    write_glyph_vertices(outline, { x, y }, outline_glyph, italic_shear, m_text.getOutlineColor());
+                }
+            }
+
+            dynamic.drawn_chars[i] = curr_char;
+            dynamic.drawn_pen_x[i] = x;
+        }
+
+        if (curr_char == ' ') {
+
+            x += glyph.advance + letter_spacing;
+
+            max_x = std::max(max_x, x);
+            max_y = std::max(max_y, y);
+
+            continue;
+        }
+
+        float const left   = glyph.bounds.position.x;
+        float const top    = glyph.bounds.position.y;
+        float const right  = glyph.bounds.position.x + glyph.bounds.size.x;
+        float const bottom = glyph.bounds.position.y + glyph.bounds.size.y;
+
+        min_x = std::min(min_x, x + left  - italic_shear * bottom);
+        max_x = std::max(max_x, x + right - italic_shear * top);
+        min_y = std::min(min_y, y + top);
+        max_y = std::max(max_y, y + bottom);
+
+        x += glyph.advance + letter_spacing;
+    }
+
+    dynamic.drawn_size = dynamic.size;
+
+    if (dynamic.size == 0u) {
+
+        dynamic.local_bounds = {};
+        return;
+    }
+
+    float const outline = std::abs(outline_thickness);
+
+    dynamic.local_bounds = sf::FloatRect(
+        { min_x - outline, min_y - outline },
+        { max_x - min_x + outline * 2.0f, max_y - min_y + outline * 2.0f }
+    );
+}
+
+// -------------------------------------------------------------------
+// Same pen movement as sf::Text, with the baked metrics scaled to the character size.
+void Label::update_sdf_glyphs() const {
+
+    PROFILE_ZONE("Label::update_sdf_glyphs");
+
+    m_sdf_vertices.clear();
+
+    Sdf_font const&     font           = *m_sdf_font;
+    float const         character_size = static_cast<float>(m_text.getCharacterSize());
+    float const         scale          = character_size / font.get_base_size();
+    float const         padding        = font.get_distance_range() * scale;
+    std::uint32_t const style          = m_text.getStyle();
+
+    // 12 degrees, as sf::Text
+    float const italic_shear = ((style & sf::Text::Italic) != 0u) ? 12.0f * std::numbers::pi_v<float> / 180.0f : 0.0f;
+
+    Sdf_glyph const* const space          = font.find_glyph(U' ');
+    float const            space_advance  = (space != nullptr) ? space->advance * scale : 0.0f;
+    float const            letter_spacing = (space_advance / 3.0f) * (m_text.getLetterSpacing() - 1.0f);
+    float const            line_spacing   = font.get_line_spacing() * scale * m_text.getLineSpacing();
+
+    float    x         = 0.0f;
+    float    y         = character_size;
+    float    min_x     = character_size;
+    float    min_y     = character_size;
+    float    max_x     = 0.0f;
+    float    max_y     = 0.0f;
+    char32_t prev_char = U'\0';
+
+    auto const append = [&](char32_t const curr_char) {
+
+        if (curr_char == U'\r') {
+
+            return;
+        }
+
+        x += font.get_kerning(prev_char, curr_char) * scale;
+        prev_char = curr_char;
+
+        if (curr_char == U' ' || curr_char == U'\n' || curr_char == U'\t') {
+
+            switch (curr_char) {
+
+                case U' ':  x += space_advance + letter_spacing;          break;
+                case U'\t': x += (space_advance + letter_spacing) * 4.0f; break;
+                case U'\n': y += line_spacing; x = 0.0f;                  break;
+                default:                                                  break;
+            }
+
+            max_x = std::max(max_x, x);
+            max_y = std::max(max_y, y);
+
+            return;
+        }
+
+        Sdf_glyph const* const glyph = font.find_glyph(curr_char);
+
+        if (glyph == nullptr) {
+
+            return;
+        }
+
+        if (glyph->width > 0.0f) {
+
+            append_sdf_glyph(m_sdf_vertices, { x, y }, *glyph, scale, italic_shear, m_text.getFillColor());
+
+            // Ink bounds, without the distance padding
+            float const left   = glyph->left * scale + padding;
+            float const top    = glyph->top  * scale + padding;
+            float const right  = (glyph->left + glyph->width)  * scale - padding;
+            float const bottom = (glyph->top  + glyph->height) * scale - padding;
+
+            min_x = std::min(min_x, x + left  - italic_shear * bottom);
+            max_x = std::max(max_x, x + right - italic_shear * top);
+            min_y = std::min(min_y, y + top);
+            max_y = std::max(max_y, y + bottom);
+        }
+
+        x += glyph->advance * scale + letter_spacing;
+    };
+
+    if (m_is_dynamic_text) {
+
+        for (std::size_t i = 0u; i < m_dynamic_text.size; ++i) {
+
+            append(static_cast<unsigned char>(m_dynamic_text.chars[i]));
+        }
+
+    } else {
+
+        sf::String const& string = m_text.getString();
+
+        for (std::size_t i = 0u; i < string.getSize(); ++i) {
+
+            append(string[i]);
+        }
+    }
+
+    if (max_x < min_x || max_y < min_y) {
+
+        m_sdf_bounds = {};
+        return;
+    }
+
+    float const outline = std::abs(m_text.getOutlineThickness());
+
+    m_sdf_bounds = sf::FloatRect(
+        { min_x - outline, min_y - outline },
+        { max_x - min_x + outline * 2.0f, max_y - min_y + outline * 2.0f }
+    );
+}
+
+// -------------------------------------------------------------------
+sf::FloatRect Label::get_text_global_bounds() const {
+
+    if (m_sdf_font) {
+
+        return m_text.getTransform().transformRect(m_sdf_bounds);
+    }
+
+    if (m_is_dynamic_text) {
+
+        return m_text.getTransform().transformRect(m_dynamic_text.local_bounds);
+    }
+
+    return m_text.getGlobalBounds();
 }
 
 // -------------------------------------------------------------------
 void Label::set_text(std::string const& text) {
 
+    m_is_dynamic_text = false;
+
     m_text.setString(text);
+    mark_layout_dirty();
 }
 
 // -------------------------------------------------------------------
 std::string Label::get_text() const {
 
+    if (m_is_dynamic_text) {
+
+        return std::string(m_dynamic_text.chars.data(), m_dynamic_text.size);
+    }
+
     return m_text.getString();
 }
 
 // -------------------------------------------------------------------
 void Label::clear() {
 
+    m_is_dynamic_text = false;
+
     m_text.setString("");
+    mark_layout_dirty();
+}
+
+// -------------------------------------------------------------------
+void Label::set_dynamic_text(std::string_view const text) {
+
+    if (text.size() > DYNAMIC_TEXT_CAPACITY) {
+
+        LOG(Log_lvl::WARNING) << "Dynamic text is limited to " << DYNAMIC_TEXT_CAPACITY << " characters, cutting: " << text;
+    }
+
+    std::array<char, DYNAMIC_TEXT_CAPACITY> chars;
+    std::size_t const                       size = std::min(text.size(), DYNAMIC_TEXT_CAPACITY);
+
+    // One glyph per byte, so printable ASCII only
+    for (std::size_t i = 0u; i < size; ++i) {
+
+        chars[i] = (text[i] >= ' ' && text[i] <= '~') ? text[i] : '?';
+    }
+
+    if (m_is_dynamic_text && size == m_dynamic_text.size && std::equal(chars.begin(), chars.begin() + static_cast<std::ptrdiff_t>(size), m_dynamic_text.chars.begin())) {
+
+        return;
+    }
+
+    if (!m_is_dynamic_text) {
+
+        m_is_dynamic_text = true;
+
+        m_text.setString("");
+        mark_glyphs_dirty();
+    }
+
+    std::copy_n(chars.begin(), size, m_dynamic_text.chars.begin());
+    m_dynamic_text.size = size;
+
+    mark_layout_dirty();
+}
+
+// -------------------------------------------------------------------
+void Label::set_integer(std::int64_t const value, std::string_view const prefix) {
+
+    std::array<char, DYNAMIC_TEXT_CAPACITY> buffer;
+    std::size_t const                       prefix_size = std::min(prefix.size(), buffer.size());
+
+    std::copy_n(prefix.begin(), prefix_size, buffer.begin());
+
+    auto const [end, error] = std::to_chars(buffer.data() + prefix_size, buffer.data() + buffer.size(), value);
+
+    if (error != std::errc()) {
+
+        LOG(Log_lvl::WARNING) << "Unable to fit " << value << " in a dynamic text after \"" << prefix << '"';
+        return;
+    }
+
+    set_dynamic_text({ buffer.data(), static_cast<std::size_t>(end - buffer.data()) });
+}
+
+// -------------------------------------------------------------------
+void Label::set_decimal(double const value, int const precision, std::string_view const prefix) {
+
+    std::array<char, DYNAMIC_TEXT_CAPACITY> buffer;
+    std::size_t const                       prefix_size = std::min(prefix.size(), buffer.size());
+
+    std::copy_n(prefix.begin(), prefix_size, buffer.begin());
+
+    auto const [end, error] = std::to_chars(buffer.data() + prefix_size, buffer.data() + buffer.size(), value, std::chars_format::fixed, precision);
+
+    if (error != std::errc()) {
+
+        LOG(Log_lvl::WARNING) << "Unable to fit " << value << " in a dynamic text after \"" << prefix << '"';
+        return;
+    }
+
+    set_dynamic_text({ buffer.data(), static_cast<std::size_t>(end - buffer.data()) });
+}
+
+// -------------------------------------------------------------------
+bool Label::is_dynamic_text() const {
+
+    return m_is_dynamic_text;
+}
+
+// -------------------------------------------------------------------
+void Label::set_sdf_font(Sdf_font_handle font) {
+
+    if (font != nullptr && !font->is_loaded()) {
+
+        LOG(Log_lvl::ERROR) << "SDF font isn't loaded, keeping the regular font";
+        return;
+    }
+
+    m_sdf_font = std::move(font);
+
+    mark_glyphs_dirty();
+    mark_layout_dirty();
+}
+
+// -------------------------------------------------------------------
+Sdf_font_handle Label::get_sdf_font() const {
+
+    return m_sdf_font;
 }
 
 // -------------------------------------------------------------------
 void Label::scale_content(bool const is_content_scaled) {
 
     m_is_content_scaled = is_content_scaled;
+    mark_layout_dirty();
 }
 
 // -------------------------------------------------------------------
@@ -149,8 +737,10 @@ bool Label::is_content_scaled() const {
 // -------------------------------------------------------------------
 void Label::hide(bool const is_hidden) {
 
-    if (is_hidden) { m_state = State::Hidden;  LOG(Log_lvl::TRACE) << "Label state change: Hidden";  }
-    else           { m_state = State::Visible; LOG(Log_lvl::TRACE) << "Label state change: Visible"; }
+    if (is_hidden) { m_state = State::Hidden;  LOG_BIN(Log_lvl::TRACE) << "Label state change: Hidden";  }
+    else           { m_state = State::Visible; LOG_BIN(Log_lvl::TRACE) << "Label state change: Visible"; }
+
+    invalidate();
 }
 
 // -------------------------------------------------------------------
@@ -181,6 +771,8 @@ void Label::set_margins(
         m_margins.bottom = bottom;
         m_margins.left   = left;
         m_margins.right  = right;
+
+        mark_layout_dirty();
     }
 }
 
@@ -208,15 +800,30 @@ float Label::get_margin_right() const {
     return m_margins.right;
 }
 
+// -------------------------------------------------------------------
+void Label::set_font(Font_handle font) {
+
+    if (font == nullptr) {
+
+        LOG(Log_lvl::ERROR) << "Font handle is null";
+        return;
+    }
+
+    m_font = std::move(font);
+    m_text.setFont(*m_font);
+    mark_glyphs_dirty();
+    mark_layout_dirty();
+}
+
 // -------------------------------------------------------------------
 void Label::set_font(sf::Font const& font) {
 
-    m_font = font;
-    m_text.setFont(m_font);
+    // Not from the cache, so this label gets its own copy.
+    set_font(std::make_shared<sf::Font const>(font));
 }
 
 // -------------------------------------------------------------------
-sf::Font Label::get_font() const {
+Font_handle Label::get_font() const {
 
     return m_font;
 }
@@ -225,6 +832,7 @@ sf::Font Label::get_font() const {
 void Label::set_border_thickness(float const thickness) {
 
     m_rect.setOutlineThickness(thickness);
+    invalidate();
 }
 
 // -------------------------------------------------------------------
@@ -237,6 +845,8 @@ float Label::get_border_thickness() const {
 void Label::set_character_size(unsigned int const size) {
 
     m_text.setCharacterSize(size);
+    mark_glyphs_dirty();
+    mark_layout_dirty();
 }
 
 // -------------------------------------------------------------------
@@ -249,6 +859,8 @@ unsigned int Label::get_character_size() const {
 void Label::set_text_style(sf::Text::Style const style) {
 
     m_text.setStyle(style);
+    mark_glyphs_dirty();
+    mark_layout_dirty();
 }
 
 // -------------------------------------------------------------------
@@ -261,6 +873,8 @@ sf::Text::Style Label::get_text_style() const {
 void Label::set_text_color(sf::Color const& color) {
 
     m_text.setFillColor(color);
+    mark_glyphs_dirty();
+    invalidate();
 }
 
 // -------------------------------------------------------------------
@@ -273,6 +887,8 @@ sf::Color Label::get_text_color() const {
 void Label::set_text_outline_color(sf::Color const& color) {
 
     m_text.setOutlineColor(color);
+    mark_glyphs_dirty();
+    invalidate();
 }
 
 // -------------------------------------------------------------------
@@ -285,6 +901,8 @@ sf::Color Label::get_text_outline_color() const {
 void Label::set_text_outline_thickness(float const thickness) {
 
     m_text.setOutlineThickness(thickness);
+    mark_glyphs_dirty();
+    mark_layout_dirty();
 }
 
 // -------------------------------------------------------------------
@@ -297,6 +915,7 @@ float Label::get_text_outline_thickness() const {
 void Label::set_background_color(sf::Color const& color) {
 
     m_rect.setFillColor(color);
+    invalidate();
 }
 
 // -------------------------------------------------------------------
@@ -309,6 +928,7 @@ sf::Color Label::get_background_color() const {
 void Label::set_border_color(sf::Color const& color) {
 
     m_rect.setOutlineColor(color);
+    invalidate();
 }
 
 // -------------------------------------------------------------------
@@ -320,29 +940,34 @@ sf::Color Label::get_border_color() const {
 // -------------------------------------------------------------------
 sf::FloatRect Label::get_local_bounds() const {
 
+    update_layout();
     return m_rect.getLocalBounds();
 }
 
 // -------------------------------------------------------------------
 sf::FloatRect Label::get_global_bounds() const {
 
+    update_layout();
     return m_rect.getGlobalBounds();
 }
 // -------------------------------------------------------------------
 void Label::move(sf::Vector2f const& delta_offset) {
 
     m_delta_offset += delta_offset;
+    mark_layout_dirty();
 }
 
 // -------------------------------------------------------------------
 void Label::set_rect_size(sf::Vector2f const& size) {
 
-    m_rect.setSize(size);
+    m_rect_base_size = size;
+    mark_layout_dirty();
 }
 
 // -------------------------------------------------------------------
 sf::Vector2f Label::get_rect_size() const {
 
+    update_layout();
     return m_rect.getSize();
 }
 
@@ -350,12 +975,14 @@ sf::Vector2f Label::get_rect_size() const {
 void Label::scale_text(sf::Vector2f const& factor) {
 
     m_text.scale(factor);
+    mark_layout_dirty();
 }
 
 // -------------------------------------------------------------------
 void Label::scale_rect(sf::Vector2f const& factor) {
 
     m_rect.scale(factor);
+    invalidate();
 }
 
 // -------------------------------------------------------------------
@@ -0,0 +1,610 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "widget/layout.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+// ===================================================================
+// Using directives
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks::utils;
+
+namespace {
+
+// -------------------------------------------------------------------
+// Start of a span of size placed in a space, whole pixels so text stays sharp.
+float align(float const start, float const space, float const size, Alignment const alignment) {
+
+    switch (alignment) {
+
+        case Alignment::Right:
+        case Alignment::Bottom: return std::round(start + space - size);
+        case Alignment::Center: return std::round(start + (space - size) * 0.5f);
+        default:                return std::round(start);
+    }
+}
+
+// -------------------------------------------------------------------
+sf::FloatRect shrink(sf::FloatRect const& rect, Layout_margins const& margins) {
+
+    return sf::FloatRect(
+        { rect.position.x + margins.left, rect.position.y + margins.top },
+        {
+            std::max(rect.size.x - margins.left - margins.right,  0.0f),
+            std::max(rect.size.y - margins.top  - margins.bottom, 0.0f)
+        }
+    );
+}
+
+} // namespace
+
+// ===================================================================
+// class Layout
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Layout::Layout(sf::RenderTarget* render_target, Layout_direction const direction)
+    : Widget(render_target)
+    , m_children()
+    , m_child_indices()
+    , m_changed_children()
+    , m_dirty_layouts()
+    , m_direction(direction)
+    , m_padding()
+    , m_spacing(0.0f)
+    , m_size({})
+    , m_natural_size({})
+    , m_arranged_rect()
+    , m_is_measure_dirty(true)
+    , m_is_arrange_dirty(true)
+    , m_is_arranging(false)
+{}
+
+// -------------------------------------------------------------------
+Layout::~Layout() {
+
+    if (m_parent != nullptr) {
+
+        static_cast<Layout*>(m_parent)->remove(*this);
+    }
+
+    for (Child const& child : m_children) {
+
+        child.widget->m_parent = nullptr;
+    }
+}
+
+// -------------------------------------------------------------------
+void Layout::set_pos(sf::Vector2f const& pos) {
+
+    // Only a root layout's position counts, it moves every child on the next update
+    m_pos = pos;
+    invalidate();
+}
+
+// -------------------------------------------------------------------
+void Layout::set_origin(sf::Vector2f const& origin) {
+
+    m_origin = origin;
+    invalidate();
+}
+
+// -------------------------------------------------------------------
+Widget_type Layout::is() const {
+
+    return Widget_type::Layout;
+}
+
+// -------------------------------------------------------------------
+void Layout::add(Widget& child, Layout_item const& item) {
+
+    if (&child == this) {
+
+        LOG(Log_lvl::ERROR) << "A layout can't contain itself";
+        return;
+    }
+
+    if (child.m_parent != nullptr) {
+
+        LOG(Log_lvl::ERROR) << "Widget is already in a layout, remove it from that one first";
+        return;
+    }
+
+    child.m_parent = this;
+
+    Layout* const layout = (child.is() == Widget_type::Layout) ? static_cast<Layout*>(&child) : nullptr;
+
+    m_child_indices.emplace(&child, m_children.size());
+    m_children.push_back(Child{ &child, layout, item, {}, {}, {}, true });
+    m_changed_children.push_back(&child);
+
+    m_is_arrange_dirty = true;
+    mark_dirty();
+}
+
+// -------------------------------------------------------------------
+void Layout::remove(Widget& child) {
+
+    auto const found = m_child_indices.find(&child);
+
+    if (found == m_child_indices.end()) {
+
+        return;
+    }
+
+    std::size_t const index = found->second;
+
+    // Measuring skips it once it is out of m_child_indices, arranging needs it gone from here
+    std::erase(m_dirty_layouts, m_children[index].layout);
+
+    m_children.erase(m_children.begin() + static_cast<std::ptrdiff_t>(index));
+    m_child_indices.erase(found);
+
+    for (std::size_t i = index; i < m_children.size(); ++i) {
+
+        m_child_indices[m_children[i].widget] = i;
+    }
+
+    child.m_parent = nullptr;
+
+    m_is_arrange_dirty = true;
+    mark_dirty();
+}
+
+// -------------------------------------------------------------------
+void Layout::set_item(Widget& child, Layout_item const& item) {
+
+    Child* const found = find_child(child);
+
+    if (found == nullptr) {
+
+        LOG(Log_lvl::ERROR) << "Widget isn't in this layout";
+        return;
+    }
+
+    found->item = item;
+
+    m_is_arrange_dirty = true;
+    mark_dirty();
+}
+
+// -------------------------------------------------------------------
+Layout_item Layout::get_item(Widget& child) const {
+
+    Child const* const found = find_child(child);
+
+    if (found == nullptr) {
+
+        LOG(Log_lvl::ERROR) << "Widget isn't in this layout";
+        return {};
+    }
+
+    return found->item;
+}
+
+// -------------------------------------------------------------------
+std::size_t Layout::get_child_count() const {
+
+    return m_children.size();
+}
+
+// -------------------------------------------------------------------
+void Layout::set_size(sf::Vector2f const& size) {
+
+    m_size = size;
+
+    m_is_arrange_dirty = true;
+    mark_dirty();
+}
+
+// -------------------------------------------------------------------
+sf::Vector2f Layout::get_size() const {
+
+    update();
+    return m_arranged_rect.size;
+}
+
+// -------------------------------------------------------------------
+void Layout::set_direction(Layout_direction const direction) {
+
+    m_direction = direction;
+
+    m_is_arrange_dirty = true;
+    mark_dirty();
+}
+
+// -------------------------------------------------------------------
+Layout_direction Layout::get_direction() const {
+
+    return m_direction;
+}
+
+// -------------------------------------------------------------------
+void Layout::set_padding(Layout_margins const& padding) {
+
+    m_padding = padding;
+
+    m_is_arrange_dirty = true;
+    mark_dirty();
+}
+
+// -------------------------------------------------------------------
+Layout_margins Layout::get_padding() const {
+
+    return m_padding;
+}
+
+// -------------------------------------------------------------------
+void Layout::set_spacing(float const spacing) {
+
+    m_spacing = spacing;
+
+    m_is_arrange_dirty = true;
+    mark_dirty();
+}
+
+// -------------------------------------------------------------------
+float Layout::get_spacing() const {
+
+    return m_spacing;
+}
+
+// -------------------------------------------------------------------
+std::uint64_t Layout::get_revision() const {
+
+    // Every revision only ever goes up, so the sum changes whenever any of them does
+    std::uint64_t revision = m_revision;
+
+    for (Child const& child : m_children) {
+
+        revision += child.widget->get_revision();
+    }
+
+    return revision;
+}
+
+// -------------------------------------------------------------------
+void Layout::update() const {
+
+    // A child layout's rect comes from its parent, bring the whole tree up to date
+    if (m_parent != nullptr) {
+
+        static_cast<Layout const*>(m_parent)->update();
+        return;
+    }
+
+    if (!m_is_measure_dirty && !m_is_arrange_dirty && m_arranged_rect.position == m_pos - m_origin) {
+
+        return;
+    }
+
+    PROFILE_ZONE("Layout::update");
+
+    sf::Vector2f const natural = measure();
+
+    arrange(sf::FloatRect(
+        m_pos - m_origin,
+        { (m_size.x > 0.0f) ? m_size.x : natural.x, (m_size.y > 0.0f) ? m_size.y : natural.y }
+    ));
+}
+
+// -------------------------------------------------------------------
+sf::FloatRect Layout::get_global_bounds() const {
+
+    update();
+    return m_arranged_rect;
+}
+
+// -------------------------------------------------------------------
+void Layout::draw() {
+
+    if (m_render_target == nullptr) {
+
+        LOG(Log_lvl::ERROR) << "No render target to draw to";
+        return;
+    }
+
+    draw(*m_render_target);
+}
+
+// -------------------------------------------------------------------
+void Layout::draw(sf::RenderTarget& target) {
+
+    update();
+
+    for (Child const& child : m_children) {
+
+        child.widget->draw(target);
+    }
+}
+
+// -------------------------------------------------------------------
+void Layout::draw(Batch_renderer& batch) {
+
+    update();
+
+    for (Child const& child : m_children) {
+
+        child.widget->draw(batch);
+    }
+}
+
+// -------------------------------------------------------------------
+void Layout::on_child_invalidated(Widget& widget) {
+
+    // The layout moving its own children isn't a change
+    if (m_is_arranging) {
+
+        return;
+    }
+
+    Child* const child = find_child(widget);
+
+    if (child == nullptr || child->is_changed) {
+
+        return;
+    }
+
+    child->is_changed = true;
+    m_changed_children.push_back(&widget);
+
+    // Only the first change since the last update has to climb the tree
+    if (!m_is_measure_dirty) {
+
+        m_is_measure_dirty = true;
+        invalidate();
+    }
+}
+
+// -------------------------------------------------------------------
+void Layout::mark_dirty() {
+
+    m_is_measure_dirty = true;
+    invalidate();
+}
+
+// -------------------------------------------------------------------
+Layout::Child* Layout::find_child(Widget const& child) {
+
+    auto const found = m_child_indices.find(&child);
+    return (found != m_child_indices.end()) ? &m_children[found->second] : nullptr;
+}
+
+// -------------------------------------------------------------------
+Layout::Child const* Layout::find_child(Widget const& child) const {
+
+    auto const found = m_child_indices.find(&child);
+    return (found != m_child_indices.end()) ? &m_children[found->second] : nullptr;
+}
+
+// -------------------------------------------------------------------
+sf::Vector2f Layout::measure() const {
+
+    if (!m_is_measure_dirty) {
+
+        return m_natural_size;
+    }
+
+    for (Widget* const widget : m_changed_children) {
+
+        auto const found = m_child_indices.find(widget);
+
+        // Removed since it changed
+        if (found == m_child_indices.end()) {
+
+            continue;
+        }
+
+        Child& child = m_children[found->second];
+        child.is_changed = false;
+
+        measure_child(child);
+    }
+
+    m_changed_children.clear();
+
+    // Natural size from the cached child sizes, nothing is measured again
+    bool const is_row = m_direction == Layout_direction::Row;
+
+    sf::Vector2f size;
+
+    for (Child const& child : m_children) {
+
+        Layout_margins const& margins = child.item.margins;
+
+        sf::Vector2f const outer(child.size.x + margins.left + margins.right, child.size.y + margins.top + margins.bottom);
+
+        if (m_direction == Layout_direction::Stack) {
+
+            size = { std::max(size.x, outer.x), std::max(size.y, outer.y) };
+
+        } else if (is_row) {
+
+            size = { size.x + outer.x, std::max(size.y, outer.y) };
+
+        } else {
+
+            size = { std::max(size.x, outer.x), size.y + outer.y };
+        }
+    }
+
+    if (m_direction != Layout_direction::Stack && m_children.size() > 1u) {
+
+        float const spacing = m_spacing * static_cast<float>(m_children.size() - 1u);
+
+        (is_row ? size.x : size.y) += spacing;
+    }
+
+    m_natural_size = {
+        size.x + m_padding.left + m_padding.right,
+        size.y + m_padding.top  + m_padding.bottom
+    };
+
+    m_is_measure_dirty = false;
+
+    return m_natural_size;
+}
+
+// -------------------------------------------------------------------
+void Layout::measure_child(Child& child) const {
+
+    sf::Vector2f size;
+    sf::Vector2f bounds_offset;
+
+    if (child.layout != nullptr) {
+
+        // Placed exactly on its slot, only its size matters
+        size = child.layout->measure();
+
+        if (child.layout->m_is_arrange_dirty || !child.layout->m_dirty_layouts.empty()) {
+
+            m_dirty_layouts.push_back(child.layout);
+        }
+
+    } else {
+
+        sf::FloatRect const bounds = child.widget->get_global_bounds();
+
+        size          = bounds.size;
+        bounds_offset = bounds.position - child.widget->get_pos();
+    }
+
+    if (size != child.size || bounds_offset != child.bounds_offset) {
+
+        child.size          = size;
+        child.bounds_offset = bounds_offset;
+
+        m_is_arrange_dirty = true;
+    }
+}
+
+// -------------------------------------------------------------------
+void Layout::arrange(sf::FloatRect const& rect) const {
+
+    measure();
+
+    m_is_arranging = true;
+
+    if (m_is_arrange_dirty || rect.size != m_arranged_rect.size) {
+
+        PROFILE_ZONE("Layout::arrange");
+
+        arrange_children(rect);
+
+    } else if (rect.position != m_arranged_rect.position) {
+
+        // Same slots, only moved
+        sf::Vector2f const delta = rect.position - m_arranged_rect.position;
+
+        for (Child& child : m_children) {
+
+            place_child(child, sf::FloatRect(child.slot.position + delta, child.slot.size));
+        }
+
+    } else {
+
+        // Nothing here moved, only the child layouts that changed inside
+        for (Layout* const layout : m_dirty_layouts) {
+
+            layout->arrange(layout->m_arranged_rect);
+        }
+    }
+
+    m_dirty_layouts.clear();
+
+    m_arranged_rect    = rect;
+    m_is_arrange_dirty = false;
+    m_is_arranging     = false;
+}
+
+// -------------------------------------------------------------------
+void Layout::arrange_children(sf::FloatRect const& rect) const {
+
+    sf::FloatRect const content = shrink(rect, m_padding);
+
+    if (m_direction == Layout_direction::Stack) {
+
+        for (Child& child : m_children) {
+
+            place_child(child, content);
+        }
+
+        return;
+    }
+
+    bool const is_row = m_direction == Layout_direction::Row;
+
+    auto const main  = [is_row](sf::Vector2f const vector) { return is_row ? vector.x : vector.y; };
+    auto const outer = [&main, is_row](Child const& child) {
+
+        Layout_margins const& margins = child.item.margins;
+        return main(child.size) + (is_row ? margins.left + margins.right : margins.top + margins.bottom);
+    };
+
+    // What the children need, the rest is shared by flex weight
+    float used       = m_spacing * static_cast<float>(std::max<std::size_t>(m_children.size(), 1u) - 1u);
+    float flex_total = 0.0f;
+
+    for (Child const& child : m_children) {
+
+        used       += outer(child);
+        flex_total += std::max(child.item.flex, 0.0f);
+    }
+
+    float const extra = std::max(main(content.size) - used, 0.0f);
+    float       pen   = main(content.position);
+
+    for (Child& child : m_children) {
+
+        float const share = (flex_total > 0.0f) ? extra * std::max(child.item.flex, 0.0f) / flex_total : 0.0f;
+        float const span  = outer(child) + share;
+
+        sf::FloatRect const slot = is_row
+            ? sf::FloatRect({ pen, content.position.y }, { span, content.size.y })
+            : sf::FloatRect({ content.position.x, pen }, { content.size.x, span });
+
+        place_child(child, slot);
+
+        pen += span + m_spacing;
+    }
+}
+
+// -------------------------------------------------------------------
+void Layout::place_child(Child& child, sf::FloatRect const& slot) const {
+
+    child.slot = slot;
+
+    sf::FloatRect const inner = shrink(slot, child.item.margins);
+
+    if (child.layout != nullptr) {
+
+        child.layout->arrange(inner);
+        return;
+    }
+
+    sf::Vector2f const bounds_position(
+        align(inner.position.x, inner.size.x, child.size.x, child.item.horizontal),
+        align(inner.position.y, inner.size.y, child.size.y, child.item.vertical)
+    );
+
+    sf::Vector2f const pos = bounds_position - child.bounds_offset;
+
+    if (pos != child.widget->get_pos()) {
+
+        child.widget->set_pos(pos);
+    }
+}
+
+} // tiny_tanks::widget
@@ -0,0 +1,395 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "widget/perf_hud.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+// ===================================================================
+// Using directives
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks::utils;
+
+namespace {
+
+// ===================================================================
+// Graph layout
+// -------------------------------------------------------------------
+
+constexpr float BAR_WIDTH    = 6.0f;   // Per 1 ms bucket
+constexpr float GRAPH_HEIGHT = 60.0f;
+constexpr float GRAPH_GAP    = 2.0f;   // Between the text and the graph
+constexpr float TEXT_MARGIN  = 4.0f;   // Around the text lines
+
+constexpr unsigned int CHARACTER_SIZE = 14u;
+
+sf::Color const BACKGROUND_COLOR(0u, 0u, 0u, 180u);
+
+// Quads in m_graph_vertices: text and graph backgrounds, bars, p50 / p95 / p99 markers
+constexpr std::size_t TEXT_BACKGROUND_QUAD  = 0u;
+constexpr std::size_t GRAPH_BACKGROUND_QUAD = 1u;
+constexpr std::size_t FIRST_BAR_QUAD        = 2u;
+constexpr std::size_t FIRST_MARK_QUAD = FIRST_BAR_QUAD + Perf_hud::BUCKET_COUNT;
+constexpr std::size_t QUAD_COUNT      = FIRST_MARK_QUAD + 3u;
+
+// -------------------------------------------------------------------
+// Writes a solid quad in place, textured from the font page's white square like the label background.
+void set_quad(std::vector<sf::Vertex>& vertices, std::size_t const quad, sf::Vector2f const min, sf::Vector2f const max, sf::Color const color) {
+
+    sf::Vertex* const vertex = vertices.data() + quad * 6u;
+
+    vertex[0] = sf::Vertex{ min,              color, WHITE_TEXEL };
+    vertex[1] = sf::Vertex{ { max.x, min.y }, color, WHITE_TEXEL };
+    vertex[2] = sf::Vertex{ { min.x, max.y }, color, WHITE_TEXEL };
+    vertex[3] = sf::Vertex{ { min.x, max.y }, color, WHITE_TEXEL };
+    vertex[4] = sf::Vertex{ { max.x, min.y }, color, WHITE_TEXEL };
+    vertex[5] = sf::Vertex{ max,              color, WHITE_TEXEL };
+}
+
+// -------------------------------------------------------------------
+sf::Color get_bucket_color(std::size_t const bucket) {
+
+    if (bucket <= 16u) { return sf::Color(  0u, 200u, 0u); } // 60 FPS or better
+    if (bucket <= 33u) { return sf::Color(230u, 200u, 0u); } // 30 FPS or better
+
+    return sf::Color(220u, 40u, 40u);
+}
+
+} // namespace
+
+// ===================================================================
+// class Perf_hud
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Perf_hud::Perf_hud(sf::RenderTarget* render_target)
+    : Widget(render_target)
+    , m_history({})
+    , m_scratch({})
+    , m_buckets({})
+    , m_history_next(0u)
+    , m_history_count(0u)
+    , m_last_counters({})
+    , m_since_text_update(0)
+    , m_frames_since_text_update(0u)
+    , m_p50(0.0f)
+    , m_p95(0.0f)
+    , m_p99(0.0f)
+    , m_is_hidden(false)
+    , m_is_graph_dirty(true)
+    , m_lines{ Label(render_target), Label(render_target), Label(render_target), Label(render_target), Label(render_target) }  // LINE_COUNT
+    , m_graph_vertices(QUAD_COUNT * 6u)
+{
+
+    for (Label& line : m_lines) {
+
+        // The background quad sits under all of them, a line's own rect would cover it
+        line.set_character_size(CHARACTER_SIZE);
+        line.set_text_color(sf::Color::White);
+        line.set_background_color(sf::Color::Transparent);
+        line.set_margins(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    place_lines();
+    update_text();
+}
+
+// -------------------------------------------------------------------
+void Perf_hud::set_pos(sf::Vector2f const& pos) {
+
+    m_pos = pos;
+    place_lines();
+
+    m_is_graph_dirty = true;
+    invalidate();
+}
+
+// -------------------------------------------------------------------
+void Perf_hud::set_origin(sf::Vector2f const& origin) {
+
+    m_origin = origin;
+    place_lines();
+
+    m_is_graph_dirty = true;
+    invalidate();
+}
+
+// -------------------------------------------------------------------
+Widget_type Perf_hud::is() const {
+
+    return Widget_type::Perf_hud;
+}
+
+// -------------------------------------------------------------------
+void Perf_hud::hide(bool const is_hidden) {
+
+    m_is_hidden = is_hidden;
+    invalidate();
+}
+
+// -------------------------------------------------------------------
+bool Perf_hud::is_hidden() const {
+
+    return m_is_hidden;
+}
+
+// -------------------------------------------------------------------
+void Perf_hud::toggle() {
+
+    hide(!m_is_hidden);
+}
+
+// -------------------------------------------------------------------
+void Perf_hud::add_frame(std::chrono::nanoseconds const frame_time, Frame_counters const& counters) {
+
+    float const frame_ms = static_cast<float>(frame_time.count()) / 1'000'000.0f;
+
+    // Replace the oldest frame once the window is full
+    if (m_history_count == HISTORY_SIZE) {
+
+        --m_buckets[std::min(static_cast<std::size_t>(m_history[m_history_next]), BUCKET_COUNT - 1u)];
+    } else {
+
+        ++m_history_count;
+    }
+
+    m_history[m_history_next] = frame_ms;
+    ++m_buckets[std::min(static_cast<std::size_t>(frame_ms), BUCKET_COUNT - 1u)];
+
+    m_history_next = (m_history_next + 1u) % HISTORY_SIZE;
+
+    m_last_counters = counters;
+
+    m_since_text_update += frame_time;
+    ++m_frames_since_text_update;
+
+    if (m_is_hidden) {
+
+        return;
+    }
+
+    if (m_since_text_update >= TEXT_UPDATE_INTERVAL) {
+
+        update_text();
+    }
+
+    m_is_graph_dirty = true;
+    invalidate();
+}
+
+// -------------------------------------------------------------------
+sf::FloatRect Perf_hud::get_global_bounds() const {
+
+    sf::FloatRect bounds = get_text_bounds();
+    bounds.size.x  = std::max(bounds.size.x, static_cast<float>(BUCKET_COUNT) * BAR_WIDTH);
+    bounds.size.y += GRAPH_GAP + GRAPH_HEIGHT;
+
+    return bounds;
+}
+
+// -------------------------------------------------------------------
+void Perf_hud::draw() {
+
+    if (m_render_target == nullptr) {
+
+        LOG(Log_lvl::ERROR) << "No render target to draw to";
+        return;
+    }
+
+    draw(*m_render_target);
+}
+
+// -------------------------------------------------------------------
+void Perf_hud::draw(sf::RenderTarget& target) {
+
+    PROFILE_ZONE("Perf_hud::draw");
+
+    if (m_is_hidden) {
+
+        return;
+    }
+
+    update_graph();
+
+    // Backgrounds first, the lines go on top
+    target.draw(m_graph_vertices.data(), m_graph_vertices.size(), sf::PrimitiveType::Triangles, sf::RenderStates(&get_texture()));
+
+    Frame_stats::count_draw_calls(1u);
+
+    for (Label& line : m_lines) {
+
+        line.draw(target);
+    }
+
+    Frame_stats::count_widget_drawn();
+}
+
+// -------------------------------------------------------------------
+void Perf_hud::draw(Batch_renderer& batch) {
+
+    PROFILE_ZONE("Perf_hud::draw (batched)");
+
+    if (m_is_hidden) {
+
+        return;
+    }
+
+    update_graph();
+
+    // Same texture as the lines, they end up in its batch
+    batch.add(m_graph_vertices, &get_texture());
+
+    for (Label& line : m_lines) {
+
+        line.draw(batch);
+    }
+
+    Frame_stats::count_widget_drawn();
+}
+
+// -------------------------------------------------------------------
+void Perf_hud::update_text() {
+
+    // Percentiles over the rolling window, in the preallocated scratch copy
+    auto const percentile = [this](float const p) {
+
+        if (m_history_count == 0u) {
+
+            return 0.0f;
+        }
+
+        std::size_t const index = static_cast<std::size_t>(p * static_cast<float>(m_history_count - 1u) + 0.5f);
+        std::nth_element(m_scratch.begin(), m_scratch.begin() + static_cast<std::ptrdiff_t>(index), m_scratch.begin() + static_cast<std::ptrdiff_t>(m_history_count));
+
+        return m_scratch[index];
+    };
+
+    std::copy_n(m_history.begin(), m_history_count, m_scratch.begin());
+
+    m_p50 = percentile(0.50f);
+    m_p95 = percentile(0.95f);
+    m_p99 = percentile(0.99f);
+
+    double const seconds = std::chrono::duration<double>(m_since_text_update).count();
+    double const fps     = (seconds > 0.0) ? static_cast<double>(m_frames_since_text_update) / seconds : 0.0;
+
+    // snprintf cuts anything longer than a dynamic text holds
+    char line[Label::DYNAMIC_TEXT_CAPACITY + 1u];
+
+    std::snprintf(line, sizeof(line), "FPS %.1f", fps);
+    m_lines[0].set_dynamic_text(line);
+
+    std::snprintf(line, sizeof(line), "p50/95/99 %.1f %.1f %.1f ms", static_cast<double>(m_p50), static_cast<double>(m_p95), static_cast<double>(m_p99));
+    m_lines[1].set_dynamic_text(line);
+
+    std::snprintf(line, sizeof(line), "draw calls %u", m_last_counters.draw_calls);
+    m_lines[2].set_dynamic_text(line);
+
+    std::snprintf(line, sizeof(line), "widgets %zu (%u drawn)", get_widget_count(), m_last_counters.widgets_drawn);
+    m_lines[3].set_dynamic_text(line);
+
+    if (m_last_counters.allocations) {
+
+        std::snprintf(line, sizeof(line), "allocs/frame %llu (%llu B)",
+            static_cast<unsigned long long>(*m_last_counters.allocations),
+            static_cast<unsigned long long>(m_last_counters.allocated_bytes.value_or(0u))
+        );
+    } else {
+
+        std::snprintf(line, sizeof(line), "allocs/frame n/a");
+    }
+
+    m_lines[4].set_dynamic_text(line);
+
+    m_since_text_update        = std::chrono::nanoseconds(0);
+    m_frames_since_text_update = 0u;
+}
+
+// -------------------------------------------------------------------
+void Perf_hud::update_graph() {
+
+    if (!m_is_graph_dirty) {
+
+        return;
+    }
+
+    sf::FloatRect const text_bounds = get_text_bounds();
+
+    set_quad(m_graph_vertices, TEXT_BACKGROUND_QUAD, text_bounds.position, text_bounds.position + text_bounds.size, BACKGROUND_COLOR);
+
+    sf::Vector2f const min(text_bounds.position.x, text_bounds.position.y + text_bounds.size.y + GRAPH_GAP);
+    sf::Vector2f const max(min.x + static_cast<float>(BUCKET_COUNT) * BAR_WIDTH, min.y + GRAPH_HEIGHT);
+
+    set_quad(m_graph_vertices, GRAPH_BACKGROUND_QUAD, min, max, BACKGROUND_COLOR);
+
+    std::uint32_t const max_count = std::max(*std::max_element(m_buckets.begin(), m_buckets.end()), 1u);
+
+    for (std::size_t bucket = 0u; bucket < BUCKET_COUNT; ++bucket) {
+
+        float const height = GRAPH_HEIGHT * static_cast<float>(m_buckets[bucket]) / static_cast<float>(max_count);
+        float const left   = min.x + static_cast<float>(bucket) * BAR_WIDTH;
+
+        set_quad(m_graph_vertices, FIRST_BAR_QUAD + bucket, { left, max.y - height }, { left + BAR_WIDTH - 1.0f, max.y }, get_bucket_color(bucket));
+    }
+
+    // Percentile markers, a bucket is 1 ms wide so milliseconds map straight to bar widths
+    float const     marks [] = { m_p50, m_p95, m_p99 };
+    sf::Color const colors[] = { sf::Color::White, sf::Color(255u, 165u, 0u), sf::Color::Red };
+
+    for (std::size_t i = 0u; i < 3u; ++i) {
+
+        float const x = min.x + std::min(marks[i], static_cast<float>(BUCKET_COUNT)) * BAR_WIDTH;
+        set_quad(m_graph_vertices, FIRST_MARK_QUAD + i, { x, min.y }, { x + 1.0f, max.y }, colors[i]);
+    }
+
+    m_is_graph_dirty = false;
+}
+
+// -------------------------------------------------------------------
+sf::Texture const& Perf_hud::get_texture() const {
+
+    return m_lines[0].get_font()->getTexture(CHARACTER_SIZE);
+}
+
+// -------------------------------------------------------------------
+// One under the other, inside the text background's margins.
+void Perf_hud::place_lines() {
+
+    float const line_spacing = m_lines[0].get_font()->getLineSpacing(CHARACTER_SIZE);
+
+    for (std::size_t i = 0u; i < LINE_COUNT; ++i) {
+
+        m_lines[i].set_origin(m_origin);
+        m_lines[i].set_pos(m_pos + sf::Vector2f(TEXT_MARGIN, TEXT_MARGIN + static_cast<float>(i) * line_spacing));
+    }
+}
+
+// -------------------------------------------------------------------
+sf::FloatRect Perf_hud::get_text_bounds() const {
+
+    sf::Vector2f const min          = m_pos - m_origin;
+    float const        line_spacing = m_lines[0].get_font()->getLineSpacing(CHARACTER_SIZE);
+
+    float right = min.x;
+
+    for (Label const& line : m_lines) {
+
+        sf::FloatRect const bounds = line.get_global_bounds();
+        right = std::max(right, bounds.position.x + bounds.size.x);
+    }
+
+    return { min, { right - min.x + TEXT_MARGIN, 2.0f * TEXT_MARGIN + static_cast<float>(LINE_COUNT) * line_spacing } };
+}
+
+} // tiny_tanks::widget
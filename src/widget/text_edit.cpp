@@ -0,0 +1,789 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "widget/text_edit.h"
+#include "utils/defs.h"
+#include "utils/frame_stats.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+// ===================================================================
+// Using directives
+// -------------------------------------------------------------------
+
+using namespace tiny_tanks::utils;
+
+namespace {
+
+// ===================================================================
+// Layout settings
+// -------------------------------------------------------------------
+
+constexpr float          TEXT_PADDING = 4.0f;   // Between the box and the text, all sides
+constexpr float          CURSOR_WIDTH = 2.0f;
+constexpr float          TAB_SPACES   = 4.0f;
+constexpr std::ptrdiff_t WHEEL_LINES  = 3;      // Per mouse wheel notch
+
+// -------------------------------------------------------------------
+// Solid quad textured from the font page's white square, like the label background.
+void append_quad(std::vector<sf::Vertex>& vertices, sf::Vector2f const min, sf::Vector2f const max, sf::Color const color) {
+
+    vertices.push_back(sf::Vertex{ min,              color, WHITE_TEXEL });
+    vertices.push_back(sf::Vertex{ { max.x, min.y }, color, WHITE_TEXEL });
+    vertices.push_back(sf::Vertex{ { min.x, max.y }, color, WHITE_TEXEL });
+    vertices.push_back(sf::Vertex{ { min.x, max.y }, color, WHITE_TEXEL });
+    vertices.push_back(sf::Vertex{ { max.x, min.y }, color, WHITE_TEXEL });
+    vertices.push_back(sf::Vertex{ max,              color, WHITE_TEXEL });
+}
+
+// -------------------------------------------------------------------
+// Pen movement for whitespace, 0 for anything with a glyph.
+float get_space_advance(sf::Font const& font, char32_t const character, unsigned int const character_size) {
+
+    if (character != U' ' && character != U'\t') {
+
+        return 0.0f;
+    }
+
+    float const space = font.getGlyph(U' ', character_size, false).advance;
+
+    return (character == U'\t') ? space * TAB_SPACES : space;
+}
+
+} // namespace
+
+// ===================================================================
+// class Text_edit
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Text_edit::Text_edit(sf::RenderTarget* render_target)
+    : Widget(render_target)
+    , m_buffer()
+    , m_font(fonts().load(DEFAULT_TEXT_FONT))
+    , m_size({ 400.0f, 200.0f })
+    , m_character_size(14u)
+    , m_text_color(DEFAULT_TEXT_COLOR)
+    , m_background_color(DEFAULT_WIDGET_BACKGROUND)
+    , m_cursor(0u)
+    , m_first_line(0u)
+    , m_is_read_only(false)
+    , m_is_hidden(false)
+    , m_line_layouts()
+    , m_previous_layouts()
+    , m_vertices()
+    , m_is_layout_dirty(true)
+{}
+
+// -------------------------------------------------------------------
+void Text_edit::set_pos(sf::Vector2f const& pos) {
+
+    m_pos = pos;
+    mark_layout_dirty();
+}
+
+// -------------------------------------------------------------------
+void Text_edit::set_origin(sf::Vector2f const& origin) {
+
+    m_origin = origin;
+    mark_layout_dirty();
+}
+
+// -------------------------------------------------------------------
+Widget_type Text_edit::is() const {
+
+    return Widget_type::Text_edit;
+}
+
+// -------------------------------------------------------------------
+void Text_edit::draw() {
+
+    if (m_render_target == nullptr) {
+
+        LOG(Log_lvl::ERROR) << "No render target to draw to";
+        return;
+    }
+
+    draw(*m_render_target);
+}
+
+// -------------------------------------------------------------------
+void Text_edit::draw(sf::RenderTarget& target) {
+
+    PROFILE_ZONE("Text_edit::draw");
+
+    if (m_is_hidden) {
+
+        return;
+    }
+
+    update_layout();
+
+    target.draw(m_vertices.data(), m_vertices.size(), sf::PrimitiveType::Triangles, sf::RenderStates(&get_texture()));
+
+    Frame_stats::count_draw_calls(1u);
+    Frame_stats::count_widget_drawn();
+}
+
+// -------------------------------------------------------------------
+void Text_edit::draw(Batch_renderer& batch) {
+
+    PROFILE_ZONE("Text_edit::draw (batched)");
+
+    if (m_is_hidden) {
+
+        return;
+    }
+
+    update_layout();
+
+    batch.add(m_vertices, &get_texture());
+
+    Frame_stats::count_widget_drawn();
+}
+
+// -------------------------------------------------------------------
+void Text_edit::set_size(sf::Vector2f const& size) {
+
+    m_size = size;
+
+    // More or fewer lines fit, and the right edge culls at a new place
+    mark_all_lines_dirty();
+    scroll_to_line(m_first_line);
+}
+
+// -------------------------------------------------------------------
+sf::Vector2f Text_edit::get_size() const {
+
+    return m_size;
+}
+
+// -------------------------------------------------------------------
+void Text_edit::set_text(std::string_view const text) {
+
+    m_buffer.clear();
+    m_buffer.append(text);
+
+    m_cursor     = m_buffer.size();
+    m_first_line = 0u;
+
+    mark_all_lines_dirty();
+    scroll_to_cursor();
+}
+
+// -------------------------------------------------------------------
+std::string Text_edit::get_text() const {
+
+    return m_buffer.get_text();
+}
+
+// -------------------------------------------------------------------
+void Text_edit::clear() {
+
+    m_buffer.clear();
+
+    m_cursor     = 0u;
+    m_first_line = 0u;
+
+    mark_all_lines_dirty();
+}
+
+// -------------------------------------------------------------------
+void Text_edit::insert(std::string_view const text) {
+
+    PROFILE_ZONE("Text_edit::insert");
+
+    std::size_t const line = m_buffer.get_line_of(m_cursor);
+
+    m_buffer.insert(m_cursor, text);
+    on_lines_inserted(line, static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n')));
+
+    m_cursor += text.size();
+
+    scroll_to_cursor();
+    mark_layout_dirty();
+}
+
+// -------------------------------------------------------------------
+void Text_edit::append(std::string_view const text) {
+
+    PROFILE_ZONE("Text_edit::append");
+
+    std::size_t const last_line    = m_buffer.get_line_count() - 1u;
+    bool const        is_following = m_first_line + get_visible_line_count() > last_line;
+
+    m_buffer.append(text);
+    on_lines_inserted(last_line, static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n')));
+
+    if (is_following) {
+
+        scroll_to_line(m_buffer.get_line_count());
+    }
+
+    mark_layout_dirty();
+}
+
+// -------------------------------------------------------------------
+void Text_edit::erase_backward() {
+
+    if (m_cursor == 0u) {
+
+        return;
+    }
+
+    --m_cursor;
+    erase_range(m_cursor, 1u);
+}
+
+// -------------------------------------------------------------------
+void Text_edit::erase_forward() {
+
+    if (m_cursor < m_buffer.size()) {
+
+        erase_range(m_cursor, 1u);
+    }
+}
+
+// -------------------------------------------------------------------
+void Text_edit::set_cursor(std::size_t const offset) {
+
+    m_cursor = std::min(offset, m_buffer.size());
+
+    scroll_to_cursor();
+    mark_layout_dirty();
+}
+
+// -------------------------------------------------------------------
+std::size_t Text_edit::get_cursor() const {
+
+    return m_cursor;
+}
+
+// -------------------------------------------------------------------
+std::size_t Text_edit::get_line_count() const {
+
+    return m_buffer.get_line_count();
+}
+
+// -------------------------------------------------------------------
+void Text_edit::scroll_to_line(std::size_t const line) {
+
+    std::size_t const line_count = m_buffer.get_line_count();
+    std::size_t const visible    = get_visible_line_count();
+    std::size_t const last_first = (line_count > visible) ? line_count - visible : 0u;
+
+    std::size_t const first_line = std::min(line, last_first);
+
+    if (first_line != m_first_line) {
+
+        m_first_line = first_line;
+        mark_layout_dirty();
+    }
+}
+
+// -------------------------------------------------------------------
+void Text_edit::scroll(std::ptrdiff_t const lines) {
+
+    if (lines < 0 && static_cast<std::size_t>(-lines) > m_first_line) {
+
+        scroll_to_line(0u);
+
+    } else {
+
+        scroll_to_line(m_first_line + static_cast<std::size_t>(lines));
+    }
+}
+
+// -------------------------------------------------------------------
+std::size_t Text_edit::get_first_visible_line() const {
+
+    return m_first_line;
+}
+
+// -------------------------------------------------------------------
+std::size_t Text_edit::get_visible_line_count() const {
+
+    float const rows = std::floor((m_size.y - TEXT_PADDING * 2.0f) / get_line_height());
+
+    return std::max(static_cast<std::size_t>(std::max(rows, 0.0f)), std::size_t{ 1u });
+}
+
+// -------------------------------------------------------------------
+bool Text_edit::handle_event(sf::Event const& event) {
+
+    if (m_is_hidden) {
+
+        return false;
+    }
+
+    if (auto const* wheel = event.getIf<sf::Event::MouseWheelScrolled>(); wheel != nullptr && wheel->wheel == sf::Mouse::Wheel::Vertical) {
+
+        sf::Vector2f const point = (m_render_target != nullptr)
+            ? m_render_target->mapPixelToCoords(wheel->position)
+            : sf::Vector2f(wheel->position);
+
+        if (!get_global_bounds().contains(point)) {
+
+            return false;
+        }
+
+        scroll(static_cast<std::ptrdiff_t>(-wheel->delta) * WHEEL_LINES);
+        return true;
+    }
+
+    if (m_is_read_only) {
+
+        return false;
+    }
+
+    if (auto const* text = event.getIf<sf::Event::TextEntered>(); text != nullptr) {
+
+        // Backspace and delete come through as key presses too, handled there
+        char32_t const character = text->unicode;
+
+        if (character == U'\r' || character == U'\n') {
+
+            insert("\n");
+
+        } else if (character == U'\t' || (character >= U' ' && character != 127u && character <= 255u)) {
+
+            char const byte = static_cast<char>(character);
+            insert(std::string_view(&byte, 1u));
+
+        } else {
+
+            return false;
+        }
+
+        return true;
+    }
+
+    auto const* key = event.getIf<sf::Event::KeyPressed>();
+
+    if (key == nullptr) {
+
+        return false;
+    }
+
+    std::size_t const line       = m_buffer.get_line_of(m_cursor);
+    std::size_t const line_start = m_buffer.get_line_start(line);
+    std::size_t const column     = m_cursor - line_start;
+
+    // Same column on another line, or its end if it is shorter
+    auto const move_to_line = [&](std::size_t const target_line) {
+
+        std::size_t const start = m_buffer.get_line_start(target_line);
+        set_cursor(std::min(start + column, m_buffer.get_line_end(target_line)));
+    };
+
+    switch (key->code) {
+
+        case sf::Keyboard::Key::Backspace: erase_backward();                                  break;
+        case sf::Keyboard::Key::Delete:    erase_forward();                                   break;
+        case sf::Keyboard::Key::Left:      set_cursor(m_cursor - (m_cursor > 0u ? 1u : 0u));  break;
+        case sf::Keyboard::Key::Right:     set_cursor(m_cursor + 1u);                         break;
+        case sf::Keyboard::Key::Home:      set_cursor(line_start);                            break;
+        case sf::Keyboard::Key::End:       set_cursor(m_buffer.get_line_end(line));           break;
+
+        case sf::Keyboard::Key::Up:
+
+            if (line > 0u) {
+
+                move_to_line(line - 1u);
+            }
+
+            break;
+
+        case sf::Keyboard::Key::Down:
+
+            if (line + 1u < m_buffer.get_line_count()) {
+
+                move_to_line(line + 1u);
+            }
+
+            break;
+
+        case sf::Keyboard::Key::PageUp:
+
+            move_to_line(line - std::min(line, get_visible_line_count()));
+            break;
+
+        case sf::Keyboard::Key::PageDown:
+
+            move_to_line(std::min(line + get_visible_line_count(), m_buffer.get_line_count() - 1u));
+            break;
+
+        default:
+
+            return false;
+    }
+
+    return true;
+}
+
+// -------------------------------------------------------------------
+void Text_edit::set_read_only(bool const is_read_only) {
+
+    m_is_read_only = is_read_only;
+    mark_layout_dirty();
+}
+
+// -------------------------------------------------------------------
+bool Text_edit::is_read_only() const {
+
+    return m_is_read_only;
+}
+
+// -------------------------------------------------------------------
+void Text_edit::hide(bool const is_hidden) {
+
+    m_is_hidden = is_hidden;
+    invalidate();
+}
+
+// -------------------------------------------------------------------
+bool Text_edit::is_hidden() const {
+
+    return m_is_hidden;
+}
+
+// -------------------------------------------------------------------
+void Text_edit::set_font(Font_handle font) {
+
+    if (font == nullptr) {
+
+        LOG(Log_lvl::ERROR) << "Font handle is null";
+        return;
+    }
+
+    m_font = std::move(font);
+
+    mark_all_lines_dirty();
+    scroll_to_line(m_first_line);
+}
+
+// -------------------------------------------------------------------
+Font_handle Text_edit::get_font() const {
+
+    return m_font;
+}
+
+// -------------------------------------------------------------------
+void Text_edit::set_character_size(unsigned int const size) {
+
+    m_character_size = size;
+
+    mark_all_lines_dirty();
+    scroll_to_line(m_first_line);
+}
+
+// -------------------------------------------------------------------
+unsigned int Text_edit::get_character_size() const {
+
+    return m_character_size;
+}
+
+// -------------------------------------------------------------------
+void Text_edit::set_text_color(sf::Color const& color) {
+
+    m_text_color = color;
+    mark_all_lines_dirty();
+}
+
+// -------------------------------------------------------------------
+sf::Color Text_edit::get_text_color() const {
+
+    return m_text_color;
+}
+
+// -------------------------------------------------------------------
+void Text_edit::set_background_color(sf::Color const& color) {
+
+    m_background_color = color;
+    mark_layout_dirty();
+}
+
+// -------------------------------------------------------------------
+sf::Color Text_edit::get_background_color() const {
+
+    return m_background_color;
+}
+
+// -------------------------------------------------------------------
+sf::FloatRect Text_edit::get_global_bounds() const {
+
+    return sf::FloatRect(m_pos - m_origin, m_size);
+}
+
+// -------------------------------------------------------------------
+void Text_edit::mark_layout_dirty() {
+
+    m_is_layout_dirty = true;
+    invalidate();
+}
+
+// -------------------------------------------------------------------
+void Text_edit::mark_all_lines_dirty() {
+
+    for (Line_layout& layout : m_line_layouts) {
+
+        layout.is_dirty = true;
+    }
+
+    mark_layout_dirty();
+}
+
+// -------------------------------------------------------------------
+// The edited line is laid out again, the lines after it only change index.
+void Text_edit::on_lines_inserted(std::size_t const line, std::size_t const count) {
+
+    for (Line_layout& layout : m_line_layouts) {
+
+        if (layout.line == line) {
+
+            layout.is_dirty = true;
+
+        } else if (layout.line > line && layout.line != NO_LINE) {
+
+            layout.line += count;
+        }
+    }
+}
+
+// -------------------------------------------------------------------
+// Lines (first_line, last_line] were joined onto first_line.
+void Text_edit::on_lines_erased(std::size_t const first_line, std::size_t const last_line) {
+
+    for (Line_layout& layout : m_line_layouts) {
+
+        if (layout.line == first_line) {
+
+            layout.is_dirty = true;
+
+        } else if (layout.line > first_line && layout.line <= last_line) {
+
+            layout.line     = NO_LINE;
+            layout.is_dirty = true;
+
+        } else if (layout.line > last_line && layout.line != NO_LINE) {
+
+            layout.line -= last_line - first_line;
+        }
+    }
+}
+
+// -------------------------------------------------------------------
+void Text_edit::erase_range(std::size_t const offset, std::size_t const count) {
+
+    PROFILE_ZONE("Text_edit::erase");
+
+    std::size_t const first_line = m_buffer.get_line_of(offset);
+    std::size_t const last_line  = m_buffer.get_line_of(std::min(offset + count, m_buffer.size()));
+
+    m_buffer.erase(offset, count);
+    on_lines_erased(first_line, last_line);
+
+    m_cursor = std::min(m_cursor, m_buffer.size());
+
+    // Fewer lines, the view may now be past the end
+    scroll_to_line(m_first_line);
+    scroll_to_cursor();
+    mark_layout_dirty();
+}
+
+// -------------------------------------------------------------------
+void Text_edit::scroll_to_cursor() {
+
+    std::size_t const line    = m_buffer.get_line_of(m_cursor);
+    std::size_t const visible = get_visible_line_count();
+
+    if (line < m_first_line) {
+
+        scroll_to_line(line);
+
+    } else if (line >= m_first_line + visible) {
+
+        scroll_to_line(line + 1u - visible);
+    }
+}
+
+// -------------------------------------------------------------------
+// Lines still on screen and unedited keep their quads, lines that came
+// into view reuse the memory of the ones that left it, so scrolling lays
+// out only the new lines and allocates nothing once warmed up.
+void Text_edit::update_layout() const {
+
+    if (!m_is_layout_dirty) {
+
+        return;
+    }
+
+    PROFILE_ZONE("Text_edit::update_layout");
+
+    std::size_t const first_line = m_first_line;
+    std::size_t const last_line  = std::min(first_line + get_visible_line_count(), m_buffer.get_line_count());
+
+    m_previous_layouts.swap(m_line_layouts);
+    m_line_layouts.clear();
+
+    for (std::size_t line = first_line; line < last_line; ++line) {
+
+        Line_layout& layout = m_line_layouts.emplace_back();
+        layout.line = line;
+
+        auto const kept = std::find_if(m_previous_layouts.begin(), m_previous_layouts.end(), [line](Line_layout const& previous) {
+
+            return previous.line == line && !previous.is_dirty;
+        });
+
+        if (kept != m_previous_layouts.end()) {
+
+            layout.vertices.swap(kept->vertices);
+            layout.is_dirty = false;
+
+            kept->line = NO_LINE;
+        }
+    }
+
+    std::size_t spare = 0u;
+
+    for (Line_layout& layout : m_line_layouts) {
+
+        if (!layout.is_dirty) {
+
+            continue;
+        }
+
+        if (spare < m_previous_layouts.size()) {
+
+            layout.vertices.swap(m_previous_layouts[spare++].vertices);
+        }
+
+        layout_line(layout);
+    }
+
+    // Move the lines into place behind the background, the cursor goes on top
+    sf::Vector2f const top_left    = m_pos - m_origin;
+    float const        line_height = get_line_height();
+
+    m_vertices.clear();
+    append_quad(m_vertices, top_left, top_left + m_size, m_background_color);
+
+    for (std::size_t row = 0u; row < m_line_layouts.size(); ++row) {
+
+        sf::Vector2f const offset = top_left + sf::Vector2f(TEXT_PADDING, TEXT_PADDING + static_cast<float>(row) * line_height);
+
+        for (sf::Vertex const& vertex : m_line_layouts[row].vertices) {
+
+            m_vertices.push_back(sf::Vertex{ vertex.position + offset, vertex.color, vertex.texCoords });
+        }
+    }
+
+    std::size_t const cursor_line = m_buffer.get_line_of(m_cursor);
+
+    if (!m_is_read_only && cursor_line >= first_line && cursor_line < last_line) {
+
+        sf::Vector2f const min = top_left + sf::Vector2f(
+            TEXT_PADDING + std::min(get_cursor_x(), m_size.x - TEXT_PADDING * 2.0f),
+            TEXT_PADDING + static_cast<float>(cursor_line - first_line) * line_height
+        );
+
+        append_quad(m_vertices, min, min + sf::Vector2f(CURSOR_WIDTH, line_height), m_text_color);
+    }
+
+    m_is_layout_dirty = false;
+}
+
+// -------------------------------------------------------------------
+// Same pen movement as sf::Text without styles, stops at the right edge.
+void Text_edit::layout_line(Line_layout& layout) const {
+
+    layout.vertices.clear();
+    layout.is_dirty = false;
+
+    sf::Font const& font  = *m_font;
+    float const     max_x = m_size.x - TEXT_PADDING * 2.0f;
+
+    std::size_t const end = m_buffer.get_line_end(layout.line);
+
+    float    x         = 0.0f;
+    char32_t prev_char = U'\0';
+
+    for (std::size_t offset = m_buffer.get_line_start(layout.line); offset < end && x < max_x; ++offset) {
+
+        char32_t const curr_char = static_cast<unsigned char>(m_buffer[offset]);
+
+        x += font.getKerning(prev_char, curr_char, m_character_size);
+        prev_char = curr_char;
+
+        if (float const advance = get_space_advance(font, curr_char, m_character_size); advance > 0.0f) {
+
+            x += advance;
+            continue;
+        }
+
+        sf::Glyph const& glyph = font.getGlyph(curr_char, m_character_size, false);
+
+        if (x + glyph.bounds.position.x + glyph.bounds.size.x > max_x) {
+
+            break;
+        }
+
+        if (glyph.bounds.size.x > 0.0f) {
+
+            std::size_t const first = layout.vertices.size();
+
+            layout.vertices.resize(first + 6u);
+            write_glyph_vertices(layout.vertices.data() + first, { x, static_cast<float>(m_character_size) }, glyph, 0.0f, m_text_color);
+        }
+
+        x += glyph.advance;
+    }
+}
+
+// -------------------------------------------------------------------
+float Text_edit::get_line_height() const {
+
+    return std::ceil(m_font->getLineSpacing(m_character_size));
+}
+
+// -------------------------------------------------------------------
+float Text_edit::get_cursor_x() const {
+
+    sf::Font const& font = *m_font;
+
+    float    x         = 0.0f;
+    char32_t prev_char = U'\0';
+
+    for (std::size_t offset = m_buffer.get_line_start(m_buffer.get_line_of(m_cursor)); offset < m_cursor; ++offset) {
+
+        char32_t const curr_char = static_cast<unsigned char>(m_buffer[offset]);
+
+        x += font.getKerning(prev_char, curr_char, m_character_size);
+        prev_char = curr_char;
+
+        float const advance = get_space_advance(font, curr_char, m_character_size);
+
+        x += (advance > 0.0f) ? advance : font.getGlyph(curr_char, m_character_size, false).advance;
+    }
+
+    return x;
+}
+
+// -------------------------------------------------------------------
+sf::Texture const& Text_edit::get_texture() const {
+
+    return m_font->getTexture(m_character_size);
+}
+
+} // tiny_tanks::widget
@@ -0,0 +1,657 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "widget/widget_manager.h"
+#include "utils/logger.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// ===================================================================
+// Namespaces
+// -------------------------------------------------------------------
+
+namespace tiny_tanks::widget {
+
+namespace {
+
+// -------------------------------------------------------------------
+// Cell coordinate of a position, clamped so far off bounds can't overflow.
+std::int32_t to_cell(float const position, float const inverse_cell_size) {
+
+    constexpr float LIMIT = 1'000'000'000.0f;
+
+    return static_cast<std::int32_t>(std::floor(std::clamp(position * inverse_cell_size, -LIMIT, LIMIT)));
+}
+
+// -------------------------------------------------------------------
+bool is_empty(sf::FloatRect const& bounds) {
+
+    return !(bounds.size.x > 0.0f && bounds.size.y > 0.0f)
+        || !std::isfinite(bounds.position.x) || !std::isfinite(bounds.size.x)
+        || !std::isfinite(bounds.position.y) || !std::isfinite(bounds.size.y);
+}
+
+} // namespace
+
+// ===================================================================
+// class Widget_manager
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+Widget_manager::Widget_manager(sf::RenderTarget* render_target, float const cell_size)
+    : m_render_target(render_target)
+    , m_cell_size(cell_size > 0.0f ? cell_size : 64.0f)
+    , m_inverse_cell_size(1.0f / m_cell_size)
+    , m_entries()
+    , m_free_entries()
+    , m_entry_indices()
+    , m_dirty_entries()
+    , m_cells()
+    , m_next_order(1u)
+    , m_hovered(NO_ENTRY)
+    , m_captured(NO_ENTRY)
+    , m_focused(NO_ENTRY)
+{
+
+    if (cell_size <= 0.0f) {
+
+        LOG(Log_lvl::ERROR) << "Cell size must be above 0, got: " << cell_size;
+    }
+}
+
+// -------------------------------------------------------------------
+Widget_manager::~Widget_manager() {
+
+    for (Entry const& entry : m_entries) {
+
+        if (entry.widget != nullptr) {
+
+            entry.widget->m_observer = nullptr;
+        }
+    }
+}
+
+// -------------------------------------------------------------------
+void Widget_manager::add(Widget& widget, Event_handler handler, std::uint32_t const events) {
+
+    if (widget.m_observer != nullptr) {
+
+        LOG(Log_lvl::ERROR) << "Widget is already in a widget manager";
+        return;
+    }
+
+    if (!handler) {
+
+        LOG(Log_lvl::ERROR) << "Event handler is empty";
+        return;
+    }
+
+    Entry_index index;
+
+    if (!m_free_entries.empty()) {
+
+        index = m_free_entries.back();
+        m_free_entries.pop_back();
+    } else {
+
+        index = static_cast<Entry_index>(m_entries.size());
+        m_entries.emplace_back();
+    }
+
+    m_entries[index] = Entry{ &widget, std::move(handler), events, m_next_order++, {}, {}, true, true };
+    m_entry_indices.emplace(&widget, index);
+
+    // Bounds are read on the next update, the widget may not be laid out yet
+    m_dirty_entries.push_back(index);
+
+    widget.m_observer = this;
+}
+
+// -------------------------------------------------------------------
+void Widget_manager::remove(Widget& widget) {
+
+    Entry_index const index = find_entry(widget);
+
+    if (index == NO_ENTRY) {
+
+        LOG(Log_lvl::ERROR) << "Widget is not in this widget manager";
+        return;
+    }
+
+    erase_cells(index);
+
+    if (m_hovered  == index) m_hovered  = NO_ENTRY;
+    if (m_captured == index) m_captured = NO_ENTRY;
+    if (m_focused  == index) m_focused  = NO_ENTRY;
+
+    // Still in m_dirty_entries maybe, update() skips entries without a widget
+    Entry& entry = m_entries[index];
+    entry.widget   = nullptr;
+    entry.handler  = nullptr;
+    entry.is_dirty = false;
+
+    widget.m_observer = nullptr;
+
+    m_entry_indices.erase(&widget);
+    m_free_entries.push_back(index);
+}
+
+// -------------------------------------------------------------------
+bool Widget_manager::contains(Widget const& widget) const {
+
+    return find_entry(widget) != NO_ENTRY;
+}
+
+// -------------------------------------------------------------------
+std::size_t Widget_manager::get_widget_count() const {
+
+    return m_entry_indices.size();
+}
+
+// -------------------------------------------------------------------
+void Widget_manager::raise(Widget& widget) {
+
+    Entry_index const index = find_entry(widget);
+
+    if (index == NO_ENTRY) {
+
+        LOG(Log_lvl::ERROR) << "Widget is not in this widget manager";
+        return;
+    }
+
+    // Cells are kept in order, so it goes back in at the end of each
+    erase_cells(index);
+    m_entries[index].order = m_next_order++;
+    insert_cells(index);
+}
+
+// -------------------------------------------------------------------
+void Widget_manager::set_enabled(Widget& widget, bool const is_enabled) {
+
+    Entry_index const index = find_entry(widget);
+
+    if (index == NO_ENTRY) {
+
+        LOG(Log_lvl::ERROR) << "Widget is not in this widget manager";
+        return;
+    }
+
+    Entry& entry = m_entries[index];
+
+    if (entry.is_enabled == is_enabled) {
+
+        return;
+    }
+
+    entry.is_enabled = is_enabled;
+
+    if (is_enabled) {
+
+        insert_cells(index);
+    } else {
+
+        erase_cells(index);
+
+        if (m_hovered  == index) m_hovered  = NO_ENTRY;
+        if (m_captured == index) m_captured = NO_ENTRY;
+        if (m_focused  == index) m_focused  = NO_ENTRY;
+    }
+}
+
+// -------------------------------------------------------------------
+bool Widget_manager::is_enabled(Widget const& widget) const {
+
+    Entry_index const index = find_entry(widget);
+
+    return index != NO_ENTRY && m_entries[index].is_enabled;
+}
+
+// -------------------------------------------------------------------
+Widget* Widget_manager::hit_test(sf::Vector2f const& point) {
+
+    update();
+
+    Entry_index const index = find_hit(point, std::numeric_limits<std::uint64_t>::max());
+
+    return (index != NO_ENTRY) ? m_entries[index].widget : nullptr;
+}
+
+// -------------------------------------------------------------------
+bool Widget_manager::dispatch(sf::Event const& event) {
+
+    update();
+
+    if (auto const* moved = event.getIf<sf::Event::MouseMoved>(); moved != nullptr) {
+
+        set_hovered(find_hit(map_pixel(moved->position), std::numeric_limits<std::uint64_t>::max()));
+
+        // A widget being dragged keeps getting the moves
+        Entry_index const target = (m_captured != NO_ENTRY) ? m_captured : m_hovered;
+
+        return target != NO_ENTRY && send(target, event);
+    }
+
+    if (auto const* pressed = event.getIf<sf::Event::MouseButtonPressed>(); pressed != nullptr) {
+
+        return send_at(map_pixel(pressed->position), event, true);
+    }
+
+    if (auto const* released = event.getIf<sf::Event::MouseButtonReleased>(); released != nullptr) {
+
+        if (m_captured != NO_ENTRY) {
+
+            Entry_index const captured = std::exchange(m_captured, NO_ENTRY);
+            return send(captured, event);
+        }
+
+        return send_at(map_pixel(released->position), event, false);
+    }
+
+    if (auto const* wheel = event.getIf<sf::Event::MouseWheelScrolled>(); wheel != nullptr) {
+
+        return send_at(map_pixel(wheel->position), event, false);
+    }
+
+    if (event.is<sf::Event::KeyPressed>() || event.is<sf::Event::KeyReleased>() || event.is<sf::Event::TextEntered>()) {
+
+        return m_focused != NO_ENTRY && send(m_focused, event);
+    }
+
+    if (event.is<sf::Event::MouseLeft>()) {
+
+        set_hovered(NO_ENTRY);
+
+    } else if (event.is<sf::Event::FocusLost>()) {
+
+        // The release happens in another window, we won't see it
+        m_captured = NO_ENTRY;
+    }
+
+    return false;
+}
+
+// -------------------------------------------------------------------
+Widget* Widget_manager::get_hovered() const {
+
+    return (m_hovered != NO_ENTRY) ? m_entries[m_hovered].widget : nullptr;
+}
+
+// -------------------------------------------------------------------
+Widget* Widget_manager::get_captured() const {
+
+    return (m_captured != NO_ENTRY) ? m_entries[m_captured].widget : nullptr;
+}
+
+// -------------------------------------------------------------------
+void Widget_manager::set_focus(Widget* widget) {
+
+    Entry_index index = NO_ENTRY;
+
+    if (widget != nullptr) {
+
+        index = find_entry(*widget);
+
+        if (index == NO_ENTRY || (m_entries[index].events & KEYBOARD) == 0u || !m_entries[index].is_enabled) {
+
+            LOG(Log_lvl::ERROR) << "Widget can't have the keyboard focus";
+            return;
+        }
+    }
+
+    set_focus_entry(index);
+}
+
+// -------------------------------------------------------------------
+Widget* Widget_manager::get_focus() const {
+
+    return (m_focused != NO_ENTRY) ? m_entries[m_focused].widget : nullptr;
+}
+
+// -------------------------------------------------------------------
+void Widget_manager::update() {
+
+    if (m_dirty_entries.empty()) {
+
+        return;
+    }
+
+    PROFILE_ZONE("Widget_manager::update");
+
+    // By index, reading bounds can update a layout whose children then
+    // invalidate and land at the end of the list
+    for (std::size_t i = 0u; i < m_dirty_entries.size(); ++i) {
+
+        Entry_index const index = m_dirty_entries[i];
+
+        if (!m_entries[index].is_dirty) {
+
+            continue;
+        }
+
+        m_entries[index].is_dirty = false;
+
+        sf::FloatRect const bounds = m_entries[index].widget->get_global_bounds();
+        Entry&              entry  = m_entries[index];
+
+        if (bounds == entry.bounds) {
+
+            continue;
+        }
+
+        Cell_range const cells = get_cell_range(bounds);
+
+        bool const is_same_cells = cells.left  == entry.cells.left  && cells.top    == entry.cells.top
+                                && cells.right == entry.cells.right && cells.bottom == entry.cells.bottom;
+
+        if (is_same_cells) {
+
+            // Moved or resized inside the same cells, only the copies change
+            entry.bounds = bounds;
+            refresh_cells(index);
+        } else {
+
+            erase_cells(index);
+            entry.bounds = bounds;
+            insert_cells(index);
+        }
+    }
+
+    m_dirty_entries.clear();
+}
+
+// -------------------------------------------------------------------
+std::size_t Widget_manager::get_cell_count() const {
+
+    // Empty cells are erased, every one left holds a widget
+    return m_cells.size();
+}
+
+// -------------------------------------------------------------------
+std::size_t Widget_manager::get_max_cell_size() const {
+
+    std::size_t max_size = 0u;
+
+    for (auto const& [key, cell] : m_cells) {
+
+        max_size = std::max(max_size, cell.size());
+    }
+
+    return max_size;
+}
+
+// -------------------------------------------------------------------
+void Widget_manager::on_widget_invalidated(Widget& widget) {
+
+    Entry_index const index = find_entry(widget);
+
+    if (index != NO_ENTRY && !m_entries[index].is_dirty) {
+
+        m_entries[index].is_dirty = true;
+        m_dirty_entries.push_back(index);
+    }
+}
+
+// -------------------------------------------------------------------
+void Widget_manager::on_widget_destroyed(Widget& widget) {
+
+    remove(widget);
+}
+
+// -------------------------------------------------------------------
+Widget_manager::Entry_index Widget_manager::find_entry(Widget const& widget) const {
+
+    auto const it = m_entry_indices.find(&widget);
+
+    return (it != m_entry_indices.end()) ? it->second : NO_ENTRY;
+}
+
+// -------------------------------------------------------------------
+// Only enabled MOUSE widgets go in cells, a hit test never has to skip
+// any. Cells are sorted by order, a widget added or raised goes last.
+void Widget_manager::insert_cells(Entry_index const index) {
+
+    Entry& entry = m_entries[index];
+
+    if (!entry.is_enabled || (entry.events & MOUSE) == 0u) {
+
+        entry.cells = {};
+        return;
+    }
+
+    entry.cells = get_cell_range(entry.bounds);
+
+    Cell_item const item = { entry.bounds, entry.order, index };
+
+    for (std::int32_t y = entry.cells.top; y <= entry.cells.bottom; ++y) {
+
+        for (std::int32_t x = entry.cells.left; x <= entry.cells.right; ++x) {
+
+            std::vector<Cell_item>& cell = m_cells[get_cell_key(x, y)];
+
+            if (cell.empty() || cell.back().order < item.order) {
+
+                cell.push_back(item);
+            } else {
+
+                auto const it = std::upper_bound(cell.begin(), cell.end(), item.order,
+                                                 [](std::uint64_t const order, Cell_item const& other) { return order < other.order; });
+                cell.insert(it, item);
+            }
+        }
+    }
+}
+
+// -------------------------------------------------------------------
+// A cell goes with its last widget, so widgets wandering over the world
+// don't leave the map full of empty cells.
+void Widget_manager::erase_cells(Entry_index const index) {
+
+    Entry& entry = m_entries[index];
+
+    for (std::int32_t y = entry.cells.top; y <= entry.cells.bottom; ++y) {
+
+        for (std::int32_t x = entry.cells.left; x <= entry.cells.right; ++x) {
+
+            auto const cell = m_cells.find(get_cell_key(x, y));
+
+            if (cell == m_cells.end()) {
+
+                continue;
+            }
+
+            auto const it = std::find_if(cell->second.begin(), cell->second.end(), [index](Cell_item const& item) { return item.entry == index; });
+
+            if (it != cell->second.end()) {
+
+                cell->second.erase(it);
+            }
+
+            if (cell->second.empty()) {
+
+                m_cells.erase(cell);
+            }
+        }
+    }
+
+    entry.cells = {};
+}
+
+// -------------------------------------------------------------------
+void Widget_manager::refresh_cells(Entry_index const index) {
+
+    Entry const& entry = m_entries[index];
+
+    for (std::int32_t y = entry.cells.top; y <= entry.cells.bottom; ++y) {
+
+        for (std::int32_t x = entry.cells.left; x <= entry.cells.right; ++x) {
+
+            auto const cell = m_cells.find(get_cell_key(x, y));
+
+            if (cell == m_cells.end()) {
+
+                continue;
+            }
+
+            for (Cell_item& item : cell->second) {
+
+                if (item.entry == index) {
+
+                    item.bounds = entry.bounds;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// -------------------------------------------------------------------
+Widget_manager::Cell_range Widget_manager::get_cell_range(sf::FloatRect const& bounds) const {
+
+    if (is_empty(bounds)) {
+
+        return {};
+    }
+
+    return {
+        to_cell(bounds.position.x,                 m_inverse_cell_size),
+        to_cell(bounds.position.y,                 m_inverse_cell_size),
+        to_cell(bounds.position.x + bounds.size.x, m_inverse_cell_size),
+        to_cell(bounds.position.y + bounds.size.y, m_inverse_cell_size)
+    };
+}
+
+// -------------------------------------------------------------------
+std::uint64_t Widget_manager::get_cell_key(std::int32_t const x, std::int32_t const y) {
+
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32u) | static_cast<std::uint32_t>(y);
+}
+
+// -------------------------------------------------------------------
+Widget_manager::Entry_index Widget_manager::find_hit(sf::Vector2f const& point, std::uint64_t const below_order) const {
+
+    auto const it = m_cells.find(get_cell_key(to_cell(point.x, m_inverse_cell_size), to_cell(point.y, m_inverse_cell_size)));
+
+    if (it == m_cells.end()) {
+
+        return NO_ENTRY;
+    }
+
+    std::vector<Cell_item> const& cell = it->second;
+
+    // From the top down, the first widget containing the point is the hit
+    for (auto item = cell.rbegin(); item != cell.rend(); ++item) {
+
+        if (item->order < below_order && item->bounds.contains(point)) {
+
+            return item->entry;
+        }
+    }
+
+    return NO_ENTRY;
+}
+
+// -------------------------------------------------------------------
+// The handler is copied first, it may add or remove widgets (and so
+// move or clear the one stored) while it runs.
+bool Widget_manager::send(Entry_index const index, sf::Event const& event) {
+
+    if (m_entries[index].widget == nullptr) {
+
+        return false;
+    }
+
+    Event_handler const handler = m_entries[index].handler;
+
+    return handler(event);
+}
+
+// -------------------------------------------------------------------
+void Widget_manager::set_hovered(Entry_index const index) {
+
+    if (index == m_hovered) {
+
+        return;
+    }
+
+    Entry_index const previous = std::exchange(m_hovered, index);
+
+    if (previous != NO_ENTRY) {
+
+        send(previous, sf::Event::MouseLeft{});
+    }
+
+    if (index != NO_ENTRY && m_hovered == index) {
+
+        send(index, sf::Event::MouseEntered{});
+    }
+}
+
+// -------------------------------------------------------------------
+void Widget_manager::set_focus_entry(Entry_index const index) {
+
+    if (index == m_focused) {
+
+        return;
+    }
+
+    Entry_index const previous = std::exchange(m_focused, index);
+
+    if (previous != NO_ENTRY) {
+
+        send(previous, sf::Event::FocusLost{});
+    }
+
+    if (index != NO_ENTRY && m_focused == index) {
+
+        send(index, sf::Event::FocusGained{});
+    }
+}
+
+// -------------------------------------------------------------------
+bool Widget_manager::send_at(sf::Vector2f const& point, sf::Event const& event, bool const is_press) {
+
+    std::uint64_t below_order = std::numeric_limits<std::uint64_t>::max();
+
+    for (;;) {
+
+        Entry_index const index = find_hit(point, below_order);
+
+        if (index == NO_ENTRY) {
+
+            break;
+        }
+
+        below_order = m_entries[index].order;
+
+        if (send(index, event)) {
+
+            if (is_press && m_entries[index].widget != nullptr) {
+
+                m_captured = index;
+                set_focus_entry(((m_entries[index].events & KEYBOARD) != 0u) ? index : NO_ENTRY);
+            }
+
+            return true;
+        }
+    }
+
+    // Pressing where nothing takes it clears the focus
+    if (is_press) {
+
+        set_focus_entry(NO_ENTRY);
+    }
+
+    return false;
+}
+
+// -------------------------------------------------------------------
+sf::Vector2f Widget_manager::map_pixel(sf::Vector2i const& pixel) const {
+
+    return (m_render_target != nullptr) ? m_render_target->mapPixelToCoords(pixel) : sf::Vector2f(pixel);
+}
+
+} // tiny_tanks::widget
@@ -0,0 +1,205 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/asset_archive.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Packs asset folders into one archive the game maps at startup, see
+// utils/asset_archive.h for the layout. Every file under each folder is
+// stored by its path relative to root, e.g. "assets/fonts/Pennsylvania.otf".
+// "--root <root>" changes the root for the folders after it, so files
+// generated in the build tree are packed next to the sources.
+//
+// Usage:
+//     Tiny_Tanks_asset_pack <output archive> <root> <folder> [folder...] [--root <root> <folder> [folder...]]...
+
+using namespace tiny_tanks::utils;
+
+namespace {
+
+// ===================================================================
+// struct Packed_file
+// -------------------------------------------------------------------
+
+struct Packed_file {
+
+    std::string           path;
+    std::filesystem::path source;
+    std::uint64_t         size   = 0u;
+    std::uint64_t         offset = 0u;
+};
+
+// -------------------------------------------------------------------
+constexpr std::uint64_t align_up(std::uint64_t const value, std::uint64_t const alignment) {
+
+    return (value + alignment - 1u) / alignment * alignment;
+}
+
+// -------------------------------------------------------------------
+void write_padding(std::ofstream& out, std::uint64_t const from, std::uint64_t const to) {
+
+    std::vector<char> const zeros(static_cast<std::size_t>(to - from), '\0');
+    out.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+    if (argc < 4) {
+
+        std::cerr << "Usage: " << argv[0] << " <output archive> <root> <folder> [folder...] [--root <root> <folder> [folder...]]...\n";
+        return 1;
+    }
+
+    std::filesystem::path const output = argv[1];
+    std::filesystem::path       root   = argv[2];
+
+    // Collect the files, sorted so the archive is the same on every build.
+    std::vector<Packed_file> files;
+
+    for (int i = 3; i < argc; ++i) {
+
+        if (std::strcmp(argv[i], "--root") == 0) {
+
+            if (i + 1 >= argc) {
+
+                std::cerr << "--root without a folder\n";
+                return 1;
+            }
+
+            root = argv[++i];
+            continue;
+        }
+
+        std::filesystem::path const folder = root / argv[i];
+
+        if (!std::filesystem::is_directory(folder)) {
+
+            std::cerr << "Not a folder: " << folder.string() << '\n';
+            return 1;
+        }
+
+        for (auto const& item : std::filesystem::recursive_directory_iterator(folder)) {
+
+            if (item.is_regular_file()) {
+
+                files.push_back(Packed_file{
+                    std::filesystem::relative(item.path(), root).generic_string(),
+                    item.path(),
+                    static_cast<std::uint64_t>(item.file_size())
+                });
+            }
+        }
+    }
+
+    std::sort(files.begin(), files.end(), [](Packed_file const& lhs, Packed_file const& rhs) { return lhs.path < rhs.path; });
+
+    // Two roots may not both hold a file, only one of them could be looked up.
+    auto const duplicate = std::adjacent_find(files.begin(), files.end(), [](Packed_file const& lhs, Packed_file const& rhs) { return lhs.path == rhs.path; });
+
+    if (duplicate != files.end()) {
+
+        std::cerr << "Packed twice: " << duplicate->path << '\n';
+        return 1;
+    }
+
+    // Keep the table at most half full so probes stay short.
+    std::uint32_t const table_size = std::bit_ceil(std::max<std::uint32_t>(static_cast<std::uint32_t>(files.size()) * 2u, 2u));
+
+    std::uint64_t const table_offset = sizeof(Asset_archive_header);
+    std::uint64_t const paths_offset = table_offset + std::uint64_t{ table_size } * sizeof(Asset_archive_entry);
+
+    std::string paths;
+    std::vector<Asset_archive_entry> table(table_size, Asset_archive_entry{});
+
+    for (Packed_file const& file : files) {
+
+        paths += file.path;
+    }
+
+    // Lay the contents out after the path characters, each one aligned.
+    std::uint64_t offset = paths_offset + paths.size();
+
+    for (Packed_file& file : files) {
+
+        offset      = align_up(offset, ASSET_ARCHIVE_ALIGNMENT);
+        file.offset = offset;
+        offset     += file.size;
+    }
+
+    std::uint32_t path_offset = static_cast<std::uint32_t>(paths_offset);
+
+    for (Packed_file const& file : files) {
+
+        std::uint64_t const hash = hash_asset_path(file.path);
+        std::uint32_t       slot = static_cast<std::uint32_t>(hash & (table_size - 1u));
+
+        while (table[slot].offset != 0u || table[slot].size != 0u) {
+
+            slot = (slot + 1u) & (table_size - 1u);
+        }
+
+        table[slot] = Asset_archive_entry{ hash, file.offset, file.size, path_offset, static_cast<std::uint32_t>(file.path.size()) };
+        path_offset += static_cast<std::uint32_t>(file.path.size());
+    }
+
+    Asset_archive_header header{};
+    std::memcpy(header.magic, ASSET_ARCHIVE_MAGIC, sizeof(ASSET_ARCHIVE_MAGIC));
+    header.version      = ASSET_ARCHIVE_VERSION;
+    header.entry_count  = static_cast<std::uint32_t>(files.size());
+    header.table_size   = table_size;
+    header.table_offset = table_offset;
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+
+    if (!out) {
+
+        std::cerr << "Unable to write " << output.string() << '\n';
+        return 1;
+    }
+
+    out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    out.write(reinterpret_cast<char const*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(Asset_archive_entry)));
+    out.write(paths.data(), static_cast<std::streamsize>(paths.size()));
+
+    std::uint64_t written = paths_offset + paths.size();
+
+    for (Packed_file const& file : files) {
+
+        write_padding(out, written, file.offset);
+
+        std::ifstream in(file.source, std::ios::binary);
+        std::vector<char> const contents{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+
+        if (contents.size() != file.size) {
+
+            std::cerr << "Unable to read " << file.source.string() << '\n';
+            return 1;
+        }
+
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        written = file.offset + file.size;
+    }
+
+    if (!out) {
+
+        std::cerr << "Unable to write " << output.string() << '\n';
+        return 1;
+    }
+
+    std::cout << "Packed " << files.size() << " file(s) into " << output.string() << " (" << written << " bytes)\n";
+
+    return 0;
+}
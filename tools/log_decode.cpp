@@ -0,0 +1,162 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "utils/log_binary.h"
+#include "utils/logger.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Turns a LOG_BIN file, or a flight recorder dump, back into the same
+// [LEVEL]/[Time]/[File]/[Line]/[Function]/[Logger] text LOG prints.
+//
+// Usage:
+//     Tiny_Tanks_log_decode <binary log> [--color]
+
+namespace {
+
+// ===================================================================
+// struct Decoded_site
+// -------------------------------------------------------------------
+
+struct Decoded_site {
+
+    Log_lvl       level = Log_lvl::NO_LOG_LVLS;
+    std::uint32_t line  = 0u;
+    std::string   file;
+    std::string   function;
+};
+
+// -------------------------------------------------------------------
+template<typename Value_type>
+Value_type read_at(std::vector<char> const& bytes, std::size_t const offset) {
+
+    Value_type value{};
+    std::memcpy(&value, bytes.data() + offset, sizeof(value));
+
+    return value;
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+    if (argc < 2) {
+
+        std::cerr << "Usage: " << argv[0] << " <binary log> [--color]\n";
+        return 1;
+    }
+
+    bool const use_color = (argc > 2) && (std::string_view(argv[2]) == "--color");
+
+    std::ifstream file(argv[1], std::ios::binary);
+
+    if (!file) {
+
+        std::cerr << "Unable to open " << argv[1] << '\n';
+        return 1;
+    }
+
+    std::vector<char> const bytes{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+    if (bytes.size() < sizeof(Log_binary_file_header)) {
+
+        std::cerr << "Not a binary log, too small\n";
+        return 1;
+    }
+
+    auto const header = read_at<Log_binary_file_header>(bytes, 0u);
+
+    if (std::memcmp(header.magic, LOG_BINARY_MAGIC, sizeof(LOG_BINARY_MAGIC)) != 0 || header.version != LOG_BINARY_VERSION) {
+
+        std::cerr << "Not a binary log, or an unsupported version\n";
+        return 1;
+    }
+
+    std::unordered_map<std::uint32_t, Decoded_site> sites;
+
+    std::size_t offset        = header.header_size;
+    std::size_t message_count = 0u;
+
+    // A zero word is where the writer stopped (or the unused rest of a mapped file).
+    while (offset + sizeof(Log_binary_record_header) <= bytes.size()) {
+
+        auto const record = read_at<Log_binary_record_header>(bytes, offset);
+
+        std::size_t const size = record.size_and_kind & 0x00FFFFFFu;
+        auto const        kind = static_cast<Log_record_kind>(record.size_and_kind >> 24u);
+
+        if (size < sizeof(Log_binary_record_header) || offset + size > bytes.size()) {
+
+            break;
+        }
+
+        std::size_t const payload_offset = offset + sizeof(Log_binary_record_header);
+
+        std::size_t const payload_size   = size - sizeof(Log_binary_record_header);
+
+        if (kind == Log_record_kind::Site) {
+
+            if (payload_size < sizeof(Log_binary_site_payload)) {
+
+                std::cerr << "Skipping a truncated site record at offset " << offset << '\n';
+                offset += size;
+                continue;
+            }
+
+            auto const payload = read_at<Log_binary_site_payload>(bytes, payload_offset);
+
+            // Names past the record's end, a corrupt or truncated dump
+            if (static_cast<std::size_t>(payload.file_size) + payload.function_size > payload_size - sizeof(payload)) {
+
+                std::cerr << "Skipping a site record with bad name sizes at offset " << offset << '\n';
+                offset += size;
+                continue;
+            }
+
+            char const* const names = bytes.data() + payload_offset + sizeof(payload);
+
+            sites[record.site_id] = Decoded_site{
+                static_cast<Log_lvl>(payload.level),
+                payload.line,
+                std::string(names, payload.file_size),
+                std::string(names + payload.file_size, payload.function_size)
+            };
+
+        } else if (kind == Log_record_kind::Message) {
+
+            std::ostringstream message;
+            Log_binary::format_args(message, std::span<std::byte const>(reinterpret_cast<std::byte const*>(bytes.data()) + payload_offset, payload_size));
+
+            auto const time = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(header.wall_clock_base_ns) + std::chrono::nanoseconds(record.timestamp_ns)));
+
+            auto const site = sites.find(record.site_id);
+
+            if (site == sites.end()) {
+
+                Logger::write_record(std::cout, Log_lvl::NO_LOG_LVLS, time, "unknown", 0u, "unknown", message.str(), use_color);
+            } else {
+
+                Logger::write_record(std::cout, site->second.level, time, site->second.file, site->second.line, site->second.function, message.str(), use_color);
+            }
+
+            ++message_count;
+        }
+
+        offset += size;
+    }
+
+    std::cerr << "Decoded " << message_count << " record(s) from " << sites.size() << " call site(s)\n";
+
+    return 0;
+}
@@ -0,0 +1,394 @@
+// ===================================================================
+// Includes
+// -------------------------------------------------------------------
+
+#include "SFML/Graphics.hpp"
+#include "utils/sdf_font.h"
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Bakes a font into a signed distance field atlas and its metrics, see
+// utils/sdf_font.h for the files written. Glyphs are rasterised once at
+// --size with FreeType and turned into distances with an exact
+// Euclidean distance transform, no GL context needed so it runs as a
+// build step on any machine.
+//
+// Usage:
+//     Tiny_Tanks_sdf_atlas <font> <output .sdf> [--size 48] [--range 6]
+
+using namespace tiny_tanks::utils;
+
+namespace {
+
+// ===================================================================
+// Settings
+// -------------------------------------------------------------------
+
+constexpr unsigned int DEFAULT_SIZE  = 48u;
+constexpr unsigned int DEFAULT_RANGE = 6u;
+constexpr unsigned int ATLAS_WIDTH   = 512u;
+constexpr unsigned int ATLAS_GAP     = 1u;   // Keeps bilinear filtering from bleeding between glyphs
+
+// Printable ASCII and Latin-1
+constexpr std::pair<char32_t, char32_t> CODEPOINT_RANGES[] = { { 32u, 126u }, { 160u, 255u } };
+
+struct Baked_glyph {
+
+    Sdf_glyph                 metrics = {};
+    unsigned int              width   = 0u;
+    unsigned int              height  = 0u;
+    std::vector<std::uint8_t> distances;
+};
+
+// ===================================================================
+// Distance transform
+// -------------------------------------------------------------------
+
+constexpr float INF = 1e20f;
+
+// -------------------------------------------------------------------
+// Felzenszwalb and Huttenlocher's squared distance transform of one row / column, in place.
+void transform_1d(std::vector<float>& f, std::size_t const n, std::vector<float>& d, std::vector<int>& v, std::vector<float>& z) {
+
+    int k = 0;
+    v[0]  = 0;
+    z[0]  = -INF;
+    z[1]  = INF;
+
+    // Lower envelope of the parabolas rooted at every sample
+    auto const intersect = [&](int const q, int const r) {
+
+        return ((f[static_cast<std::size_t>(q)] + static_cast<float>(q * q)) - (f[static_cast<std::size_t>(r)] + static_cast<float>(r * r)))
+             / static_cast<float>(2 * q - 2 * r);
+    };
+
+    for (int q = 1; q < static_cast<int>(n); ++q) {
+
+        float s = intersect(q, v[static_cast<std::size_t>(k)]);
+
+        while (s <= z[static_cast<std::size_t>(k)]) {
+
+            --k;
+            s = intersect(q, v[static_cast<std::size_t>(k)]);
+        }
+
+        ++k;
+        v[static_cast<std::size_t>(k)]      = q;
+        z[static_cast<std::size_t>(k)]      = s;
+        z[static_cast<std::size_t>(k) + 1u] = INF;
+    }
+
+    k = 0;
+
+    for (int q = 0; q < static_cast<int>(n); ++q) {
+
+        while (z[static_cast<std::size_t>(k) + 1u] < static_cast<float>(q)) {
+
+            ++k;
+        }
+
+        int const r = v[static_cast<std::size_t>(k)];
+        d[static_cast<std::size_t>(q)] = static_cast<float>((q - r) * (q - r)) + f[static_cast<std::size_t>(r)];
+    }
+
+    std::copy_n(d.begin(), n, f.begin());
+}
+
+// -------------------------------------------------------------------
+// Squared distance of every pixel to the nearest pixel where grid is 0.
+void transform_2d(std::vector<float>& grid, unsigned int const width, unsigned int const height) {
+
+    std::size_t const size = std::max(width, height);
+
+    std::vector<float> f(size);
+    std::vector<float> d(size);
+    std::vector<int>   v(size);
+    std::vector<float> z(size + 1u);
+
+    for (unsigned int x = 0u; x < width; ++x) {
+
+        for (unsigned int y = 0u; y < height; ++y) { f[y] = grid[y * width + x]; }
+
+        transform_1d(f, height, d, v, z);
+
+        for (unsigned int y = 0u; y < height; ++y) { grid[y * width + x] = f[y]; }
+    }
+
+    for (unsigned int y = 0u; y < height; ++y) {
+
+        std::copy_n(grid.begin() + y * width, width, f.begin());
+        transform_1d(f, width, d, v, z);
+        std::copy_n(f.begin(), width, grid.begin() + y * width);
+    }
+}
+
+// -------------------------------------------------------------------
+// 0.5 on the outline, 1 at range pixels inside and 0 at range pixels outside.
+std::vector<std::uint8_t> make_distance_field(FT_Bitmap const& bitmap, unsigned int const range, unsigned int const width, unsigned int const height) {
+
+    std::vector<float> to_inside (static_cast<std::size_t>(width) * height, INF);
+    std::vector<float> to_outside(static_cast<std::size_t>(width) * height, 0.0f);
+
+    for (unsigned int y = 0u; y < bitmap.rows; ++y) {
+
+        for (unsigned int x = 0u; x < bitmap.width; ++x) {
+
+            std::uint8_t const coverage = bitmap.buffer[static_cast<std::ptrdiff_t>(y) * bitmap.pitch + x];
+
+            if (coverage >= 128u) {
+
+                std::size_t const index = (y + range) * width + (x + range);
+
+                to_inside [index] = 0.0f;
+                to_outside[index] = INF;
+            }
+        }
+    }
+
+    transform_2d(to_inside,  width, height);
+    transform_2d(to_outside, width, height);
+
+    std::vector<std::uint8_t> distances(to_inside.size());
+
+    for (std::size_t i = 0u; i < distances.size(); ++i) {
+
+        // Pixel centres, so both sides are half a pixel short of the real outline
+        float const signed_distance = (to_outside[i] > 0.0f)
+            ? std::sqrt(to_outside[i]) - 0.5f
+            : -(std::sqrt(to_inside[i]) - 0.5f);
+
+        float const value = std::clamp(0.5f + signed_distance / (2.0f * static_cast<float>(range)), 0.0f, 1.0f);
+        distances[i] = static_cast<std::uint8_t>(std::lround(value * 255.0f));
+    }
+
+    return distances;
+}
+
+// -------------------------------------------------------------------
+template<typename Type>
+void write_array(std::ofstream& out, std::vector<Type> const& values) {
+
+    out.write(reinterpret_cast<char const*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(Type)));
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+    if (argc < 3) {
+
+        std::cerr << "Usage: " << argv[0] << " <font> <output .sdf> [--size 48] [--range 6]\n";
+        return 1;
+    }
+
+    std::filesystem::path const font_path = argv[1];
+    std::filesystem::path const output    = argv[2];
+
+    unsigned int size  = DEFAULT_SIZE;
+    unsigned int range = DEFAULT_RANGE;
+
+    for (int i = 3; i + 1 < argc; i += 2) {
+
+        std::string_view const arg = argv[i];
+
+        if      (arg == "--size")  { size  = static_cast<unsigned int>(std::stoul(argv[i + 1])); }
+        else if (arg == "--range") { range = static_cast<unsigned int>(std::stoul(argv[i + 1])); }
+        else {
+
+            std::cerr << "Unknown option " << arg << '\n';
+            return 1;
+        }
+    }
+
+    FT_Library library = nullptr;
+    FT_Face    face    = nullptr;
+
+    if (FT_Init_FreeType(&library) != 0 || FT_New_Face(library, font_path.string().c_str(), 0, &face) != 0) {
+
+        std::cerr << "Unable to open " << font_path.string() << '\n';
+        return 1;
+    }
+
+    FT_Set_Pixel_Sizes(face, 0u, size);
+
+    // Rasterise every glyph and turn it into distances
+    std::vector<Baked_glyph> glyphs;
+    std::vector<FT_UInt>     glyph_indices;
+
+    for (auto const& [first, last] : CODEPOINT_RANGES) {
+
+        for (char32_t codepoint = first; codepoint <= last; ++codepoint) {
+
+            FT_UInt const glyph_index = FT_Get_Char_Index(face, codepoint);
+
+            if (glyph_index == 0u || FT_Load_Char(face, codepoint, FT_LOAD_RENDER | FT_LOAD_TARGET_NORMAL) != 0) {
+
+                continue;
+            }
+
+            FT_GlyphSlot const slot = face->glyph;
+
+            Baked_glyph glyph;
+            glyph.metrics.codepoint = codepoint;
+            glyph.metrics.advance   = static_cast<float>(slot->advance.x) / 64.0f;
+
+            if (slot->bitmap.width != 0u && slot->bitmap.rows != 0u && slot->bitmap.pixel_mode == FT_PIXEL_MODE_GRAY) {
+
+                glyph.width     = slot->bitmap.width + range * 2u;
+                glyph.height    = slot->bitmap.rows  + range * 2u;
+                glyph.distances = make_distance_field(slot->bitmap, range, glyph.width, glyph.height);
+
+                glyph.metrics.left   = static_cast<float>(slot->bitmap_left) - static_cast<float>(range);
+                glyph.metrics.top    = static_cast<float>(-slot->bitmap_top) - static_cast<float>(range);
+                glyph.metrics.width  = static_cast<float>(glyph.width);
+                glyph.metrics.height = static_cast<float>(glyph.height);
+            }
+
+            glyphs.push_back(std::move(glyph));
+            glyph_indices.push_back(glyph_index);
+        }
+    }
+
+    if (glyphs.empty()) {
+
+        std::cerr << "No glyphs found in " << font_path.string() << '\n';
+        return 1;
+    }
+
+    // Shelf packing, tallest first so the rows waste little
+    std::vector<std::size_t> order(glyphs.size());
+
+    for (std::size_t i = 0u; i < order.size(); ++i) { order[i] = i; }
+
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t const lhs, std::size_t const rhs) {
+
+        return glyphs[lhs].height > glyphs[rhs].height;
+    });
+
+    unsigned int x          = ATLAS_GAP;
+    unsigned int y          = ATLAS_GAP;
+    unsigned int row_height = 0u;
+
+    for (std::size_t const index : order) {
+
+        Baked_glyph& glyph = glyphs[index];
+
+        if (glyph.width == 0u) {
+
+            continue;
+        }
+
+        if (x + glyph.width + ATLAS_GAP > ATLAS_WIDTH) {
+
+            x          = ATLAS_GAP;
+            y         += row_height + ATLAS_GAP;
+            row_height = 0u;
+        }
+
+        glyph.metrics.texture_x = x;
+        glyph.metrics.texture_y = y;
+
+        x         += glyph.width + ATLAS_GAP;
+        row_height = std::max(row_height, glyph.height);
+    }
+
+    unsigned int const atlas_height = std::bit_ceil(y + row_height + ATLAS_GAP);
+
+    sf::Image atlas({ ATLAS_WIDTH, atlas_height }, sf::Color(255u, 255u, 255u, 0u));
+
+    for (Baked_glyph const& glyph : glyphs) {
+
+        for (unsigned int row = 0u; row < glyph.height; ++row) {
+
+            for (unsigned int column = 0u; column < glyph.width; ++column) {
+
+                std::uint8_t const distance = glyph.distances[row * glyph.width + column];
+                atlas.setPixel({ glyph.metrics.texture_x + column, glyph.metrics.texture_y + row }, sf::Color(255u, 255u, 255u, distance));
+            }
+        }
+    }
+
+    // Kerning of every baked pair, only the non zero ones are kept
+    std::vector<Sdf_kerning> kerning;
+
+    if (FT_HAS_KERNING(face)) {
+
+        for (std::size_t first = 0u; first < glyphs.size(); ++first) {
+
+            for (std::size_t second = 0u; second < glyphs.size(); ++second) {
+
+                FT_Vector amount{};
+
+                if (FT_Get_Kerning(face, glyph_indices[first], glyph_indices[second], FT_KERNING_DEFAULT, &amount) == 0 && amount.x != 0) {
+
+                    kerning.push_back(Sdf_kerning{
+                        glyphs[first].metrics.codepoint,
+                        glyphs[second].metrics.codepoint,
+                        static_cast<float>(amount.x) / 64.0f
+                    });
+                }
+            }
+        }
+    }
+
+    Sdf_font_header header{};
+    std::memcpy(header.magic, SDF_FONT_MAGIC, sizeof(SDF_FONT_MAGIC));
+    header.version        = SDF_FONT_VERSION;
+    header.glyph_count    = static_cast<std::uint32_t>(glyphs.size());
+    header.kerning_count  = static_cast<std::uint32_t>(kerning.size());
+    header.base_size      = static_cast<float>(size);
+    header.distance_range = static_cast<float>(range);
+    header.line_spacing   = static_cast<float>(face->size->metrics.height) / 64.0f;
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+
+    std::vector<Sdf_glyph> metrics;
+    metrics.reserve(glyphs.size());
+
+    for (Baked_glyph const& glyph : glyphs) {
+
+        metrics.push_back(glyph.metrics);
+    }
+
+    std::filesystem::create_directories(output.parent_path().empty() ? "." : output.parent_path());
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+
+    out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    write_array(out, metrics);
+    write_array(out, kerning);
+
+    if (!out) {
+
+        std::cerr << "Unable to write " << output.string() << '\n';
+        return 1;
+    }
+
+    std::filesystem::path const atlas_path = output.string() + SDF_ATLAS_SUFFIX;
+
+    if (!atlas.saveToFile(atlas_path)) {
+
+        std::cerr << "Unable to write " << atlas_path.string() << '\n';
+        return 1;
+    }
+
+    std::cout << "Baked " << glyphs.size() << " glyphs and " << kerning.size() << " kerning pairs into "
+              << output.string() << " (" << ATLAS_WIDTH << 'x' << atlas_height << " atlas)\n";
+
+    return 0;
+}